@@ -0,0 +1,260 @@
+#include "baseline.h"
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+static constexpr double DefaultTolerance = 0.25;
+
+/* Just enough JSON to read back what the workload runner writes */
+class BaselineParser {
+public:
+	explicit BaselineParser(std::string Text) : Text(std::move(Text)) {}
+
+	bool Parse(std::vector<BaselineEntry>& Entries, std::string& BuildType, std::string& Error) {
+		double Tolerance = DefaultTolerance;
+		bool Found = false;
+		Entries.clear();
+		if (!Expect('{')) {
+			return Fail(Error, "expected an object");
+		}
+		while (!Peek('}')) {
+			std::string Key;
+			if (!String(Key) || !Expect(':')) {
+				return Fail(Error, "expected a key");
+			}
+			if (Key == "tolerance") {
+				if (!Number(Tolerance)) {
+					return Fail(Error, "tolerance must be a number");
+				}
+			}
+			else if (Key == "build_type") {
+				if (!String(BuildType)) {
+					return Fail(Error, "build_type must be a string");
+				}
+			}
+			else if (Key == "workloads") {
+				if (!Workloads(Entries)) {
+					return Fail(Error, "malformed workloads array");
+				}
+				Found = true;
+			}
+			else if (!Skip()) {
+				return Fail(Error, "malformed value for " + Key);
+			}
+			if (!Expect(',') && !Peek('}')) {
+				return Fail(Error, "expected , or }");
+			}
+		}
+		if (!Found) {
+			return Fail(Error, "no workloads array");
+		}
+		for (BaselineEntry& Entry : Entries) {
+			if (Entry.Tolerance == 0) {
+				Entry.Tolerance = Tolerance;
+			}
+		}
+		return true;
+	}
+
+private:
+	std::string Text;
+	size_t Position = 0;
+
+	bool Fail(std::string& Error, const std::string& What) {
+		Error = What + " at offset " + std::to_string(Position);
+		return false;
+	}
+
+	void Space() {
+		while (Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position]))) {
+			++Position;
+		}
+	}
+
+	bool Peek(char Token) {
+		Space();
+		return Position < Text.size() && Text[Position] == Token;
+	}
+
+	bool Expect(char Token) {
+		if (!Peek(Token)) {
+			return false;
+		}
+		++Position;
+		return true;
+	}
+
+	bool String(std::string& Value) {
+		if (!Expect('"')) {
+			return false;
+		}
+		Value.clear();
+		while (Position < Text.size() && Text[Position] != '"') {
+			if (Text[Position] == '\\' && ++Position == Text.size()) {
+				return false;
+			}
+			Value += Text[Position++];
+		}
+		return Position++ < Text.size();
+	}
+
+	bool Number(double& Value) {
+		Space();
+		const char* Start = Text.c_str() + Position;
+		char* End;
+		Value = std::strtod(Start, &End);
+		Position += End - Start;
+		return End != Start;
+	}
+
+	bool Literal(const char* Word) {
+		Space();
+		size_t Length = std::strlen(Word);
+		if (Text.compare(Position, Length, Word) != 0) {
+			return false;
+		}
+		Position += Length;
+		return true;
+	}
+
+	bool Skip() {
+		if (Peek('"')) {
+			std::string Ignored;
+			return String(Ignored);
+		}
+		if (Expect('[')) {
+			while (!Peek(']')) {
+				if (!Skip() || (!Expect(',') && !Peek(']'))) {
+					return false;
+				}
+			}
+			return Expect(']');
+		}
+		if (Expect('{')) {
+			while (!Peek('}')) {
+				std::string Key;
+				if (!String(Key) || !Expect(':') || !Skip() || (!Expect(',') && !Peek('}'))) {
+					return false;
+				}
+			}
+			return Expect('}');
+		}
+		double Ignored;
+		return Literal("true") || Literal("false") || Literal("null") || Number(Ignored);
+	}
+
+	bool Workloads(std::vector<BaselineEntry>& Entries) {
+		if (!Expect('[')) {
+			return false;
+		}
+		while (!Peek(']')) {
+			BaselineEntry Entry;
+			if (!Expect('{')) {
+				return false;
+			}
+			while (!Peek('}')) {
+				std::string Key;
+				double Value;
+				if (!String(Key) || !Expect(':')) {
+					return false;
+				}
+				if (Key == "name") {
+					if (!String(Entry.Name)) {
+						return false;
+					}
+				}
+				else if (Key == "instructions" || Key == "cycles" || Key == "emulated_mhz" || Key == "tolerance") {
+					if (!Number(Value)) {
+						return false;
+					}
+					if (Key == "instructions") Entry.Instructions = static_cast<u64>(Value);
+					else if (Key == "cycles") Entry.Cycles = static_cast<u64>(Value);
+					else if (Key == "emulated_mhz") Entry.EmulatedMHz = Value;
+					else Entry.Tolerance = Value;
+				}
+				else if (!Skip()) {
+					return false;
+				}
+				if (!Expect(',') && !Peek('}')) {
+					return false;
+				}
+			}
+			Expect('}');
+			if (Entry.Name.empty()) {
+				return false;
+			}
+			Entries.push_back(Entry);
+			if (!Expect(',') && !Peek(']')) {
+				return false;
+			}
+		}
+		return Expect(']');
+	}
+};
+
+bool LoadBaseline(std::istream& In, std::vector<BaselineEntry>& Entries, std::string& BuildType, std::string& Error) {
+	std::string Text((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+	return BaselineParser(std::move(Text)).Parse(Entries, BuildType, Error);
+}
+
+const BaselineEntry* FindBaseline(const std::vector<BaselineEntry>& Entries, const std::string& Name) {
+	for (const BaselineEntry& Entry : Entries) {
+		if (Entry.Name == Name) {
+			return &Entry;
+		}
+	}
+	return nullptr;
+}
+
+bool WithinBaseline(const BaselineEntry& Expected, const BaselineMeasurement& Measured) {
+	return Measured.Instructions == Expected.Instructions && Measured.Cycles == Expected.Cycles
+		&& Measured.EmulatedMHz >= Expected.EmulatedMHz * (1 - Expected.Tolerance);
+}
+
+bool ReportBaseline(std::ostream& Out, const std::vector<BaselineEntry>& Entries, const std::vector<BaselineMeasurement>& Measured) {
+	bool Passed = true;
+	char Line[160];
+	std::snprintf(Line, sizeof(Line), "%-16s %-14s %14s %14s %9s\n", "workload", "metric", "baseline", "current", "change");
+	Out << Line;
+	for (const BaselineMeasurement& Run : Measured) {
+		const BaselineEntry* Expected = FindBaseline(Entries, Run.Name);
+		if (!Expected) {
+			std::snprintf(Line, sizeof(Line), "%-16s %-14s %14s %14.2f %9s  not in baseline\n", Run.Name.c_str(), "emulated_mhz", "-", Run.EmulatedMHz, "");
+			Out << Line;
+			continue;
+		}
+		auto Count = [&](const char* Metric, u64 Before, u64 After) {
+			std::snprintf(Line, sizeof(Line), "%-16s %-14s %14llu %14llu %+8.2f%%%s\n", Run.Name.c_str(), Metric,
+				static_cast<unsigned long long>(Before), static_cast<unsigned long long>(After),
+				Before ? 100.0 * (static_cast<double>(After) - Before) / Before : 0.0, Before == After ? "" : "  CHANGED, the workload no longer does the same work");
+			Out << Line;
+			Passed &= Before == After;
+		};
+		Count("instructions", Expected->Instructions, Run.Instructions);
+		Count("cycles", Expected->Cycles, Run.Cycles);
+		double Change = Expected->EmulatedMHz ? (Run.EmulatedMHz - Expected->EmulatedMHz) / Expected->EmulatedMHz : 0;
+		bool Slower = Run.EmulatedMHz < Expected->EmulatedMHz * (1 - Expected->Tolerance);
+		std::snprintf(Line, sizeof(Line), "%-16s %-14s %14.2f %14.2f %+8.2f%%  noise %.1f%%%s\n", Run.Name.c_str(), "emulated_mhz",
+			Expected->EmulatedMHz, Run.EmulatedMHz, 100 * Change, 100 * Run.Spread, Slower ? "  REGRESSION" : "");
+		Out << Line;
+		if (Slower) {
+			std::snprintf(Line, sizeof(Line), "%-16s %-14s allowed down to %.2f MHz (tolerance %.0f%%)\n", "", "", Expected->EmulatedMHz * (1 - Expected->Tolerance),
+				100 * Expected->Tolerance);
+			Out << Line;
+		}
+		Passed &= !Slower;
+	}
+	for (const BaselineEntry& Entry : Entries) {
+		bool Ran = false;
+		for (const BaselineMeasurement& Run : Measured) {
+			Ran |= Run.Name == Entry.Name;
+		}
+		if (!Ran) {
+			std::snprintf(Line, sizeof(Line), "%-16s %-14s %14.2f %14s %9s  not run\n", Entry.Name.c_str(), "emulated_mhz", Entry.EmulatedMHz, "-", "");
+			Out << Line;
+		}
+	}
+	return Passed;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "../src/6502.h"
+
+/*
+	Committed workload results for the CTest performance check. The file is the JSON written by
+	6502-bench-workloads --json, optionally with a top-level "tolerance" and per-workload
+	"tolerance" overrides (fraction of emulated MHz that may be lost, 0.25 = 25%).
+	Instruction and cycle counts are deterministic and must match exactly.
+
+	Speeds only compare within one CMAKE_BUILD_TYPE, recorded as "build_type"; the runner refuses
+	a baseline from another build type. bench/baseline.json is a Release run: refresh it with
+	cmake -DCMAKE_BUILD_TYPE=Release, then 6502-bench-workloads --json bench/baseline.json on
+	the reference machine.
+*/
+struct BaselineEntry {
+	std::string Name;
+	u64 Instructions = 0;
+	u64 Cycles = 0;
+	double EmulatedMHz = 0;
+	double Tolerance = 0;
+};
+
+struct BaselineMeasurement {
+	std::string Name;
+	u64 Instructions = 0;
+	u64 Cycles = 0;
+	double EmulatedMHz = 0; // From the best repetition
+	double Spread = 0; // Median over best time, minus one
+};
+
+bool LoadBaseline(std::istream& In, std::vector<BaselineEntry>& Entries, std::string& BuildType, std::string& Error);
+const BaselineEntry* FindBaseline(const std::vector<BaselineEntry>& Entries, const std::string& Name);
+/* True when the counts match and the speed is within tolerance */
+bool WithinBaseline(const BaselineEntry& Expected, const BaselineMeasurement& Measured);
+/* One row per metric, regressions flagged; returns false if anything regressed */
+bool ReportBaseline(std::ostream& Out, const std::vector<BaselineEntry>& Entries, const std::vector<BaselineMeasurement>& Measured);
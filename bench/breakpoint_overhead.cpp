@@ -0,0 +1,67 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../src/6502.h"
+#include "../src/condition.h"
+#include "../src/run_loop.h"
+#include "overhead.h"
+
+/*
+	Cost of each RunLoop mode on a loop that never reaches its breakpoints, against calling
+	Execute directly, and the cost of evaluating one compiled breakpoint condition.
+	Usage: breakpoint-overhead [cycles]
+*/
+
+static double Time(RunLoop& Loop, RunMode Mode, u64 Cycles, u64& Instructions) {
+	Loop.M6502.PC = CopyLoopOrigin;
+	Loop.Mode = Mode;
+	auto Start = std::chrono::steady_clock::now();
+	Instructions = Loop.Run(Cycles).Instructions;
+	return SecondsSince(Start);
+}
+
+static double TimeExecute(NMOS6502& M6502, u64 Cycles, u64& Instructions) {
+	M6502.PC = CopyLoopOrigin;
+	auto Start = std::chrono::steady_clock::now();
+	u64 Spent = 0;
+	for (Instructions = 0; Spent < Cycles; ++Instructions) {
+		Spent += M6502.Execute(0);
+	}
+	return SecondsSince(Start);
+}
+
+int main(int argc, char** argv) {
+	u64 Cycles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+	NMOS6502 M6502;
+	LoadCopyLoop(M6502);
+	RunLoop Loop(M6502);
+	for (u16 Address = 0x8000; Address < 0x9000; Address += 3) {
+		Loop.Breakpoints.Set(Address);
+	}
+
+	static constexpr const char* Names[] = { "execute", "fast loop", "debug, per instruction", "debug, per block" };
+	static constexpr RunMode Modes[] = { RunFast, RunFast, RunDebugInstruction, RunDebugBlock };
+	double Best[4];
+	u64 Instructions[4] = {};
+	KeepBest(Best, [&](int Which) {
+		return Which == 0 ? TimeExecute(M6502, Cycles, Instructions[0]) : Time(Loop, Modes[Which], Cycles, Instructions[Which]);
+	});
+	for (int Which = 0; Which < 4; ++Which) {
+		std::printf("%-24s %.2f ns/instruction (%+.1f%%)\n", Names[Which], 1e9 * Best[Which] / Instructions[Which], 100.0 * (Best[Which] - Best[0]) / Best[0]);
+	}
+
+	Condition Compiled;
+	Compiled.Compile("A == $42 && mem[$0200] & $80");
+	u64 Holds = 0;
+	double Conditions = 1e9;
+	for (int Round = 0; Round < 5; ++Round) {
+		auto Start = std::chrono::steady_clock::now();
+		for (u32 i = 0; i < 10000000; ++i) {
+			M6502.A = static_cast<u8>(i);
+			Holds += Compiled.Evaluate(M6502);
+		}
+		Conditions = std::min(Conditions, SecondsSince(Start));
+	}
+	std::printf("%-24s %.2f ns/evaluation (%llu held)\n", "condition", 1e9 * Conditions / 10000000, static_cast<unsigned long long>(Holds));
+	return 0;
+}
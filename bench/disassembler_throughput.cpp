@@ -0,0 +1,53 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../src/disassembler.h"
+#include "../src/opcodes.h"
+
+/*
+	Bulk disassembly speed over a 64 KB image of random bytes, in MB of code consumed and of
+	listing produced per second, against formatting each instruction into a std::string.
+	Usage: disassembler-throughput [passes]
+*/
+
+static double Seconds(std::chrono::steady_clock::time_point Start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+int main(int argc, char** argv) {
+	int Passes = argc > 1 ? std::atoi(argv[1]) : 200;
+	std::vector<u8> Memory(0x10000);
+	u32 Seed = 2463534242u;
+	for (u8& Byte : Memory) {
+		Seed ^= Seed << 13;
+		Seed ^= Seed >> 17;
+		Seed ^= Seed << 5;
+		Byte = static_cast<u8>(Seed);
+	}
+
+	std::vector<char> Listing(1 << 20);
+	size_t Produced = 0;
+	auto Start = std::chrono::steady_clock::now();
+	for (int Pass = 0; Pass < Passes; ++Pass) {
+		for (u32 Next = 0; Next < 0x10000;) {
+			Produced += DisassembleRange(Memory.data(), Next, 0x10000, Listing.data(), Listing.size(), Next);
+		}
+	}
+	double Range = Seconds(Start);
+
+	size_t Strings = 0;
+	Start = std::chrono::steady_clock::now();
+	for (int Pass = 0; Pass < Passes / 10 + 1; ++Pass) {
+		for (u32 Address = 0; Address < 0x10000; Address += InstructionLength(Memory[Address])) {
+			Strings += Disassemble(Memory, static_cast<u16>(Address)).size();
+		}
+	}
+	double String = Seconds(Start) / (Passes / 10 + 1) * Passes;
+
+	double Code = 65536.0 * Passes / 1048576.0;
+	std::printf("range     %.0f MB/s of code, %.0f MB/s of listing\n", Code / Range, Produced / 1048576.0 / Range);
+	std::printf("string    %.0f MB/s of code (%zu)\n", Code / String, Strings);
+	return 0;
+}
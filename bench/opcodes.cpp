@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+#include <cstring>
+#include <string>
+#include "../src/6502.h"
+#include "../src/opcodes.h"
+
+/*
+	Time per instruction and emulated MHz for every documented opcode, one benchmark per
+	addressing mode variant: page-cross and no-cross for indexed reads, taken, not taken and
+	taken across a page for branches.
+
+	An instruction that ends up 1-3 bytes further on runs from a sled of back-to-back copies,
+	so the host loop is paid once per 64 instructions. Anything else (JMP, JSR, RTS, RTI,
+	branches across a page) is timed one instruction at a time from a fresh PC.
+	Operands are written in the core's dialect, absolute operands high byte first.
+*/
+
+enum Variant { Plain, NoCross, Cross, Taken, NotTaken, TakenCross };
+
+static constexpr const char* VariantNames[] = { "", "no_cross", "cross", "taken", "not_taken", "taken_cross" };
+static constexpr u16 SledStart = 0x0400;
+static constexpr int SledCopies = 64; // Fits in one page, so taken branches never cross
+static constexpr u16 CrossingBranch = 0x04F0; // Plus 0x7F lands on the next page
+static constexpr u8 Index = 0x10;
+
+struct Bench {
+	u8 Opcode;
+	Variant Kind;
+	u16 Start;
+	int Stride; // 0 when timed one instruction at a time
+};
+
+/* Registers, flags, pointers and stack for one pass over the sled */
+static void Restart(NMOS6502& M6502, const Bench& Setup) {
+	M6502.PC = Setup.Start;
+	M6502.SP = 0x01F0;
+	M6502.A = 0x01;
+	M6502.X = Index;
+	M6502.Y = Index;
+	if (IsBranch(Setup.Opcode)) {
+		/* Bits 7-6 pick N, V, C or Z and bit 5 the value that takes the branch */
+		static constexpr NMOS6502::FLAGS Flags[] = { NMOS6502::N, NMOS6502::V, NMOS6502::C, NMOS6502::Z };
+		bool Value = (Setup.Opcode & 0x20) != 0;
+		M6502.ProcessorStatus[Flags[Setup.Opcode >> 6]] = Setup.Kind == NotTaken ? !Value : Value;
+	}
+}
+
+static void Encode(const Bench& Setup, u8 Bytes[3]) {
+	const OpcodeInfo& Info = OpcodeTable[Setup.Opcode];
+	Bytes[0] = Setup.Opcode;
+	Bytes[1] = 0;
+	Bytes[2] = 0;
+	switch (Info.Mode) {
+	case Immediate: Bytes[1] = 0x01; break;
+	case ZeroPage: case ZeroPageX: case ZeroPageY: Bytes[1] = 0x40; break;
+	case IndirectX: Bytes[1] = 0x70; break; // Plus X is the pointer at $80
+	case IndirectY: Bytes[1] = Setup.Kind == Cross ? 0x92 : 0x90; break;
+	case Absolute: Bytes[1] = 0x30; break;
+	case AbsoluteX: case AbsoluteY:
+		Bytes[1] = 0x30;
+		Bytes[2] = Setup.Kind == Cross ? 0xF8 : 0x00;
+		break;
+	case Indirect: Bytes[1] = 0x00; Bytes[2] = 0x31; break;
+	case Relative: Bytes[1] = Setup.Kind == TakenCross ? 0x7F : 0x02; break; // The core branches relative to the opcode
+	default: break;
+	}
+}
+
+static void Prepare(NMOS6502& M6502, Bench& Setup) {
+	M6502.Reset();
+	M6502.Memory[0x80] = 0x00; // ($70,X) -> $3000
+	M6502.Memory[0x81] = 0x30;
+	M6502.Memory[0x90] = 0x00; // ($90),Y -> $3010
+	M6502.Memory[0x91] = 0x30;
+	M6502.Memory[0x92] = 0xF8; // ($92),Y -> $3108
+	M6502.Memory[0x93] = 0x30;
+	u8 Bytes[3];
+	Setup.Start = Setup.Kind == TakenCross ? CrossingBranch : SledStart;
+	Encode(Setup, Bytes);
+	std::copy(Bytes, Bytes + 3, M6502.Memory.begin() + Setup.Start);
+
+	/* Probe how far one instruction moves PC */
+	NMOS6502 Probe = M6502;
+	Restart(Probe, Setup);
+	Probe.Execute(0);
+	int Stride = Probe.PC - Setup.Start;
+	Setup.Stride = Stride >= 1 && Stride <= 3 ? Stride : 0;
+	for (int Copy = 1; Setup.Stride && Copy < SledCopies; ++Copy) {
+		std::copy(Bytes, Bytes + Setup.Stride, M6502.Memory.begin() + Setup.Start + Copy * Setup.Stride);
+	}
+}
+
+static void Run(benchmark::State& State, Bench Setup) {
+	NMOS6502 M6502;
+	Prepare(M6502, Setup);
+	u64 Cycles = 0, Instructions = 0;
+	if (Setup.Stride) {
+		for (auto _ : State) {
+			Restart(M6502, Setup);
+			for (int i = 0; i < SledCopies; ++i) {
+				Cycles += M6502.Execute(0);
+			}
+		}
+		Instructions = State.iterations() * SledCopies;
+	}
+	else {
+		for (auto _ : State) {
+			Restart(M6502, Setup);
+			Cycles += M6502.Execute(0);
+		}
+		Instructions = State.iterations();
+	}
+	State.SetItemsProcessed(Instructions);
+	State.counters["instruction"] = benchmark::Counter(static_cast<double>(Instructions), benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+	State.counters["emulated_cycles"] = benchmark::Counter(static_cast<double>(Cycles), benchmark::Counter::kIsRate); // M/s is MHz
+	State.counters["cycles/instr"] = benchmark::Counter(static_cast<double>(Cycles) / Instructions);
+}
+
+int main(int argc, char** argv) {
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		const OpcodeInfo& Info = OpcodeTable[Opcode];
+		if (std::strcmp(Info.Mnemonic, "???") == 0 || Opcode == 0x00) { // BRK has no handler in this core
+			continue;
+		}
+		std::vector<Variant> Variants = { Plain };
+		if (Info.Mode == AbsoluteX || Info.Mode == AbsoluteY || Info.Mode == IndirectY) {
+			Variants = { NoCross, Cross };
+		}
+		else if (Info.Mode == Relative) {
+			Variants = { Taken, NotTaken, TakenCross };
+		}
+		for (Variant Kind : Variants) {
+			std::string Name = std::string(Info.Mnemonic) + "/" + AddressingModeNames[Info.Mode];
+			if (Kind != Plain) {
+				Name += std::string("/") + VariantNames[Kind];
+			}
+			Bench Setup{ static_cast<u8>(Opcode), Kind, 0, 0 };
+			benchmark::RegisterBenchmark(Name.c_str(), Run, Setup);
+		}
+	}
+	benchmark::Initialize(&argc, argv);
+	if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	benchmark::Shutdown();
+	return 0;
+}
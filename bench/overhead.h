@@ -0,0 +1,56 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include "../src/6502.h"
+
+/*
+	Shared by the overhead benches: a small zero page copy loop at $0200 that never leaves its
+	two pages, and the timing helpers they measure it with.
+*/
+
+static const u8 CopyLoop[] = {
+	0xA2, 0x00,       // 0200  LDX #$00
+	0xB5, 0x10,       // 0202  LDA $10,X
+	0x95, 0x20,       // 0204  STA $20,X
+	0xE8,             // 0206  INX
+	0xEA,             // 0207  NOP
+	0xEA,             // 0208  NOP
+	0xE0, 0x10,       // 0209  CPX #$10
+	0xD0, 0xF7,       // 020B  BNE back to $0202 (the core branches relative to the opcode, 0xF7 is a no-op on fall through)
+	0x4C, 0x00, 0x02  // 020D  JMP $0200
+};
+
+static constexpr u16 CopyLoopOrigin = 0x0200;
+
+inline void LoadCopyLoop(NMOS6502& M6502) {
+	M6502.Reset();
+	std::copy(std::begin(CopyLoop), std::end(CopyLoop), M6502.Memory.begin() + CopyLoopOrigin);
+}
+
+inline double SecondsSince(std::chrono::steady_clock::time_point Start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+/* Seconds to run the loop for Instructions calls to Execute */
+inline double TimeInstructions(NMOS6502& M6502, u64 Instructions) {
+	M6502.PC = CopyLoopOrigin;
+	auto Start = std::chrono::steady_clock::now();
+	for (u64 i = 0; i < Instructions; ++i) {
+		M6502.Execute(0);
+	}
+	return SecondsSince(Start);
+}
+
+/*
+	Best of Rounds timings of each of Variants, taken in turn round after round so scheduling
+	noise falls on all of them alike. Time(Which) sets up one variant and returns its seconds.
+*/
+template <int Variants, typename Timer>
+void KeepBest(double (&Best)[Variants], Timer Time, int Rounds = 5) {
+	std::fill(std::begin(Best), std::end(Best), 1e9);
+	for (int Round = 0; Round < Rounds; ++Round) {
+		for (int Which = 0; Which < Variants; ++Which) {
+			Best[Which] = std::min(Best[Which], Time(Which));
+		}
+	}
+}
@@ -0,0 +1,139 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../src/6502.h"
+#include "../src/opcodes.h"
+#include "../src/perf_counters.h"
+
+/*
+	Host hardware counters per emulated instruction, grouped by opcode class. Every documented
+	opcode that moves straight on (plus taken branches and JMP abs) runs from a sled of 64 copies
+	with counters open around the whole run, so the host loop that resets PC is included but
+	amortised. JSR, RTS, RTI, BRK and JMP indirect are left out, their targets depend on the stack
+	or on memory rather than the sled.
+	Usage: 6502-perf-classes [passes]
+*/
+
+static constexpr u16 SledStart = 0x0400;
+static constexpr int SledCopies = 64;
+
+static bool Encode(u8 Opcode, u8 Bytes[3]) {
+	const OpcodeInfo& Info = OpcodeTable[Opcode];
+	Bytes[0] = Opcode;
+	Bytes[1] = 0;
+	Bytes[2] = 0;
+	switch (Info.Mode) {
+	case Immediate: Bytes[1] = 0x01; break;
+	case ZeroPage: case ZeroPageX: case ZeroPageY: Bytes[1] = 0x40; break;
+	case IndirectX: Bytes[1] = 0x70; break;
+	case IndirectY: Bytes[1] = 0x90; break;
+	case Absolute: case AbsoluteX: case AbsoluteY: Bytes[1] = 0x30; break; // High byte first in this core
+	case Relative: Bytes[1] = 0x02; break; // Taken, relative to the opcode, lands on the next copy
+	case Indirect: return false;
+	default: break;
+	}
+	return !MnemonicIn(Info.Mnemonic, "JSR RTS RTI BRK ???");
+}
+
+static void Restart(NMOS6502& M6502, u8 Opcode) {
+	M6502.PC = SledStart;
+	M6502.SP = 0x01F0;
+	M6502.A = 0x01;
+	M6502.X = 0x10;
+	M6502.Y = 0x10;
+	if (IsBranch(Opcode)) {
+		static constexpr NMOS6502::FLAGS Flags[] = { NMOS6502::N, NMOS6502::V, NMOS6502::C, NMOS6502::Z };
+		M6502.ProcessorStatus[Flags[Opcode >> 6]] = (Opcode & 0x20) != 0;
+	}
+}
+
+/* Lays out the sled, returns false when one copy does not lead straight to the next */
+static bool Prepare(NMOS6502& M6502, u8 Opcode) {
+	M6502.Reset();
+	M6502.Memory[0x80] = 0x00; // ($70,X) -> $3000
+	M6502.Memory[0x81] = 0x30;
+	M6502.Memory[0x90] = 0x00; // ($90),Y -> $3010
+	M6502.Memory[0x91] = 0x30;
+	u8 Bytes[3];
+	if (!Encode(Opcode, Bytes)) {
+		return false;
+	}
+	int Stride = 1 + OperandLength(OpcodeTable[Opcode].Mode);
+	for (int Copy = 0; Copy < SledCopies; ++Copy) {
+		u16 At = static_cast<u16>(SledStart + Copy * Stride);
+		if (Opcode == 0x4C) { // JMP abs, little-endian, to the next copy
+			Bytes[1] = static_cast<u8>(At + Stride);
+			Bytes[2] = static_cast<u8>((At + Stride) >> 8);
+		}
+		std::copy(Bytes, Bytes + Stride, M6502.Memory.begin() + At);
+	}
+	NMOS6502 Probe = M6502;
+	Restart(Probe, Opcode);
+	Probe.Execute(0);
+	return Probe.PC == SledStart + Stride;
+}
+
+int main(int argc, char** argv) {
+	long Passes = argc > 1 ? std::strtol(argv[1], nullptr, 10) : 20000;
+	if (Passes <= 0) {
+		std::fprintf(stderr, "usage: %s [passes]\n", argv[0]);
+		return 2;
+	}
+	PerfCounters Counters;
+	if (!Counters.AnyAvailable()) {
+		std::printf("no perf_event counters available (not Linux, or kernel.perf_event_paranoid too strict), nothing to report\n");
+		return 0;
+	}
+	for (int Which = 0; Which < PerfCounters::EventCount; ++Which) {
+		if (!Counters.Available(static_cast<PerfCounters::Event>(Which))) {
+			std::printf("%s unavailable\n", PerfCounters::EventNames[Which]);
+		}
+	}
+
+	PerfCounters::Sample Totals[OpcodeClassCount];
+	u64 Instructions[OpcodeClassCount] = {};
+	int Opcodes[OpcodeClassCount] = {};
+	NMOS6502 M6502;
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		if (!Prepare(M6502, static_cast<u8>(Opcode))) {
+			continue;
+		}
+		OpcodeClass Class = ClassOf(static_cast<u8>(Opcode));
+		Counters.Start();
+		for (long Pass = 0; Pass < Passes; ++Pass) {
+			Restart(M6502, static_cast<u8>(Opcode));
+			for (int i = 0; i < SledCopies; ++i) {
+				M6502.Execute(0);
+			}
+		}
+		Totals[Class] += Counters.Stop();
+		Instructions[Class] += static_cast<u64>(Passes) * SledCopies;
+		++Opcodes[Class];
+	}
+
+	/* Per emulated instruction, "-" where the counter is missing */
+	auto Column = [](const PerfCounters::Sample& Sample, PerfCounters::Event Which, u64 Count, char* Text, size_t Size) {
+		if (Sample.Valid[Which]) {
+			std::snprintf(Text, Size, "%.3f", static_cast<double>(Sample.Values[Which]) / Count);
+		}
+		else {
+			std::snprintf(Text, Size, "-");
+		}
+	};
+	std::printf("%-11s %7s %12s %9s %9s %9s %9s %9s\n", "class", "opcodes", "instructions", "ns", "host ins", "IPC", "br-miss", "c-miss");
+	for (int Class = 0; Class < OpcodeClassCount; ++Class) {
+		if (!Instructions[Class]) {
+			continue;
+		}
+		char Time[16], Host[16], IPC[16], Branch[16], Cache[16];
+		Column(Totals[Class], PerfCounters::TaskClock, Instructions[Class], Time, sizeof(Time));
+		Column(Totals[Class], PerfCounters::Instructions, Instructions[Class], Host, sizeof(Host));
+		Column(Totals[Class], PerfCounters::BranchMisses, Instructions[Class], Branch, sizeof(Branch));
+		Column(Totals[Class], PerfCounters::CacheMisses, Instructions[Class], Cache, sizeof(Cache));
+		double Ratio = Totals[Class].InstructionsPerCycle();
+		Ratio < 0 ? std::snprintf(IPC, sizeof(IPC), "-") : std::snprintf(IPC, sizeof(IPC), "%.2f", Ratio);
+		std::printf("%-11s %7d %12llu %9s %9s %9s %9s %9s\n", OpcodeClassNames[Class], Opcodes[Class],
+			static_cast<unsigned long long>(Instructions[Class]), Time, Host, IPC, Branch, Cache);
+	}
+	return 0;
+}
@@ -0,0 +1,32 @@
+#include <cstdio>
+#include <cstdlib>
+#include "../src/6502.h"
+#include "../src/profiler.h"
+#include "overhead.h"
+
+/*
+	Measures the cost of attaching the PC profiler to an instrumented core.
+	Usage: profiler-overhead [instructions]
+*/
+
+int main(int argc, char** argv) {
+	u64 Instructions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+	NMOS6502 M6502;
+	LoadCopyLoop(M6502);
+	Profiler PCProfiler;
+
+	double Best[2];
+	KeepBest(Best, [&](int Which) {
+		M6502.PCProfiler = Which ? &PCProfiler : nullptr;
+		return TimeInstructions(M6502, Instructions);
+	});
+	M6502.PCProfiler = nullptr;
+	double Detached = Best[0], Attached = Best[1];
+
+	double Overhead = 100.0 * (Attached - Detached) / Detached;
+	std::printf("detached: %.2f ns/instruction\n", 1e9 * Detached / Instructions);
+	std::printf("attached: %.2f ns/instruction\n", 1e9 * Attached / Instructions);
+	std::printf("overhead: %.1f%%\n", Overhead);
+	PCProfiler.FlatProfile(std::cout, M6502.Memory, 10);
+	return Overhead < 10.0 ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../src/6502.h"
+#include "../src/replay.h"
+
+/*
+	Cost of recording a run that reads a device register every few instructions and takes an
+	interrupt every 1000, against calling Execute directly; then how fast the recording replays
+	forwards, and the latency of a reverse step and a reverse continue.
+	Usage: replay-overhead [instructions] [checkpoint cycles]
+*/
+
+static const u8 Program[] = {
+	0xAD, 0xD0, 0x00, // 0200  LDA $D000 (device register)
+	0x85, 0x10,       // 0203  STA $10
+	0x18,             // 0205  CLC
+	0x65, 0x12,       // 0206  ADC $12
+	0x85, 0x12,       // 0208  STA $12
+	0x4C, 0x00, 0x02  // 020A  JMP $0200
+};
+
+static const u8 Handler[] = {
+	0xE6, 0x13,       // 0080  INC $13
+	0x4C, 0x00, 0x02  // 0082  JMP $0200
+};
+
+static double Seconds(std::chrono::steady_clock::time_point Start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+static void Load(NMOS6502& M6502) {
+	M6502.Reset();
+	std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+	std::copy(std::begin(Handler), std::end(Handler), M6502.Memory.begin() + 0x0080);
+	M6502.Memory[0xFFFA] = 0x80;
+	M6502.PC = 0x0200;
+	M6502.SP = 0x01FF;
+}
+
+/* The host side of the run: a new device value before every instruction, an IRQ every 1000 */
+static void Drive(NMOS6502& M6502, u64 i) {
+	M6502.Memory[0xD000] = static_cast<u8>(i * 73);
+	if (i % 1000 == 0) {
+		M6502.IRQPending = true;
+	}
+}
+
+int main(int argc, char** argv) {
+	u64 Instructions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000000;
+	u64 Every = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+	NMOS6502 M6502;
+	Load(M6502);
+	auto Start = std::chrono::steady_clock::now();
+	for (u64 i = 0; i < Instructions; ++i) {
+		Drive(M6502, i);
+		M6502.Execute(0);
+	}
+	double Plain = Seconds(Start);
+
+	Load(M6502);
+	Recording Log;
+	{
+		Recorder Recording(M6502, Every);
+		Recording.Input(0xD000);
+		Start = std::chrono::steady_clock::now();
+		for (u64 i = 0; i < Instructions; ++i) {
+			Drive(M6502, i);
+			Recording.Step();
+		}
+		Log = std::move(Recording.Log);
+	}
+	double Recorded = Seconds(Start);
+
+	NMOS6502 Other;
+	Replayer Replay(Other, Log);
+	Start = std::chrono::steady_clock::now();
+	while (Replay.Step()) {
+	}
+	double Replayed = Seconds(Start);
+
+	int Steps = 100;
+	Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Steps; ++i) {
+		Replay.ReverseStep();
+	}
+	double Reverse = Seconds(Start) / Steps;
+
+	BreakpointMap Breakpoints;
+	Breakpoints.Set(0x0082);
+	Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Steps; ++i) {
+		Replay.ReverseContinue(Breakpoints);
+	}
+	double Continue = Seconds(Start) / Steps;
+
+	size_t Bytes = Log.Events.size() * sizeof(ReplayEvent) + Log.Checkpoints.size() * (sizeof(Checkpoint) + 0x10000);
+	std::printf("execute          %.2f ns/instruction\n", 1e9 * Plain / Instructions);
+	std::printf("record           %.2f ns/instruction (%+.1f%%), %zu events, %zu checkpoints, %.1f MB\n", 1e9 * Recorded / Instructions,
+		100.0 * (Recorded - Plain) / Plain, Log.Events.size(), Log.Checkpoints.size(), Bytes / 1048576.0);
+	std::printf("replay           %.2f ns/instruction, %.1fx real time\n", 1e9 * Replayed / Instructions, Plain / Replayed);
+	std::printf("reverse step     %.1f us\n", 1e6 * Reverse);
+	std::printf("reverse continue %.1f us\n", 1e6 * Continue);
+	return 0;
+}
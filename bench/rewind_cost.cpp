@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "../src/6502.h"
+#include "../src/rewind.h"
+
+/*
+	Cost of capturing into a RewindBuffer every N cycles of a loop that writes across a few
+	pages, how many frames fit the budget with their keyframes, and the latency of rebuilding a
+	retained frame and of rewinding the core.
+	Usage: rewind-cost [cycles] [capture every N cycles] [budget bytes] [keyframe every N captures]
+*/
+
+static const u8 Program[] = {
+	0xE8,             // 0200  INX
+	0x8A,             // 0201  TXA
+	0x9D, 0x30, 0x00, // 0202  STA $3000,X
+	0x9D, 0x41, 0x00, // 0205  STA $4100,X
+	0xE6, 0x10,       // 0208  INC $10
+	0x4C, 0x00, 0x02  // 020A  JMP $0200
+};
+
+static double Seconds(std::chrono::steady_clock::time_point Start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+int main(int argc, char** argv) {
+	u64 Cycles = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000000;
+	u64 Every = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000;
+	size_t Budget = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1 << 20;
+	NMOS6502 M6502;
+	M6502.Reset();
+	std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+	M6502.PC = 0x0200;
+	DirtyPageMap Dirty;
+	M6502.DirtyPages = &Dirty;
+	RewindBuffer Buffer(Budget);
+	Buffer.KeyframeEvery = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : Buffer.KeyframeEvery;
+
+	double Capturing = 0;
+	u64 Captures = 0;
+	auto Start = std::chrono::steady_clock::now();
+	for (u64 Spent = 0, Next = 0; Spent < Cycles;) {
+		if (Spent >= Next) {
+			auto Before = std::chrono::steady_clock::now();
+			Buffer.Capture(M6502, Dirty, Spent);
+			Capturing += Seconds(Before);
+			++Captures;
+			Next = Spent + Every;
+		}
+		Spent += M6502.Execute(0);
+	}
+	double Total = Seconds(Start);
+
+	MachineSnapshot State;
+	size_t Frames = Buffer.Frames();
+	int Rounds = 1000;
+	Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Rounds; ++i) {
+		Buffer.Reconstruct(1 + i % (Frames - 1), State);
+	}
+	double Reconstruct = Seconds(Start) / Rounds;
+	Start = std::chrono::steady_clock::now();
+	for (int i = 0; i < Rounds; ++i) {
+		Buffer.Reconstruct(Frames - 1, State);
+	}
+	double Oldest = Seconds(Start) / Rounds;
+	Start = std::chrono::steady_clock::now();
+	Buffer.Rewind(M6502, Dirty, 1);
+	double Rewind = Seconds(Start);
+
+	std::printf("capture          %.2f us each, %.1f%% of the run\n", 1e6 * Capturing / Captures, 100.0 * Capturing / Total);
+	std::printf("retained         %zu of %llu frames in %zu bytes (%.1f KB per frame after the whole state)\n", Frames,
+		static_cast<unsigned long long>(Captures), Buffer.Bytes(), (Buffer.Bytes() - 0x10000) / 1024.0 / Frames);
+	std::printf("reconstruct      %.2f us average, %.2f us for the oldest frame\n", 1e6 * Reconstruct, 1e6 * Oldest);
+	std::printf("rewind one frame %.2f us\n", 1e6 * Rewind);
+	return 0;
+}
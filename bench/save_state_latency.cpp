@@ -0,0 +1,61 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "../src/6502.h"
+#include "../src/save_state.h"
+
+/*
+	Save and restore latency of a full 64 KB machine: building the file in memory, writing it,
+	opening (mapping) it, and restoring it into a core. Files go to the given directory.
+	Usage: save-state-latency [directory] [rounds]
+*/
+
+static double Seconds(std::chrono::steady_clock::time_point Start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+int main(int argc, char** argv) {
+	std::string Path = std::string(argc > 1 ? argv[1] : "/tmp") + "/m6502-save-state-latency.bin";
+	int Rounds = argc > 2 ? std::atoi(argv[2]) : 2000;
+	NMOS6502 M6502;
+	M6502.Reset();
+	for (size_t i = 0; i < M6502.Memory.size(); ++i) {
+		M6502.Memory[i] = static_cast<u8>(i * 13);
+	}
+	std::vector<DeviceChunk> Devices = { { DeviceTag("VIA1"), std::vector<u8>(16, 0xAA) } };
+
+	/* Keep the best of each to filter out scheduling noise */
+	double Build = 1e9, Save = 1e9, Open = 1e9, Restore = 1e9;
+	std::vector<u8> Contents;
+	NMOS6502 Other;
+	for (int Round = 0; Round < Rounds; ++Round) {
+		auto Start = std::chrono::steady_clock::now();
+		SaveState(Contents, M6502, Round, Devices);
+		Build = std::min(Build, Seconds(Start));
+
+		Start = std::chrono::steady_clock::now();
+		if (!SaveState(Path, M6502, Round, Devices)) {
+			std::fprintf(stderr, "cannot write %s\n", Path.c_str());
+			return 1;
+		}
+		Save = std::min(Save, Seconds(Start));
+
+		SaveStateFile File;
+		Start = std::chrono::steady_clock::now();
+		if (!File.Open(Path)) {
+			std::fprintf(stderr, "%s\n", File.Error().c_str());
+			return 1;
+		}
+		Open = std::min(Open, Seconds(Start));
+		Start = std::chrono::steady_clock::now();
+		File.Restore(Other);
+		Restore = std::min(Restore, Seconds(Start));
+	}
+	std::remove(Path.c_str());
+	std::printf("build in memory  %.2f us\n", 1e6 * Build);
+	std::printf("save to file     %.2f us\n", 1e6 * Save);
+	std::printf("open and map     %.2f us\n", 1e6 * Open);
+	std::printf("restore          %.2f us\n", 1e6 * Restore);
+	return Other.Memory == M6502.Memory ? 0 : 1;
+}
@@ -0,0 +1,35 @@
+#include <cstdio>
+#include <cstdlib>
+#include "../src/6502.h"
+#include "../src/watchpoints.h"
+#include "overhead.h"
+
+/*
+	Cost of watchpoints on an instrumented core running a zero page copy loop: with no map
+	attached, with a map whose watches are all on other pages, and with a watch on the page the
+	loop uses but on an address it never touches, which takes the slow path on every access.
+	The plain core has no watchpoint code; compare with the execute line of breakpoint-overhead.
+	Usage: watchpoint-overhead [instructions]
+*/
+
+int main(int argc, char** argv) {
+	u64 Instructions = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000000;
+	NMOS6502 M6502;
+	LoadCopyLoop(M6502);
+	WatchpointMap Elsewhere, SamePage;
+	Elsewhere.Add(0x8000, WatchAccess, 0x100);
+	SamePage.Add(0x00F0, WatchAccess);
+	WatchpointMap* Maps[] = { nullptr, &Elsewhere, &SamePage };
+
+	static constexpr const char* Names[] = { "no map", "other pages watched", "same page watched" };
+	double Best[3];
+	KeepBest(Best, [&](int Which) {
+		M6502.Watchpoints = Maps[Which];
+		return TimeInstructions(M6502, Instructions);
+	});
+	M6502.Watchpoints = nullptr;
+	for (int Which = 0; Which < 3; ++Which) {
+		std::printf("%-24s %.2f ns/instruction (%+.1f%%)\n", Names[Which], 1e9 * Best[Which] / Instructions, 100.0 * (Best[Which] - Best[0]) / Best[0]);
+	}
+	return 0;
+}
@@ -0,0 +1,365 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "../src/perf_counters.h"
+#include "baseline.h"
+#include "workloads.h"
+
+/*
+	Macro benchmarks: whole programs run to completion through NMOS6502::Execute, reporting
+	emulated cycles per host second and, where the kernel allows it, host instructions retired
+	per emulated instruction, with host IPC, branch and cache misses alongside when the PMU is
+	exposed (see perf_counters.h). Every run is checked against a host implementation of the same
+	algorithm so a broken core cannot post a fast time.
+	Usage: 6502-bench-workloads [--repetitions N] [--filter substring] [--json file] [--baseline file]
+
+	With --baseline the results are compared against a committed run (see baseline.h) and the
+	exit code is non-zero on a regression, or 2 when the baseline is from another build type. A workload that looks slower gets up to two more
+	rounds of repetitions before it is reported, so one descheduled sample does not fail the check.
+*/
+
+static constexpr u16 Origin = 0x0200;
+static constexpr u64 InstructionLimit = 500000000;
+static constexpr int BaselineRetries = 2;
+#ifndef M6502_BUILD_TYPE
+#define M6502_BUILD_TYPE ""
+#endif
+
+/* Zero page locations shared with the programs */
+static constexpr u16 CRC = 0x18;
+static constexpr u16 BCD = 0x44;
+
+/* Deterministic xorshift fill so every run and every commit sorts and checksums the same data */
+static void Fill(NMOS6502& M6502, u16 Address, u32 Size, u32 Seed) {
+	for (u32 i = 0; i < Size; ++i) {
+		Seed ^= Seed << 13;
+		Seed ^= Seed >> 17;
+		Seed ^= Seed << 5;
+		M6502.Memory[Address + i] = static_cast<u8>(Seed);
+	}
+}
+
+static void FillData(NMOS6502& M6502) {
+	Fill(M6502, 0x4000, 0x2000, 0x6502);
+}
+
+static bool CheckMemcpy(const NMOS6502& M6502) {
+	return std::equal(M6502.Memory.begin() + 0x4000, M6502.Memory.begin() + 0x6000, M6502.Memory.begin() + 0x6000);
+}
+
+static void NoSetup(NMOS6502&) {}
+
+static bool CheckMemset(const NMOS6502& M6502) {
+	return std::all_of(M6502.Memory.begin() + 0x8000, M6502.Memory.begin() + 0xA000, [](u8 Byte) { return Byte == 0xA5; });
+}
+
+static bool CheckCrc16(const NMOS6502& M6502) {
+	u16 Crc = 0xFFFF;
+	for (u32 Address = 0x4000; Address < 0x5000; ++Address) {
+		Crc ^= M6502.Memory[Address] << 8;
+		for (int Bit = 0; Bit < 8; ++Bit) {
+			Crc = Crc & 0x8000 ? (Crc << 1) ^ 0x1021 : Crc << 1;
+		}
+	}
+	return M6502.Memory[CRC] == (Crc & 0xFF) && M6502.Memory[CRC + 1] == Crc >> 8;
+}
+
+static bool CheckCrc32(const NMOS6502& M6502) {
+	u32 Crc = 0xFFFFFFFF;
+	for (u32 Address = 0x4000; Address < 0x5000; ++Address) {
+		Crc ^= M6502.Memory[Address];
+		for (int Bit = 0; Bit < 8; ++Bit) {
+			Crc = Crc & 1 ? (Crc >> 1) ^ 0xEDB88320 : Crc >> 1;
+		}
+	}
+	Crc = ~Crc;
+	for (int i = 0; i < 4; ++i) {
+		if (M6502.Memory[CRC + i] != static_cast<u8>(Crc >> (8 * i))) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool CheckSorted(const NMOS6502& M6502) {
+	NMOS6502 Original;
+	Original.Memory.assign(0x10000, 0);
+	FillData(Original);
+	std::sort(Original.Memory.begin() + 0x4000, Original.Memory.begin() + 0x40C0);
+	return std::equal(Original.Memory.begin() + 0x4000, Original.Memory.begin() + 0x40C0, M6502.Memory.begin() + 0x4000);
+}
+
+static void SetupMulDiv(NMOS6502& M6502) {
+	Fill(M6502, 0x5000, 0x100, 0x1234);
+	for (u16 i = 0; i < 0x40; ++i) {
+		if (M6502.Memory[0x5080 + i] == 0 && M6502.Memory[0x50C0 + i] == 0) {
+			M6502.Memory[0x5080 + i] = 0x01;
+		}
+	}
+}
+
+static bool CheckMulDiv(const NMOS6502& M6502) {
+	auto Word = [&M6502](u16 Low, u16 High, u16 i) {
+		return static_cast<u32>(M6502.Memory[Low + i] | M6502.Memory[High + i] << 8);
+	};
+	for (u16 i = 0; i < 0x40; ++i) {
+		u32 A = Word(0x5000, 0x5040, i), B = Word(0x5080, 0x50C0, i);
+		u32 Product = A * B;
+		for (int Byte = 0; Byte < 4; ++Byte) {
+			if (M6502.Memory[0x5100 + 0x40 * Byte + i] != static_cast<u8>(Product >> (8 * Byte))) {
+				return false;
+			}
+		}
+		if (Word(0x5200, 0x5240, i) != A / B || Word(0x5280, 0x52C0, i) != A % B) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* The program's 8.8 signed multiply: magnitudes multiplied, the middle 16 bits kept, the sign put back */
+static u16 FixedMultiply(u16 M, u16 N) {
+	bool Negative = (M ^ N) & 0x8000;
+	u32 Product = static_cast<u32>(static_cast<u16>(M & 0x8000 ? -M : M)) * static_cast<u16>(N & 0x8000 ? -N : N);
+	u16 Result = static_cast<u16>(Product >> 8);
+	return Negative ? static_cast<u16>(-Result) : Result;
+}
+
+static bool CheckMandelbrot(const NMOS6502& M6502) {
+	u16 CI = 0xFEC0;
+	for (int Y = 0; Y < 16; ++Y, CI += 0x28) {
+		u16 CR = 0xFE00;
+		for (int X = 0; X < 24; ++X, CR += 0x1B) {
+			u16 ZR = 0, ZI = 0;
+			u8 Iterations = 0;
+			while (true) {
+				u16 ZR2 = FixedMultiply(ZR, ZR), ZI2 = FixedMultiply(ZI, ZI);
+				if (static_cast<u16>(ZR2 + ZI2) >> 8 >= 4) {
+					break;
+				}
+				ZI = static_cast<u16>((FixedMultiply(ZR, ZI) << 1) + CI);
+				ZR = static_cast<u16>(ZR2 - ZI2 + CR);
+				if (++Iterations == 16) {
+					break;
+				}
+			}
+			if (M6502.Memory[0x6000 + Y * 24 + X] != Iterations) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool CheckBcdCounter(const NMOS6502& M6502) {
+	return M6502.Memory[BCD] == 0x99 && M6502.Memory[BCD + 1] == 0x99 && M6502.Memory[BCD + 2] == 0x09;
+}
+
+struct Workload {
+	const char* Name;
+	const u8* Program;
+	size_t Size;
+	u16 Halt;
+	void (*Setup)(NMOS6502&);
+	bool (*Check)(const NMOS6502&);
+};
+
+static const Workload Workloads[] = {
+	{ "memcpy", Memcpy, sizeof(Memcpy), MemcpyHalt, FillData, CheckMemcpy },
+	{ "memset", Memset, sizeof(Memset), MemsetHalt, NoSetup, CheckMemset },
+	{ "crc16", Crc16, sizeof(Crc16), Crc16Halt, FillData, CheckCrc16 },
+	{ "crc32", Crc32, sizeof(Crc32), Crc32Halt, FillData, CheckCrc32 },
+	{ "bubble_sort", BubbleSort, sizeof(BubbleSort), BubbleSortHalt, FillData, CheckSorted },
+	{ "insertion_sort", InsertionSort, sizeof(InsertionSort), InsertionSortHalt, FillData, CheckSorted },
+	{ "muldiv16", MulDiv, sizeof(MulDiv), MulDivHalt, SetupMulDiv, CheckMulDiv },
+	{ "mandelbrot", Mandelbrot, sizeof(Mandelbrot), MandelbrotHalt, NoSetup, CheckMandelbrot },
+	{ "bcd_counter", BcdCounter, sizeof(BcdCounter), BcdCounterHalt, NoSetup, CheckBcdCounter },
+};
+
+struct Result {
+	u64 Instructions = 0;
+	u64 Cycles = 0;
+	PerfCounters::Sample Host; // From the last repetition
+	std::vector<double> Seconds;
+	bool Valid = true;
+};
+
+static bool RunOnce(const Workload& Job, PerfCounters& Counter, Result& Out, double& Seconds) {
+	NMOS6502 M6502;
+	M6502.Reset();
+	M6502.ProcessorStatus.reset();
+	M6502.SP = 0x01FF;
+	M6502.PC = Origin;
+	std::copy(Job.Program, Job.Program + Job.Size, M6502.Memory.begin() + Origin);
+	Job.Setup(M6502);
+
+	u64 Instructions = 0, Cycles = 0;
+	Counter.Start();
+	auto Start = std::chrono::steady_clock::now();
+	while (M6502.PC != Job.Halt && Instructions < InstructionLimit) {
+		Cycles += M6502.Execute(0);
+		++Instructions;
+	}
+	Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	Out.Host = Counter.Stop();
+	Out.Instructions = Instructions;
+	Out.Cycles = Cycles;
+	return M6502.PC == Job.Halt && Job.Check(M6502);
+}
+
+static double Median(std::vector<double> Values) {
+	std::sort(Values.begin(), Values.end());
+	size_t Middle = Values.size() / 2;
+	return Values.size() % 2 ? Values[Middle] : (Values[Middle - 1] + Values[Middle]) / 2;
+}
+
+static void WriteJSON(std::ostream& Out, const std::vector<const Workload*>& Jobs, const std::vector<Result>& Results) {
+	char Line[160];
+	Out << "{\n  \"build_type\": \"" << M6502_BUILD_TYPE << "\",\n  \"workloads\": [\n";
+	for (size_t i = 0; i < Jobs.size(); ++i) {
+		const Result& Run = Results[i];
+		double Best = *std::min_element(Run.Seconds.begin(), Run.Seconds.end());
+		Out << "    {\"name\": \"" << Jobs[i]->Name << "\"";
+		std::snprintf(Line, sizeof(Line), ", \"instructions\": %llu, \"cycles\": %llu", static_cast<unsigned long long>(Run.Instructions),
+			static_cast<unsigned long long>(Run.Cycles));
+		Out << Line;
+		std::snprintf(Line, sizeof(Line), ", \"seconds\": %.9f, \"median_seconds\": %.9f, \"emulated_mhz\": %.3f", Best, Median(Run.Seconds),
+			Run.Cycles / Best / 1e6);
+		Out << Line << ", \"samples\": [";
+		for (size_t Sample = 0; Sample < Run.Seconds.size(); ++Sample) {
+			std::snprintf(Line, sizeof(Line), "%s%.9f", Sample ? ", " : "", Run.Seconds[Sample]);
+			Out << Line;
+		}
+		Out << "]";
+		static constexpr const char* PerInstruction[] = { "host_instructions_per_instruction", nullptr, "branch_misses_per_instruction",
+			"cache_misses_per_instruction", "host_ns_per_instruction" };
+		for (int Which = 0; Which < PerfCounters::EventCount; ++Which) {
+			if (!PerInstruction[Which]) {
+				continue;
+			}
+			Out << ", \"" << PerInstruction[Which] << "\": ";
+			if (Run.Host.Valid[Which]) {
+				std::snprintf(Line, sizeof(Line), "%.4f", static_cast<double>(Run.Host.Values[Which]) / Run.Instructions);
+				Out << Line;
+			}
+			else {
+				Out << "null";
+			}
+		}
+		double IPC = Run.Host.InstructionsPerCycle();
+		if (IPC < 0) {
+			Out << ", \"host_ipc\": null";
+		}
+		else {
+			std::snprintf(Line, sizeof(Line), ", \"host_ipc\": %.3f", IPC);
+			Out << Line;
+		}
+		Out << ", \"valid\": " << (Run.Valid ? "true" : "false") << "}" << (i + 1 < Jobs.size() ? "," : "") << "\n";
+	}
+	Out << "  ]\n}\n";
+}
+
+static void Measure(const Workload& Job, PerfCounters& Counter, int Repetitions, Result& Run) {
+	for (int Repetition = 0; Repetition < Repetitions; ++Repetition) {
+		double Seconds;
+		Run.Valid &= RunOnce(Job, Counter, Run, Seconds);
+		Run.Seconds.push_back(Seconds);
+	}
+}
+
+static BaselineMeasurement Summarise(const Workload& Job, const Result& Run) {
+	double Best = *std::min_element(Run.Seconds.begin(), Run.Seconds.end());
+	return { Job.Name, Run.Instructions, Run.Cycles, Run.Cycles / Best / 1e6, Median(Run.Seconds) / Best - 1 };
+}
+
+int main(int argc, char** argv) {
+	int Repetitions = 5;
+	const char* Filter = "";
+	const char* JSONPath = nullptr;
+	const char* BaselinePath = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--repetitions") == 0 && i + 1 < argc) {
+			Repetitions = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			Filter = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			JSONPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+			BaselinePath = argv[++i];
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--repetitions N] [--filter substring] [--json file] [--baseline file]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::vector<BaselineEntry> Baseline;
+	if (BaselinePath) {
+		std::ifstream In(BaselinePath);
+		std::string BuildType, Error = "could not open the file";
+		if (!In || !LoadBaseline(In, Baseline, BuildType, Error)) {
+			std::fprintf(stderr, "%s: %s\n", BaselinePath, Error.c_str());
+			return 2;
+		}
+		if (BuildType != M6502_BUILD_TYPE) {
+			std::fprintf(stderr, "%s: measured on a \"%s\" build, this is a \"%s\" build; speeds do not compare\n", BaselinePath, BuildType.c_str(), M6502_BUILD_TYPE);
+			return 2;
+		}
+	}
+
+	PerfCounters Counter;
+	std::vector<const Workload*> Jobs;
+	std::vector<Result> Results;
+	std::vector<BaselineMeasurement> Measured;
+	bool AllValid = true;
+	std::printf("%-16s %12s %12s %10s %10s %12s %8s\n", "workload", "instructions", "cycles", "best ms", "MHz", "host/instr", "IPC");
+	for (const Workload& Job : Workloads) {
+		if (!std::strstr(Job.Name, Filter)) {
+			continue;
+		}
+		Result Run;
+		Measure(Job, Counter, Repetitions, Run);
+		const BaselineEntry* Expected = FindBaseline(Baseline, Job.Name);
+		for (int Retry = 0; Expected && Retry < BaselineRetries && !WithinBaseline(*Expected, Summarise(Job, Run)); ++Retry) {
+			Measure(Job, Counter, Repetitions, Run);
+		}
+		double Best = *std::min_element(Run.Seconds.begin(), Run.Seconds.end());
+		char HostPerInstruction[16] = "n/a", IPC[16] = "n/a";
+		if (Run.Host.Valid[PerfCounters::Instructions]) {
+			std::snprintf(HostPerInstruction, sizeof(HostPerInstruction), "%.2f", static_cast<double>(Run.Host.Values[PerfCounters::Instructions]) / Run.Instructions);
+		}
+		if (Run.Host.InstructionsPerCycle() >= 0) {
+			std::snprintf(IPC, sizeof(IPC), "%.2f", Run.Host.InstructionsPerCycle());
+		}
+		std::printf("%-16s %12llu %12llu %10.3f %10.2f %12s %8s%s\n", Job.Name, static_cast<unsigned long long>(Run.Instructions),
+			static_cast<unsigned long long>(Run.Cycles), Best * 1e3, Run.Cycles / Best / 1e6, HostPerInstruction, IPC, Run.Valid ? "" : "  INVALID");
+		AllValid &= Run.Valid;
+		Jobs.push_back(&Job);
+		Measured.push_back(Summarise(Job, Run));
+		Results.push_back(std::move(Run));
+	}
+
+	if (JSONPath) {
+		std::ofstream Out(JSONPath);
+		WriteJSON(Out, Jobs, Results);
+		if (!Out) {
+			std::fprintf(stderr, "could not write %s\n", JSONPath);
+			return 2;
+		}
+	}
+	bool Passed = true;
+	if (BaselinePath) {
+		std::printf("\ncompared with %s\n", BaselinePath);
+		std::fflush(stdout);
+		Passed = ReportBaseline(std::cout, Baseline, Measured);
+	}
+	return AllValid && Passed ? 0 : 1;
+}
@@ -0,0 +1,1072 @@
+#pragma once
+#include "../src/6502.h"
+
+/*
+	Self-contained 6502 programs for the macro benchmarks, loaded at $0200. Each one ends in a
+	JMP to itself at its Halt address. They are written for this core's dialect: absolute
+	data operands are stored high byte first, JSR is followed by a BIT abs opcode so the return
+	to opcode + 1 skips the target, branches are relative to the opcode and padded with empty
+	opcodes so the offset byte is harmless when the branch falls through, and multi-byte shifts
+	and adds carry by hand because ROL/ROR and ADC do not.
+*/
+
+static const u8 Memcpy[] = {
+	0xA9, 0x00,               // 0200  LDA #$00
+	0x85, 0x10,               // 0202  STA SRC
+	0x85, 0x12,               // 0204  STA DST
+	0xA9, 0x40,               // 0206  LDA #$40
+	0x85, 0x11,               // 0208  STA SRC+1
+	0xA9, 0x60,               // 020A  LDA #$60
+	0x85, 0x13,               // 020C  STA DST+1
+	0xA2, 0x20,               // 020E  LDX #$20
+	0xA0, 0x00,               // 0210  LDY #$00
+	// copy:
+	0xB1, 0x10,               // 0212  LDA (SRC),Y
+	0x91, 0x12,               // 0214  STA (DST),Y
+	0xC8,                     // 0216  INY
+	0xC0, 0x00,               // 0217  CPY #$00
+	0x02, 0x02,               // 0219  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xF7,               // 021B  BNE copy
+	0xE6, 0x11,               // 021D  INC SRC+1
+	0xE6, 0x13,               // 021F  INC DST+1
+	0xCA,                     // 0221  DEX
+	0xE0, 0x00,               // 0222  CPX #$00
+	0x02, 0x02, 0x02,         // 0224  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xEB,               // 0227  BNE copy
+	// done:
+	0x4C, 0x29, 0x02,         // 0229  JMP done
+};
+static constexpr u16 MemcpyHalt = 0x0229;
+
+static const u8 Memset[] = {
+	0xA9, 0x00,               // 0200  LDA #$00
+	0x85, 0x12,               // 0202  STA DST
+	0xA9, 0x80,               // 0204  LDA #$80
+	0x85, 0x13,               // 0206  STA DST+1
+	0xA2, 0x20,               // 0208  LDX #$20
+	0xA0, 0x00,               // 020A  LDY #$00
+	0xA9, 0xA5,               // 020C  LDA #$A5
+	// fill:
+	0x91, 0x12,               // 020E  STA (DST),Y
+	0xC8,                     // 0210  INY
+	0xC0, 0x00,               // 0211  CPY #$00
+	0xD0, 0xFB,               // 0213  BNE fill
+	0xE6, 0x13,               // 0215  INC DST+1
+	0xCA,                     // 0217  DEX
+	0xE0, 0x00,               // 0218  CPX #$00
+	0xD0, 0xF4,               // 021A  BNE fill
+	// done:
+	0x4C, 0x1C, 0x02,         // 021C  JMP done
+};
+static constexpr u16 MemsetHalt = 0x021C;
+
+static const u8 Crc16[] = {
+	0xA9, 0xFF,               // 0200  LDA #$FF
+	0x85, 0x18,               // 0202  STA CRC
+	0x85, 0x19,               // 0204  STA CRC+1
+	0xA9, 0x00,               // 0206  LDA #$00
+	0x85, 0x10,               // 0208  STA SRC
+	0xA9, 0x40,               // 020A  LDA #$40
+	0x85, 0x11,               // 020C  STA SRC+1
+	0xA9, 0x10,               // 020E  LDA #$10
+	0x85, 0x1C,               // 0210  STA PAGES
+	0xA0, 0x00,               // 0212  LDY #$00
+	// byte:
+	0xB1, 0x10,               // 0214  LDA (SRC),Y
+	0x45, 0x19,               // 0216  EOR CRC+1
+	0x85, 0x19,               // 0218  STA CRC+1
+	0xA2, 0x08,               // 021A  LDX #$08
+	// bit:
+	0x06, 0x18,               // 021C  ASL CRC
+	0xA5, 0x19,               // 021E  LDA CRC+1
+	0x65, 0x19,               // 0220  ADC CRC+1
+	0x85, 0x14,               // 0222  STA TMP
+	0xA5, 0x19,               // 0224  LDA CRC+1
+	0xC9, 0x80,               // 0226  CMP #$80
+	0xA5, 0x14,               // 0228  LDA TMP
+	0x85, 0x19,               // 022A  STA CRC+1
+	0x90, 0x0F,               // 022C  BCC nopoly
+	0x02,                     // 022E  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x19,               // 022F  LDA CRC+1
+	0x49, 0x10,               // 0231  EOR #$10
+	0x85, 0x19,               // 0233  STA CRC+1
+	0xA5, 0x18,               // 0235  LDA CRC
+	0x49, 0x21,               // 0237  EOR #$21
+	0x85, 0x18,               // 0239  STA CRC
+	// nopoly:
+	0xCA,                     // 023B  DEX
+	0xE0, 0x00,               // 023C  CPX #$00
+	0x02, 0x02,               // 023E  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xDC,               // 0240  BNE bit
+	0xC8,                     // 0242  INY
+	0xC0, 0x00,               // 0243  CPY #$00
+	0xD0, 0xCF,               // 0245  BNE byte
+	0xE6, 0x11,               // 0247  INC SRC+1
+	0xC6, 0x1C,               // 0249  DEC PAGES
+	0xA5, 0x1C,               // 024B  LDA PAGES
+	0xD0, 0xC7,               // 024D  BNE byte
+	// done:
+	0x4C, 0x4F, 0x02,         // 024F  JMP done
+};
+static constexpr u16 Crc16Halt = 0x024F;
+
+static const u8 Crc32[] = {
+	0xA9, 0xFF,               // 0200  LDA #$FF
+	0x85, 0x18,               // 0202  STA CRC
+	0x85, 0x19,               // 0204  STA CRC+1
+	0x85, 0x1A,               // 0206  STA CRC+2
+	0x85, 0x1B,               // 0208  STA CRC+3
+	0xA9, 0x00,               // 020A  LDA #$00
+	0x85, 0x10,               // 020C  STA SRC
+	0xA9, 0x40,               // 020E  LDA #$40
+	0x85, 0x11,               // 0210  STA SRC+1
+	0xA9, 0x10,               // 0212  LDA #$10
+	0x85, 0x1C,               // 0214  STA PAGES
+	0xA0, 0x00,               // 0216  LDY #$00
+	// byte:
+	0xB1, 0x10,               // 0218  LDA (SRC),Y
+	0x45, 0x18,               // 021A  EOR CRC
+	0x85, 0x18,               // 021C  STA CRC
+	0xA2, 0x08,               // 021E  LDX #$08
+	// bit:
+	0x46, 0x1B,               // 0220  LSR CRC+3
+	0xA9, 0x7F,               // 0222  LDA #$7F
+	0x69, 0x00,               // 0224  ADC #$00
+	0x29, 0x80,               // 0226  AND #$80
+	0x85, 0x14,               // 0228  STA TMP
+	0x46, 0x1A,               // 022A  LSR CRC+2
+	0xA5, 0x1A,               // 022C  LDA CRC+2
+	0x05, 0x14,               // 022E  ORA TMP
+	0x85, 0x1A,               // 0230  STA CRC+2
+	0xA9, 0x7F,               // 0232  LDA #$7F
+	0x69, 0x00,               // 0234  ADC #$00
+	0x29, 0x80,               // 0236  AND #$80
+	0x85, 0x14,               // 0238  STA TMP
+	0x46, 0x19,               // 023A  LSR CRC+1
+	0xA5, 0x19,               // 023C  LDA CRC+1
+	0x05, 0x14,               // 023E  ORA TMP
+	0x85, 0x19,               // 0240  STA CRC+1
+	0xA9, 0x7F,               // 0242  LDA #$7F
+	0x69, 0x00,               // 0244  ADC #$00
+	0x29, 0x80,               // 0246  AND #$80
+	0x85, 0x14,               // 0248  STA TMP
+	0x46, 0x18,               // 024A  LSR CRC
+	0xA5, 0x18,               // 024C  LDA CRC
+	0x05, 0x14,               // 024E  ORA TMP
+	0x85, 0x18,               // 0250  STA CRC
+	0x90, 0x1A,               // 0252  BCC nopoly
+	0xA5, 0x1B,               // 0254  LDA CRC+3
+	0x49, 0xED,               // 0256  EOR #$ED
+	0x85, 0x1B,               // 0258  STA CRC+3
+	0xA5, 0x1A,               // 025A  LDA CRC+2
+	0x49, 0xB8,               // 025C  EOR #$B8
+	0x85, 0x1A,               // 025E  STA CRC+2
+	0xA5, 0x19,               // 0260  LDA CRC+1
+	0x49, 0x83,               // 0262  EOR #$83
+	0x85, 0x19,               // 0264  STA CRC+1
+	0xA5, 0x18,               // 0266  LDA CRC
+	0x49, 0x20,               // 0268  EOR #$20
+	0x85, 0x18,               // 026A  STA CRC
+	// nopoly:
+	0xCA,                     // 026C  DEX
+	0xE0, 0x00,               // 026D  CPX #$00
+	0x02, 0x02,               // 026F  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xAF,               // 0271  BNE bit
+	0xC8,                     // 0273  INY
+	0xC0, 0x00,               // 0274  CPY #$00
+	0x02, 0x02, 0x02,         // 0276  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0x9F,               // 0279  BNE byte
+	0xE6, 0x11,               // 027B  INC SRC+1
+	0xC6, 0x1C,               // 027D  DEC PAGES
+	0xA5, 0x1C,               // 027F  LDA PAGES
+	0xD0, 0x97,               // 0281  BNE byte
+	0xA5, 0x18,               // 0283  LDA CRC
+	0x49, 0xFF,               // 0285  EOR #$FF
+	0x85, 0x18,               // 0287  STA CRC
+	0xA5, 0x19,               // 0289  LDA CRC+1
+	0x49, 0xFF,               // 028B  EOR #$FF
+	0x85, 0x19,               // 028D  STA CRC+1
+	0xA5, 0x1A,               // 028F  LDA CRC+2
+	0x49, 0xFF,               // 0291  EOR #$FF
+	0x85, 0x1A,               // 0293  STA CRC+2
+	0xA5, 0x1B,               // 0295  LDA CRC+3
+	0x49, 0xFF,               // 0297  EOR #$FF
+	0x85, 0x1B,               // 0299  STA CRC+3
+	// done:
+	0x4C, 0x9B, 0x02,         // 029B  JMP done
+};
+static constexpr u16 Crc32Halt = 0x029B;
+
+static const u8 BubbleSort[] = {
+	// sweep:
+	0xA9, 0x00,               // 0200  LDA #$00
+	0x85, 0x1E,               // 0202  STA SWAP
+	0xA2, 0x00,               // 0204  LDX #$00
+	// compare:
+	0xBD, 0x40, 0x00,         // 0206  LDA $4000,X
+	0xDD, 0x40, 0x01,         // 0209  CMP $4001,X
+	0x90, 0x14,               // 020C  BCC ordered
+	0xF0, 0x12,               // 020E  BEQ ordered
+	0x02, 0x02,               // 0210  (padding, offset of the branch above must be an empty opcode)
+	0xBC, 0x40, 0x01,         // 0212  LDY $4001,X
+	0x9D, 0x40, 0x01,         // 0215  STA $4001,X
+	0x98,                     // 0218  TYA
+	0x9D, 0x40, 0x00,         // 0219  STA $4000,X
+	0xA9, 0x01,               // 021C  LDA #$01
+	0x85, 0x1E,               // 021E  STA SWAP
+	// ordered:
+	0xE8,                     // 0220  INX
+	0xE0, 0xBF,               // 0221  CPX #$BF
+	0xD0, 0xE3,               // 0223  BNE compare
+	0xA5, 0x1E,               // 0225  LDA SWAP
+	0x02, 0x02,               // 0227  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xD7,               // 0229  BNE sweep
+	// done:
+	0x4C, 0x2B, 0x02,         // 022B  JMP done
+};
+static constexpr u16 BubbleSortHalt = 0x022B;
+
+static const u8 InsertionSort[] = {
+	0xA0, 0x01,               // 0200  LDY #$01
+	// outer:
+	0xB9, 0x40, 0x00,         // 0202  LDA $4000,Y
+	0x85, 0x1F,               // 0205  STA KEY
+	0x84, 0x1D,               // 0207  STY IDX
+	0x98,                     // 0209  TYA
+	0xAA,                     // 020A  TAX
+	// inner:
+	0xE0, 0x00,               // 020B  CPX #$00
+	0xF0, 0x1A,               // 020D  BEQ place
+	0x02, 0x02, 0x02, 0x02,   // 020F  (padding, offset of the branch above must be an empty opcode)
+	0xBD, 0x3F, 0xFF,         // 0213  LDA $3FFF,X
+	0xC5, 0x1F,               // 0216  CMP KEY
+	0x90, 0x0F,               // 0218  BCC place
+	0x02, 0x02,               // 021A  (padding, offset of the branch above must be an empty opcode)
+	0xF0, 0x0B,               // 021C  BEQ place
+	0x02, 0x02,               // 021E  (padding, offset of the branch above must be an empty opcode)
+	0x9D, 0x40, 0x00,         // 0220  STA $4000,X
+	0xCA,                     // 0223  DEX
+	0x4C, 0x0B, 0x02,         // 0224  JMP inner
+	// place:
+	0xA5, 0x1F,               // 0227  LDA KEY
+	0x9D, 0x40, 0x00,         // 0229  STA $4000,X
+	0xA4, 0x1D,               // 022C  LDY IDX
+	0xC8,                     // 022E  INY
+	0xC0, 0xC0,               // 022F  CPY #$C0
+	0x02, 0x02,               // 0231  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xCF,               // 0233  BNE outer
+	// done:
+	0x4C, 0x35, 0x02,         // 0235  JMP done
+};
+static constexpr u16 InsertionSortHalt = 0x0235;
+
+static const u8 MulDiv[] = {
+	0xA9, 0x00,               // 0200  LDA #$00
+	0x85, 0x1D,               // 0202  STA IDX
+	// next:
+	0xA4, 0x1D,               // 0204  LDY IDX
+	0xB9, 0x50, 0x00,         // 0206  LDA $5000,Y
+	0x85, 0x20,               // 0209  STA M0
+	0x85, 0x28,               // 020B  STA Q0
+	0xB9, 0x50, 0x40,         // 020D  LDA $5040,Y
+	0x85, 0x21,               // 0210  STA M1
+	0x85, 0x29,               // 0212  STA Q1
+	0xB9, 0x50, 0x80,         // 0214  LDA $5080,Y
+	0x85, 0x22,               // 0217  STA N0
+	0x85, 0x2A,               // 0219  STA D0
+	0xB9, 0x50, 0xC0,         // 021B  LDA $50C0,Y
+	0x85, 0x23,               // 021E  STA N1
+	0x85, 0x2B,               // 0220  STA D1
+	0x20, 0x2C, 0x62, 0x02,   // 0222  JSR mul16
+	0xA4, 0x1D,               // 0226  LDY IDX
+	0xA5, 0x24,               // 0228  LDA P0
+	0x99, 0x51, 0x00,         // 022A  STA $5100,Y
+	0xA5, 0x25,               // 022D  LDA P1
+	0x99, 0x51, 0x40,         // 022F  STA $5140,Y
+	0xA5, 0x26,               // 0232  LDA P2
+	0x99, 0x51, 0x80,         // 0234  STA $5180,Y
+	0xA5, 0x27,               // 0237  LDA P3
+	0x99, 0x51, 0xC0,         // 0239  STA $51C0,Y
+	0x20, 0x2C, 0x41, 0x03,   // 023C  JSR div16
+	0xA4, 0x1D,               // 0240  LDY IDX
+	0xA5, 0x28,               // 0242  LDA Q0
+	0x99, 0x52, 0x00,         // 0244  STA $5200,Y
+	0xA5, 0x29,               // 0247  LDA Q1
+	0x99, 0x52, 0x40,         // 0249  STA $5240,Y
+	0xA5, 0x2C,               // 024C  LDA R0
+	0x99, 0x52, 0x80,         // 024E  STA $5280,Y
+	0xA5, 0x2D,               // 0251  LDA R1
+	0x99, 0x52, 0xC0,         // 0253  STA $52C0,Y
+	0xE6, 0x1D,               // 0256  INC IDX
+	0xA5, 0x1D,               // 0258  LDA IDX
+	0xC9, 0x40,               // 025A  CMP #$40
+	0x02,                     // 025C  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xA7,               // 025D  BNE next
+	0x4C, 0xFE, 0x03,         // 025F  JMP done
+	// P0-P3 = M0-M1 * N0-N1, shifting the multiplier out from the top
+	// mul16:
+	0xA9, 0x00,               // 0262  LDA #$00
+	0x85, 0x24,               // 0264  STA P0
+	0x85, 0x25,               // 0266  STA P1
+	0x85, 0x26,               // 0268  STA P2
+	0x85, 0x27,               // 026A  STA P3
+	0xA2, 0x10,               // 026C  LDX #$10
+	// mulbit:
+	0x06, 0x24,               // 026E  ASL P0
+	0xA5, 0x25,               // 0270  LDA P1
+	0x65, 0x25,               // 0272  ADC P1
+	0x85, 0x14,               // 0274  STA TMP
+	0xA5, 0x25,               // 0276  LDA P1
+	0xC9, 0x80,               // 0278  CMP #$80
+	0xA5, 0x14,               // 027A  LDA TMP
+	0x85, 0x25,               // 027C  STA P1
+	0xA5, 0x26,               // 027E  LDA P2
+	0x65, 0x26,               // 0280  ADC P2
+	0x85, 0x14,               // 0282  STA TMP
+	0xA5, 0x26,               // 0284  LDA P2
+	0xC9, 0x80,               // 0286  CMP #$80
+	0xA5, 0x14,               // 0288  LDA TMP
+	0x85, 0x26,               // 028A  STA P2
+	0xA5, 0x27,               // 028C  LDA P3
+	0x65, 0x27,               // 028E  ADC P3
+	0x85, 0x14,               // 0290  STA TMP
+	0xA5, 0x27,               // 0292  LDA P3
+	0xC9, 0x80,               // 0294  CMP #$80
+	0xA5, 0x14,               // 0296  LDA TMP
+	0x85, 0x27,               // 0298  STA P3
+	0x06, 0x22,               // 029A  ASL N0
+	0xA5, 0x23,               // 029C  LDA N1
+	0x65, 0x23,               // 029E  ADC N1
+	0x85, 0x14,               // 02A0  STA TMP
+	0xA5, 0x23,               // 02A2  LDA N1
+	0xC9, 0x80,               // 02A4  CMP #$80
+	0xA5, 0x14,               // 02A6  LDA TMP
+	0x85, 0x23,               // 02A8  STA N1
+	0xB0, 0x07,               // 02AA  BCS muladd
+	0x02, 0x02,               // 02AC  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x36, 0x03,         // 02AE  JMP mulnext
+	// muladd:
+	0x18,                     // 02B1  CLC
+	0xB0, 0x17,               // 02B2  BCS cin_1
+	0x02, 0x02,               // 02B4  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x24,               // 02B6  LDA P0
+	0x65, 0x20,               // 02B8  ADC M0
+	0x85, 0x24,               // 02BA  STA P0
+	0xC5, 0x20,               // 02BC  CMP M0
+	0xA9, 0x00,               // 02BE  LDA #$00
+	0x69, 0x00,               // 02C0  ADC #$00
+	0x49, 0x01,               // 02C2  EOR #$01
+	0xC9, 0x01,               // 02C4  CMP #$01
+	0x4C, 0xD3, 0x02,         // 02C6  JMP add_2
+	0xA5, 0x24,               // 02C9  LDA P0
+	0x65, 0x20,               // 02CB  ADC M0
+	0x85, 0x24,               // 02CD  STA P0
+	0xA5, 0x20,               // 02CF  LDA M0
+	0xC5, 0x24,               // 02D1  CMP P0
+	0xB0, 0x17,               // 02D3  BCS cin_3
+	0x02, 0x02,               // 02D5  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x25,               // 02D7  LDA P1
+	0x65, 0x21,               // 02D9  ADC M1
+	0x85, 0x25,               // 02DB  STA P1
+	0xC5, 0x21,               // 02DD  CMP M1
+	0xA9, 0x00,               // 02DF  LDA #$00
+	0x69, 0x00,               // 02E1  ADC #$00
+	0x49, 0x01,               // 02E3  EOR #$01
+	0xC9, 0x01,               // 02E5  CMP #$01
+	0x4C, 0xF4, 0x02,         // 02E7  JMP add_4
+	0xA5, 0x25,               // 02EA  LDA P1
+	0x65, 0x21,               // 02EC  ADC M1
+	0x85, 0x25,               // 02EE  STA P1
+	0xA5, 0x21,               // 02F0  LDA M1
+	0xC5, 0x25,               // 02F2  CMP P1
+	0xB0, 0x17,               // 02F4  BCS cin_5
+	0x02, 0x02,               // 02F6  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x26,               // 02F8  LDA P2
+	0x69, 0x00,               // 02FA  ADC #$00
+	0x85, 0x26,               // 02FC  STA P2
+	0xC9, 0x00,               // 02FE  CMP #$00
+	0xA9, 0x00,               // 0300  LDA #$00
+	0x69, 0x00,               // 0302  ADC #$00
+	0x49, 0x01,               // 0304  EOR #$01
+	0xC9, 0x01,               // 0306  CMP #$01
+	0x4C, 0x15, 0x03,         // 0308  JMP add_6
+	0xA5, 0x26,               // 030B  LDA P2
+	0x69, 0x00,               // 030D  ADC #$00
+	0x85, 0x26,               // 030F  STA P2
+	0xA9, 0x00,               // 0311  LDA #$00
+	0xC5, 0x26,               // 0313  CMP P2
+	0xB0, 0x17,               // 0315  BCS cin_7
+	0x02, 0x02,               // 0317  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x27,               // 0319  LDA P3
+	0x69, 0x00,               // 031B  ADC #$00
+	0x85, 0x27,               // 031D  STA P3
+	0xC9, 0x00,               // 031F  CMP #$00
+	0xA9, 0x00,               // 0321  LDA #$00
+	0x69, 0x00,               // 0323  ADC #$00
+	0x49, 0x01,               // 0325  EOR #$01
+	0xC9, 0x01,               // 0327  CMP #$01
+	0x4C, 0x36, 0x03,         // 0329  JMP add_8
+	0xA5, 0x27,               // 032C  LDA P3
+	0x69, 0x00,               // 032E  ADC #$00
+	0x85, 0x27,               // 0330  STA P3
+	0xA9, 0x00,               // 0332  LDA #$00
+	0xC5, 0x27,               // 0334  CMP P3
+	// mulnext:
+	0xCA,                     // 0336  DEX
+	0xE0, 0x00,               // 0337  CPX #$00
+	0xF0, 0x07,               // 0339  BEQ muldone
+	0x02, 0x02,               // 033B  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x6E, 0x02,         // 033D  JMP mulbit
+	// muldone:
+	0x60,                     // 0340  RTS
+	// Q0-Q1 = Q0-Q1 / D0-D1, remainder in R0-R1 (restoring division)
+	// div16:
+	0xA9, 0x00,               // 0341  LDA #$00
+	0x85, 0x2C,               // 0343  STA R0
+	0x85, 0x2D,               // 0345  STA R1
+	0xA2, 0x10,               // 0347  LDX #$10
+	// divbit:
+	0x06, 0x28,               // 0349  ASL Q0
+	0xA5, 0x29,               // 034B  LDA Q1
+	0x65, 0x29,               // 034D  ADC Q1
+	0x85, 0x14,               // 034F  STA TMP
+	0xA5, 0x29,               // 0351  LDA Q1
+	0xC9, 0x80,               // 0353  CMP #$80
+	0xA5, 0x14,               // 0355  LDA TMP
+	0x85, 0x29,               // 0357  STA Q1
+	0xA5, 0x2C,               // 0359  LDA R0
+	0x65, 0x2C,               // 035B  ADC R0
+	0x85, 0x14,               // 035D  STA TMP
+	0xA5, 0x2C,               // 035F  LDA R0
+	0xC9, 0x80,               // 0361  CMP #$80
+	0xA5, 0x14,               // 0363  LDA TMP
+	0x85, 0x2C,               // 0365  STA R0
+	0xA5, 0x2D,               // 0367  LDA R1
+	0x65, 0x2D,               // 0369  ADC R1
+	0x85, 0x14,               // 036B  STA TMP
+	0xA5, 0x2D,               // 036D  LDA R1
+	0xC9, 0x80,               // 036F  CMP #$80
+	0xA5, 0x14,               // 0371  LDA TMP
+	0x85, 0x2D,               // 0373  STA R1
+	0x90, 0x07,               // 0375  BCC divcompare
+	0x02, 0x02,               // 0377  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x8E, 0x03,         // 0379  JMP divsub
+	// divcompare:
+	0xA5, 0x2D,               // 037C  LDA R1
+	0xC5, 0x2B,               // 037E  CMP D1
+	0xD0, 0x07,               // 0380  BNE divdecided
+	0x02,                     // 0382  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x2C,               // 0383  LDA R0
+	0xC5, 0x2A,               // 0385  CMP D0
+	// divdecided:
+	0xB0, 0x07,               // 0387  BCS divsub
+	0x02, 0x02,               // 0389  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0xF3, 0x03,         // 038B  JMP divnext
+	// divsub:
+	0x18,                     // 038E  CLC
+	0xB0, 0x1C,               // 038F  BCS bin_9
+	0xA5, 0x2C,               // 0391  LDA R0
+	0xC5, 0x2A,               // 0393  CMP D0
+	0xA9, 0x00,               // 0395  LDA #$00
+	0x69, 0x00,               // 0397  ADC #$00
+	0x85, 0x14,               // 0399  STA TMP
+	0xA5, 0x2C,               // 039B  LDA R0
+	0x18,                     // 039D  CLC
+	0xE5, 0x2A,               // 039E  SBC D0
+	0x85, 0x2C,               // 03A0  STA R0
+	0xA5, 0x14,               // 03A2  LDA TMP
+	0x49, 0x01,               // 03A4  EOR #$01
+	0xC9, 0x01,               // 03A6  CMP #$01
+	0x4C, 0xC0, 0x03,         // 03A8  JMP sub_10
+	0xA5, 0x2A,               // 03AB  LDA D0
+	0xC5, 0x2C,               // 03AD  CMP R0
+	0xA9, 0x00,               // 03AF  LDA #$00
+	0x69, 0x00,               // 03B1  ADC #$00
+	0x85, 0x14,               // 03B3  STA TMP
+	0xA5, 0x2C,               // 03B5  LDA R0
+	0x38,                     // 03B7  SEC
+	0xE5, 0x2A,               // 03B8  SBC D0
+	0x85, 0x2C,               // 03BA  STA R0
+	0xA5, 0x14,               // 03BC  LDA TMP
+	0xC9, 0x01,               // 03BE  CMP #$01
+	0xB0, 0x1C,               // 03C0  BCS bin_11
+	0xA5, 0x2D,               // 03C2  LDA R1
+	0xC5, 0x2B,               // 03C4  CMP D1
+	0xA9, 0x00,               // 03C6  LDA #$00
+	0x69, 0x00,               // 03C8  ADC #$00
+	0x85, 0x14,               // 03CA  STA TMP
+	0xA5, 0x2D,               // 03CC  LDA R1
+	0x18,                     // 03CE  CLC
+	0xE5, 0x2B,               // 03CF  SBC D1
+	0x85, 0x2D,               // 03D1  STA R1
+	0xA5, 0x14,               // 03D3  LDA TMP
+	0x49, 0x01,               // 03D5  EOR #$01
+	0xC9, 0x01,               // 03D7  CMP #$01
+	0x4C, 0xF1, 0x03,         // 03D9  JMP sub_12
+	0xA5, 0x2B,               // 03DC  LDA D1
+	0xC5, 0x2D,               // 03DE  CMP R1
+	0xA9, 0x00,               // 03E0  LDA #$00
+	0x69, 0x00,               // 03E2  ADC #$00
+	0x85, 0x14,               // 03E4  STA TMP
+	0xA5, 0x2D,               // 03E6  LDA R1
+	0x38,                     // 03E8  SEC
+	0xE5, 0x2B,               // 03E9  SBC D1
+	0x85, 0x2D,               // 03EB  STA R1
+	0xA5, 0x14,               // 03ED  LDA TMP
+	0xC9, 0x01,               // 03EF  CMP #$01
+	0xE6, 0x28,               // 03F1  INC Q0
+	// divnext:
+	0xCA,                     // 03F3  DEX
+	0xE0, 0x00,               // 03F4  CPX #$00
+	0xF0, 0x07,               // 03F6  BEQ divdone
+	0x02, 0x02,               // 03F8  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x49, 0x03,         // 03FA  JMP divbit
+	// divdone:
+	0x60,                     // 03FD  RTS
+	// done:
+	0x4C, 0xFE, 0x03,         // 03FE  JMP done
+};
+static constexpr u16 MulDivHalt = 0x03FE;
+
+static const u8 Mandelbrot[] = {
+	0xA9, 0x00,               // 0200  LDA #$00
+	0x85, 0x42,               // 0202  STA OUT
+	0xA9, 0x60,               // 0204  LDA #$60
+	0x85, 0x43,               // 0206  STA OUT+1
+	0xA9, 0xC0,               // 0208  LDA #$C0
+	0x85, 0x32,               // 020A  STA CI
+	0xA9, 0xFE,               // 020C  LDA #$FE
+	0x85, 0x33,               // 020E  STA CI+1
+	0xA9, 0x00,               // 0210  LDA #$00
+	0x85, 0x40,               // 0212  STA PY
+	// row:
+	0xA9, 0x00,               // 0214  LDA #$00
+	0x85, 0x30,               // 0216  STA CR
+	0xA9, 0xFE,               // 0218  LDA #$FE
+	0x85, 0x31,               // 021A  STA CR+1
+	0xA9, 0x00,               // 021C  LDA #$00
+	0x85, 0x3F,               // 021E  STA PX
+	// pixel:
+	0xA9, 0x00,               // 0220  LDA #$00
+	0x85, 0x34,               // 0222  STA ZR
+	0x85, 0x35,               // 0224  STA ZR+1
+	0x85, 0x36,               // 0226  STA ZI
+	0x85, 0x37,               // 0228  STA ZI+1
+	0x85, 0x3E,               // 022A  STA IT
+	// iterate:
+	0xA5, 0x34,               // 022C  LDA ZR
+	0x85, 0x20,               // 022E  STA M0
+	0x85, 0x22,               // 0230  STA N0
+	0xA5, 0x35,               // 0232  LDA ZR+1
+	0x85, 0x21,               // 0234  STA M1
+	0x85, 0x23,               // 0236  STA N1
+	0x20, 0x2C, 0x8D, 0x04,   // 0238  JSR smul
+	0xA5, 0x25,               // 023C  LDA P1
+	0x85, 0x38,               // 023E  STA ZR2
+	0xA5, 0x26,               // 0240  LDA P2
+	0x85, 0x39,               // 0242  STA ZR2+1
+	0xA5, 0x36,               // 0244  LDA ZI
+	0x85, 0x20,               // 0246  STA M0
+	0x85, 0x22,               // 0248  STA N0
+	0xA5, 0x37,               // 024A  LDA ZI+1
+	0x85, 0x21,               // 024C  STA M1
+	0x85, 0x23,               // 024E  STA N1
+	0x20, 0x2C, 0x8D, 0x04,   // 0250  JSR smul
+	0xA5, 0x25,               // 0254  LDA P1
+	0x85, 0x3A,               // 0256  STA ZI2
+	0xA5, 0x26,               // 0258  LDA P2
+	0x85, 0x3B,               // 025A  STA ZI2+1
+	0xA5, 0x38,               // 025C  LDA ZR2
+	0x85, 0x3C,               // 025E  STA T
+	0xA5, 0x39,               // 0260  LDA ZR2+1
+	0x85, 0x3D,               // 0262  STA T+1
+	0x18,                     // 0264  CLC
+	0xB0, 0x17,               // 0265  BCS cin_1
+	0x02, 0x02,               // 0267  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x3C,               // 0269  LDA T
+	0x65, 0x3A,               // 026B  ADC ZI2
+	0x85, 0x3C,               // 026D  STA T
+	0xC5, 0x3A,               // 026F  CMP ZI2
+	0xA9, 0x00,               // 0271  LDA #$00
+	0x69, 0x00,               // 0273  ADC #$00
+	0x49, 0x01,               // 0275  EOR #$01
+	0xC9, 0x01,               // 0277  CMP #$01
+	0x4C, 0x86, 0x02,         // 0279  JMP add_2
+	0xA5, 0x3C,               // 027C  LDA T
+	0x65, 0x3A,               // 027E  ADC ZI2
+	0x85, 0x3C,               // 0280  STA T
+	0xA5, 0x3A,               // 0282  LDA ZI2
+	0xC5, 0x3C,               // 0284  CMP T
+	0xB0, 0x17,               // 0286  BCS cin_3
+	0x02, 0x02,               // 0288  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x3D,               // 028A  LDA T+1
+	0x65, 0x3B,               // 028C  ADC ZI2+1
+	0x85, 0x3D,               // 028E  STA T+1
+	0xC5, 0x3B,               // 0290  CMP ZI2+1
+	0xA9, 0x00,               // 0292  LDA #$00
+	0x69, 0x00,               // 0294  ADC #$00
+	0x49, 0x01,               // 0296  EOR #$01
+	0xC9, 0x01,               // 0298  CMP #$01
+	0x4C, 0xA7, 0x02,         // 029A  JMP add_4
+	0xA5, 0x3D,               // 029D  LDA T+1
+	0x65, 0x3B,               // 029F  ADC ZI2+1
+	0x85, 0x3D,               // 02A1  STA T+1
+	0xA5, 0x3B,               // 02A3  LDA ZI2+1
+	0xC5, 0x3D,               // 02A5  CMP T+1
+	0xA5, 0x3D,               // 02A7  LDA T+1
+	0xC9, 0x04,               // 02A9  CMP #$04
+	0x90, 0x07,               // 02AB  BCC inside
+	0x02, 0x02,               // 02AD  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0xDC, 0x03,         // 02AF  JMP escape
+	// inside:
+	0xA5, 0x34,               // 02B2  LDA ZR
+	0x85, 0x20,               // 02B4  STA M0
+	0xA5, 0x35,               // 02B6  LDA ZR+1
+	0x85, 0x21,               // 02B8  STA M1
+	0xA5, 0x36,               // 02BA  LDA ZI
+	0x85, 0x22,               // 02BC  STA N0
+	0xA5, 0x37,               // 02BE  LDA ZI+1
+	0x85, 0x23,               // 02C0  STA N1
+	0x20, 0x2C, 0x8D, 0x04,   // 02C2  JSR smul
+	0xA5, 0x25,               // 02C6  LDA P1
+	0x85, 0x36,               // 02C8  STA ZI
+	0xA5, 0x26,               // 02CA  LDA P2
+	0x85, 0x37,               // 02CC  STA ZI+1
+	0x06, 0x36,               // 02CE  ASL ZI
+	0xA5, 0x37,               // 02D0  LDA ZI+1
+	0x65, 0x37,               // 02D2  ADC ZI+1
+	0x85, 0x14,               // 02D4  STA TMP
+	0xA5, 0x37,               // 02D6  LDA ZI+1
+	0xC9, 0x80,               // 02D8  CMP #$80
+	0xA5, 0x14,               // 02DA  LDA TMP
+	0x85, 0x37,               // 02DC  STA ZI+1
+	0x18,                     // 02DE  CLC
+	0xB0, 0x17,               // 02DF  BCS cin_5
+	0x02, 0x02,               // 02E1  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x36,               // 02E3  LDA ZI
+	0x65, 0x32,               // 02E5  ADC CI
+	0x85, 0x36,               // 02E7  STA ZI
+	0xC5, 0x32,               // 02E9  CMP CI
+	0xA9, 0x00,               // 02EB  LDA #$00
+	0x69, 0x00,               // 02ED  ADC #$00
+	0x49, 0x01,               // 02EF  EOR #$01
+	0xC9, 0x01,               // 02F1  CMP #$01
+	0x4C, 0x00, 0x03,         // 02F3  JMP add_6
+	0xA5, 0x36,               // 02F6  LDA ZI
+	0x65, 0x32,               // 02F8  ADC CI
+	0x85, 0x36,               // 02FA  STA ZI
+	0xA5, 0x32,               // 02FC  LDA CI
+	0xC5, 0x36,               // 02FE  CMP ZI
+	0xB0, 0x17,               // 0300  BCS cin_7
+	0x02, 0x02,               // 0302  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x37,               // 0304  LDA ZI+1
+	0x65, 0x33,               // 0306  ADC CI+1
+	0x85, 0x37,               // 0308  STA ZI+1
+	0xC5, 0x33,               // 030A  CMP CI+1
+	0xA9, 0x00,               // 030C  LDA #$00
+	0x69, 0x00,               // 030E  ADC #$00
+	0x49, 0x01,               // 0310  EOR #$01
+	0xC9, 0x01,               // 0312  CMP #$01
+	0x4C, 0x21, 0x03,         // 0314  JMP add_8
+	0xA5, 0x37,               // 0317  LDA ZI+1
+	0x65, 0x33,               // 0319  ADC CI+1
+	0x85, 0x37,               // 031B  STA ZI+1
+	0xA5, 0x33,               // 031D  LDA CI+1
+	0xC5, 0x37,               // 031F  CMP ZI+1
+	0xA5, 0x38,               // 0321  LDA ZR2
+	0x85, 0x34,               // 0323  STA ZR
+	0xA5, 0x39,               // 0325  LDA ZR2+1
+	0x85, 0x35,               // 0327  STA ZR+1
+	0x18,                     // 0329  CLC
+	0xB0, 0x1C,               // 032A  BCS bin_9
+	0xA5, 0x34,               // 032C  LDA ZR
+	0xC5, 0x3A,               // 032E  CMP ZI2
+	0xA9, 0x00,               // 0330  LDA #$00
+	0x69, 0x00,               // 0332  ADC #$00
+	0x85, 0x14,               // 0334  STA TMP
+	0xA5, 0x34,               // 0336  LDA ZR
+	0x18,                     // 0338  CLC
+	0xE5, 0x3A,               // 0339  SBC ZI2
+	0x85, 0x34,               // 033B  STA ZR
+	0xA5, 0x14,               // 033D  LDA TMP
+	0x49, 0x01,               // 033F  EOR #$01
+	0xC9, 0x01,               // 0341  CMP #$01
+	0x4C, 0x5B, 0x03,         // 0343  JMP sub_10
+	0xA5, 0x3A,               // 0346  LDA ZI2
+	0xC5, 0x34,               // 0348  CMP ZR
+	0xA9, 0x00,               // 034A  LDA #$00
+	0x69, 0x00,               // 034C  ADC #$00
+	0x85, 0x14,               // 034E  STA TMP
+	0xA5, 0x34,               // 0350  LDA ZR
+	0x38,                     // 0352  SEC
+	0xE5, 0x3A,               // 0353  SBC ZI2
+	0x85, 0x34,               // 0355  STA ZR
+	0xA5, 0x14,               // 0357  LDA TMP
+	0xC9, 0x01,               // 0359  CMP #$01
+	0xB0, 0x1C,               // 035B  BCS bin_11
+	0xA5, 0x35,               // 035D  LDA ZR+1
+	0xC5, 0x3B,               // 035F  CMP ZI2+1
+	0xA9, 0x00,               // 0361  LDA #$00
+	0x69, 0x00,               // 0363  ADC #$00
+	0x85, 0x14,               // 0365  STA TMP
+	0xA5, 0x35,               // 0367  LDA ZR+1
+	0x18,                     // 0369  CLC
+	0xE5, 0x3B,               // 036A  SBC ZI2+1
+	0x85, 0x35,               // 036C  STA ZR+1
+	0xA5, 0x14,               // 036E  LDA TMP
+	0x49, 0x01,               // 0370  EOR #$01
+	0xC9, 0x01,               // 0372  CMP #$01
+	0x4C, 0x8C, 0x03,         // 0374  JMP sub_12
+	0xA5, 0x3B,               // 0377  LDA ZI2+1
+	0xC5, 0x35,               // 0379  CMP ZR+1
+	0xA9, 0x00,               // 037B  LDA #$00
+	0x69, 0x00,               // 037D  ADC #$00
+	0x85, 0x14,               // 037F  STA TMP
+	0xA5, 0x35,               // 0381  LDA ZR+1
+	0x38,                     // 0383  SEC
+	0xE5, 0x3B,               // 0384  SBC ZI2+1
+	0x85, 0x35,               // 0386  STA ZR+1
+	0xA5, 0x14,               // 0388  LDA TMP
+	0xC9, 0x01,               // 038A  CMP #$01
+	0x18,                     // 038C  CLC
+	0xB0, 0x17,               // 038D  BCS cin_13
+	0x02, 0x02,               // 038F  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x34,               // 0391  LDA ZR
+	0x65, 0x30,               // 0393  ADC CR
+	0x85, 0x34,               // 0395  STA ZR
+	0xC5, 0x30,               // 0397  CMP CR
+	0xA9, 0x00,               // 0399  LDA #$00
+	0x69, 0x00,               // 039B  ADC #$00
+	0x49, 0x01,               // 039D  EOR #$01
+	0xC9, 0x01,               // 039F  CMP #$01
+	0x4C, 0xAE, 0x03,         // 03A1  JMP add_14
+	0xA5, 0x34,               // 03A4  LDA ZR
+	0x65, 0x30,               // 03A6  ADC CR
+	0x85, 0x34,               // 03A8  STA ZR
+	0xA5, 0x30,               // 03AA  LDA CR
+	0xC5, 0x34,               // 03AC  CMP ZR
+	0xB0, 0x17,               // 03AE  BCS cin_15
+	0x02, 0x02,               // 03B0  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x35,               // 03B2  LDA ZR+1
+	0x65, 0x31,               // 03B4  ADC CR+1
+	0x85, 0x35,               // 03B6  STA ZR+1
+	0xC5, 0x31,               // 03B8  CMP CR+1
+	0xA9, 0x00,               // 03BA  LDA #$00
+	0x69, 0x00,               // 03BC  ADC #$00
+	0x49, 0x01,               // 03BE  EOR #$01
+	0xC9, 0x01,               // 03C0  CMP #$01
+	0x4C, 0xCF, 0x03,         // 03C2  JMP add_16
+	0xA5, 0x35,               // 03C5  LDA ZR+1
+	0x65, 0x31,               // 03C7  ADC CR+1
+	0x85, 0x35,               // 03C9  STA ZR+1
+	0xA5, 0x31,               // 03CB  LDA CR+1
+	0xC5, 0x35,               // 03CD  CMP ZR+1
+	0xE6, 0x3E,               // 03CF  INC IT
+	0xA5, 0x3E,               // 03D1  LDA IT
+	0xC9, 0x10,               // 03D3  CMP #$10
+	0xF0, 0x07,               // 03D5  BEQ escape
+	0x02, 0x02,               // 03D7  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x2C, 0x02,         // 03D9  JMP iterate
+	// escape:
+	0xA0, 0x00,               // 03DC  LDY #$00
+	0xA5, 0x3E,               // 03DE  LDA IT
+	0x91, 0x42,               // 03E0  STA (OUT),Y
+	0xE6, 0x42,               // 03E2  INC OUT
+	0xA5, 0x42,               // 03E4  LDA OUT
+	0xD0, 0x04,               // 03E6  BNE samepage
+	0xE6, 0x43,               // 03E8  INC OUT+1
+	// samepage:
+	0x18,                     // 03EA  CLC
+	0xB0, 0x17,               // 03EB  BCS cin_17
+	0x02, 0x02,               // 03ED  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x30,               // 03EF  LDA CR
+	0x69, 0x1B,               // 03F1  ADC #$1B
+	0x85, 0x30,               // 03F3  STA CR
+	0xC9, 0x1B,               // 03F5  CMP #$1B
+	0xA9, 0x00,               // 03F7  LDA #$00
+	0x69, 0x00,               // 03F9  ADC #$00
+	0x49, 0x01,               // 03FB  EOR #$01
+	0xC9, 0x01,               // 03FD  CMP #$01
+	0x4C, 0x0C, 0x04,         // 03FF  JMP add_18
+	0xA5, 0x30,               // 0402  LDA CR
+	0x69, 0x1B,               // 0404  ADC #$1B
+	0x85, 0x30,               // 0406  STA CR
+	0xA9, 0x1B,               // 0408  LDA #$1B
+	0xC5, 0x30,               // 040A  CMP CR
+	0xB0, 0x17,               // 040C  BCS cin_19
+	0x02, 0x02,               // 040E  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x31,               // 0410  LDA CR+1
+	0x69, 0x00,               // 0412  ADC #$00
+	0x85, 0x31,               // 0414  STA CR+1
+	0xC9, 0x00,               // 0416  CMP #$00
+	0xA9, 0x00,               // 0418  LDA #$00
+	0x69, 0x00,               // 041A  ADC #$00
+	0x49, 0x01,               // 041C  EOR #$01
+	0xC9, 0x01,               // 041E  CMP #$01
+	0x4C, 0x2D, 0x04,         // 0420  JMP add_20
+	0xA5, 0x31,               // 0423  LDA CR+1
+	0x69, 0x00,               // 0425  ADC #$00
+	0x85, 0x31,               // 0427  STA CR+1
+	0xA9, 0x00,               // 0429  LDA #$00
+	0xC5, 0x31,               // 042B  CMP CR+1
+	0xE6, 0x3F,               // 042D  INC PX
+	0xA5, 0x3F,               // 042F  LDA PX
+	0xC9, 0x18,               // 0431  CMP #$18
+	0xF0, 0x07,               // 0433  BEQ rowdone
+	0x02, 0x02,               // 0435  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x20, 0x02,         // 0437  JMP pixel
+	// rowdone:
+	0x18,                     // 043A  CLC
+	0xB0, 0x17,               // 043B  BCS cin_21
+	0x02, 0x02,               // 043D  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x32,               // 043F  LDA CI
+	0x69, 0x28,               // 0441  ADC #$28
+	0x85, 0x32,               // 0443  STA CI
+	0xC9, 0x28,               // 0445  CMP #$28
+	0xA9, 0x00,               // 0447  LDA #$00
+	0x69, 0x00,               // 0449  ADC #$00
+	0x49, 0x01,               // 044B  EOR #$01
+	0xC9, 0x01,               // 044D  CMP #$01
+	0x4C, 0x5C, 0x04,         // 044F  JMP add_22
+	0xA5, 0x32,               // 0452  LDA CI
+	0x69, 0x28,               // 0454  ADC #$28
+	0x85, 0x32,               // 0456  STA CI
+	0xA9, 0x28,               // 0458  LDA #$28
+	0xC5, 0x32,               // 045A  CMP CI
+	0xB0, 0x17,               // 045C  BCS cin_23
+	0x02, 0x02,               // 045E  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x33,               // 0460  LDA CI+1
+	0x69, 0x00,               // 0462  ADC #$00
+	0x85, 0x33,               // 0464  STA CI+1
+	0xC9, 0x00,               // 0466  CMP #$00
+	0xA9, 0x00,               // 0468  LDA #$00
+	0x69, 0x00,               // 046A  ADC #$00
+	0x49, 0x01,               // 046C  EOR #$01
+	0xC9, 0x01,               // 046E  CMP #$01
+	0x4C, 0x7D, 0x04,         // 0470  JMP add_24
+	0xA5, 0x33,               // 0473  LDA CI+1
+	0x69, 0x00,               // 0475  ADC #$00
+	0x85, 0x33,               // 0477  STA CI+1
+	0xA9, 0x00,               // 0479  LDA #$00
+	0xC5, 0x33,               // 047B  CMP CI+1
+	0xE6, 0x40,               // 047D  INC PY
+	0xA5, 0x40,               // 047F  LDA PY
+	0xC9, 0x10,               // 0481  CMP #$10
+	0xF0, 0x07,               // 0483  BEQ finished
+	0x02, 0x02,               // 0485  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x14, 0x02,         // 0487  JMP row
+	// finished:
+	0x4C, 0xC3, 0x05,         // 048A  JMP done
+	// P1-P2 = (M * N) >> 8 for signed 8.8 operands
+	// smul:
+	0xA5, 0x21,               // 048D  LDA M1
+	0x45, 0x23,               // 048F  EOR N1
+	0x85, 0x2E,               // 0491  STA SIGN
+	0xA5, 0x21,               // 0493  LDA M1
+	0xC9, 0x80,               // 0495  CMP #$80
+	0x90, 0x17,               // 0497  BCC mpositive
+	0x02,                     // 0499  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x20,               // 049A  LDA M0
+	0x49, 0xFF,               // 049C  EOR #$FF
+	0x85, 0x20,               // 049E  STA M0
+	0xA5, 0x21,               // 04A0  LDA M1
+	0x49, 0xFF,               // 04A2  EOR #$FF
+	0x85, 0x21,               // 04A4  STA M1
+	0xE6, 0x20,               // 04A6  INC M0
+	0xA5, 0x20,               // 04A8  LDA M0
+	0xD0, 0x04,               // 04AA  BNE mpositive
+	0xE6, 0x21,               // 04AC  INC M1
+	// mpositive:
+	0xA5, 0x23,               // 04AE  LDA N1
+	0xC9, 0x80,               // 04B0  CMP #$80
+	0x90, 0x17,               // 04B2  BCC npositive
+	0x02,                     // 04B4  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x22,               // 04B5  LDA N0
+	0x49, 0xFF,               // 04B7  EOR #$FF
+	0x85, 0x22,               // 04B9  STA N0
+	0xA5, 0x23,               // 04BB  LDA N1
+	0x49, 0xFF,               // 04BD  EOR #$FF
+	0x85, 0x23,               // 04BF  STA N1
+	0xE6, 0x22,               // 04C1  INC N0
+	0xA5, 0x22,               // 04C3  LDA N0
+	0xD0, 0x04,               // 04C5  BNE npositive
+	0xE6, 0x23,               // 04C7  INC N1
+	// npositive:
+	0xA9, 0x00,               // 04C9  LDA #$00
+	0x85, 0x24,               // 04CB  STA P0
+	0x85, 0x25,               // 04CD  STA P1
+	0x85, 0x26,               // 04CF  STA P2
+	0x85, 0x27,               // 04D1  STA P3
+	0xA2, 0x10,               // 04D3  LDX #$10
+	// smulbit:
+	0x06, 0x24,               // 04D5  ASL P0
+	0xA5, 0x25,               // 04D7  LDA P1
+	0x65, 0x25,               // 04D9  ADC P1
+	0x85, 0x14,               // 04DB  STA TMP
+	0xA5, 0x25,               // 04DD  LDA P1
+	0xC9, 0x80,               // 04DF  CMP #$80
+	0xA5, 0x14,               // 04E1  LDA TMP
+	0x85, 0x25,               // 04E3  STA P1
+	0xA5, 0x26,               // 04E5  LDA P2
+	0x65, 0x26,               // 04E7  ADC P2
+	0x85, 0x14,               // 04E9  STA TMP
+	0xA5, 0x26,               // 04EB  LDA P2
+	0xC9, 0x80,               // 04ED  CMP #$80
+	0xA5, 0x14,               // 04EF  LDA TMP
+	0x85, 0x26,               // 04F1  STA P2
+	0xA5, 0x27,               // 04F3  LDA P3
+	0x65, 0x27,               // 04F5  ADC P3
+	0x85, 0x14,               // 04F7  STA TMP
+	0xA5, 0x27,               // 04F9  LDA P3
+	0xC9, 0x80,               // 04FB  CMP #$80
+	0xA5, 0x14,               // 04FD  LDA TMP
+	0x85, 0x27,               // 04FF  STA P3
+	0x06, 0x22,               // 0501  ASL N0
+	0xA5, 0x23,               // 0503  LDA N1
+	0x65, 0x23,               // 0505  ADC N1
+	0x85, 0x14,               // 0507  STA TMP
+	0xA5, 0x23,               // 0509  LDA N1
+	0xC9, 0x80,               // 050B  CMP #$80
+	0xA5, 0x14,               // 050D  LDA TMP
+	0x85, 0x23,               // 050F  STA N1
+	0xB0, 0x07,               // 0511  BCS smuladd
+	0x02, 0x02,               // 0513  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0x9D, 0x05,         // 0515  JMP smulnext
+	// smuladd:
+	0x18,                     // 0518  CLC
+	0xB0, 0x17,               // 0519  BCS cin_25
+	0x02, 0x02,               // 051B  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x24,               // 051D  LDA P0
+	0x65, 0x20,               // 051F  ADC M0
+	0x85, 0x24,               // 0521  STA P0
+	0xC5, 0x20,               // 0523  CMP M0
+	0xA9, 0x00,               // 0525  LDA #$00
+	0x69, 0x00,               // 0527  ADC #$00
+	0x49, 0x01,               // 0529  EOR #$01
+	0xC9, 0x01,               // 052B  CMP #$01
+	0x4C, 0x3A, 0x05,         // 052D  JMP add_26
+	0xA5, 0x24,               // 0530  LDA P0
+	0x65, 0x20,               // 0532  ADC M0
+	0x85, 0x24,               // 0534  STA P0
+	0xA5, 0x20,               // 0536  LDA M0
+	0xC5, 0x24,               // 0538  CMP P0
+	0xB0, 0x17,               // 053A  BCS cin_27
+	0x02, 0x02,               // 053C  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x25,               // 053E  LDA P1
+	0x65, 0x21,               // 0540  ADC M1
+	0x85, 0x25,               // 0542  STA P1
+	0xC5, 0x21,               // 0544  CMP M1
+	0xA9, 0x00,               // 0546  LDA #$00
+	0x69, 0x00,               // 0548  ADC #$00
+	0x49, 0x01,               // 054A  EOR #$01
+	0xC9, 0x01,               // 054C  CMP #$01
+	0x4C, 0x5B, 0x05,         // 054E  JMP add_28
+	0xA5, 0x25,               // 0551  LDA P1
+	0x65, 0x21,               // 0553  ADC M1
+	0x85, 0x25,               // 0555  STA P1
+	0xA5, 0x21,               // 0557  LDA M1
+	0xC5, 0x25,               // 0559  CMP P1
+	0xB0, 0x17,               // 055B  BCS cin_29
+	0x02, 0x02,               // 055D  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x26,               // 055F  LDA P2
+	0x69, 0x00,               // 0561  ADC #$00
+	0x85, 0x26,               // 0563  STA P2
+	0xC9, 0x00,               // 0565  CMP #$00
+	0xA9, 0x00,               // 0567  LDA #$00
+	0x69, 0x00,               // 0569  ADC #$00
+	0x49, 0x01,               // 056B  EOR #$01
+	0xC9, 0x01,               // 056D  CMP #$01
+	0x4C, 0x7C, 0x05,         // 056F  JMP add_30
+	0xA5, 0x26,               // 0572  LDA P2
+	0x69, 0x00,               // 0574  ADC #$00
+	0x85, 0x26,               // 0576  STA P2
+	0xA9, 0x00,               // 0578  LDA #$00
+	0xC5, 0x26,               // 057A  CMP P2
+	0xB0, 0x17,               // 057C  BCS cin_31
+	0x02, 0x02,               // 057E  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x27,               // 0580  LDA P3
+	0x69, 0x00,               // 0582  ADC #$00
+	0x85, 0x27,               // 0584  STA P3
+	0xC9, 0x00,               // 0586  CMP #$00
+	0xA9, 0x00,               // 0588  LDA #$00
+	0x69, 0x00,               // 058A  ADC #$00
+	0x49, 0x01,               // 058C  EOR #$01
+	0xC9, 0x01,               // 058E  CMP #$01
+	0x4C, 0x9D, 0x05,         // 0590  JMP add_32
+	0xA5, 0x27,               // 0593  LDA P3
+	0x69, 0x00,               // 0595  ADC #$00
+	0x85, 0x27,               // 0597  STA P3
+	0xA9, 0x00,               // 0599  LDA #$00
+	0xC5, 0x27,               // 059B  CMP P3
+	// smulnext:
+	0xCA,                     // 059D  DEX
+	0xE0, 0x00,               // 059E  CPX #$00
+	0xF0, 0x07,               // 05A0  BEQ smuldone
+	0x02, 0x02,               // 05A2  (padding, offset of the branch above must be an empty opcode)
+	0x4C, 0xD5, 0x04,         // 05A4  JMP smulbit
+	// smuldone:
+	0xA5, 0x2E,               // 05A7  LDA SIGN
+	0xC9, 0x80,               // 05A9  CMP #$80
+	0x90, 0x17,               // 05AB  BCC spositive
+	0x02,                     // 05AD  (padding, offset of the branch above must be an empty opcode)
+	0xA5, 0x25,               // 05AE  LDA P1
+	0x49, 0xFF,               // 05B0  EOR #$FF
+	0x85, 0x25,               // 05B2  STA P1
+	0xA5, 0x26,               // 05B4  LDA P2
+	0x49, 0xFF,               // 05B6  EOR #$FF
+	0x85, 0x26,               // 05B8  STA P2
+	0xE6, 0x25,               // 05BA  INC P1
+	0xA5, 0x25,               // 05BC  LDA P1
+	0xD0, 0x04,               // 05BE  BNE spositive
+	0xE6, 0x26,               // 05C0  INC P2
+	// spositive:
+	0x60,                     // 05C2  RTS
+	// done:
+	0x4C, 0xC3, 0x05,         // 05C3  JMP done
+};
+static constexpr u16 MandelbrotHalt = 0x05C3;
+
+static const u8 BcdCounter[] = {
+	0xA9, 0x00,               // 0200  LDA #$00
+	0x85, 0x44,               // 0202  STA BCD
+	0x85, 0x45,               // 0204  STA BCD+1
+	0x85, 0x46,               // 0206  STA BCD+2
+	// count:
+	0xA2, 0x00,               // 0208  LDX #$00
+	// digit:
+	0xB5, 0x44,               // 020A  LDA BCD,X
+	0x18,                     // 020C  CLC
+	0x69, 0x01,               // 020D  ADC #$01
+	0x95, 0x44,               // 020F  STA BCD,X
+	0x29, 0x0F,               // 0211  AND #$0F
+	0xC9, 0x0A,               // 0213  CMP #$0A
+	0xD0, 0x1A,               // 0215  BNE check
+	0x02, 0x02, 0x02, 0x02,   // 0217  (padding, offset of the branch above must be an empty opcode)
+	0xB5, 0x44,               // 021B  LDA BCD,X
+	0x18,                     // 021D  CLC
+	0x69, 0x06,               // 021E  ADC #$06
+	0x95, 0x44,               // 0220  STA BCD,X
+	0xC9, 0xA0,               // 0222  CMP #$A0
+	0xD0, 0x0B,               // 0224  BNE check
+	0x02,                     // 0226  (padding, offset of the branch above must be an empty opcode)
+	0xA9, 0x00,               // 0227  LDA #$00
+	0x95, 0x44,               // 0229  STA BCD,X
+	0xE8,                     // 022B  INX
+	0x4C, 0x0A, 0x02,         // 022C  JMP digit
+	// check:
+	0xA5, 0x44,               // 022F  LDA BCD
+	0xC9, 0x99,               // 0231  CMP #$99
+	0x02,                     // 0233  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xD4,               // 0234  BNE count
+	0xA5, 0x45,               // 0236  LDA BCD+1
+	0xC9, 0x99,               // 0238  CMP #$99
+	0x02, 0x02, 0x02,         // 023A  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xCB,               // 023D  BNE count
+	0xA5, 0x46,               // 023F  LDA BCD+2
+	0xC9, 0x09,               // 0241  CMP #$09
+	0x02, 0x02,               // 0243  (padding, offset of the next branch must be an empty opcode)
+	0xD0, 0xC3,               // 0245  BNE count
+	// done:
+	0x4C, 0x47, 0x02,         // 0247  JMP done
+};
+static constexpr u16 BcdCounterHalt = 0x0247;
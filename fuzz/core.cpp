@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "../src/6502.h"
+#include "../src/opcodes.h"
+#include "../src/snapshot.h"
+
+/*
+	Persistent-mode fuzz target. One machine is set up once with the seed program; every input
+	then runs on it and the dirty pages are restored from the baseline snapshot afterwards, so an
+	iteration costs the instructions it runs plus a few page copies.
+
+	Input layout: bytes 0-1 and 2-3 are the cycles (little-endian) at which IRQ and NMI are
+	asserted, $FFFF for never; the rest is copied over the seed at the load address. A run ends
+	when the cycle budget is spent, on an opcode the NMOS 6502 does not document, when the stack
+	pointer leaves page 1, or, as a crash libFuzzer keeps, when the watch address is executed or
+	its byte changes.
+
+	Configured from the environment, as libFuzzer owns the command line:
+	M6502_FUZZ_SEED (raw image path), M6502_FUZZ_ORIGIN (hex load and start address, default 0200),
+	M6502_FUZZ_CYCLES (budget per input, default 2000), M6502_FUZZ_WATCH (hex address, default none).
+
+	Built with Clang the target links libFuzzer. Elsewhere a small driver takes its place:
+	6502-fuzz [--runs N] [--seed S] [input...] runs the given inputs, or N random ones, and
+	reports executions per second and why the runs stopped.
+*/
+
+enum StopReason { StopBudget, StopInvalidOpcode, StopStackWrap, StopWatch, StopReasonCount };
+static constexpr const char* StopReasonNames[StopReasonCount] = { "budget", "invalid opcode", "stack wrap", "watch" };
+
+static NMOS6502* Machine;
+static MachineSnapshot Baseline;
+static DirtyPageMap Dirty;
+static u16 Origin = 0x0200;
+static u64 CycleBudget = 2000;
+static long WatchAddress = -1;
+static bool Documented[0x100];
+
+static void Setup() {
+	if (const char* Value = std::getenv("M6502_FUZZ_ORIGIN")) {
+		Origin = static_cast<u16>(std::strtoul(Value, nullptr, 16));
+	}
+	if (const char* Value = std::getenv("M6502_FUZZ_CYCLES")) {
+		CycleBudget = std::strtoull(Value, nullptr, 10);
+	}
+	if (const char* Value = std::getenv("M6502_FUZZ_WATCH")) {
+		WatchAddress = std::strtol(Value, nullptr, 16) & 0xFFFF;
+	}
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		Documented[Opcode] = std::strcmp(OpcodeTable[Opcode].Mnemonic, "???") != 0;
+	}
+
+	Machine = new NMOS6502();
+	Machine->Reset();
+	if (const char* Path = std::getenv("M6502_FUZZ_SEED")) {
+		std::ifstream File(Path, std::ios::binary);
+		std::vector<char> Image((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+		if (!File.good() && !File.eof()) {
+			std::fprintf(stderr, "cannot read seed %s\n", Path);
+			std::exit(2);
+		}
+		std::memcpy(&Machine->Memory[Origin], Image.data(), std::min<size_t>(Image.size(), 0x10000 - Origin));
+	}
+	Machine->PC = Origin;
+	Machine->SP = 0x01FF;
+	Baseline.Capture(*Machine);
+	Machine->DirtyPages = &Dirty;
+}
+
+static u16 Word(const uint8_t* Data) {
+	return static_cast<u16>(Data[0] | Data[1] << 8);
+}
+
+static StopReason RunOne(const uint8_t* Data, size_t Size) {
+	Baseline.Restore(*Machine, Dirty);
+	u64 IRQAt = ~0ull, NMIAt = ~0ull;
+	if (Size >= 4) {
+		IRQAt = Word(Data) == 0xFFFF ? ~0ull : Word(Data);
+		NMIAt = Word(Data + 2) == 0xFFFF ? ~0ull : Word(Data + 2);
+		Data += 4;
+		Size -= 4;
+	}
+	Size = std::min<size_t>(Size, 0x10000 - Origin);
+	std::memcpy(&Machine->Memory[Origin], Data, Size);
+	Dirty.MarkRange(Origin, Size);
+
+	NMOS6502& M6502 = *Machine;
+	u8 Watched = WatchAddress >= 0 ? M6502.Memory[WatchAddress] : 0;
+	for (u64 Cycles = 0; Cycles < CycleBudget;) {
+		if (Cycles >= IRQAt) {
+			M6502.IRQPending = true;
+			IRQAt = ~0ull;
+		}
+		if (Cycles >= NMIAt) {
+			M6502.NMIPending = true;
+			NMIAt = ~0ull;
+		}
+		if (!Documented[M6502.Memory[M6502.PC]]) {
+			return StopInvalidOpcode;
+		}
+		Cycles += M6502.Execute(0);
+		if ((M6502.SP & 0xFF00) != 0x0100) {
+			return StopStackWrap;
+		}
+		if (WatchAddress >= 0 && (M6502.PC == WatchAddress || M6502.Memory[WatchAddress] != Watched)) {
+			return StopWatch;
+		}
+	}
+	return StopBudget;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* Data, size_t Size) {
+	if (!Machine) {
+		Setup();
+	}
+	if (RunOne(Data, Size) == StopWatch) {
+		std::fprintf(stderr, "watch address %04lX reached\n", WatchAddress);
+		std::abort();
+	}
+	return 0;
+}
+
+#ifdef M6502_FUZZ_DRIVER
+int main(int argc, char** argv) {
+	u64 Runs = 100000, State = 0x2545F4914F6CDD1Dull;
+	std::vector<const char*> Inputs;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--runs") == 0 && i + 1 < argc) {
+			Runs = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			State = std::strtoull(argv[++i], nullptr, 0) | 1;
+		}
+		else if (argv[i][0] != '-') {
+			Inputs.push_back(argv[i]);
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--runs N] [--seed S] [input...]\n", argv[0]);
+			return 2;
+		}
+	}
+	Setup();
+
+	u64 Stops[StopReasonCount] = {};
+	std::vector<uint8_t> Input;
+	auto Start = std::chrono::steady_clock::now();
+	if (!Inputs.empty()) {
+		Runs = Inputs.size();
+	}
+	for (u64 Run = 0; Run < Runs; ++Run) {
+		if (!Inputs.empty()) {
+			std::ifstream File(Inputs[Run], std::ios::binary);
+			Input.assign(std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>());
+		}
+		else { // xorshift64, 4 header bytes and up to 60 program bytes
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			Input.resize(4 + State % 61);
+			for (uint8_t& Byte : Input) {
+				State ^= State << 13;
+				State ^= State >> 7;
+				State ^= State << 17;
+				Byte = static_cast<uint8_t>(State >> 32);
+			}
+		}
+		StopReason Reason = RunOne(Input.data(), Input.size());
+		++Stops[Reason];
+		if (!Inputs.empty()) {
+			std::printf("%s: %s\n", Inputs[Run], StopReasonNames[Reason]);
+		}
+	}
+	double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+	std::printf("%llu runs, %.2f s, %.0f exec/s;", static_cast<unsigned long long>(Runs), Seconds, Seconds > 0 ? Runs / Seconds : 0.0);
+	for (int Reason = 0; Reason < StopReasonCount; ++Reason) {
+		std::printf(" %s %llu", StopReasonNames[Reason], static_cast<unsigned long long>(Stops[Reason]));
+	}
+	std::printf("\n");
+	return Stops[StopWatch] ? 1 : 0;
+}
+#endif
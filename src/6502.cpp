@@ -1,4 +1,9 @@
 ﻿#include "6502.h"
+#ifdef NMOS6502_INSTRUMENTATION
+#include "call_graph.h"
+#include "profiler.h"
+#include "trace.h"
+#endif
 
 NMOS6502::NMOS6502() {
 	Memory = std::vector<u8>(1024 * 64);
@@ -30,11 +35,22 @@ void NMOS6502::Reset() {
 u8 NMOS6502::FetchByte()
 {
 	++CyclesPerformed;
+#ifdef NMOS6502_INSTRUMENTATION
+	if (Heatmap) {
+		Heatmap->Execute(PC);
+	}
+#endif
 	return Memory[PC++];
 }
 
 u16 NMOS6502::FetchWord() {
 	CyclesPerformed += 2;
+#ifdef NMOS6502_INSTRUMENTATION
+	if (Heatmap) {
+		Heatmap->Execute(PC);
+		Heatmap->Execute(static_cast<u16>(PC + 1));
+	}
+#endif
 	u16 Word = static_cast<u16>(Memory[PC] << 8 | Memory[static_cast<u16>(PC + 1)] & 0x00FF);
 	PC += 2;
 	return Word;
@@ -54,30 +70,39 @@ void NMOS6502::IRQ() {
 		return;
 	}
 	/* Push PC to stack (hh first) */
-	Memory[SP] = PC << 8;
+	WriteByte(SP, PC << 8);
 	--SP;
-	Memory[SP] = PC & 0xFF;
+	WriteByte(SP, PC & 0xFF);
 	--SP;
 	/* Set processor flags and push to stack */
-	Memory[SP] = static_cast<uint8_t>(ProcessorStatus.to_ulong());
-	PC = Memory[0xFFFA];
+	WriteByte(SP, static_cast<uint8_t>(ProcessorStatus.to_ulong()));
+	PC = ReadByte(0xFFFA);
 	ProcessorStatus.reset(I);
 }
 
 void NMOS6502::NMI() {
 	/* Push PC to stack (hh first) */
-	Memory[SP] = PC << 8;
+	WriteByte(SP, PC << 8);
 	--SP;
-	Memory[SP] = PC & 0xFF;
+	WriteByte(SP, PC & 0xFF);
 	--SP;
 	/* Set processor flags and push to stack */
-	Memory[SP] = static_cast<uint8_t>(ProcessorStatus.to_ulong());
-	PC = Memory[0xFFFE];
+	WriteByte(SP, static_cast<uint8_t>(ProcessorStatus.to_ulong()));
+	PC = ReadByte(0xFFFE);
 	ProcessorStatus.reset(I);
 }
 
 int NMOS6502::Execute(u32 CyclesRequired) {
 	CyclesPerformed = 0;
+#ifdef NMOS6502_INSTRUMENTATION
+	u16 InterruptStack = SP;
+	if (Heatmap) { // Interrupt pushes are put down to the interrupted instruction
+		Heatmap->Instruction = PC;
+	}
+	if (Watchpoints) {
+		Watchpoints->Instruction = PC;
+	}
+#endif
 	if (NMIPending) { // NMI/IRQ wires pull to logic-low when requesting interrupts
 		NMIPending = false; // Functionally putting the NMI wire on high
 		NMI();
@@ -86,17 +111,52 @@ int NMOS6502::Execute(u32 CyclesRequired) {
 		IRQPending = false;
 		IRQ();
 	}
+#ifdef NMOS6502_INSTRUMENTATION
+	if (CallProfiler && SP != InterruptStack) { // An interrupt was taken
+		CallProfiler->Call(PC, InterruptStack, true);
+	}
+	u16 InstructionAddress = PC;
+	u16 InstructionStack = SP;
+	if (Heatmap) {
+		Heatmap->Instruction = PC;
+	}
+	if (Watchpoints) {
+		Watchpoints->Instruction = PC;
+	}
+	if (Tracer) {
+		Tracer->Record(*this);
+	}
+#endif
 	u8 Instruction = FetchByte();
+#ifdef NMOS6502_INSTRUMENTATION
+	Stats.Current = Instruction;
+#endif
 	(this->*Opcodes[Instruction])();
+#ifdef NMOS6502_INSTRUMENTATION
+	++Stats.Executions[Instruction];
+	Stats.Cycles[Instruction] += CyclesPerformed;
+	if (PCProfiler) {
+		PCProfiler->Record(InstructionAddress, CyclesPerformed);
+	}
+	if (CallProfiler) {
+		CallProfiler->Step(Instruction, CyclesPerformed, PC, InstructionStack, SP);
+	}
+	if (Tracer) {
+		Tracer->Advance(CyclesPerformed);
+	}
+	if (Watchpoints) {
+		Watchpoints->Retire(Memory);
+	}
+#endif
 	return CyclesPerformed;
 }
 
 u16 NMOS6502::GetIndirectX() {
 	u8 ZeroPage = FetchByte();
 	u8 BaseAddress = ZeroPage + X;
-	u8 Low = Memory[BaseAddress];
+	u8 Low = ReadByte(BaseAddress);
 	Cycle();
-	u8 High = Memory[++BaseAddress];
+	u8 High = ReadByte(++BaseAddress);
 	Cycle();
 	u16 EffectiveAddress = Low | (High << 8);
 	Cycle();
@@ -105,14 +165,17 @@ u16 NMOS6502::GetIndirectX() {
 
 u16 NMOS6502::GetIndirectY(bool CheckBoundary) {
 	u8 ZeroPage = FetchByte();
-	u8 Low = Memory[ZeroPage];
+	u8 Low = ReadByte(ZeroPage);
 	Cycle();
-	u8 High = Memory[++ZeroPage];
+	u8 High = ReadByte(++ZeroPage);
 	Cycle();
 	u16 EffectiveAddress = (Low | (High << 8));
 	if (CheckBoundary) {
 		if ((EffectiveAddress & 0xFF00) != ((EffectiveAddress + Y) & 0xFF00)) {
 			Cycle();
+#ifdef NMOS6502_INSTRUMENTATION
+			++Stats.PageCrosses[Stats.Current];
+#endif
 		}
 	}
 	EffectiveAddress += Y;
@@ -125,6 +188,9 @@ u16 NMOS6502::GetAbsoluteY(bool CheckBoundary) {
 	if (CheckBoundary) {
 		if ((BaseAddress & 0xFF00) != (EffectiveAddress & 0xFF00)) { // Page boundary cross
 			Cycle();
+#ifdef NMOS6502_INSTRUMENTATION
+			++Stats.PageCrosses[Stats.Current];
+#endif
 		}
 	}
 	return EffectiveAddress;
@@ -136,6 +202,9 @@ u16 NMOS6502::GetAbsoluteX(bool CheckBoundary) {
 	if (CheckBoundary) {
 		if ((BaseAddress & 0xFF00) != (EffectiveAddress & 0xFF00)) { 
 			Cycle();
+#ifdef NMOS6502_INSTRUMENTATION
+			++Stats.PageCrosses[Stats.Current];
+#endif
 		}
 	}
 	return EffectiveAddress;
@@ -195,16 +264,25 @@ void NMOS6502::Move(u8 *Target, MoveDirection Direction, bool IsRotate) {
 
 void NMOS6502::Branch(u8 Byte) {
 	PC -= 2; // Execute, FetchByte ops execute before running this function
+#ifdef NMOS6502_INSTRUMENTATION
+	++Stats.BranchesTaken[Stats.Current];
+#endif
 	if (Byte > 0x7F) {
 		u8 BranchOffset = static_cast<u8>(pow(2, 8) - Byte);
 		if ((PC & 0xFF00) != ((PC - BranchOffset) & 0xFF00)) {
 			Cycle();
+#ifdef NMOS6502_INSTRUMENTATION
+			++Stats.PageCrosses[Stats.Current];
+#endif
 		}
 		PC -= BranchOffset;
 	}
 	else {
 		if ((PC & 0xFF00) != ((PC + Byte) & 0xFF00)) { 
 			Cycle();
+#ifdef NMOS6502_INSTRUMENTATION
+			++Stats.PageCrosses[Stats.Current];
+#endif
 		}
 		PC += Byte;
 	}
@@ -217,7 +295,7 @@ void NMOS6502::Opcode0x00() {
 
 void NMOS6502::Opcode0x01() {
 	u16 EffectiveAddress = GetIndirectX();
-	A |= Memory[EffectiveAddress];
+	A |= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
@@ -236,14 +314,14 @@ void NMOS6502::Opcode0x04() {
 
 void NMOS6502::Opcode0x05() {
 	u8 ZeroPage = FetchByte();
-	A |= Memory[ZeroPage];
+	A |= ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
 
 void NMOS6502::Opcode0x06() {
 	u8 ZeroPage = FetchByte();
-	Move(&Memory[ZeroPage], LEFT, false);
+	Move(Modify(ZeroPage), LEFT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::ASL);
 }
@@ -255,7 +333,7 @@ void NMOS6502::Opcode0x07() {
 void NMOS6502::Opcode0x08() {
 	u8 P = static_cast<u8>(ProcessorStatus.to_ulong());
 	Cycle();
-	Memory[SP] = P;
+	WriteByte(SP, P);
 	Cycle();
 	--SP;
 	HandleFlags(INSTRUCTION::PHP);
@@ -284,14 +362,14 @@ void NMOS6502::Opcode0x0C() {
 
 void NMOS6502::Opcode0x0D() {
 	u16 EffectiveAddress = FetchWord();
-	A |= Memory[EffectiveAddress];
+	A |= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
 
 void NMOS6502::Opcode0x0E() {
 	u16 EffectiveAddress = FetchWord();
-	Move(&Memory[EffectiveAddress], LEFT, false);
+	Move(Modify(EffectiveAddress), LEFT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::ASL);
 }
@@ -312,7 +390,7 @@ void NMOS6502::Opcode0x10() {
 
 void NMOS6502::Opcode0x11() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	A |= Memory[EffectiveAddress];
+	A |= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
@@ -331,7 +409,7 @@ void NMOS6502::Opcode0x14() {
 
 void NMOS6502::Opcode0x15() {
 	u8 ZeroPage = GetZeroPageX();
-	A |= Memory[ZeroPage];
+	A |= ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
@@ -340,7 +418,7 @@ void NMOS6502::Opcode0x16() {
 	u8 ZeroPage = FetchByte();
 	u8 EffectiveAddress = ZeroPage + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], LEFT, false);
+	Move(Modify(EffectiveAddress), LEFT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::ASL);
 }
@@ -357,7 +435,7 @@ void NMOS6502::Opcode0x18() {
 
 void NMOS6502::Opcode0x19() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	A |= Memory[EffectiveAddress];
+	A |= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
@@ -376,7 +454,7 @@ void NMOS6502::Opcode0x1C() {
 
 void NMOS6502::Opcode0x1D() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	A |= Memory[EffectiveAddress];
+	A |= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::ORA);
 }
@@ -385,7 +463,7 @@ void NMOS6502::Opcode0x1E() {
 	u16 BaseAddress = FetchWord();
 	u16 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], LEFT, false);
+	Move(Modify(EffectiveAddress), LEFT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::ASL);
 }
@@ -395,13 +473,13 @@ void NMOS6502::Opcode0x1F() {
 }
 
 void NMOS6502::Opcode0x20() {
-	Memory[SP] = ((PC - 1) >> 8) & 0xFF; // High return
+	WriteByte(SP, ((PC - 1) >> 8) & 0xFF); // High return
 	Cycle();
 	--SP;
-	Memory[SP] = (PC - 1) & 0xFF; // Low return
+	WriteByte(SP, (PC - 1) & 0xFF); // Low return
 	Cycle();
 	--SP;
-	PC = (Memory[PC + 2] << 8) | (Memory[PC + 1]);
+	PC = (ReadCode(PC + 2) << 8) | (ReadCode(PC + 1));
 	Cycle();
 	Cycle();
 	Cycle();
@@ -409,7 +487,7 @@ void NMOS6502::Opcode0x20() {
 
 void NMOS6502::Opcode0x21() {
 	u16 EffectiveAddress = GetIndirectX();
-	A &= Memory[EffectiveAddress];
+	A &= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::AND);
 }
@@ -424,14 +502,14 @@ void NMOS6502::Opcode0x23() {
 
 void NMOS6502::Opcode0x24() {
 	u8 ZeroPage = FetchByte();
-	u8 Operand = Memory[ZeroPage];
+	u8 Operand = ReadByte(ZeroPage);
 	(A & Operand) == 0 ? ProcessorStatus.set(Z) : ProcessorStatus.reset(Z);
 	(Operand & (1 << 6)) == 1 ? ProcessorStatus.set(N) : ProcessorStatus.reset(N);
 	(Operand & (1 << 7)) == 1 ? ProcessorStatus.set(V) : ProcessorStatus.reset(V);
 }
 
 void NMOS6502::Opcode0x25() {
-	u8 Operand = Memory[FetchByte()];
+	u8 Operand = ReadByte(FetchByte());
 	A &= Operand;
 	Cycle();
 	HandleFlags(INSTRUCTION::AND);
@@ -439,7 +517,7 @@ void NMOS6502::Opcode0x25() {
 
 void NMOS6502::Opcode0x26() {
 	u8 ZeroPage = FetchByte();
-	Move(&Memory[ZeroPage], LEFT, true);
+	Move(Modify(ZeroPage), LEFT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROL);
 }
@@ -449,9 +527,9 @@ void NMOS6502::Opcode0x27() {
 }
 
 void NMOS6502::Opcode0x28() {
-	u8 StackP = Memory[SP];
+	u8 StackP = ReadByte(SP);
 	Cycle();
-	Memory[SP] = 0x0;
+	WriteByte(SP, 0x0);
 	Cycle();
 	++SP;
 	ProcessorStatus = std::bitset<6>{StackP};
@@ -477,7 +555,7 @@ void NMOS6502::Opcode0x2B() {
 
 void NMOS6502::Opcode0x2C() {
 	u16 EffectiveAddress = FetchWord();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	(A & Operand) == 0 ? ProcessorStatus.set(Z) : ProcessorStatus.reset(Z);
 	(Operand & (1 << 6)) == 1 ? ProcessorStatus.set(N) : ProcessorStatus.reset(N);
 	(Operand & (1 << 7)) == 1 ? ProcessorStatus.set(V) : ProcessorStatus.reset(V);
@@ -485,14 +563,14 @@ void NMOS6502::Opcode0x2C() {
 
 void NMOS6502::Opcode0x2D() {
 	u16 EffectiveAddress = FetchWord();
-	A &= Memory[EffectiveAddress];
+	A &= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::AND);
 }
 
 void NMOS6502::Opcode0x2E() {
 	u16 EffectiveAddress = FetchWord();
-	Move(&Memory[EffectiveAddress], LEFT, true);
+	Move(Modify(EffectiveAddress), LEFT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROL);
 }
@@ -513,7 +591,7 @@ void NMOS6502::Opcode0x30() {
 
 void NMOS6502::Opcode0x31() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	A &= Memory[EffectiveAddress];
+	A &= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::AND);
 }
@@ -532,7 +610,7 @@ void NMOS6502::Opcode0x34() {
 
 void NMOS6502::Opcode0x35() {
 	u16 EffectiveAddress = GetZeroPageX();
-	A &= Memory[EffectiveAddress];
+	A &= ReadByte(EffectiveAddress);
 	HandleFlags(INSTRUCTION::AND);
 }
 
@@ -540,7 +618,7 @@ void NMOS6502::Opcode0x36() {
 	u8 BaseAddress = FetchByte();
 	u8 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], LEFT, true);
+	Move(Modify(EffectiveAddress), LEFT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROL);
 }
@@ -557,7 +635,7 @@ void NMOS6502::Opcode0x38() {
 
 void NMOS6502::Opcode0x39() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	A &= Memory[EffectiveAddress];
+	A &= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::AND);
 }
@@ -576,7 +654,7 @@ void NMOS6502::Opcode0x3C() {
 
 void NMOS6502::Opcode0x3D() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	A &= Memory[EffectiveAddress];
+	A &= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::AND);
 }
@@ -585,7 +663,7 @@ void NMOS6502::Opcode0x3E() {
 	u16 BaseAddress = FetchWord();
 	u16 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], LEFT, true);
+	Move(Modify(EffectiveAddress), LEFT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROL);
 }
@@ -595,15 +673,15 @@ void NMOS6502::Opcode0x3F() {
 }
 
 void NMOS6502::Opcode0x40() {
-	ProcessorStatus = Memory[SP];
+	ProcessorStatus = ReadByte(SP);
 	++SP;
-	PC = Memory[static_cast<uint16_t>(SP + 1)] << 8 + Memory[SP];
+	PC = ReadByte(static_cast<uint16_t>(SP + 1)) << 8 + ReadByte(SP);
 	SP += 2;
 }
 
 void NMOS6502::Opcode0x41() {
 	u16 EffectiveAddress = GetIndirectX();
-	A ^= Memory[EffectiveAddress];
+	A ^= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
@@ -622,14 +700,14 @@ void NMOS6502::Opcode0x44() {
 
 void NMOS6502::Opcode0x45() {
 	u8 ZeroPage = FetchByte();
-	A ^= Memory[ZeroPage];
+	A ^= ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
 
 void NMOS6502::Opcode0x46() {
 	u8 ZeroPage = FetchByte();
-	Move(&Memory[ZeroPage], RIGHT, false);
+	Move(Modify(ZeroPage), RIGHT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::LSR);
 }
@@ -641,7 +719,7 @@ void NMOS6502::Opcode0x47() {
 void NMOS6502::Opcode0x48() {
 	u8 Accumulator = A;
 	Cycle();
-	Memory[SP] = Accumulator;
+	WriteByte(SP, Accumulator);
 	Cycle();
 	--SP;
 	HandleFlags(INSTRUCTION::PHA);
@@ -665,23 +743,23 @@ void NMOS6502::Opcode0x4B() {
 }
 
 void NMOS6502::Opcode0x4C() {
-	u16 Low = Memory[PC];
+	u16 Low = ReadCode(PC);
 	Cycle();
-	u16 High = Memory[static_cast<u16>(PC + 1)];
+	u16 High = ReadCode(static_cast<u16>(PC + 1));
 	Cycle();
 	PC = High << 8 | Low;
 }
 
 void NMOS6502::Opcode0x4D() {
 	u16 EffectiveAddress = FetchWord();
-	A ^= Memory[EffectiveAddress];
+	A ^= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
 
 void NMOS6502::Opcode0x4E() {
 	u16 EffectiveAddress = FetchWord();
-	Move(&Memory[EffectiveAddress], RIGHT, false);
+	Move(Modify(EffectiveAddress), RIGHT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::LSR);
 }
@@ -702,7 +780,7 @@ void NMOS6502::Opcode0x50() {
 
 void NMOS6502::Opcode0x51() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	A ^= Memory[EffectiveAddress];
+	A ^= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
@@ -721,7 +799,7 @@ void NMOS6502::Opcode0x54() {
 
 void NMOS6502::Opcode0x55() {
 	u8 ZeroPage = GetZeroPageX();
-	A ^= Memory[ZeroPage];
+	A ^= ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
@@ -730,7 +808,7 @@ void NMOS6502::Opcode0x56() {
 	u8 BaseAddress = FetchByte();
 	u8 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], RIGHT, false);
+	Move(Modify(EffectiveAddress), RIGHT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::LSR);
 }
@@ -747,7 +825,7 @@ void NMOS6502::Opcode0x58() {
 
 void NMOS6502::Opcode0x59() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	A ^= Memory[EffectiveAddress];
+	A ^= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
@@ -766,7 +844,7 @@ void NMOS6502::Opcode0x5C() {
 
 void NMOS6502::Opcode0x5D() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	A ^= Memory[EffectiveAddress];
+	A ^= ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::EOR);
 }
@@ -775,7 +853,7 @@ void NMOS6502::Opcode0x5E() {
 	u16 BaseAddress = FetchWord();
 	u16 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], RIGHT, false);
+	Move(Modify(EffectiveAddress), RIGHT, false);
 	Cycle();
 	HandleFlags(INSTRUCTION::LSR);
 }
@@ -785,10 +863,10 @@ void NMOS6502::Opcode0x5F() {
 }
 
 void NMOS6502::Opcode0x60() {
-	u8 PCReturnLow = Memory[SP + 1];
+	u8 PCReturnLow = ReadByte(SP + 1);
 	Cycle();
 	++SP;
-	u8 PCReturnHigh = Memory[SP + 1];
+	u8 PCReturnHigh = ReadByte(SP + 1);
 	Cycle();
 	++SP;
 	Cycle();
@@ -798,7 +876,7 @@ void NMOS6502::Opcode0x60() {
 
 void NMOS6502::Opcode0x61() {
 	u16 EffectiveAddress = GetIndirectX();
-	PerformArithmetic(Memory[EffectiveAddress]);
+	PerformArithmetic(ReadByte(EffectiveAddress));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
@@ -817,14 +895,14 @@ void NMOS6502::Opcode0x64() {
 
 void NMOS6502::Opcode0x65() {
 	u8 ZeroPage = FetchByte();
-	PerformArithmetic(Memory[ZeroPage]);
+	PerformArithmetic(ReadByte(ZeroPage));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
 
 void NMOS6502::Opcode0x66() {
 	u8 ZeroPage = FetchByte();
-	Move(&Memory[ZeroPage], RIGHT, true);
+	Move(Modify(ZeroPage), RIGHT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROR);
 }
@@ -834,9 +912,9 @@ void NMOS6502::Opcode0x67() {
 }
 
 void NMOS6502::Opcode0x68() {
-	u8 StackA = Memory[SP];
+	u8 StackA = ReadByte(SP);
 	Cycle();
-	Memory[SP] = 0x0;
+	WriteByte(SP, 0x0);
 	Cycle();
 	++SP;
 	A = StackA;
@@ -862,28 +940,28 @@ void NMOS6502::Opcode0x6B() {
 }
 
 void NMOS6502::Opcode0x6C() {
-	u16 Low = Memory[PC];
+	u16 Low = ReadCode(PC);
 	Cycle();
-	u16 High = Memory[PC + 1];
+	u16 High = ReadCode(PC + 1);
 	Cycle();
 	u16 BaseAddress = High << 8 | Low;
-	u16 EffectiveAddressLow = Memory[BaseAddress];
+	u16 EffectiveAddressLow = ReadByte(BaseAddress);
 	Cycle();
-	u16 EffectiveAddressHigh = Memory[static_cast<u16>(BaseAddress + 1)];
+	u16 EffectiveAddressHigh = ReadByte(static_cast<u16>(BaseAddress + 1));
 	Cycle();
 	PC = EffectiveAddressLow << 8 | EffectiveAddressHigh;
 }
 
 void NMOS6502::Opcode0x6D() {
 	u16 EffectiveAddress = FetchWord();
-	PerformArithmetic(Memory[EffectiveAddress]);
+	PerformArithmetic(ReadByte(EffectiveAddress));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
 
 void NMOS6502::Opcode0x6E() {
 	u16 EffectiveAddress = FetchWord();
-	Move(&Memory[EffectiveAddress], RIGHT, true);
+	Move(Modify(EffectiveAddress), RIGHT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROR);
 }
@@ -904,7 +982,7 @@ void NMOS6502::Opcode0x70() {
 
 void NMOS6502::Opcode0x71() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	PerformArithmetic(Memory[EffectiveAddress]);
+	PerformArithmetic(ReadByte(EffectiveAddress));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
@@ -925,7 +1003,7 @@ void NMOS6502::Opcode0x75() {
 	u8 ZeroPage = FetchByte();
 	u8 EffectiveAddress = ZeroPage + X;
 	Cycle();
-	PerformArithmetic(Memory[EffectiveAddress]);
+	PerformArithmetic(ReadByte(EffectiveAddress));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
@@ -934,7 +1012,7 @@ void NMOS6502::Opcode0x76() {
 	u8 BaseAddress = FetchByte();
 	u8 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], RIGHT, true);
+	Move(Modify(EffectiveAddress), RIGHT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROR);
 }
@@ -951,7 +1029,7 @@ void NMOS6502::Opcode0x78() {
 
 void NMOS6502::Opcode0x79() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	PerformArithmetic(Memory[EffectiveAddress]);
+	PerformArithmetic(ReadByte(EffectiveAddress));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
@@ -970,7 +1048,7 @@ void NMOS6502::Opcode0x7C() {
 
 void NMOS6502::Opcode0x7D() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	PerformArithmetic(Memory[EffectiveAddress]);
+	PerformArithmetic(ReadByte(EffectiveAddress));
 	Cycle();
 	HandleFlags(INSTRUCTION::ADC);
 }
@@ -979,7 +1057,7 @@ void NMOS6502::Opcode0x7E() {
 	u16 BaseAddress = FetchWord();
 	u16 EffectiveAddress = BaseAddress + X;
 	Cycle();
-	Move(&Memory[EffectiveAddress], RIGHT, true);
+	Move(Modify(EffectiveAddress), RIGHT, true);
 	Cycle();
 	HandleFlags(INSTRUCTION::ROR);
 }
@@ -995,7 +1073,7 @@ void NMOS6502::Opcode0x80() {
 void NMOS6502::Opcode0x81() {
 	u16 EffectiveAddress = GetIndirectX();
 	Cycle();
-	Memory[EffectiveAddress] = A;
+	WriteByte(EffectiveAddress, A);
 	HandleFlags(INSTRUCTION::STA);
 }
 
@@ -1010,21 +1088,21 @@ void NMOS6502::Opcode0x83() {
 void NMOS6502::Opcode0x84() {
 	u8 ZeroPage = FetchByte();
 	Cycle();
-	Memory[ZeroPage] = Y;
+	WriteByte(ZeroPage, Y);
 	HandleFlags(INSTRUCTION::STY);
 }
 
 void NMOS6502::Opcode0x85() {
 	u8 ZeroPage = FetchByte();
 	Cycle();
-	Memory[ZeroPage] = A;
+	WriteByte(ZeroPage, A);
 	HandleFlags(INSTRUCTION::STA);
 }
 
 void NMOS6502::Opcode0x86() {
 	u8 ZeroPage = FetchByte();
 	Cycle();
-	Memory[ZeroPage] = X;
+	WriteByte(ZeroPage, X);
 	HandleFlags(INSTRUCTION::STX);
 }
 
@@ -1054,21 +1132,21 @@ void NMOS6502::Opcode0x8B() {
 
 void NMOS6502::Opcode0x8C() {
 	u16 EffectiveAddress = FetchWord();
-	Memory[EffectiveAddress] = Y;
+	WriteByte(EffectiveAddress, Y);
 	Cycle();
 	HandleFlags(INSTRUCTION::STY);
 }
 
 void NMOS6502::Opcode0x8D() {
 	u16 EffectiveAddress = FetchWord();
-	Memory[EffectiveAddress] = A;
+	WriteByte(EffectiveAddress, A);
 	Cycle();
 	HandleFlags(INSTRUCTION::STA);
 }
 
 void NMOS6502::Opcode0x8E() {
 	u16 EffectiveAddress = FetchWord();
-	Memory[EffectiveAddress] = X;
+	WriteByte(EffectiveAddress, X);
 	Cycle();
 	HandleFlags(INSTRUCTION::STX);
 }
@@ -1090,7 +1168,7 @@ void NMOS6502::Opcode0x90() {
 void NMOS6502::Opcode0x91() {
 	u16 EffectiveAddress = GetIndirectY();
 	Cycle();
-	Memory[EffectiveAddress] = A;
+	WriteByte(EffectiveAddress, A);
 	Cycle();
 	HandleFlags(INSTRUCTION::STA);
 }
@@ -1106,7 +1184,7 @@ void NMOS6502::Opcode0x93() {
 void NMOS6502::Opcode0x94() {
 	u8 ZeroPage = FetchByte();
 	Cycle();
-	Memory[static_cast<u16>(ZeroPage + X)] = Y;
+	WriteByte(static_cast<u16>(ZeroPage + X), Y);
 	Cycle();
 	HandleFlags(INSTRUCTION::STY);
 }
@@ -1114,7 +1192,7 @@ void NMOS6502::Opcode0x94() {
 void NMOS6502::Opcode0x95() {
 	u8 ZeroPage = FetchByte();
 	Cycle();
-	Memory[static_cast<u16>(ZeroPage + X)] = A;
+	WriteByte(static_cast<u16>(ZeroPage + X), A);
 	Cycle();
 	HandleFlags(INSTRUCTION::STA);
 }
@@ -1122,7 +1200,7 @@ void NMOS6502::Opcode0x95() {
 void NMOS6502::Opcode0x96() {
 	u8 ZeroPage = FetchByte();
 	Cycle();
-	Memory[static_cast<u16>(ZeroPage + Y)] = X;
+	WriteByte(static_cast<u16>(ZeroPage + Y), X);
 	Cycle();
 	HandleFlags(INSTRUCTION::STX);
 }
@@ -1140,7 +1218,7 @@ void NMOS6502::Opcode0x98() {
 void NMOS6502::Opcode0x99() {
 	u16 EffectiveAddress = GetAbsoluteY();
 	Cycle();
-	Memory[EffectiveAddress] = A;
+	WriteByte(EffectiveAddress, A);
 	Cycle();
 	HandleFlags(INSTRUCTION::STA);
 }
@@ -1162,7 +1240,7 @@ void NMOS6502::Opcode0x9C() {
 void NMOS6502::Opcode0x9D() {
 	u16 EffectiveAddress = GetAbsoluteX();
 	Cycle();
-	Memory[EffectiveAddress] = A;
+	WriteByte(EffectiveAddress, A);
 	Cycle();
 	HandleFlags(INSTRUCTION::STA);
 }
@@ -1183,7 +1261,7 @@ void NMOS6502::Opcode0xA0() {
 
 void NMOS6502::Opcode0xA1() {
 	u16 EffectiveAddress = GetIndirectX();
-	A = Memory[EffectiveAddress];
+	A = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
@@ -1200,21 +1278,21 @@ void NMOS6502::Opcode0xA3() {
 
 void NMOS6502::Opcode0xA4() {
 	u8 ZeroPage = FetchByte();
-	Y = Memory[ZeroPage];
+	Y = ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDY);
 }
 
 void NMOS6502::Opcode0xA5() {
 	u8 ZeroPage = FetchByte();
-	A = Memory[ZeroPage];
+	A = ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
 
 void NMOS6502::Opcode0xA6() {
 	u8 ZeroPage = FetchByte();
-	X = Memory[ZeroPage];
+	X = ReadByte(ZeroPage);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDX);
 }
@@ -1247,21 +1325,21 @@ void NMOS6502::Opcode0xAB() {
 
 void NMOS6502::Opcode0xAC() {
 	u16 EffectiveAddress = FetchWord();
-	Y = Memory[EffectiveAddress];
+	Y = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDY);
 }
 
 void NMOS6502::Opcode0xAD() {
 	u16 EffectiveAddress = FetchWord();
-	A = Memory[EffectiveAddress];
+	A = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
 
 void NMOS6502::Opcode0xAE() {
 	u16 EffectiveAddress = FetchWord();
-	X = Memory[EffectiveAddress];
+	X = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDX);
 }
@@ -1282,7 +1360,7 @@ void NMOS6502::Opcode0xB0() {
 
 void NMOS6502::Opcode0xB1() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	A = Memory[EffectiveAddress];
+	A = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
@@ -1297,21 +1375,21 @@ void NMOS6502::Opcode0xB3() {
 
 void NMOS6502::Opcode0xB4() {
 	u8 EffectiveAddress = GetZeroPageX();
-	Y = Memory[EffectiveAddress];
+	Y = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDY);
 }
 
 void NMOS6502::Opcode0xB5() {
 	u8 EffectiveAddress = GetZeroPageX();
-	A = Memory[EffectiveAddress];
+	A = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
 
 void NMOS6502::Opcode0xB6() {
 	u8 EffectiveAddress = GetZeroPageY();
-	X = Memory[EffectiveAddress];
+	X = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDX);
 }
@@ -1328,7 +1406,7 @@ void NMOS6502::Opcode0xB8() {
 
 void NMOS6502::Opcode0xB9() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	A = Memory[EffectiveAddress];
+	A = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
@@ -1345,21 +1423,21 @@ void NMOS6502::Opcode0xBB() {
 
 void NMOS6502::Opcode0xBC() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	Y = Memory[EffectiveAddress];
+	Y = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDY);
 }
 
 void NMOS6502::Opcode0xBD() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	A = Memory[EffectiveAddress];
+	A = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDA);
 }
 
 void NMOS6502::Opcode0xBE() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	X = Memory[EffectiveAddress];
+	X = ReadByte(EffectiveAddress);
 	Cycle();
 	HandleFlags(INSTRUCTION::LDX);
 }
@@ -1375,7 +1453,7 @@ void NMOS6502::Opcode0xC0() {
 
 void NMOS6502::Opcode0xC1() {
 	u16 EffectiveAddress = GetIndirectX();
-	Compare(&A, Memory[EffectiveAddress]);
+	Compare(&A, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
@@ -1389,23 +1467,23 @@ void NMOS6502::Opcode0xC3() {
 
 void NMOS6502::Opcode0xC4() {
 	u8 ZeroPage = FetchByte();
-	Compare(&Y, Memory[ZeroPage]);
+	Compare(&Y, ReadByte(ZeroPage));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xC5() {
 	u8 ZeroPage = FetchByte();
-	Compare(&A, Memory[ZeroPage]);
+	Compare(&A, ReadByte(ZeroPage));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xC6() {
 	u8 ZeroPage = FetchByte();
-	u8 Operand = Memory[ZeroPage];
+	u8 Operand = ReadByte(ZeroPage);
 	Cycle();
 	Operand -= 1;
 	Cycle();
-	Memory[ZeroPage] = Operand;
+	WriteByte(ZeroPage, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::DEC);
 }
@@ -1437,23 +1515,23 @@ void NMOS6502::Opcode0xCB() {
 
 void NMOS6502::Opcode0xCC() {
 	u16 EffectiveAddress = FetchWord();
-	Compare(&Y, Memory[EffectiveAddress]);
+	Compare(&Y, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xCD() {
 	u16 EffectiveAddress = FetchWord();
-	Compare(&A, Memory[EffectiveAddress]);
+	Compare(&A, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xCE() {
 	u16 EffectiveAddress = FetchWord();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	Cycle();
 	Operand -= 1;
 	Cycle();
-	Memory[EffectiveAddress] = Operand;
+	WriteByte(EffectiveAddress, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::DEC);
 }
@@ -1474,7 +1552,7 @@ void NMOS6502::Opcode0xD0() {
 
 void NMOS6502::Opcode0xD1() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	Compare(&A, Memory[EffectiveAddress]);
+	Compare(&A, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
@@ -1494,17 +1572,17 @@ void NMOS6502::Opcode0xD5() {
 	u8 ZeroPage = FetchByte();
 	ZeroPage += X;
 	Cycle();
-	Compare(&A, Memory[ZeroPage]);
+	Compare(&A, ReadByte(ZeroPage));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xD6() {
 	u8 EffectiveAddress = GetZeroPageX();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	Cycle();
 	Operand -= 1;
 	Cycle();
-	Memory[EffectiveAddress] = Operand;
+	WriteByte(EffectiveAddress, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::DEC);
 }
@@ -1521,7 +1599,7 @@ void NMOS6502::Opcode0xD8() {
 
 void NMOS6502::Opcode0xD9() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	Compare(&A, Memory[EffectiveAddress]);
+	Compare(&A, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
@@ -1539,18 +1617,18 @@ void NMOS6502::Opcode0xDC() {
 
 void NMOS6502::Opcode0xDD() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	Compare(&A, Memory[EffectiveAddress]);
+	Compare(&A, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xDE() {
 	u16 EffectiveAddress = GetAbsoluteX();
 	Cycle();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	Cycle();
 	Operand -= 1;
 	Cycle();
-	Memory[EffectiveAddress] = Operand;
+	WriteByte(EffectiveAddress, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::DEC);
 }
@@ -1566,7 +1644,7 @@ void NMOS6502::Opcode0xE0() {
 
 void NMOS6502::Opcode0xE1() {
 	u16 EffectiveAddress = GetIndirectX();
-	PerformArithmetic(~Memory[EffectiveAddress], true);
+	PerformArithmetic(~ReadByte(EffectiveAddress), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
@@ -1581,24 +1659,24 @@ void NMOS6502::Opcode0xE3() {
 
 void NMOS6502::Opcode0xE4() {
 	u8 ZeroPage = FetchByte();
-	Compare(&X, Memory[ZeroPage]);
+	Compare(&X, ReadByte(ZeroPage));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xE5() {
 	u8 ZeroPage = FetchByte();
-	PerformArithmetic(~Memory[ZeroPage], true);
+	PerformArithmetic(~ReadByte(ZeroPage), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
 
 void NMOS6502::Opcode0xE6() {
 	u8 ZeroPage = FetchByte();
-	u8 Operand = Memory[ZeroPage];
+	u8 Operand = ReadByte(ZeroPage);
 	Cycle();
 	Operand += 1;
 	Cycle();
-	Memory[ZeroPage] = Operand;
+	WriteByte(ZeroPage, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::INC);
 }
@@ -1629,24 +1707,24 @@ void NMOS6502::Opcode0xEB() {
 
 void NMOS6502::Opcode0xEC() {
 	u16 EffectiveAddress = FetchWord();
-	Compare(&X, Memory[EffectiveAddress]);
+	Compare(&X, ReadByte(EffectiveAddress));
 	Cycle();
 }
 
 void NMOS6502::Opcode0xED() {
 	u16 EffectiveAddress = FetchWord();
-	PerformArithmetic(~Memory[EffectiveAddress], true);
+	PerformArithmetic(~ReadByte(EffectiveAddress), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
 
 void NMOS6502::Opcode0xEE() {
 	u16 EffectiveAddress = FetchWord();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	Cycle();
 	Operand += 1;
 	Cycle();
-	Memory[EffectiveAddress] = Operand;
+	WriteByte(EffectiveAddress, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::INC);
 }
@@ -1667,7 +1745,7 @@ void NMOS6502::Opcode0xF0() {
 
 void NMOS6502::Opcode0xF1() {
 	u16 EffectiveAddress = GetIndirectY(true);
-	PerformArithmetic(~Memory[EffectiveAddress], true);
+	PerformArithmetic(~ReadByte(EffectiveAddress), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
@@ -1688,18 +1766,18 @@ void NMOS6502::Opcode0xF5() {
 	u8 ZeroPage = FetchByte();
 	u8 EffectiveAddress = ZeroPage + X;
 	Cycle();
-	PerformArithmetic(~Memory[EffectiveAddress], true);
+	PerformArithmetic(~ReadByte(EffectiveAddress), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
 
 void NMOS6502::Opcode0xF6() {
 	u8 EffectiveAddress = GetZeroPageX();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	Cycle();
 	Operand += 1;
 	Cycle();
-	Memory[EffectiveAddress] = Operand;
+	WriteByte(EffectiveAddress, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::INC);
 }
@@ -1716,7 +1794,7 @@ void NMOS6502::Opcode0xF8() {
 
 void NMOS6502::Opcode0xF9() {
 	u16 EffectiveAddress = GetAbsoluteY(true);
-	PerformArithmetic(~Memory[EffectiveAddress], true);
+	PerformArithmetic(~ReadByte(EffectiveAddress), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
@@ -1735,7 +1813,7 @@ void NMOS6502::Opcode0xFC() {
 
 void NMOS6502::Opcode0xFD() {
 	u16 EffectiveAddress = GetAbsoluteX(true);
-	PerformArithmetic(~Memory[EffectiveAddress], true);
+	PerformArithmetic(~ReadByte(EffectiveAddress), true);
 	Cycle();
 	HandleFlags(INSTRUCTION::SBC);
 }
@@ -1743,11 +1821,11 @@ void NMOS6502::Opcode0xFD() {
 void NMOS6502::Opcode0xFE() {
 	u16 EffectiveAddress = GetAbsoluteX();
 	Cycle();
-	u8 Operand = Memory[EffectiveAddress];
+	u8 Operand = ReadByte(EffectiveAddress);
 	Cycle();
 	Operand += 1;
 	Cycle();
-	Memory[EffectiveAddress] = Operand;
+	WriteByte(EffectiveAddress, Operand);
 	Cycle();
 	HandleFlags(INSTRUCTION::INC);
 }
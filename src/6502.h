@@ -4,10 +4,22 @@
 #include <vector>
 #include <algorithm>
 #include <bitset>
+#include <cmath>
 
 using u8 = uint8_t;
 using u16 = uint16_t;
 using u32 = uint32_t;
+using u64 = uint64_t;
+
+#ifdef NMOS6502_INSTRUMENTATION
+#include "opcode_stats.h"
+#include "memory_heatmap.h"
+#include "dirty_pages.h"
+#include "watchpoints.h"
+class Profiler;
+class CallGraphProfiler;
+class TraceWriter;
+#endif
 
 class NMOS6502 {
 public:
@@ -51,6 +63,16 @@ public:
 	void Reset();
 	int Execute(u32 CyclesRequired);
 	void Cycle();
+
+#ifdef NMOS6502_INSTRUMENTATION
+	OpcodeStats Stats;
+	Profiler* PCProfiler = nullptr; // Optional, fed with the address and cycles of every instruction
+	CallGraphProfiler* CallProfiler = nullptr; // Optional, follows JSR/RTS and interrupts
+	TraceWriter* Tracer = nullptr; // Optional, records the state before every instruction
+	MemoryHeatmap* Heatmap = nullptr; // Optional, counts reads, writes and executes per address
+	DirtyPageMap* DirtyPages = nullptr; // Optional, marks the pages written
+	WatchpointMap* Watchpoints = nullptr; // Optional, records data accesses to watched addresses
+#endif
 	
 	template <typename T>
 	void PrintHex(T t) {
@@ -60,6 +82,60 @@ public:
 	u8 FetchByte();
 	u16 FetchWord();
 
+	/* Every data access of the instructions goes through these, Modify for read-modify-write operands */
+	u8 ReadByte(u16 Address) {
+#ifdef NMOS6502_INSTRUMENTATION
+		if (Heatmap) {
+			Heatmap->Read(Address);
+		}
+		if (Watchpoints && Watchpoints->Watched(Address, WatchRead)) {
+			Watchpoints->Read(Address, Memory[Address]);
+		}
+#endif
+		return Memory[Address];
+	}
+
+	/* Instruction stream bytes read without advancing PC */
+	u8 ReadCode(u16 Address) {
+#ifdef NMOS6502_INSTRUMENTATION
+		if (Heatmap) {
+			Heatmap->Execute(Address);
+		}
+#endif
+		return Memory[Address];
+	}
+
+	void WriteByte(u16 Address, u8 Value) {
+#ifdef NMOS6502_INSTRUMENTATION
+		if (Heatmap) {
+			Heatmap->Write(Address);
+		}
+		if (DirtyPages) {
+			DirtyPages->Mark(Address);
+		}
+		if (Watchpoints && Watchpoints->Watched(Address, WatchWrite)) {
+			Watchpoints->Write(Address, Memory[Address], Value);
+		}
+#endif
+		Memory[Address] = Value;
+	}
+
+	u8* Modify(u16 Address) {
+#ifdef NMOS6502_INSTRUMENTATION
+		if (Heatmap) {
+			Heatmap->Read(Address);
+			Heatmap->Write(Address);
+		}
+		if (DirtyPages) {
+			DirtyPages->Mark(Address);
+		}
+		if (Watchpoints && Watchpoints->Watched(Address, WatchAccess)) {
+			Watchpoints->Modify(Address, Memory[Address]);
+		}
+#endif
+		return &Memory[Address];
+	}
+
 	u16 GetIndirectX();
 	u16 GetIndirectY(bool CheckBoundary = false);
 	u16 GetAbsoluteX(bool CheckBoundary = false);
@@ -0,0 +1,599 @@
+#pragma once
+#include <array>
+#include <string_view>
+#include <vector>
+#include "6502.h"
+#include "opcodes.h"
+
+/*
+	A small 6502 assembler that runs at compile time, so tests and benchmarks can embed programs
+	as source and get the bytes with no assembly at run time:
+
+		constexpr auto Program = R"(
+				.org $0200
+			SRC = $10
+				LDX #$08
+			loop:
+				STA SRC,X
+				DEX
+				BNE loop
+			done:
+				JMP done
+		)"_6502;
+
+	Program is a std::array<u8, N>; Assembled<"...">::Label("done") gives a label's address.
+
+	Syntax: one statement per line, "; comments", "label:" before a statement or alone, "NAME = value"
+	equates, ".org value" before the first byte (default $0200) and ".byte value, ...". Operands
+	take the standard forms (#imm, zp, zp,X, abs,Y, (ind), (zp,X), (zp),Y, A) and expressions of
+	one symbol plus or minus numbers ($hex, 0xhex, %binary, decimal). Numbers and equates that fit
+	in a byte select zero page addressing; labels always take the absolute form.
+
+	The bytes are in this core's dialect, like the programs in bench/workloads.h: absolute data
+	operands are stored high byte first while JMP keeps the low byte first; JSR is emitted as
+	20 2C ll hh so the return to opcode + 1 runs a harmless BIT abs; branch offsets are relative
+	to the opcode, and branches are padded with empty opcodes ($02), before a backward branch or
+	after a forward one, until their offset byte is itself an empty opcode, as falling through
+	executes it.
+*/
+
+enum AssemblySymbolKind : u8 { SymbolUndefined, SymbolLabel, SymbolEquate };
+
+struct AssemblySymbol {
+	std::string_view Name;
+	AssemblySymbolKind Kind = SymbolUndefined;
+	int Value = 0; // Address of a label once assembled, or the equate
+	int Item = 0; // Statement a label is bound to
+};
+
+struct Assembly {
+	std::vector<u8> Bytes;
+	std::vector<AssemblySymbol> Symbols;
+	u16 Origin = 0x0200;
+	const char* Error = nullptr; // With the 1-based Line it comes from, when the source does not assemble
+	int Line = 0;
+
+	/* Address of a label or value of an equate, -1 if there is no such symbol */
+	constexpr int Label(std::string_view Name) const {
+		for (const AssemblySymbol& Symbol : Symbols) {
+			if (Symbol.Name == Name && Symbol.Kind != SymbolUndefined) {
+				return Symbol.Value;
+			}
+		}
+		return -1;
+	}
+};
+
+inline constexpr u8 AssemblyPadding = 0x02;
+
+/* Whether the core runs Opcode as a one-byte no-op, so it is safe as a fall-through offset byte */
+constexpr bool EmptyOpcode(u8 Opcode) {
+	return OpcodeTable[Opcode].Mnemonic[0] == '?';
+}
+
+class Assembler {
+public:
+	constexpr explicit Assembler(std::string_view Source) : Source(Source) {}
+
+	constexpr Assembly Run() {
+		int Number = 0;
+		for (size_t Start = 0; Start <= Source.size() && !Result.Error;) {
+			size_t End = Source.find('\n', Start);
+			End = End == std::string_view::npos ? Source.size() : End;
+			Line = ++Number;
+			Statement(Source.substr(Start, End - Start));
+			Start = End + 1;
+		}
+		if (!Result.Error) {
+			Layout();
+		}
+		if (!Result.Error) {
+			Encode();
+		}
+		Result.Symbols = Symbols;
+		return Result;
+	}
+
+private:
+	struct Operand {
+		int Symbol = -1;
+		int Value = 0;
+	};
+
+	struct Item {
+		bool Data = false;
+		u8 Opcode = 0;
+		Operand Argument;
+		int PadBefore = 0;
+		int PadAfter = 0;
+		int Line = 0;
+	};
+
+	std::string_view Source;
+	std::vector<Item> Items;
+	std::vector<AssemblySymbol> Symbols;
+	std::vector<int> Addresses; // Of each item, including its padding before, then of the end
+	Assembly Result;
+	int Line = 0;
+
+	static constexpr bool IsSpace(char C) {
+		return C == ' ' || C == '\t' || C == '\r';
+	}
+
+	static constexpr bool IsIdentifier(char C, bool First) {
+		return (C >= 'A' && C <= 'Z') || (C >= 'a' && C <= 'z') || C == '_' || (!First && C >= '0' && C <= '9');
+	}
+
+	static constexpr char Upper(char C) {
+		return C >= 'a' && C <= 'z' ? static_cast<char>(C - 'a' + 'A') : C;
+	}
+
+	static constexpr std::string_view Trim(std::string_view Text) {
+		while (!Text.empty() && IsSpace(Text.front())) {
+			Text.remove_prefix(1);
+		}
+		while (!Text.empty() && IsSpace(Text.back())) {
+			Text.remove_suffix(1);
+		}
+		return Text;
+	}
+
+	static constexpr bool Matches(std::string_view Text, std::string_view Word) {
+		if (Text.size() != Word.size()) {
+			return false;
+		}
+		for (size_t i = 0; i < Text.size(); ++i) {
+			if (Upper(Text[i]) != Word[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static constexpr size_t IdentifierLength(std::string_view Text) {
+		size_t Length = 0;
+		while (Length < Text.size() && IsIdentifier(Text[Length], Length == 0)) {
+			++Length;
+		}
+		return Length;
+	}
+
+	static constexpr int FindOpcode(std::string_view Mnemonic, AddressingMode Mode) {
+		for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+			if (OpcodeTable[Opcode].Mode == Mode && Matches(Mnemonic, OpcodeTable[Opcode].Mnemonic)) {
+				return Opcode;
+			}
+		}
+		return -1;
+	}
+
+	static constexpr int Length(const Item& Statement) {
+		return Statement.Data ? 1 : DialectLength(Statement.Opcode);
+	}
+
+	constexpr bool Fail(const char* Error, int At = 0) {
+		if (!Result.Error) {
+			Result.Error = Error;
+			Result.Line = At ? At : Line;
+		}
+		return false;
+	}
+
+	constexpr int Symbol(std::string_view Name) {
+		for (size_t i = 0; i < Symbols.size(); ++i) {
+			if (Symbols[i].Name == Name) {
+				return static_cast<int>(i);
+			}
+		}
+		Symbols.push_back({ Name });
+		return static_cast<int>(Symbols.size() - 1);
+	}
+
+	constexpr bool Define(std::string_view Name, AssemblySymbolKind Kind, int Value) {
+		int Index = Symbol(Name);
+		if (Symbols[Index].Kind != SymbolUndefined) {
+			return Fail("symbol defined twice");
+		}
+		if (Kind == SymbolEquate && Index != static_cast<int>(Symbols.size() - 1)) {
+			return Fail("equate used before it is defined");
+		}
+		Symbols[Index].Kind = Kind;
+		(Kind == SymbolLabel ? Symbols[Index].Item : Symbols[Index].Value) = Value;
+		return true;
+	}
+
+	constexpr bool Number(std::string_view& Text, int& Value) {
+		int Base = 10;
+		if (Text.front() == '$') {
+			Base = 16;
+			Text.remove_prefix(1);
+		}
+		else if (Text.size() > 1 && Text[0] == '0' && (Text[1] == 'x' || Text[1] == 'X')) {
+			Base = 16;
+			Text.remove_prefix(2);
+		}
+		else if (Text.front() == '%') {
+			Base = 2;
+			Text.remove_prefix(1);
+		}
+		int Digits = 0;
+		Value = 0;
+		for (; !Text.empty(); Text.remove_prefix(1), ++Digits) {
+			char C = Upper(Text.front());
+			int Digit = C >= '0' && C <= '9' ? C - '0' : C >= 'A' && C <= 'F' ? C - 'A' + 10 : 99;
+			if (Digit >= Base) {
+				break;
+			}
+			Value = Value * Base + Digit;
+			if (Value > 0xFFFF) {
+				return Fail("number out of range");
+			}
+		}
+		return Digits > 0 || Fail("bad number");
+	}
+
+	/* One symbol plus or minus numbers, with equates folded into the value */
+	constexpr bool Expression(std::string_view Text, Operand& Parsed) {
+		Parsed = {};
+		Text = Trim(Text);
+		int Sign = 1;
+		bool Term = true;
+		while (!Text.empty()) {
+			if (!Term) {
+				if (Text.front() != '+' && Text.front() != '-') {
+					return Fail("unexpected text in expression");
+				}
+				Sign = Text.front() == '-' ? -1 : 1;
+				Text = Trim(Text.substr(1));
+				Term = true;
+				continue;
+			}
+			int Value = 0;
+			if (size_t Length = IdentifierLength(Text)) {
+				int Index = Symbol(Text.substr(0, Length));
+				Text.remove_prefix(Length);
+				if (Symbols[Index].Kind == SymbolEquate) {
+					Value = Symbols[Index].Value;
+				}
+				else if (Sign < 0 || Parsed.Symbol >= 0) {
+					return Fail("an expression takes at most one label, added");
+				}
+				else {
+					Parsed.Symbol = Index;
+				}
+			}
+			else if (!Number(Text, Value)) {
+				return false;
+			}
+			Parsed.Value += Sign * Value;
+			Text = Trim(Text);
+			Term = false;
+		}
+		if (Term) {
+			return Fail("missing operand");
+		}
+		if (Parsed.Symbol < 0 && (Parsed.Value < 0 || Parsed.Value > 0xFFFF)) {
+			return Fail("value out of range");
+		}
+		return true;
+	}
+
+	constexpr bool Constant(std::string_view Text, int& Value) {
+		Operand Argument;
+		if (!Expression(Text, Argument)) {
+			return false;
+		}
+		if (Argument.Symbol >= 0) {
+			return Fail("value must be known before it is used");
+		}
+		Value = Argument.Value;
+		return true;
+	}
+
+	/* Splits "expression,X" into the expression, with Register set to 'X', 'Y' or 0 */
+	static constexpr std::string_view SplitIndex(std::string_view Text, char& Register) {
+		Register = 0;
+		size_t Comma = Text.rfind(',');
+		if (Comma != std::string_view::npos) {
+			std::string_view After = Trim(Text.substr(Comma + 1));
+			if (Matches(After, "X") || Matches(After, "Y")) {
+				Register = Upper(After.front());
+				return Trim(Text.substr(0, Comma));
+			}
+		}
+		return Text;
+	}
+
+	constexpr void Statement(std::string_view Text) {
+		size_t Comment = Text.find(';');
+		Text = Trim(Comment == std::string_view::npos ? Text : Text.substr(0, Comment));
+		size_t Name = IdentifierLength(Text);
+		if (Name && Name < Text.size() && Text[Name] == ':') {
+			if (!Define(Text.substr(0, Name), SymbolLabel, static_cast<int>(Items.size()))) {
+				return;
+			}
+			Text = Trim(Text.substr(Name + 1));
+			Name = IdentifierLength(Text);
+		}
+		if (Text.empty()) {
+			return;
+		}
+		if (Text.front() == '.') {
+			size_t Length = IdentifierLength(Text.substr(1)) + 1;
+			std::string_view Directive = Text.substr(0, Length);
+			std::string_view Arguments = Text.substr(Length);
+			int Value = 0;
+			if (Matches(Directive, ".ORG")) {
+				if (!Items.empty()) {
+					Fail(".org after code");
+				}
+				else if (Constant(Arguments, Value)) {
+					Result.Origin = static_cast<u16>(Value);
+				}
+			}
+			else if (Matches(Directive, ".BYTE")) {
+				for (size_t Comma = 0; Comma != std::string_view::npos && !Result.Error; Arguments = Arguments.substr(Comma + 1)) {
+					Comma = Arguments.find(',');
+					if (Constant(Arguments.substr(0, Comma), Value)) {
+						if (Value > 0xFF) {
+							Fail("byte out of range");
+						}
+						Items.push_back({ true, static_cast<u8>(Value), {}, 0, 0, Line });
+					}
+				}
+			}
+			else {
+				Fail("unknown directive");
+			}
+			return;
+		}
+		std::string_view Rest = Trim(Text.substr(Name));
+		if (Name && !Rest.empty() && Rest.front() == '=') {
+			int Value = 0;
+			if (Constant(Rest.substr(1), Value)) {
+				Define(Text.substr(0, Name), SymbolEquate, Value);
+			}
+			return;
+		}
+		if (Name != 3 || (!Rest.empty() && !IsSpace(Text[3]))) {
+			Fail("expected an instruction");
+			return;
+		}
+		Instruction(Text.substr(0, 3), Rest);
+	}
+
+	constexpr void Instruction(std::string_view Mnemonic, std::string_view Text) {
+		bool Known = false;
+		for (const OpcodeInfo& Info : OpcodeTable) {
+			Known = Known || (Info.Mnemonic[0] != '?' && Matches(Mnemonic, Info.Mnemonic));
+		}
+		if (!Known) {
+			Fail("unknown instruction");
+			return;
+		}
+		Operand Argument;
+		AddressingMode Mode = Implied;
+		AddressingMode Short = Implied; // Zero page form to prefer when the value fits
+		char Register = 0;
+		if (Text.empty()) {
+			Mode = FindOpcode(Mnemonic, Implied) >= 0 ? Implied : Accumulator;
+		}
+		else if (Matches(Text, "A")) {
+			Mode = Accumulator;
+		}
+		else if (Text.front() == '#') {
+			Mode = Immediate;
+			Expression(Text.substr(1), Argument);
+		}
+		else if (Text.front() == '(') {
+			std::string_view Inner = SplitIndex(Text, Register);
+			if (Inner.size() < 2 || Inner.back() != ')') {
+				Fail("bad indirect operand");
+				return;
+			}
+			Inner = Inner.substr(1, Inner.size() - 2);
+			if (Register == 'Y') {
+				Mode = IndirectY;
+			}
+			else if (Register == 0) {
+				Inner = SplitIndex(Inner, Register);
+				Mode = Register == 'X' ? IndirectX : Indirect;
+				if (Register == 'Y') {
+					Fail("bad indirect operand");
+				}
+			}
+			else {
+				Fail("bad indirect operand");
+			}
+			Expression(Inner, Argument);
+		}
+		else {
+			Expression(SplitIndex(Text, Register), Argument);
+			Mode = Register == 'X' ? AbsoluteX : Register == 'Y' ? AbsoluteY : Absolute;
+			Short = Register == 'X' ? ZeroPageX : Register == 'Y' ? ZeroPageY : ZeroPage;
+			if (Register == 0 && FindOpcode(Mnemonic, Relative) >= 0) {
+				Mode = Short = Relative;
+			}
+		}
+		if (Result.Error) {
+			return;
+		}
+		if (Short != Mode && FindOpcode(Mnemonic, Short) >= 0 &&
+			((Argument.Symbol < 0 && Argument.Value <= 0xFF) || FindOpcode(Mnemonic, Mode) < 0)) {
+			Mode = Short;
+		}
+		int Opcode = FindOpcode(Mnemonic, Mode);
+		if (Opcode < 0) {
+			Fail("addressing mode not available for this instruction");
+			return;
+		}
+		Items.push_back({ false, static_cast<u8>(Opcode), Argument, 0, 0, Line });
+	}
+
+	constexpr void Place() {
+		Addresses.assign(Items.size() + 1, Result.Origin);
+		for (size_t i = 0; i < Items.size(); ++i) {
+			Addresses[i + 1] = Addresses[i] + Items[i].PadBefore + Length(Items[i]) + Items[i].PadAfter;
+		}
+	}
+
+	constexpr int Address(const Operand& Argument, int At) {
+		if (Argument.Symbol < 0) {
+			return Argument.Value;
+		}
+		const AssemblySymbol& Target = Symbols[Argument.Symbol];
+		if (Target.Kind != SymbolLabel) {
+			Fail("undefined symbol", At);
+			return 0;
+		}
+		return Addresses[Target.Item] + Argument.Value;
+	}
+
+	/*
+		Gives each branch in turn, the others as they stand, the fewest pads that make its offset byte
+		an empty opcode, and goes round again until nothing moves, which reproduces hand placement.
+		Should that not settle, pads are only allowed to grow from then on, which must.
+	*/
+	constexpr void Layout() {
+		bool Changed = true;
+		for (int Pass = 0; Changed && !Result.Error; ++Pass) {
+			Changed = false;
+			for (size_t i = 0; i < Items.size() && !Result.Error; ++i) {
+				Item& Branch = Items[i];
+				if (Branch.Data || OpcodeTable[Branch.Opcode].Mode != Relative) {
+					continue;
+				}
+				Place();
+				int Target = Branch.Argument.Symbol;
+				bool Forward = Target >= 0 && Symbols[Target].Kind == SymbolLabel && Symbols[Target].Item > static_cast<int>(i);
+				int& Pad = Forward ? Branch.PadAfter : Branch.PadBefore;
+				int Direction = Forward ? 1 : -1;
+				int Unpadded = Address(Branch.Argument, Branch.Line) - (Addresses[i] + Branch.PadBefore) - Direction * Pad;
+				int Fewest = Pass < 32 ? 0 : Pad;
+				auto Offset = [&] { return Unpadded + Direction * Fewest; };
+				while (Offset() >= -128 && Offset() <= 127 && !EmptyOpcode(static_cast<u8>(Offset()))) {
+					++Fewest;
+				}
+				if (Offset() < -128 || Offset() > 127) {
+					Fail("branch out of range", Branch.Line);
+				}
+				else if (Fewest != Pad) {
+					Pad = Fewest;
+					Changed = true;
+				}
+			}
+		}
+		Place();
+		if (!Result.Error && Addresses.back() > 0x10000) {
+			Fail("program runs past $FFFF", Items.back().Line);
+		}
+		for (AssemblySymbol& Symbol : Symbols) {
+			if (Symbol.Kind == SymbolLabel && !Result.Error) {
+				Symbol.Value = Addresses[Symbol.Item];
+			}
+		}
+	}
+
+	constexpr void Encode() {
+		for (size_t i = 0; i < Items.size() && !Result.Error; ++i) {
+			const Item& Statement = Items[i];
+			Result.Bytes.insert(Result.Bytes.end(), Statement.PadBefore, AssemblyPadding);
+			Result.Bytes.push_back(Statement.Opcode);
+			int Value = Statement.Data ? 0 : Address(Statement.Argument, Statement.Line);
+			u8 Low = static_cast<u8>(Value), High = static_cast<u8>(Value >> 8);
+			switch (Statement.Data ? Implied : OpcodeTable[Statement.Opcode].Mode) {
+			case Implied:
+			case Accumulator:
+				break;
+			case Relative:
+				Result.Bytes.push_back(static_cast<u8>(Value - (Addresses[i] + Statement.PadBefore)));
+				break;
+			case Absolute:
+			case AbsoluteX:
+			case AbsoluteY:
+			case Indirect:
+				if (Value < 0 || Value > 0xFFFF) {
+					Fail("address out of range", Statement.Line);
+				}
+				if (Statement.Opcode == 0x20) {
+					Result.Bytes.insert(Result.Bytes.end(), { 0x2C, Low, High });
+				}
+				else if (Statement.Opcode == 0x4C || Statement.Opcode == 0x6C) {
+					Result.Bytes.insert(Result.Bytes.end(), { Low, High });
+				}
+				else {
+					Result.Bytes.insert(Result.Bytes.end(), { High, Low });
+				}
+				break;
+			default:
+				if (Value < 0 || Value > 0xFF) {
+					Fail("operand does not fit in a byte", Statement.Line);
+				}
+				Result.Bytes.push_back(Low);
+				break;
+			}
+			Result.Bytes.insert(Result.Bytes.end(), Statement.PadAfter, AssemblyPadding);
+		}
+	}
+};
+
+/* Assembles at run time, or inside a constant expression as long as the Assembly does not outlive it */
+constexpr Assembly Assemble(std::string_view Source) {
+	return Assembler(Source).Run();
+}
+
+/*
+	Not constexpr, so source that does not assemble stops the build where it is used. Assemble()
+	the same text at run time for the Error and Line.
+*/
+inline void AssemblyFailed(const char*, int) {}
+
+template <size_t N>
+struct AssemblySource {
+	char Text[N] = {};
+
+	constexpr AssemblySource(const char (&Source)[N]) {
+		for (size_t i = 0; i < N; ++i) {
+			Text[i] = Source[i];
+		}
+	}
+
+	constexpr std::string_view View() const {
+		return { Text, N - 1 };
+	}
+};
+
+template <AssemblySource Source>
+struct Assembled {
+	static constexpr size_t Size = [] {
+		Assembly Program = Assemble(Source.View());
+		if (Program.Error) {
+			AssemblyFailed(Program.Error, Program.Line);
+		}
+		return Program.Bytes.size();
+	}();
+
+	static constexpr u16 Origin = Assemble(Source.View()).Origin;
+
+	static constexpr std::array<u8, Size> Bytes = [] {
+		std::array<u8, Size> Image{};
+		Assembly Program = Assemble(Source.View());
+		for (size_t i = 0; i < Size; ++i) {
+			Image[i] = Program.Bytes[i];
+		}
+		return Image;
+	}();
+
+	static consteval u16 Label(std::string_view Name) {
+		int Address = Assemble(Source.View()).Label(Name);
+		if (Address < 0) {
+			AssemblyFailed("undefined label", 0);
+		}
+		return static_cast<u16>(Address);
+	}
+};
+
+template <AssemblySource Source>
+constexpr const std::array<u8, Assembled<Source>::Size>& operator""_6502() {
+	return Assembled<Source>::Bytes;
+}
@@ -0,0 +1,168 @@
+#include "call_graph.h"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <sstream>
+
+CallGraphProfiler::CallGraphProfiler() {
+	Clear();
+}
+
+void CallGraphProfiler::Clear() {
+	Nodes.assign(1, Node{ 0, 0, false, 0, 0 });
+	Stack.clear();
+	Children.clear();
+	Current = 0;
+}
+
+void CallGraphProfiler::Step(u8 Opcode, u32 Cycles, u16 PC, u16 StackBefore, u16 StackAfter) {
+	Nodes[Current].Exclusive += Cycles;
+	switch (Opcode) {
+	case 0x20: // JSR
+		Call(PC, StackBefore);
+		break;
+	case 0x28: // PLP
+	case 0x40: // RTI
+	case 0x60: // RTS
+	case 0x68: // PLA
+	case 0x9A: // TXS
+		Unwind(StackAfter);
+		break;
+	}
+}
+
+void CallGraphProfiler::Call(u16 Target, u16 StackPointer, bool Interrupt) {
+	u64 Key = static_cast<u64>(Current) << 17 | static_cast<u64>(Interrupt) << 16 | Target;
+	auto Child = Children.find(Key);
+	if (Child == Children.end()) {
+		Child = Children.emplace(Key, static_cast<u32>(Nodes.size())).first;
+		Nodes.push_back(Node{ Current, Target, Interrupt, 0, 0 });
+	}
+	Current = Child->second;
+	++Nodes[Current].Calls;
+	Stack.push_back(Frame{ Current, StackPointer });
+}
+
+void CallGraphProfiler::Unwind(u16 StackPointer) {
+	while (!Stack.empty() && Stack.back().StackPointer <= StackPointer) {
+		Stack.pop_back();
+	}
+	Current = Stack.empty() ? 0 : Stack.back().Node;
+}
+
+size_t CallGraphProfiler::LoadLabels(std::istream& In) {
+	size_t Loaded = 0;
+	std::string Line;
+	while (std::getline(In, Line)) {
+		std::istringstream Fields(Line);
+		std::string Address, Name;
+		if (!(Fields >> Address >> Name)) {
+			continue;
+		}
+		if (Address == "al") { // VICE: al C:C000 .name
+			Address = Name;
+			if (!(Fields >> Name)) {
+				continue;
+			}
+			Address = Address.substr(Address.find(':') + 1);
+		}
+		if (!Name.empty() && Name[0] == '.') {
+			Name.erase(0, 1);
+		}
+		if (!Address.empty() && Address[0] == '$') {
+			Address.erase(0, 1);
+		}
+		try {
+			size_t Parsed = 0;
+			unsigned long Value = std::stoul(Address, &Parsed, 16);
+			if (Parsed != Address.size() || Value > 0xFFFF || Name.empty()) {
+				continue;
+			}
+			Labels[static_cast<u16>(Value)] = Name;
+			++Loaded;
+		}
+		catch (const std::exception&) {
+			continue;
+		}
+	}
+	return Loaded;
+}
+
+std::string CallGraphProfiler::Name(u16 Function, bool Interrupt) const {
+	auto Label = Labels.find(Function);
+	std::string Result;
+	if (Label != Labels.end()) {
+		Result = Label->second;
+	}
+	else {
+		char Buffer[8];
+		std::snprintf(Buffer, sizeof(Buffer), "$%04X", Function);
+		Result = Buffer;
+	}
+	if (Interrupt) {
+		Result = "[int]" + Result;
+	}
+	std::replace(Result.begin(), Result.end(), ';', '_');
+	std::replace(Result.begin(), Result.end(), ' ', '_');
+	return Result;
+}
+
+void CallGraphProfiler::WriteFolded(std::ostream& Out) const {
+	std::vector<std::string> Paths(Nodes.size());
+	Paths[0] = "root";
+	for (u32 Index = 1; Index < Nodes.size(); ++Index) { // Parents are always created before children
+		Paths[Index] = Paths[Nodes[Index].Parent] + ';' + Name(Nodes[Index].Function, Nodes[Index].Interrupt);
+	}
+	for (u32 Index = 0; Index < Nodes.size(); ++Index) {
+		if (Nodes[Index].Exclusive != 0) {
+			Out << Paths[Index] << ' ' << Nodes[Index].Exclusive << '\n';
+		}
+	}
+}
+
+void CallGraphProfiler::Report(std::ostream& Out) const {
+	struct Totals {
+		u64 Calls = 0;
+		u64 Inclusive = 0;
+		u64 Exclusive = 0;
+	};
+	/* Keyed by interrupt flag and address so handlers and subroutines at one address stay apart */
+	std::map<u32, Totals> Functions;
+	u64 Total = 0;
+	std::vector<u32> Seen;
+	for (u32 Index = 0; Index < Nodes.size(); ++Index) {
+		const Node& Entry = Nodes[Index];
+		Total += Entry.Exclusive;
+		if (Index == 0) {
+			continue;
+		}
+		u32 Key = static_cast<u32>(Entry.Interrupt) << 16 | Entry.Function;
+		Functions[Key].Calls += Entry.Calls;
+		Functions[Key].Exclusive += Entry.Exclusive;
+		Seen.clear();
+		for (u32 Walk = Index; Walk != 0; Walk = Nodes[Walk].Parent) {
+			u32 WalkKey = static_cast<u32>(Nodes[Walk].Interrupt) << 16 | Nodes[Walk].Function;
+			if (std::find(Seen.begin(), Seen.end(), WalkKey) == Seen.end()) {
+				Seen.push_back(WalkKey);
+				Functions[WalkKey].Inclusive += Entry.Exclusive;
+			}
+		}
+	}
+
+	std::vector<std::pair<u32, Totals>> Sorted(Functions.begin(), Functions.end());
+	std::stable_sort(Sorted.begin(), Sorted.end(), [](const auto& L, const auto& R) { return L.second.Inclusive > R.second.Inclusive; });
+	char Line[128];
+	Out << "         Calls       Inclusive   Incl%       Exclusive   Excl%  Subroutine\n";
+	for (const auto& [Key, Entry] : Sorted) {
+		std::snprintf(Line, sizeof(Line), "%14llu %15llu %6.2f%% %15llu %6.2f%%  %s\n",
+			static_cast<unsigned long long>(Entry.Calls),
+			static_cast<unsigned long long>(Entry.Inclusive), Total ? 100.0 * Entry.Inclusive / Total : 0.0,
+			static_cast<unsigned long long>(Entry.Exclusive), Total ? 100.0 * Entry.Exclusive / Total : 0.0,
+			Name(static_cast<u16>(Key), Key >> 16).c_str());
+		Out << Line;
+	}
+	std::snprintf(Line, sizeof(Line), "%14s %15llu %6.2f%% %15llu %6.2f%%  %s\n", "",
+		static_cast<unsigned long long>(Total), 100.0,
+		static_cast<unsigned long long>(Nodes[0].Exclusive), Total ? 100.0 * Nodes[0].Exclusive / Total : 0.0, "root");
+	Out << Line;
+}
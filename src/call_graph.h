@@ -0,0 +1,53 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "6502.h"
+
+/*
+	Subroutine profiler built on a shadow call stack. Attach to NMOS6502::CallProfiler in an
+	instrumented build. JSR and interrupt entry push a frame holding the stack pointer from before
+	the call; any instruction that raises SP (RTS, RTI, PLA, PLP, TXS) pops every frame the stack
+	has unwound past, so subroutines left by discarding their return address are closed as well.
+*/
+class CallGraphProfiler {
+public:
+	struct Node {
+		u32 Parent;
+		u16 Function;
+		bool Interrupt;
+		u64 Exclusive; // Cycles spent in this call path with no deeper frame
+		u64 Calls;
+	};
+
+	struct Frame {
+		u32 Node;
+		u16 StackPointer; // SP before the return address was pushed
+	};
+
+	CallGraphProfiler();
+	std::vector<Node> Nodes; // Call tree, Nodes[0] is the root
+	std::vector<Frame> Stack;
+	std::unordered_map<u16, std::string> Labels;
+
+	/* Called after every instruction with the stack pointer from before and after it */
+	void Step(u8 Opcode, u32 Cycles, u16 PC, u16 StackBefore, u16 StackAfter);
+	void Call(u16 Target, u16 StackPointer, bool Interrupt = false);
+	void Unwind(u16 StackPointer);
+	void Clear();
+
+	/* Reads "ADDR name" lines (ADDR as C000, $C000 or 0xC000) and VICE "al C:C000 .name" lines */
+	size_t LoadLabels(std::istream& In);
+	std::string Name(u16 Function, bool Interrupt = false) const;
+
+	/* Brendan Gregg's folded format: "root;caller;callee cycles" per call path */
+	void WriteFolded(std::ostream& Out) const;
+	/* Inclusive and exclusive cycles per subroutine, recursion counted once per path */
+	void Report(std::ostream& Out) const;
+
+private:
+	std::unordered_map<u64, u32> Children; // (parent node << 17 | interrupt << 16 | function) -> node
+	u32 Current;
+};
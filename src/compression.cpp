@@ -0,0 +1,132 @@
+#include "compression.h"
+#include <cstring>
+#include <vector>
+
+static uint32_t Load32(const uint8_t* Bytes) {
+	uint32_t Value;
+	std::memcpy(&Value, Bytes, sizeof(Value));
+	return Value;
+}
+
+static bool WriteLength(uint8_t*& Op, const uint8_t* End, size_t Length) {
+	for (; Length >= 255; Length -= 255) {
+		if (Op == End) {
+			return false;
+		}
+		*Op++ = 255;
+	}
+	if (Op == End) {
+		return false;
+	}
+	*Op++ = static_cast<uint8_t>(Length);
+	return true;
+}
+
+static bool WriteSequence(uint8_t*& Op, const uint8_t* End, const uint8_t* Literals, size_t LiteralLength, size_t Offset, size_t MatchLength) {
+	if (Op == End) {
+		return false;
+	}
+	size_t MatchCode = MatchLength ? MatchLength - 4 : 0;
+	*Op++ = static_cast<uint8_t>((LiteralLength < 15 ? LiteralLength : 15) << 4 | (MatchCode < 15 ? MatchCode : 15));
+	if (LiteralLength >= 15 && !WriteLength(Op, End, LiteralLength - 15)) {
+		return false;
+	}
+	if (static_cast<size_t>(End - Op) < LiteralLength) {
+		return false;
+	}
+	std::memcpy(Op, Literals, LiteralLength);
+	Op += LiteralLength;
+	if (MatchLength == 0) {
+		return true;
+	}
+	if (End - Op < 2) {
+		return false;
+	}
+	*Op++ = static_cast<uint8_t>(Offset);
+	*Op++ = static_cast<uint8_t>(Offset >> 8);
+	return MatchCode < 15 || WriteLength(Op, End, MatchCode - 15);
+}
+
+size_t CompressBlock(const uint8_t* In, size_t Size, uint8_t* Out, size_t Capacity) {
+	constexpr int HashBits = 13;
+	constexpr uint32_t Empty = 0xFFFFFFFF;
+	std::vector<uint32_t> Table(1 << HashBits, Empty);
+	uint8_t* Op = Out;
+	const uint8_t* End = Out + Capacity;
+	size_t Anchor = 0, Pos = 0;
+
+	while (Pos + 4 <= Size) {
+		uint32_t Sequence = Load32(In + Pos);
+		uint32_t Hash = (Sequence * 2654435761u) >> (32 - HashBits);
+		uint32_t Candidate = Table[Hash];
+		Table[Hash] = static_cast<uint32_t>(Pos);
+		if (Candidate == Empty || Pos - Candidate > 0xFFFF || Load32(In + Candidate) != Sequence) {
+			++Pos;
+			continue;
+		}
+		size_t Length = 4;
+		while (Pos + Length < Size && In[Candidate + Length] == In[Pos + Length]) {
+			++Length;
+		}
+		if (!WriteSequence(Op, End, In + Anchor, Pos - Anchor, Pos - Candidate, Length)) {
+			return 0;
+		}
+		Pos += Length;
+		Anchor = Pos;
+	}
+	if (!WriteSequence(Op, End, In + Anchor, Size - Anchor, 0, 0)) {
+		return 0;
+	}
+	return Op - Out;
+}
+
+static bool ReadLength(const uint8_t*& Ip, const uint8_t* End, size_t& Length) {
+	uint8_t Byte;
+	do {
+		if (Ip == End) {
+			return false;
+		}
+		Byte = *Ip++;
+		Length += Byte;
+	} while (Byte == 255);
+	return true;
+}
+
+bool DecompressBlock(const uint8_t* In, size_t Size, uint8_t* Out, size_t RawSize) {
+	const uint8_t* Ip = In;
+	const uint8_t* InEnd = In + Size;
+	size_t Written = 0;
+	while (Ip < InEnd) {
+		uint8_t Token = *Ip++;
+		size_t LiteralLength = Token >> 4;
+		if (LiteralLength == 15 && !ReadLength(Ip, InEnd, LiteralLength)) {
+			return false;
+		}
+		if (static_cast<size_t>(InEnd - Ip) < LiteralLength || RawSize - Written < LiteralLength) {
+			return false;
+		}
+		std::memcpy(Out + Written, Ip, LiteralLength);
+		Ip += LiteralLength;
+		Written += LiteralLength;
+		if (Ip == InEnd) {
+			break;
+		}
+		if (InEnd - Ip < 2) {
+			return false;
+		}
+		size_t Offset = Ip[0] | Ip[1] << 8;
+		Ip += 2;
+		size_t MatchLength = Token & 0x0F;
+		if (MatchLength == 15 && !ReadLength(Ip, InEnd, MatchLength)) {
+			return false;
+		}
+		MatchLength += 4;
+		if (Offset == 0 || Offset > Written || RawSize - Written < MatchLength) {
+			return false;
+		}
+		for (size_t i = 0; i < MatchLength; ++i, ++Written) { // Matches may overlap their own output
+			Out[Written] = Out[Written - Offset];
+		}
+	}
+	return Written == RawSize;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/*
+	Small LZ77 block codec used for trace files. A block is a run of sequences, each a token
+	(literal length << 4 | match length - 4, 15 meaning more length bytes follow), the literals,
+	then a 16-bit little-endian match offset and any extra match length bytes. The final sequence
+	carries literals only.
+*/
+
+/* Returns the compressed size, or 0 when the output would not fit in Capacity */
+size_t CompressBlock(const uint8_t* In, size_t Size, uint8_t* Out, size_t Capacity);
+
+/* Returns false on malformed input or when the output is not exactly RawSize bytes */
+bool DecompressBlock(const uint8_t* In, size_t Size, uint8_t* Out, size_t RawSize);
@@ -0,0 +1,404 @@
+#include "condition.h"
+#include <cctype>
+#include <cstring>
+
+enum ConditionOp : u8 {
+	OpConst, // Followed by a 32-bit little-endian value
+	OpA, OpX, OpY, OpSP, OpPC, OpP,
+	OpFlag, // Followed by the flag's bit number
+	OpMemory, // Replaces the address on top with the byte there
+	OpNot, OpNegate, OpComplement, OpBool,
+	OpOr, OpXor, OpAnd, OpEqual, OpNotEqual, OpLess, OpLessEqual, OpGreater, OpGreaterEqual,
+	OpShiftLeft, OpShiftRight, OpAdd, OpSubtract, OpMultiply,
+	OpJumpIfFalse, OpJumpIfTrue, // Followed by a 16-bit target; jump keeping the top, or pop it
+	OpEnd
+};
+
+class ConditionCompiler {
+public:
+	ConditionCompiler(const std::string& Text, std::vector<u8>& Code) : Text(Text), Code(Code) {}
+	std::string Message;
+
+	bool Compile() {
+		Code.clear();
+		if (!Or()) {
+			return false;
+		}
+		Space();
+		if (Position != Text.size()) {
+			return Fail("unexpected text");
+		}
+		Code.push_back(OpEnd);
+		return Code.size() <= Condition::MaxCode || Fail("condition too long");
+	}
+
+private:
+	const std::string& Text;
+	std::vector<u8>& Code;
+	size_t Position = 0;
+	int Depth = 0;
+
+	bool Fail(const char* What) {
+		if (Message.empty()) {
+			Message = std::string(What) + " at column " + std::to_string(Position + 1);
+		}
+		return false;
+	}
+
+	void Space() {
+		while (Position < Text.size() && std::isspace(static_cast<unsigned char>(Text[Position]))) {
+			++Position;
+		}
+	}
+
+	/* Consumes Token when it comes next and is not the start of a longer operator in Unless */
+	bool Accept(const char* Token, const char* Unless = "") {
+		Space();
+		size_t Length = std::strlen(Token);
+		if (Text.compare(Position, Length, Token) != 0) {
+			return false;
+		}
+		if (Position + Length < Text.size() && *Unless && std::strchr(Unless, Text[Position + Length])) {
+			return false;
+		}
+		Position += Length;
+		return true;
+	}
+
+	bool Push() {
+		if (++Depth > Condition::MaxDepth) {
+			return Fail("expression too deep");
+		}
+		return true;
+	}
+
+	void Emit(u8 Op) {
+		Code.push_back(Op);
+	}
+
+	bool Binary(u8 Op) {
+		Emit(Op);
+		--Depth;
+		return true;
+	}
+
+	size_t EmitJump(u8 Op) {
+		Emit(Op);
+		Code.push_back(0);
+		Code.push_back(0);
+		return Code.size() - 2;
+	}
+
+	bool Patch(size_t At) {
+		if (Code.size() > Condition::MaxCode) {
+			return Fail("condition too long");
+		}
+		Code[At] = static_cast<u8>(Code.size());
+		Code[At + 1] = static_cast<u8>(Code.size() >> 8);
+		return true;
+	}
+
+	bool Or() {
+		if (!And()) {
+			return false;
+		}
+		while (Accept("||")) {
+			Emit(OpBool);
+			size_t Jump = EmitJump(OpJumpIfTrue);
+			--Depth;
+			if (!And()) {
+				return false;
+			}
+			Emit(OpBool);
+			if (!Patch(Jump)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool And() {
+		if (!BitOr()) {
+			return false;
+		}
+		while (Accept("&&")) {
+			size_t Jump = EmitJump(OpJumpIfFalse);
+			--Depth;
+			if (!BitOr()) {
+				return false;
+			}
+			Emit(OpBool);
+			if (!Patch(Jump)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool BitOr() {
+		if (!BitXor()) {
+			return false;
+		}
+		while (Accept("|", "|")) {
+			if (!BitXor() || !Binary(OpOr)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool BitXor() {
+		if (!BitAnd()) {
+			return false;
+		}
+		while (Accept("^")) {
+			if (!BitAnd() || !Binary(OpXor)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool BitAnd() {
+		if (!Equality()) {
+			return false;
+		}
+		while (Accept("&", "&")) {
+			if (!Equality() || !Binary(OpAnd)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Equality() {
+		if (!Relational()) {
+			return false;
+		}
+		for (;;) {
+			u8 Op = Accept("==") ? OpEqual : Accept("!=") ? OpNotEqual : OpEnd;
+			if (Op == OpEnd) {
+				return true;
+			}
+			if (!Relational() || !Binary(Op)) {
+				return false;
+			}
+		}
+	}
+
+	bool Relational() {
+		if (!Shift()) {
+			return false;
+		}
+		for (;;) {
+			u8 Op = Accept("<=") ? OpLessEqual : Accept(">=") ? OpGreaterEqual : Accept("<", "<") ? OpLess : Accept(">", ">") ? OpGreater : OpEnd;
+			if (Op == OpEnd) {
+				return true;
+			}
+			if (!Shift() || !Binary(Op)) {
+				return false;
+			}
+		}
+	}
+
+	bool Shift() {
+		if (!Additive()) {
+			return false;
+		}
+		for (;;) {
+			u8 Op = Accept("<<") ? OpShiftLeft : Accept(">>") ? OpShiftRight : OpEnd;
+			if (Op == OpEnd) {
+				return true;
+			}
+			if (!Additive() || !Binary(Op)) {
+				return false;
+			}
+		}
+	}
+
+	bool Additive() {
+		if (!Multiplicative()) {
+			return false;
+		}
+		for (;;) {
+			u8 Op = Accept("+") ? OpAdd : Accept("-") ? OpSubtract : OpEnd;
+			if (Op == OpEnd) {
+				return true;
+			}
+			if (!Multiplicative() || !Binary(Op)) {
+				return false;
+			}
+		}
+	}
+
+	bool Multiplicative() {
+		if (!Unary()) {
+			return false;
+		}
+		while (Accept("*")) {
+			if (!Unary() || !Binary(OpMultiply)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool Unary() {
+		u8 Op = Accept("!", "=") ? OpNot : Accept("~") ? OpComplement : Accept("-") ? OpNegate : OpEnd;
+		if (Op == OpEnd) {
+			return Primary();
+		}
+		if (!Unary()) {
+			return false;
+		}
+		Emit(Op);
+		return true;
+	}
+
+	bool Number(int Base, size_t Start) {
+		u32 Value = 0;
+		size_t End = Start;
+		for (; End < Text.size() && std::isxdigit(static_cast<unsigned char>(Text[End])); ++End) {
+			int Digit = std::isdigit(static_cast<unsigned char>(Text[End])) ? Text[End] - '0' : std::tolower(Text[End]) - 'a' + 10;
+			if (Digit >= Base) {
+				break;
+			}
+			Value = Value * Base + Digit;
+		}
+		if (End == Start) {
+			return Fail("expected a number");
+		}
+		Position = End;
+		if (!Push()) {
+			return false;
+		}
+		Emit(OpConst);
+		for (int Byte = 0; Byte < 4; ++Byte) {
+			Code.push_back(static_cast<u8>(Value >> (8 * Byte)));
+		}
+		return true;
+	}
+
+	bool Primary() {
+		Space();
+		if (Position == Text.size()) {
+			return Fail("expected an operand");
+		}
+		char First = Text[Position];
+		if (Accept("(")) {
+			if (!Or()) {
+				return false;
+			}
+			return Accept(")") || Fail("expected )");
+		}
+		if (First == '$') {
+			return Number(16, Position + 1);
+		}
+		if (First == '%') {
+			return Number(2, Position + 1);
+		}
+		if (First == '0' && Position + 1 < Text.size() && std::tolower(Text[Position + 1]) == 'x') {
+			return Number(16, Position + 2);
+		}
+		if (std::isdigit(static_cast<unsigned char>(First))) {
+			return Number(10, Position);
+		}
+
+		std::string Name;
+		while (Position < Text.size() && std::isalnum(static_cast<unsigned char>(Text[Position]))) {
+			Name += static_cast<char>(std::toupper(Text[Position++]));
+		}
+		if (Name == "MEM") {
+			if (!Accept("[") || !Or()) {
+				return Fail("expected mem[address]");
+			}
+			Emit(OpMemory);
+			return Accept("]") || Fail("expected ]");
+		}
+		static const struct { const char* Name; u8 Op; int Flag; } Names[] = {
+			{ "A", OpA, -1 }, { "X", OpX, -1 }, { "Y", OpY, -1 }, { "SP", OpSP, -1 }, { "PC", OpPC, -1 }, { "P", OpP, -1 },
+			{ "N", OpFlag, NMOS6502::N }, { "V", OpFlag, NMOS6502::V }, { "D", OpFlag, NMOS6502::D },
+			{ "I", OpFlag, NMOS6502::I }, { "Z", OpFlag, NMOS6502::Z }, { "C", OpFlag, NMOS6502::C },
+		};
+		for (const auto& Entry : Names) {
+			if (Name == Entry.Name) {
+				if (!Push()) {
+					return false;
+				}
+				Emit(Entry.Op);
+				if (Entry.Flag >= 0) {
+					Code.push_back(static_cast<u8>(Entry.Flag));
+				}
+				return true;
+			}
+		}
+		Position -= Name.size();
+		return Fail(Name.empty() ? "expected an operand" : "unknown name");
+	}
+};
+
+bool Condition::Compile(const std::string& Text) {
+	ConditionCompiler Compiler(Text, Code);
+	if (!Compiler.Compile()) {
+		Code.clear();
+		Message = Compiler.Message;
+		return false;
+	}
+	Message.clear();
+	return true;
+}
+
+int32_t Condition::Value(const NMOS6502& M6502) const {
+	int32_t Stack[MaxDepth];
+	int Top = -1;
+	const u8* Ip = Code.data();
+	if (Code.empty()) {
+		return 1; // No condition always holds
+	}
+	for (;;) {
+		switch (*Ip++) {
+		case OpConst:
+			Stack[++Top] = static_cast<int32_t>(Ip[0] | Ip[1] << 8 | Ip[2] << 16 | static_cast<u32>(Ip[3]) << 24);
+			Ip += 4;
+			break;
+		case OpA: Stack[++Top] = M6502.A; break;
+		case OpX: Stack[++Top] = M6502.X; break;
+		case OpY: Stack[++Top] = M6502.Y; break;
+		case OpSP: Stack[++Top] = M6502.SP; break;
+		case OpPC: Stack[++Top] = M6502.PC; break;
+		case OpP: Stack[++Top] = static_cast<int32_t>(M6502.ProcessorStatus.to_ulong()); break;
+		case OpFlag: Stack[++Top] = M6502.ProcessorStatus[*Ip++]; break;
+		case OpMemory: Stack[Top] = M6502.Memory[static_cast<u16>(Stack[Top])]; break;
+		case OpNot: Stack[Top] = !Stack[Top]; break;
+		case OpNegate: Stack[Top] = static_cast<int32_t>(0u - static_cast<u32>(Stack[Top])); break;
+		case OpComplement: Stack[Top] = ~Stack[Top]; break;
+		case OpBool: Stack[Top] = Stack[Top] != 0; break;
+		case OpOr: --Top; Stack[Top] |= Stack[Top + 1]; break;
+		case OpXor: --Top; Stack[Top] ^= Stack[Top + 1]; break;
+		case OpAnd: --Top; Stack[Top] &= Stack[Top + 1]; break;
+		case OpEqual: --Top; Stack[Top] = Stack[Top] == Stack[Top + 1]; break;
+		case OpNotEqual: --Top; Stack[Top] = Stack[Top] != Stack[Top + 1]; break;
+		case OpLess: --Top; Stack[Top] = Stack[Top] < Stack[Top + 1]; break;
+		case OpLessEqual: --Top; Stack[Top] = Stack[Top] <= Stack[Top + 1]; break;
+		case OpGreater: --Top; Stack[Top] = Stack[Top] > Stack[Top + 1]; break;
+		case OpGreaterEqual: --Top; Stack[Top] = Stack[Top] >= Stack[Top + 1]; break;
+		case OpShiftLeft: --Top; Stack[Top] = static_cast<int32_t>(static_cast<u32>(Stack[Top]) << (Stack[Top + 1] & 31)); break;
+		case OpShiftRight: --Top; Stack[Top] >>= Stack[Top + 1] & 31; break;
+		case OpAdd: --Top; Stack[Top] = static_cast<int32_t>(static_cast<u32>(Stack[Top]) + static_cast<u32>(Stack[Top + 1])); break;
+		case OpSubtract: --Top; Stack[Top] = static_cast<int32_t>(static_cast<u32>(Stack[Top]) - static_cast<u32>(Stack[Top + 1])); break;
+		case OpMultiply: --Top; Stack[Top] = static_cast<int32_t>(static_cast<u32>(Stack[Top]) * static_cast<u32>(Stack[Top + 1])); break;
+		case OpJumpIfFalse:
+		case OpJumpIfTrue:
+			if ((Stack[Top] != 0) == (Ip[-1] == OpJumpIfTrue)) {
+				Ip = Code.data() + (Ip[0] | Ip[1] << 8);
+			}
+			else {
+				--Top;
+				Ip += 2;
+			}
+			break;
+		default:
+			return Stack[Top];
+		}
+	}
+}
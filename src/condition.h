@@ -0,0 +1,44 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "6502.h"
+
+/*
+	Breakpoint and watchpoint conditions such as "A == $42 && mem[$0200] & $80", compiled once
+	to a small stack bytecode and evaluated against the core's registers and Memory.
+
+	Operands: numbers ($hex, 0xhex, %binary, decimal), the registers A X Y SP PC P, the flags
+	N V D I Z C as 0 or 1, and mem[expression] for a byte of memory. Operators, loosest first:
+	|| && | ^ & (== !=) (< <= > >=) (<< >>) (+ -) * and the unary ! ~ -, all as in C on 32-bit
+	signed values, with && and || short-circuiting. Names are case-insensitive.
+*/
+class Condition {
+public:
+	static constexpr int MaxDepth = 16;
+	static constexpr size_t MaxCode = 0xFFFF; // Jump targets are 16 bits
+
+	/* False, with Error() saying where, when Text does not parse or compiles to over MaxCode bytes */
+	bool Compile(const std::string& Text);
+	int32_t Value(const NMOS6502& M6502) const;
+	bool Evaluate(const NMOS6502& M6502) const {
+		return Value(M6502) != 0;
+	}
+
+	bool Empty() const {
+		return Code.empty();
+	}
+
+	const std::vector<u8>& Bytecode() const {
+		return Code;
+	}
+
+	const std::string& Error() const {
+		return Message;
+	}
+
+private:
+	std::vector<u8> Code;
+	std::string Message;
+
+	friend class ConditionCompiler;
+};
@@ -0,0 +1,157 @@
+#include "differential.h"
+#include <cstdio>
+#include <cstring>
+#include "opcodes.h"
+
+DifferentialRunner::DifferentialRunner(NMOS6502& Fast) : Fast(Fast) {
+	Resync();
+}
+
+void DifferentialRunner::Resync() {
+	std::memcpy(Reference.Memory.data(), Fast.Memory.data(), Reference.Memory.size());
+	InSync = false;
+	FastDirty.Clear();
+	Sync();
+}
+
+void DifferentialRunner::Sync() {
+	Reference.A = Fast.A;
+	Reference.X = Fast.X;
+	Reference.Y = Fast.Y;
+	Reference.SP = Fast.SP;
+	Reference.PC = Fast.PC;
+	Reference.ProcessorStatus = Fast.ProcessorStatus;
+	if (!InSync) {
+		FastDirty.ForEach([&](u8 Page) {
+			std::memcpy(&Reference.Memory[Page << 8], &Fast.Memory[Page << 8], 0x100);
+		});
+	}
+	FastDirty.Clear();
+	Reference.Dirty.Clear();
+	InSync = true;
+}
+
+static DiffRegisters Registers(u8 A, u8 X, u8 Y, u16 SP, u16 PC, const std::bitset<6>& P) {
+	DiffRegisters Out;
+	Out.A = A;
+	Out.X = X;
+	Out.Y = Y;
+	Out.SP = SP;
+	Out.PC = PC;
+	Out.P = static_cast<u8>(P.to_ulong());
+	return Out;
+}
+
+bool DifferentialRunner::Check(u16 BlockStart, u16 Address, u8 Opcode) {
+	u32 Fields = 0;
+	Fields |= (Fast.A != Reference.A) << DiffA;
+	Fields |= (Fast.X != Reference.X) << DiffX;
+	Fields |= (Fast.Y != Reference.Y) << DiffY;
+	Fields |= (Fast.SP != Reference.SP) << DiffSP;
+	Fields |= (Fast.PC != Reference.PC) << DiffPC;
+	Fields |= (Fast.ProcessorStatus != Reference.ProcessorStatus) << DiffP;
+
+	DirtyPageMap Written = Reference.Dirty;
+	for (int Word = 0; Word < 4; ++Word) {
+		Written.Words[Word] |= FastDirty.Words[Word];
+	}
+	int MemoryAddress = -1;
+	Written.ForEach([&](u8 Page) {
+		if (MemoryAddress < 0 && std::memcmp(&Fast.Memory[Page << 8], &Reference.Memory[Page << 8], 0x100) != 0) {
+			for (int Offset = 0; Offset < 0x100; ++Offset) {
+				if (Fast.Memory[Page << 8 | Offset] != Reference.Memory[Page << 8 | Offset]) {
+					MemoryAddress = Page << 8 | Offset;
+					break;
+				}
+			}
+		}
+	});
+	if (MemoryAddress >= 0) {
+		Fields |= 1 << DiffMemory;
+	}
+
+	if (!Fields) {
+		FastDirty.Clear();
+		Reference.Dirty.Clear();
+		return true;
+	}
+	Report.Instruction = Instructions - 1;
+	Report.BlockStart = BlockStart;
+	Report.Address = Address;
+	Report.Opcode = Opcode;
+	Report.Fields = Fields;
+	Report.Fast = Registers(Fast.A, Fast.X, Fast.Y, Fast.SP, Fast.PC, Fast.ProcessorStatus);
+	Report.Reference = Registers(Reference.A, Reference.X, Reference.Y, Reference.SP, Reference.PC, Reference.ProcessorStatus);
+	Report.MemoryAddress = MemoryAddress;
+	if (MemoryAddress >= 0) {
+		Report.FastValue = Fast.Memory[MemoryAddress];
+		Report.ReferenceValue = Reference.Memory[MemoryAddress];
+	}
+	return false;
+}
+
+bool DifferentialRunner::Run(u64 Count) {
+	DirtyPageMap* Previous = Fast.DirtyPages;
+	Fast.DirtyPages = &FastDirty;
+	bool Agreed = true;
+	for (u64 Done = 0; Agreed && Done < Count;) {
+		bool Checked = SampleEvery <= 1 || Blocks % SampleEvery == 0;
+		++Blocks;
+		if (Checked) {
+			Sync();
+			++CheckedBlocks;
+		}
+		else {
+			InSync = false;
+		}
+		u16 BlockStart = Fast.PC;
+		for (bool End = false; !End && Done < Count;) {
+			u16 Address = Fast.PC;
+			u8 Opcode = Fast.Memory[Address];
+			End = Fast.NMIPending || Fast.IRQPending;
+			if (Checked) {
+				Reference.NMIPending = Fast.NMIPending;
+				Reference.IRQPending = Fast.IRQPending;
+			}
+			Fast.Execute(0);
+			++Done;
+			++Instructions;
+			End |= BlockEnds.Ends[Opcode];
+			if (Checked) {
+				Reference.Step();
+				if ((Mode == PerInstruction || End || Done == Count) && !Check(BlockStart, Address, Opcode)) {
+					Agreed = false;
+					break;
+				}
+			}
+		}
+	}
+	Fast.DirtyPages = Previous;
+	return Agreed;
+}
+
+std::string Divergence::Describe() const {
+	const OpcodeInfo& Info = OpcodeTable[Opcode];
+	char Part[128];
+	std::snprintf(Part, sizeof(Part), "instruction %llu at %04X (%02X %s %s), block %04X:", static_cast<unsigned long long>(Instruction),
+		Address, Opcode, Info.Mnemonic, AddressingModeNames[Info.Mode], BlockStart);
+	std::string Text = Part;
+	const unsigned FastValues[] = { Fast.A, Fast.X, Fast.Y, Fast.SP, Fast.PC, Fast.P };
+	const unsigned ReferenceValues[] = { Reference.A, Reference.X, Reference.Y, Reference.SP, Reference.PC, Reference.P };
+	for (int Field = DiffA; Field < DiffMemory; ++Field) {
+		if (Fields & 1u << Field) {
+			int Digits = Field == DiffSP || Field == DiffPC ? 4 : 2;
+			std::snprintf(Part, sizeof(Part), " %s %0*X != %0*X", DiffFieldNames[Field], Digits, FastValues[Field], Digits, ReferenceValues[Field]);
+			Text += Part;
+		}
+	}
+	if (Fields & 1u << DiffMemory) {
+		std::snprintf(Part, sizeof(Part), " ram[%04X] %02X != %02X", MemoryAddress, FastValue, ReferenceValue);
+		Text += Part;
+	}
+	std::snprintf(Part, sizeof(Part), "\n  fast      A=%02X X=%02X Y=%02X SP=%04X PC=%04X P=%02X", Fast.A, Fast.X, Fast.Y, Fast.SP, Fast.PC, Fast.P);
+	Text += Part;
+	std::snprintf(Part, sizeof(Part), "\n  reference A=%02X X=%02X Y=%02X SP=%04X PC=%04X P=%02X", Reference.A, Reference.X, Reference.Y, Reference.SP, Reference.PC, Reference.P);
+	Text += Part;
+	return Text;
+}
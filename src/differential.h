@@ -0,0 +1,68 @@
+#pragma once
+#include <string>
+#include "6502.h"
+#include "dirty_pages.h"
+#include "reference_core.h"
+
+#ifndef NMOS6502_INSTRUMENTATION
+#error "DifferentialRunner needs the DirtyPages hook; link against 6502-core-instrumented"
+#endif
+
+enum DiffField { DiffA, DiffX, DiffY, DiffSP, DiffPC, DiffP, DiffMemory, DiffFieldCount };
+inline constexpr const char* DiffFieldNames[DiffFieldCount] = { "a", "x", "y", "sp", "pc", "p", "ram" };
+
+struct DiffRegisters {
+	u8 A = 0, X = 0, Y = 0, P = 0;
+	u16 SP = 0, PC = 0;
+};
+
+/* Where the two cores first disagreed, and on what */
+struct Divergence {
+	u64 Instruction = 0; // Instructions run before the one that diverged (or that ended the block)
+	u16 BlockStart = 0;
+	u16 Address = 0; // Of that instruction
+	u8 Opcode = 0;
+	u32 Fields = 0; // A bit per DiffField
+	DiffRegisters Fast, Reference;
+	int MemoryAddress = -1; // First differing byte when DiffMemory is set
+	u8 FastValue = 0, ReferenceValue = 0;
+
+	/* "instruction 1234 at 0203 (8D STA Absolute), block 0200: a 42 != 43, ..." as fast != reference */
+	std::string Describe() const;
+};
+
+/*
+	Lockstep validation of an NMOS6502 against ReferenceCore. Both run the same instructions and
+	are compared on registers, flags and every page either one wrote, after each instruction or
+	after each basic block (ended by a branch, jump or interrupt).
+
+	SampleEvery N checks one block in N: the others run on the fast core alone, and before the
+	next checked block the reference is brought up to date from the fast core's registers and
+	the pages it wrote meanwhile. The fast core's written pages come from its DirtyPages hook,
+	which Run borrows for its duration, so the runner needs an instrumented build: without the
+	hook it could neither compare the fast core's writes nor resync short of copying 64 KB.
+*/
+class DifferentialRunner {
+public:
+	enum Granularity { PerInstruction, PerBlock };
+
+	explicit DifferentialRunner(NMOS6502& Fast);
+	NMOS6502& Fast;
+	ReferenceCore Reference;
+	Granularity Mode = PerInstruction;
+	u64 SampleEvery = 1;
+	u64 Instructions = 0, Blocks = 0, CheckedBlocks = 0;
+	Divergence Report;
+
+	/* Up to Count instructions; false as soon as the cores diverge, with Report filled in */
+	bool Run(u64 Count);
+	/* Copies the fast core's full state into the reference, as at construction */
+	void Resync();
+
+private:
+	DirtyPageMap FastDirty;
+	bool InSync = false;
+
+	void Sync();
+	bool Check(u16 BlockStart, u16 Address, u8 Opcode);
+};
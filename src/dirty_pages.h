@@ -0,0 +1,47 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+/*
+	One bit per 256-byte page written since the last Clear. Attach to NMOS6502::DirtyPages in an
+	instrumented build: every write through WriteByte and Modify, interrupt pushes included,
+	marks its page, so a restore only has to copy what actually changed.
+*/
+class DirtyPageMap {
+public:
+	uint64_t Words[4] = {};
+
+	void Mark(uint16_t Address) {
+		Words[Address >> 14] |= uint64_t{ 1 } << (Address >> 8 & 63);
+	}
+
+	/* For bulk writes that bypass the core, such as loading an input into Memory */
+	void MarkRange(uint16_t Address, size_t Length) {
+		for (size_t Page = Address >> 8; Length && Page <= static_cast<size_t>((Address + Length - 1) >> 8) && Page < 256; ++Page) {
+			Words[Page >> 6] |= uint64_t{ 1 } << (Page & 63);
+		}
+	}
+
+	bool Test(uint8_t Page) const {
+		return Words[Page >> 6] >> (Page & 63) & 1;
+	}
+
+	int Count() const {
+		return std::popcount(Words[0]) + std::popcount(Words[1]) + std::popcount(Words[2]) + std::popcount(Words[3]);
+	}
+
+	void Clear() {
+		Words[0] = Words[1] = Words[2] = Words[3] = 0;
+	}
+
+	/* Calls Visit(Page) for every dirty page in ascending order */
+	template <typename Visitor>
+	void ForEach(Visitor&& Visit) const {
+		for (int Word = 0; Word < 4; ++Word) {
+			for (uint64_t Bits = Words[Word]; Bits; Bits &= Bits - 1) {
+				Visit(static_cast<uint8_t>(Word * 64 + std::countr_zero(Bits)));
+			}
+		}
+	}
+};
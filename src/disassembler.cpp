@@ -0,0 +1,210 @@
+#include "disassembler.h"
+#include "opcodes.h"
+#include <cstring>
+
+/* How the operand is read, by the rules of OperandValue: data words high byte first, JMP and JSR targets low byte first */
+enum OperandFormat : u8 { OperandNone, OperandByte, OperandWord, OperandJump, OperandCall, OperandTarget };
+
+/* Text before and after the operand, padded so both are always copied whole */
+struct InstructionForm {
+	char Prefix[8] = {};
+	u8 PrefixLength = 0;
+	OperandFormat Operand = OperandNone;
+	char Suffix[4] = {};
+	u8 SuffixLength = 0;
+	u8 Digits = 0; // Of the operand: 0, 2 or 4
+	u8 Length = 1;
+};
+
+struct InstructionForms {
+	InstructionForm Forms[0x100];
+
+	constexpr InstructionForms() : Forms() {
+		for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+			const OpcodeInfo& Info = OpcodeTable[Opcode];
+			InstructionForm& Form = Forms[Opcode];
+			const char* Before = "";
+			const char* After = "";
+			Form.Operand = OperandNone;
+			switch (Info.Mode) {
+			case Implied: break;
+			case Accumulator: Before = " A"; break;
+			case Immediate: Before = " #$"; Form.Operand = OperandByte; break;
+			case ZeroPage: Before = " $"; Form.Operand = OperandByte; break;
+			case ZeroPageX: Before = " $"; After = ",X"; Form.Operand = OperandByte; break;
+			case ZeroPageY: Before = " $"; After = ",Y"; Form.Operand = OperandByte; break;
+			case Absolute: Before = " $"; Form.Operand = OperandWord; break;
+			case AbsoluteX: Before = " $"; After = ",X"; Form.Operand = OperandWord; break;
+			case AbsoluteY: Before = " $"; After = ",Y"; Form.Operand = OperandWord; break;
+			case Indirect: Before = " ($"; After = ")"; Form.Operand = OperandWord; break;
+			case IndirectX: Before = " ($"; After = ",X)"; Form.Operand = OperandByte; break;
+			case IndirectY: Before = " ($"; After = "),Y"; Form.Operand = OperandByte; break;
+			case Relative: Before = " $"; Form.Operand = OperandTarget; break;
+			}
+			u8 Length = 0;
+			for (const char* Text = Info.Mnemonic; *Text; ++Text) {
+				Form.Prefix[Length++] = *Text;
+			}
+			for (const char* Text = Before; *Text; ++Text) {
+				Form.Prefix[Length++] = *Text;
+			}
+			Form.PrefixLength = Length;
+			Length = 0;
+			for (const char* Text = After; *Text; ++Text) {
+				Form.Suffix[Length++] = *Text;
+			}
+			Form.SuffixLength = Length;
+			if (Opcode == 0x4C || Opcode == 0x6C) {
+				Form.Operand = OperandJump;
+			}
+			else if (Opcode == 0x20) {
+				Form.Operand = OperandCall;
+			}
+			Form.Length = DialectLength(static_cast<u8>(Opcode));
+			Form.Digits = Form.Operand == OperandNone ? 0 : Form.Operand == OperandByte ? 2 : 4;
+		}
+	}
+};
+
+static constexpr InstructionForms Forms;
+static constexpr char HexDigits[] = "0123456789ABCDEF";
+
+struct HexTable {
+	char Pairs[0x100][2] = {};
+
+	constexpr HexTable() {
+		for (int Value = 0; Value < 0x100; ++Value) {
+			Pairs[Value][0] = HexDigits[Value >> 4];
+			Pairs[Value][1] = HexDigits[Value & 15];
+		}
+	}
+};
+
+static constexpr HexTable HexPairs;
+
+/*
+	A whole DisassembleRange line per opcode, "0000  00 00 00  LDA ($0000),Y\n" with the
+	mnemonic and operand text in place, so a line is one copy and a few fixed-size stores
+*/
+struct LineForm {
+	char Text[32] = {};
+	OperandFormat Operand = OperandNone;
+	u8 Shift = 0; // Brings the operand's digits to the top of the four written
+	u8 Restore = 0; // Where eight bytes of Text go back over the byte dump the opcode does not use
+	u8 OperandAt = 0;
+	u8 Digits = 0;
+	u8 LineLength = 0;
+	u8 Length = 1;
+};
+
+struct LineForms {
+	LineForm Lines[0x100];
+
+	constexpr LineForms() : Lines() {
+		for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+			const InstructionForm& Form = Forms.Forms[Opcode];
+			LineForm& Line = Lines[Opcode];
+			for (char& Character : Line.Text) {
+				Character = ' ';
+			}
+			u8 Column = 16;
+			for (u8 i = 0; i < Form.PrefixLength; ++i) {
+				Line.Text[Column++] = Form.Prefix[i];
+			}
+			Line.OperandAt = Column;
+			Column += Form.Digits;
+			for (u8 i = 0; i < Form.SuffixLength; ++i) {
+				Line.Text[Column++] = Form.Suffix[i];
+			}
+			Line.Text[Column++] = '\n';
+			Line.Operand = Form.Operand;
+			Line.Shift = static_cast<u8>(16 - 4 * Form.Digits);
+			Line.Restore = static_cast<u8>(5 + 3 * (Form.Length < 3 ? Form.Length : 3));
+			Line.Digits = Form.Digits;
+			Line.LineLength = Column;
+			Line.Length = Form.Length;
+		}
+	}
+};
+
+static constexpr LineForms Lines;
+
+static char* PutByte(char* Out, u8 Value) {
+	Out[0] = HexDigits[Value >> 4];
+	Out[1] = HexDigits[Value & 15];
+	return Out + 2;
+}
+
+static char* PutWord(char* Out, u16 Value) {
+	return PutByte(PutByte(Out, static_cast<u8>(Value >> 8)), static_cast<u8>(Value));
+}
+
+/* Every format's value is worked out and one picked, so no branch depends on the opcode */
+static u32 OperandOf(OperandFormat Format, const u8* Bytes, u16 Address) {
+	const u32 Operands[] = {
+		0, Bytes[1], static_cast<u32>(Bytes[1] << 8 | Bytes[2]), static_cast<u32>(Bytes[1] | Bytes[2] << 8),
+		static_cast<u32>(Bytes[2] | Bytes[3] << 8), static_cast<u16>(Address + static_cast<int8_t>(Bytes[1]))
+	};
+	return Operands[Format];
+}
+
+size_t DisassembleInto(const u8* Bytes, u16 Address, char* Out) {
+	const InstructionForm& Form = Forms.Forms[Bytes[0]];
+	char* Cursor = Out;
+	std::memcpy(Cursor, Form.Prefix, sizeof(Form.Prefix));
+	Cursor += Form.PrefixLength;
+
+	/* Every operand is written as four digits and only Digits of them kept */
+	u32 Value = OperandOf(Form.Operand, Bytes, Address) << (16 - 4 * Form.Digits);
+	PutWord(Cursor, static_cast<u16>(Value));
+	Cursor += Form.Digits;
+
+	std::memcpy(Cursor, Form.Suffix, sizeof(Form.Suffix));
+	Cursor += Form.SuffixLength;
+	*Cursor = '\0';
+	return Cursor - Out;
+}
+
+std::string Disassemble(const std::vector<u8>& Memory, u16 Address) {
+	u8 Bytes[4];
+	for (u16 i = 0; i < 4; ++i) {
+		Bytes[i] = Memory[static_cast<u16>(Address + i)];
+	}
+	return Disassemble(Bytes, Address);
+}
+
+std::string Disassemble(const u8* Bytes, u16 Address) {
+	char Buffer[DisassemblyBufferSize];
+	return std::string(Buffer, DisassembleInto(Bytes, Address, Buffer));
+}
+
+size_t DisassembleRange(const u8* Memory, u32 Start, u32 End, char* Out, size_t Capacity, u32& Next) {
+	char* Cursor = Out;
+	u32 Address = Start;
+	End = End < 0x10000 ? End : 0x10000;
+	while (Address < End && static_cast<size_t>(Cursor - Out) + DisassemblyLineSize <= Capacity) {
+		u16 At = static_cast<u16>(Address);
+		u8 Bytes[4] = { Memory[At], Memory[static_cast<u16>(At + 1)], Memory[static_cast<u16>(At + 2)], Memory[static_cast<u16>(At + 3)] };
+		const LineForm& Line = Lines.Lines[Bytes[0]];
+
+		/* The whole line from its template, then the address and the first three bytes over it */
+		std::memcpy(Cursor, Line.Text, sizeof(Line.Text));
+		std::memcpy(Cursor, HexPairs.Pairs[At >> 8], 2);
+		std::memcpy(Cursor + 2, HexPairs.Pairs[At & 0xFF], 2);
+		std::memcpy(Cursor + 6, HexPairs.Pairs[Bytes[0]], 2);
+		std::memcpy(Cursor + 9, HexPairs.Pairs[Bytes[1]], 2);
+		std::memcpy(Cursor + 12, HexPairs.Pairs[Bytes[2]], 2);
+		std::memcpy(Cursor + Line.Restore, Line.Text + Line.Restore, 8);
+
+		/* Four operand digits are always written and the template put back after the ones kept */
+		u16 Value = static_cast<u16>(OperandOf(Line.Operand, Bytes, At) << Line.Shift);
+		std::memcpy(Cursor + Line.OperandAt, HexPairs.Pairs[Value >> 8], 2);
+		std::memcpy(Cursor + Line.OperandAt + 2, HexPairs.Pairs[Value & 0xFF], 2);
+		std::memcpy(Cursor + Line.OperandAt + Line.Digits, Line.Text + Line.OperandAt + Line.Digits, 4);
+
+		Cursor += Line.LineLength;
+		Address += Line.Length;
+	}
+	Next = Address;
+	return Cursor - Out;
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "6502.h"
+
+/* Room DisassembleInto needs, the longest instruction text and some slack for whole-word copies */
+inline constexpr size_t DisassemblyBufferSize = 24;
+/* Room DisassembleRange needs for each line */
+inline constexpr size_t DisassemblyLineSize = 48;
+
+/*
+	Formats the instruction at Address in standard 6502 assembler syntax, with its operand decoded
+	the way this core reads it (see OperandValue), so the text matches the source _6502 assembled.
+*/
+std::string Disassemble(const std::vector<u8>& Memory, u16 Address);
+/* Same, for an instruction whose opcode and three following bytes are in Bytes */
+std::string Disassemble(const u8* Bytes, u16 Address);
+
+/*
+	Same again, written NUL-terminated into Out, which must hold DisassemblyBufferSize bytes.
+	Returns the length of the text. Formats from a per-opcode table derived at compile time
+	from OpcodeTable, with no allocation and no printf.
+*/
+size_t DisassembleInto(const u8* Bytes, u16 Address, char* Out);
+
+/*
+	Listing of the instructions from Start up to End (exclusive, at most 0x10000) of a 64 KB
+	Memory, one "0200  A9 42     LDA #$42" line each, as the profiler prints them. Instructions
+	take DialectLength bytes, so JSR spans four of which the first three are dumped. Stops early
+	when fewer than DisassemblyLineSize bytes of Capacity remain. Returns the bytes written and
+	sets Next to the address of the first instruction not listed.
+*/
+size_t DisassembleRange(const u8* Memory, u32 Start, u32 End, char* Out, size_t Capacity, u32& Next);
@@ -0,0 +1,360 @@
+#include "gdb_stub.h"
+#include <cstdlib>
+
+static const char Hex[] = "0123456789abcdef";
+static constexpr size_t MaxPacket = 0x1000; // Advertised as PacketSize, in hex
+
+static const char TargetXml[] =
+	"<?xml version=\"1.0\"?>"
+	"<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+	"<target version=\"1.0\"><feature name=\"org.hyprd.m6502.core\">"
+	"<reg name=\"a\" bitsize=\"8\" regnum=\"0\"/>"
+	"<reg name=\"x\" bitsize=\"8\"/>"
+	"<reg name=\"y\" bitsize=\"8\"/>"
+	"<reg name=\"p\" bitsize=\"8\"/>"
+	"<reg name=\"sp\" bitsize=\"16\" type=\"data_ptr\"/>"
+	"<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"
+	"</feature></target>";
+
+static int Nibble(char Digit) {
+	if (Digit >= '0' && Digit <= '9') return Digit - '0';
+	if (Digit >= 'a' && Digit <= 'f') return Digit - 'a' + 10;
+	if (Digit >= 'A' && Digit <= 'F') return Digit - 'A' + 10;
+	return -1;
+}
+
+static void AppendHex(std::string& Out, u8 Value) {
+	Out += Hex[Value >> 4];
+	Out += Hex[Value & 15];
+}
+
+/* "addr,len" with an optional ":" or ";" after; false when malformed */
+static bool AddressLength(const std::string& Arguments, u32& Address, u32& Length, size_t* End = nullptr) {
+	char* Cursor;
+	Address = std::strtoul(Arguments.c_str(), &Cursor, 16);
+	if (*Cursor != ',') {
+		return false;
+	}
+	Length = std::strtoul(Cursor + 1, &Cursor, 16);
+	if (End) {
+		*End = Cursor - Arguments.c_str();
+	}
+	return Address < 0x10000;
+}
+
+GdbStub::GdbStub(NMOS6502& M6502) : M6502(M6502), Loop(M6502) {
+	Loop.Mode = RunDebugInstruction;
+	Attach();
+}
+
+GdbStub::~GdbStub() {
+	Detach();
+}
+
+void GdbStub::Attach() {
+	Attached = true;
+#ifdef NMOS6502_INSTRUMENTATION
+	M6502.Watchpoints = &Watches;
+#endif
+}
+
+void GdbStub::Detach() {
+	Attached = false;
+#ifdef NMOS6502_INSTRUMENTATION
+	if (M6502.Watchpoints == &Watches) {
+		M6502.Watchpoints = nullptr;
+	}
+#endif
+}
+
+std::string GdbStub::Frame(const std::string& Payload) {
+	u8 Sum = 0;
+	for (char Byte : Payload) {
+		Sum += static_cast<u8>(Byte);
+	}
+	std::string Framed = "$" + Payload + "#";
+	AppendHex(Framed, Sum);
+	return Framed;
+}
+
+void GdbStub::Receive(const char* Bytes, size_t Length, std::vector<std::string>& Packets, std::string& Acks) {
+	for (size_t i = 0; i < Length; ++i) {
+		char Byte = Bytes[i];
+		if (Pending.empty()) {
+			if (Byte == '$') {
+				Pending += Byte;
+			}
+			else if (Byte == '\x03') {
+				Packets.push_back("\x03"); // ^C while stopped has nothing to interrupt
+			}
+			continue; // Acks from GDB and line noise
+		}
+		Pending += Byte;
+		if (Pending.size() > MaxPacket + 4) { // Longer than any GDB sends; drop it rather than buffer without end
+			if (!NoAck) {
+				Acks += '-';
+			}
+			Pending.clear();
+			continue;
+		}
+		size_t Hash = Pending.size() - 3;
+		if (Pending.size() < 4 || Pending[Hash] != '#') {
+			continue;
+		}
+		u8 Sum = 0;
+		for (size_t j = 1; j < Hash; ++j) {
+			Sum += static_cast<u8>(Pending[j]);
+		}
+		int High = Nibble(Pending[Hash + 1]), Low = Nibble(Pending[Hash + 2]);
+		bool Good = High >= 0 && Low >= 0 && (High << 4 | Low) == Sum;
+		if (!NoAck) {
+			Acks += Good ? '+' : '-';
+		}
+		if (Good) {
+			Packets.push_back(Pending.substr(1, Hash - 1));
+		}
+		Pending.clear();
+	}
+}
+
+std::string GdbStub::Registers() const {
+	std::string Out;
+	Out.reserve(16);
+	AppendHex(Out, M6502.A);
+	AppendHex(Out, M6502.X);
+	AppendHex(Out, M6502.Y);
+	AppendHex(Out, static_cast<u8>(M6502.ProcessorStatus.to_ulong()));
+	AppendHex(Out, static_cast<u8>(M6502.SP));
+	AppendHex(Out, static_cast<u8>(M6502.SP >> 8));
+	AppendHex(Out, static_cast<u8>(M6502.PC));
+	AppendHex(Out, static_cast<u8>(M6502.PC >> 8));
+	return Out;
+}
+
+bool GdbStub::SetRegister(int Number, u32 Value) {
+	switch (Number) {
+	case 0: M6502.A = static_cast<u8>(Value); break;
+	case 1: M6502.X = static_cast<u8>(Value); break;
+	case 2: M6502.Y = static_cast<u8>(Value); break;
+	case 3: M6502.ProcessorStatus = std::bitset<6>(Value); break;
+	case 4: M6502.SP = static_cast<u16>(Value); break;
+	case 5: M6502.PC = static_cast<u16>(Value); break;
+	default: return false;
+	}
+	return true;
+}
+
+std::string GdbStub::ReadMemory(const std::string& Arguments) const {
+	u32 Address, Length;
+	if (!AddressLength(Arguments, Address, Length)) {
+		return "E01";
+	}
+	Length = std::min(Length, std::min<u32>(0x10000 - Address, MaxPacket / 2));
+	std::string Out(2 * Length, '0');
+	const u8* Block = M6502.Memory.data() + Address;
+	for (u32 i = 0; i < Length; ++i) {
+		Out[2 * i] = Hex[Block[i] >> 4];
+		Out[2 * i + 1] = Hex[Block[i] & 15];
+	}
+	return Out;
+}
+
+std::string GdbStub::WriteMemory(const std::string& Arguments, bool Binary) {
+	u32 Address, Length;
+	size_t Colon;
+	if (!AddressLength(Arguments, Address, Length, &Colon) || Colon >= Arguments.size() || Arguments[Colon] != ':' || Length > 0x10000 - Address) {
+		return "E01";
+	}
+	size_t Cursor = Colon + 1;
+	for (u32 i = 0; i < Length; ++i) {
+		if (Binary) {
+			if (Cursor >= Arguments.size()) {
+				return "E01";
+			}
+			u8 Byte = static_cast<u8>(Arguments[Cursor++]);
+			if (Byte == 0x7D && Cursor < Arguments.size()) {
+				Byte = static_cast<u8>(Arguments[Cursor++]) ^ 0x20;
+			}
+			M6502.Memory[Address + i] = Byte;
+		}
+		else {
+			int High = Cursor + 1 < Arguments.size() ? Nibble(Arguments[Cursor]) : -1;
+			int Low = High >= 0 ? Nibble(Arguments[Cursor + 1]) : -1;
+			if (Low < 0) {
+				return "E01";
+			}
+			M6502.Memory[Address + i] = static_cast<u8>(High << 4 | Low);
+			Cursor += 2;
+		}
+	}
+	return "OK";
+}
+
+std::string GdbStub::Breakpoint(const std::string& Arguments, bool Insert) {
+	u32 Address, Length;
+	if (Arguments.size() < 2 || Arguments[1] != ',' || !AddressLength(Arguments.substr(2), Address, Length)) {
+		return "E01";
+	}
+	Length = std::min(std::max<u32>(Length, 1), 0x10000 - Address);
+	switch (Arguments[0]) {
+	case '0':
+	case '1':
+		Insert ? Loop.Breakpoints.Set(static_cast<u16>(Address)) : Loop.Breakpoints.Clear(static_cast<u16>(Address));
+		return "OK";
+#ifdef NMOS6502_INSTRUMENTATION
+	case '2':
+	case '3':
+	case '4': {
+		static constexpr WatchKind Kinds[] = { WatchWrite, WatchRead, WatchAccess };
+		WatchKind Kind = Kinds[Arguments[0] - '2'];
+		Insert ? Watches.Add(static_cast<u16>(Address), Kind, Length) : Watches.Remove(static_cast<u16>(Address), Kind, Length);
+		return "OK";
+	}
+#endif
+	default:
+		return ""; // Unsupported kinds are reported with an empty reply
+	}
+}
+
+std::string GdbStub::Resume(const std::string& Arguments, bool Step) {
+	if (!Arguments.empty()) {
+		M6502.PC = static_cast<u16>(std::strtoul(Arguments.c_str(), nullptr, 16));
+	}
+#ifdef NMOS6502_INSTRUMENTATION
+	Watches.ClearHits();
+#endif
+	bool Watched = false;
+	if (Step) {
+		M6502.Execute(0);
+#ifdef NMOS6502_INSTRUMENTATION
+		Watched = !Watches.Hits.empty();
+#endif
+	}
+	else {
+		for (;;) {
+			RunStop Stop = Loop.Run(Slice).Stop;
+			if (Stop == RunBreakpoint) {
+				break;
+			}
+			if (Stop == RunWatchpoint) {
+				Watched = true;
+				break;
+			}
+			if (Interrupted && Interrupted()) {
+				return "S02";
+			}
+		}
+	}
+	if (!Watched) {
+		return "S05";
+	}
+#ifdef NMOS6502_INSTRUMENTATION
+	const WatchHit& Hit = Watches.Hits.back();
+	u8 Kind = Watches.At(Hit.Address);
+	std::string Reply = Kind == WatchAccess ? "T05awatch:" : Kind == WatchRead ? "T05rwatch:" : "T05watch:";
+	AppendHex(Reply, static_cast<u8>(Hit.Address >> 8));
+	AppendHex(Reply, static_cast<u8>(Hit.Address));
+	return Reply + ";";
+#else
+	return "S05";
+#endif
+}
+
+std::string GdbStub::Features(const std::string& Arguments) const {
+	static const std::string Prefix = "target.xml:";
+	u32 Offset, Length;
+	if (Arguments.compare(0, Prefix.size(), Prefix) != 0 || !AddressLength(Arguments.substr(Prefix.size()), Offset, Length)) {
+		return "E00";
+	}
+	std::string Document = TargetXml;
+	if (Offset >= Document.size()) {
+		return "l";
+	}
+	std::string Chunk = Document.substr(Offset, Length);
+	return (Offset + Chunk.size() < Document.size() ? "m" : "l") + Chunk;
+}
+
+std::string GdbStub::Handle(const std::string& Packet) {
+	if (Packet.empty()) {
+		return "";
+	}
+	std::string Arguments = Packet.substr(1);
+	switch (Packet[0]) {
+	case '?': return "S05";
+	case '\x03': return "S02";
+	case 'g': return Registers();
+	case 'G': {
+		u32 Values[6] = {}; // All parsed before any is set, so a malformed packet changes nothing
+		for (int Number = 0, Cursor = 0; Number < 6; ++Number) {
+			int Width = Number < 4 ? 1 : 2;
+			for (int Byte = 0; Byte < Width; ++Byte, Cursor += 2) {
+				int High = Cursor + 1 < static_cast<int>(Arguments.size()) ? Nibble(Arguments[Cursor]) : -1;
+				int Low = High >= 0 ? Nibble(Arguments[Cursor + 1]) : -1;
+				if (Low < 0) {
+					return "E01";
+				}
+				Values[Number] |= static_cast<u32>(High << 4 | Low) << (8 * Byte);
+			}
+		}
+		for (int Number = 0; Number < 6; ++Number) {
+			SetRegister(Number, Values[Number]);
+		}
+		return "OK";
+	}
+	case 'p': {
+		int Number = std::strtol(Arguments.c_str(), nullptr, 16);
+		std::string All = Registers();
+		static constexpr int Offsets[] = { 0, 2, 4, 6, 8, 12, 16 };
+		return Number >= 0 && Number < 6 ? All.substr(Offsets[Number], Offsets[Number + 1] - Offsets[Number]) : "E01";
+	}
+	case 'P': {
+		size_t Equals = Arguments.find('=');
+		if (Equals == std::string::npos) {
+			return "E01";
+		}
+		u32 Value = 0;
+		for (size_t i = Equals + 1, Shift = 0; i + 1 < Arguments.size(); i += 2, Shift += 8) {
+			int High = Nibble(Arguments[i]), Low = Nibble(Arguments[i + 1]);
+			if (High < 0 || Low < 0) {
+				return "E01";
+			}
+			Value |= static_cast<u32>(High << 4 | Low) << Shift;
+		}
+		return SetRegister(std::strtol(Arguments.c_str(), nullptr, 16), Value) ? "OK" : "E01";
+	}
+	case 'm': return ReadMemory(Arguments);
+	case 'M': return WriteMemory(Arguments, false);
+	case 'X': return WriteMemory(Arguments, true);
+	case 'Z': return Breakpoint(Arguments, true);
+	case 'z': return Breakpoint(Arguments, false);
+	case 'c': return Resume(Arguments, false);
+	case 's': return Resume(Arguments, true);
+	case 'H': return "OK";
+	case 'D':
+		Detach();
+		return "OK";
+	case 'k':
+		Killed = true;
+		return "";
+	case 'q':
+		if (Packet.compare(0, 10, "qSupported") == 0) {
+			return "PacketSize=1000;qXfer:features:read+;QStartNoAckMode+";
+		}
+		if (Packet.compare(0, 20, "qXfer:features:read:") == 0) {
+			return Features(Packet.substr(20));
+		}
+		if (Packet == "qAttached") return "1";
+		if (Packet == "qC") return "QC1";
+		if (Packet == "qfThreadInfo") return "m1";
+		if (Packet == "qsThreadInfo") return "l";
+		return "";
+	case 'Q':
+		if (Packet == "QStartNoAckMode") {
+			NoAck = true; // Takes effect after this packet's own ack
+			return "OK";
+		}
+		return "";
+	default:
+		return "";
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "6502.h"
+#include "run_loop.h"
+
+/*
+	GDB remote serial protocol target for the core. The transport belongs to the caller: Receive
+	splits incoming bytes into packets and produces the acks, Handle turns one packet's payload
+	into the reply's, and Frame wraps that for sending.
+
+	Registers are a, x, y, p (8 bits each), then sp and pc (16 bits, little-endian), described to
+	GDB by the target.xml served through qXfer. Memory reads copy the whole requested block in one
+	pass. Breakpoints are the RunLoop's bitmap; in an instrumented build the core's Watchpoints
+	back Z2-Z4, attached only while a client is, so a detached guest records no hits. Continue runs the debug loop in Slice-cycle runs and polls Interrupted between
+	them, which lets a caller watch its transport for ^C.
+*/
+class GdbStub {
+public:
+	explicit GdbStub(NMOS6502& M6502);
+	~GdbStub();
+	NMOS6502& M6502;
+	RunLoop Loop;
+	std::function<bool()> Interrupted; // True stops a continue with SIGINT
+	u64 Slice = 20000;
+	bool Attached = true; // Cleared by D, after which the caller runs the fast loop
+	bool Killed = false; // Set by k, which has no reply
+
+	/* A client connected, or went away without a D; the constructor attaches */
+	void Attach();
+	void Detach();
+
+	std::string Handle(const std::string& Packet);
+	/* Appends complete, checksummed packets to Packets; Acks gets what to send back */
+	void Receive(const char* Bytes, size_t Length, std::vector<std::string>& Packets, std::string& Acks);
+	static std::string Frame(const std::string& Payload);
+
+private:
+	std::string Pending; // Bytes of a packet not yet complete
+	bool NoAck = false;
+#ifdef NMOS6502_INSTRUMENTATION
+	WatchpointMap Watches;
+#endif
+
+	std::string Registers() const;
+	bool SetRegister(int Number, u32 Value);
+	std::string ReadMemory(const std::string& Arguments) const;
+	std::string WriteMemory(const std::string& Arguments, bool Binary);
+	std::string Breakpoint(const std::string& Arguments, bool Insert);
+	std::string Resume(const std::string& Arguments, bool Step);
+	std::string Features(const std::string& Arguments) const;
+};
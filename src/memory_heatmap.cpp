@@ -0,0 +1,141 @@
+#include "memory_heatmap.h"
+#include <cstdio>
+#include <cstring>
+
+static constexpr char HeatmapMagic[8] = { 'M', '6', '5', '0', '2', 'H', 'M', 'P' };
+static constexpr uint32_t HeatmapVersion = 1;
+
+MemoryHeatmap::MemoryHeatmap() {
+	Clear();
+}
+
+void MemoryHeatmap::Clear() {
+	Reads.assign(0x10000, 0);
+	Writes.assign(0x10000, 0);
+	Executes.assign(0x10000, 0);
+	LastWriter.assign(0x10000, 0);
+}
+
+std::optional<uint16_t> MemoryHeatmap::WhoWrote(uint16_t Address) const {
+	if (Writes[Address] == 0) {
+		return std::nullopt;
+	}
+	return LastWriter[Address];
+}
+
+static void PutVarint(std::ostream& Out, uint64_t Value) {
+	while (Value >= 0x80) {
+		Out.put(static_cast<char>(Value | 0x80));
+		Value >>= 7;
+	}
+	Out.put(static_cast<char>(Value));
+}
+
+static bool GetVarint(std::istream& In, uint64_t& Value) {
+	Value = 0;
+	for (int Shift = 0; Shift < 64; Shift += 7) {
+		int Byte = In.get();
+		if (Byte == EOF) {
+			return false;
+		}
+		Value |= static_cast<uint64_t>(Byte & 0x7F) << Shift;
+		if (!(Byte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void PutLittleEndian(std::ostream& Out, uint32_t Value, int Bytes) {
+	for (int i = 0; i < Bytes; ++i) {
+		Out.put(static_cast<char>(Value >> (8 * i)));
+	}
+}
+
+static bool GetLittleEndian(std::istream& In, uint32_t& Value, int Bytes) {
+	Value = 0;
+	for (int i = 0; i < Bytes; ++i) {
+		int Byte = In.get();
+		if (Byte == EOF) {
+			return false;
+		}
+		Value |= static_cast<uint32_t>(Byte) << (8 * i);
+	}
+	return true;
+}
+
+bool MemoryHeatmap::Save(std::ostream& Out) const {
+	uint32_t Entries = 0;
+	for (uint32_t Address = 0; Address < 0x10000; ++Address) {
+		Entries += Reads[Address] || Writes[Address] || Executes[Address];
+	}
+	Out.write(HeatmapMagic, sizeof(HeatmapMagic));
+	PutLittleEndian(Out, HeatmapVersion, 4);
+	PutLittleEndian(Out, Entries, 4);
+	for (uint32_t Address = 0; Address < 0x10000; ++Address) {
+		if (!Reads[Address] && !Writes[Address] && !Executes[Address]) {
+			continue;
+		}
+		PutLittleEndian(Out, Address, 2);
+		PutVarint(Out, Reads[Address]);
+		PutVarint(Out, Writes[Address]);
+		PutVarint(Out, Executes[Address]);
+		PutLittleEndian(Out, LastWriter[Address], 2);
+	}
+	return static_cast<bool>(Out);
+}
+
+bool MemoryHeatmap::Load(std::istream& In) {
+	char Magic[sizeof(HeatmapMagic)];
+	uint32_t Version, Entries;
+	if (!In.read(Magic, sizeof(Magic)) || std::memcmp(Magic, HeatmapMagic, sizeof(Magic)) != 0
+		|| !GetLittleEndian(In, Version, 4) || Version != HeatmapVersion || !GetLittleEndian(In, Entries, 4) || Entries > 0x10000) {
+		return false;
+	}
+	Clear();
+	for (uint32_t i = 0; i < Entries; ++i) {
+		uint32_t Address, Writer;
+		if (!GetLittleEndian(In, Address, 2) || !GetVarint(In, Reads[Address]) || !GetVarint(In, Writes[Address])
+			|| !GetVarint(In, Executes[Address]) || !GetLittleEndian(In, Writer, 2)) {
+			Clear();
+			return false;
+		}
+		LastWriter[Address] = static_cast<uint16_t>(Writer);
+	}
+	return true;
+}
+
+void MemoryHeatmap::WriteCSV(std::ostream& Out) const {
+	Out << "address,reads,writes,executes,last_writer\n";
+	char Line[96];
+	for (uint32_t Address = 0; Address < 0x10000; ++Address) {
+		if (!Reads[Address] && !Writes[Address] && !Executes[Address]) {
+			continue;
+		}
+		char Writer[8] = "";
+		if (Writes[Address]) {
+			std::snprintf(Writer, sizeof(Writer), "%04X", LastWriter[Address]);
+		}
+		std::snprintf(Line, sizeof(Line), "%04X,%llu,%llu,%llu,%s\n", Address, static_cast<unsigned long long>(Reads[Address]),
+			static_cast<unsigned long long>(Writes[Address]), static_cast<unsigned long long>(Executes[Address]), Writer);
+		Out << Line;
+	}
+}
+
+void MemoryHeatmap::WritePageCSV(std::ostream& Out) const {
+	Out << "page,reads,writes,executes\n";
+	char Line[80];
+	for (uint32_t Page = 0; Page < 0x100; ++Page) {
+		uint64_t PageReads = 0, PageWrites = 0, PageExecutes = 0;
+		for (uint32_t Address = Page << 8; Address < (Page + 1) << 8; ++Address) {
+			PageReads += Reads[Address];
+			PageWrites += Writes[Address];
+			PageExecutes += Executes[Address];
+		}
+		if (PageReads || PageWrites || PageExecutes) {
+			std::snprintf(Line, sizeof(Line), "%02X,%llu,%llu,%llu\n", Page, static_cast<unsigned long long>(PageReads),
+				static_cast<unsigned long long>(PageWrites), static_cast<unsigned long long>(PageExecutes));
+			Out << Line;
+		}
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+/*
+	Per-address memory traffic. Attach to NMOS6502::Heatmap in an instrumented build: instruction
+	stream fetches count as executes, operand, pointer and stack accesses as reads and writes, and
+	every write remembers the address of the instruction that made it.
+*/
+class MemoryHeatmap {
+public:
+	MemoryHeatmap();
+	std::vector<uint64_t> Reads;
+	std::vector<uint64_t> Writes;
+	std::vector<uint64_t> Executes;
+	std::vector<uint16_t> LastWriter; // Only meaningful where Writes is non-zero
+	uint16_t Instruction = 0; // Address of the instruction being executed, kept up to date by the core
+
+	void Read(uint16_t Address) {
+		++Reads[Address];
+	}
+
+	void Write(uint16_t Address) {
+		++Writes[Address];
+		LastWriter[Address] = Instruction;
+	}
+
+	void Execute(uint16_t Address) {
+		++Executes[Address];
+	}
+
+	void Clear();
+	/* Address of the instruction that last wrote Address, if anything did */
+	std::optional<uint16_t> WhoWrote(uint16_t Address) const;
+
+	/*
+		Compact binary export of the touched addresses only: "M6502HMP", u32 version, u32 entries,
+		then per entry u16 address, varint reads, writes and executes, u16 last writer (little-endian).
+	*/
+	bool Save(std::ostream& Out) const;
+	bool Load(std::istream& In);
+	/* address,reads,writes,executes,last_writer for every touched address */
+	void WriteCSV(std::ostream& Out) const;
+	/* The same totals per 256-byte page */
+	void WritePageCSV(std::ostream& Out) const;
+};
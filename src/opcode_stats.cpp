@@ -0,0 +1,75 @@
+#include "opcode_stats.h"
+#include "opcodes.h"
+#include <algorithm>
+#include <iomanip>
+#include <numeric>
+#include <vector>
+
+void OpcodeStats::Clear() {
+	*this = OpcodeStats{};
+}
+
+uint64_t OpcodeStats::BranchesNotTaken(uint8_t Opcode) const {
+	return IsBranch(Opcode) ? Executions[Opcode] - BranchesTaken[Opcode] : 0;
+}
+
+uint64_t OpcodeStats::TotalExecutions() const {
+	return std::accumulate(std::begin(Executions), std::end(Executions), uint64_t{ 0 });
+}
+
+uint64_t OpcodeStats::TotalCycles() const {
+	return std::accumulate(std::begin(Cycles), std::end(Cycles), uint64_t{ 0 });
+}
+
+void OpcodeStats::Report(std::ostream& Out) const {
+	std::vector<int> Order;
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		if (Executions[Opcode] != 0) {
+			Order.push_back(Opcode);
+		}
+	}
+	std::stable_sort(Order.begin(), Order.end(), [this](int L, int R) { return Cycles[L] > Cycles[R]; });
+
+	uint64_t Total = TotalCycles();
+	std::ios_base::fmtflags Flags = Out.flags();
+	Out << "Opcode  Instruction      Executions          Cycles   Avg  Cycle%   PageX       Taken    NotTaken\n";
+	for (int Opcode : Order) {
+		const OpcodeInfo& Info = OpcodeTable[Opcode];
+		Out << "0x" << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << Opcode << std::dec << std::setfill(' ')
+			<< "    " << Info.Mnemonic << ' ' << std::left << std::setw(12) << AddressingModeNames[Info.Mode] << std::right
+			<< std::setw(12) << Executions[Opcode]
+			<< std::setw(16) << Cycles[Opcode]
+			<< std::fixed << std::setprecision(2)
+			<< std::setw(6) << static_cast<double>(Cycles[Opcode]) / Executions[Opcode]
+			<< std::setw(7) << 100.0 * Cycles[Opcode] / Total << '%'
+			<< std::setw(8) << PageCrosses[Opcode];
+		if (IsBranch(static_cast<uint8_t>(Opcode))) {
+			Out << std::setw(12) << BranchesTaken[Opcode] << std::setw(12) << BranchesNotTaken(static_cast<uint8_t>(Opcode));
+		}
+		Out << '\n';
+	}
+	Out << "Total: " << TotalExecutions() << " instructions, " << Total << " cycles\n";
+	Out.flags(Flags);
+}
+
+void OpcodeStats::ReportJSON(std::ostream& Out) const {
+	Out << "{\n\t\"total_executions\": " << TotalExecutions() << ",\n\t\"total_cycles\": " << TotalCycles() << ",\n\t\"opcodes\": [";
+	bool First = true;
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		if (Executions[Opcode] == 0) {
+			continue;
+		}
+		const OpcodeInfo& Info = OpcodeTable[Opcode];
+		Out << (First ? "\n" : ",\n") << "\t\t{ \"opcode\": " << Opcode
+			<< ", \"mnemonic\": \"" << Info.Mnemonic << "\", \"mode\": \"" << AddressingModeNames[Info.Mode]
+			<< "\", \"executions\": " << Executions[Opcode]
+			<< ", \"cycles\": " << Cycles[Opcode]
+			<< ", \"page_crosses\": " << PageCrosses[Opcode];
+		if (IsBranch(static_cast<uint8_t>(Opcode))) {
+			Out << ", \"branches_taken\": " << BranchesTaken[Opcode] << ", \"branches_not_taken\": " << BranchesNotTaken(static_cast<uint8_t>(Opcode));
+		}
+		Out << " }";
+		First = false;
+	}
+	Out << "\n\t]\n}\n";
+}
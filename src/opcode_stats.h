@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+
+/*
+	Per-opcode execution counters, fed from NMOS6502::Execute when the core is
+	built with NMOS6502_INSTRUMENTATION. Untaken branches are not counted separately:
+	every execution of a branch opcode that did not reach Branch() was untaken.
+*/
+struct OpcodeStats {
+	uint64_t Executions[0x100] = {};
+	uint64_t Cycles[0x100] = {};
+	uint64_t PageCrosses[0x100] = {};
+	uint64_t BranchesTaken[0x100] = {};
+	uint8_t Current = 0; // Opcode currently being dispatched
+
+	void Clear();
+	uint64_t BranchesNotTaken(uint8_t Opcode) const;
+	uint64_t TotalExecutions() const;
+	uint64_t TotalCycles() const;
+
+	void Report(std::ostream& Out) const;
+	void ReportJSON(std::ostream& Out) const;
+};
@@ -0,0 +1,693 @@
+#pragma once
+#include <cstdint>
+
+/*
+	Static description of the documented NMOS 6502 instruction set, indexed by opcode.
+	Undocumented opcodes are listed as "???" with implied addressing.
+*/
+
+enum AddressingMode : uint8_t {
+	Implied,
+	Accumulator,
+	Immediate,
+	ZeroPage,
+	ZeroPageX,
+	ZeroPageY,
+	Absolute,
+	AbsoluteX,
+	AbsoluteY,
+	Indirect,
+	IndirectX,
+	IndirectY,
+	Relative
+};
+
+inline constexpr const char* AddressingModeNames[] = {
+	"Implied", "Accumulator", "Immediate", "ZeroPage", "ZeroPageX", "ZeroPageY",
+	"Absolute", "AbsoluteX", "AbsoluteY", "Indirect", "IndirectX", "IndirectY", "Relative"
+};
+
+struct OpcodeInfo {
+	const char* Mnemonic;
+	AddressingMode Mode;
+};
+
+constexpr uint8_t OperandLength(AddressingMode Mode) {
+	switch (Mode) {
+	case Implied:
+	case Accumulator:
+		return 0;
+	case Absolute:
+	case AbsoluteX:
+	case AbsoluteY:
+	case Indirect:
+		return 2;
+	default:
+		return 1;
+	}
+}
+
+constexpr bool IsBranch(uint8_t Opcode) {
+	return (Opcode & 0x1F) == 0x10;
+}
+
+inline constexpr OpcodeInfo OpcodeTable[0x100] = {
+	{ "BRK", Implied },     // 0x00
+	{ "ORA", IndirectX },   // 0x01
+	{ "???", Implied },     // 0x02
+	{ "???", Implied },     // 0x03
+	{ "???", Implied },     // 0x04
+	{ "ORA", ZeroPage },    // 0x05
+	{ "ASL", ZeroPage },    // 0x06
+	{ "???", Implied },     // 0x07
+	{ "PHP", Implied },     // 0x08
+	{ "ORA", Immediate },   // 0x09
+	{ "ASL", Accumulator }, // 0x0A
+	{ "???", Implied },     // 0x0B
+	{ "???", Implied },     // 0x0C
+	{ "ORA", Absolute },    // 0x0D
+	{ "ASL", Absolute },    // 0x0E
+	{ "???", Implied },     // 0x0F
+	{ "BPL", Relative },    // 0x10
+	{ "ORA", IndirectY },   // 0x11
+	{ "???", Implied },     // 0x12
+	{ "???", Implied },     // 0x13
+	{ "???", Implied },     // 0x14
+	{ "ORA", ZeroPageX },   // 0x15
+	{ "ASL", ZeroPageX },   // 0x16
+	{ "???", Implied },     // 0x17
+	{ "CLC", Implied },     // 0x18
+	{ "ORA", AbsoluteY },   // 0x19
+	{ "???", Implied },     // 0x1A
+	{ "???", Implied },     // 0x1B
+	{ "???", Implied },     // 0x1C
+	{ "ORA", AbsoluteX },   // 0x1D
+	{ "ASL", AbsoluteX },   // 0x1E
+	{ "???", Implied },     // 0x1F
+	{ "JSR", Absolute },    // 0x20
+	{ "AND", IndirectX },   // 0x21
+	{ "???", Implied },     // 0x22
+	{ "???", Implied },     // 0x23
+	{ "BIT", ZeroPage },    // 0x24
+	{ "AND", ZeroPage },    // 0x25
+	{ "ROL", ZeroPage },    // 0x26
+	{ "???", Implied },     // 0x27
+	{ "PLP", Implied },     // 0x28
+	{ "AND", Immediate },   // 0x29
+	{ "ROL", Accumulator }, // 0x2A
+	{ "???", Implied },     // 0x2B
+	{ "BIT", Absolute },    // 0x2C
+	{ "AND", Absolute },    // 0x2D
+	{ "ROL", Absolute },    // 0x2E
+	{ "???", Implied },     // 0x2F
+	{ "BMI", Relative },    // 0x30
+	{ "AND", IndirectY },   // 0x31
+	{ "???", Implied },     // 0x32
+	{ "???", Implied },     // 0x33
+	{ "???", Implied },     // 0x34
+	{ "AND", ZeroPageX },   // 0x35
+	{ "ROL", ZeroPageX },   // 0x36
+	{ "???", Implied },     // 0x37
+	{ "SEC", Implied },     // 0x38
+	{ "AND", AbsoluteY },   // 0x39
+	{ "???", Implied },     // 0x3A
+	{ "???", Implied },     // 0x3B
+	{ "???", Implied },     // 0x3C
+	{ "AND", AbsoluteX },   // 0x3D
+	{ "ROL", AbsoluteX },   // 0x3E
+	{ "???", Implied },     // 0x3F
+	{ "RTI", Implied },     // 0x40
+	{ "EOR", IndirectX },   // 0x41
+	{ "???", Implied },     // 0x42
+	{ "???", Implied },     // 0x43
+	{ "???", Implied },     // 0x44
+	{ "EOR", ZeroPage },    // 0x45
+	{ "LSR", ZeroPage },    // 0x46
+	{ "???", Implied },     // 0x47
+	{ "PHA", Implied },     // 0x48
+	{ "EOR", Immediate },   // 0x49
+	{ "LSR", Accumulator }, // 0x4A
+	{ "???", Implied },     // 0x4B
+	{ "JMP", Absolute },    // 0x4C
+	{ "EOR", Absolute },    // 0x4D
+	{ "LSR", Absolute },    // 0x4E
+	{ "???", Implied },     // 0x4F
+	{ "BVC", Relative },    // 0x50
+	{ "EOR", IndirectY },   // 0x51
+	{ "???", Implied },     // 0x52
+	{ "???", Implied },     // 0x53
+	{ "???", Implied },     // 0x54
+	{ "EOR", ZeroPageX },   // 0x55
+	{ "LSR", ZeroPageX },   // 0x56
+	{ "???", Implied },     // 0x57
+	{ "CLI", Implied },     // 0x58
+	{ "EOR", AbsoluteY },   // 0x59
+	{ "???", Implied },     // 0x5A
+	{ "???", Implied },     // 0x5B
+	{ "???", Implied },     // 0x5C
+	{ "EOR", AbsoluteX },   // 0x5D
+	{ "LSR", AbsoluteX },   // 0x5E
+	{ "???", Implied },     // 0x5F
+	{ "RTS", Implied },     // 0x60
+	{ "ADC", IndirectX },   // 0x61
+	{ "???", Implied },     // 0x62
+	{ "???", Implied },     // 0x63
+	{ "???", Implied },     // 0x64
+	{ "ADC", ZeroPage },    // 0x65
+	{ "ROR", ZeroPage },    // 0x66
+	{ "???", Implied },     // 0x67
+	{ "PLA", Implied },     // 0x68
+	{ "ADC", Immediate },   // 0x69
+	{ "ROR", Accumulator }, // 0x6A
+	{ "???", Implied },     // 0x6B
+	{ "JMP", Indirect },    // 0x6C
+	{ "ADC", Absolute },    // 0x6D
+	{ "ROR", Absolute },    // 0x6E
+	{ "???", Implied },     // 0x6F
+	{ "BVS", Relative },    // 0x70
+	{ "ADC", IndirectY },   // 0x71
+	{ "???", Implied },     // 0x72
+	{ "???", Implied },     // 0x73
+	{ "???", Implied },     // 0x74
+	{ "ADC", ZeroPageX },   // 0x75
+	{ "ROR", ZeroPageX },   // 0x76
+	{ "???", Implied },     // 0x77
+	{ "SEI", Implied },     // 0x78
+	{ "ADC", AbsoluteY },   // 0x79
+	{ "???", Implied },     // 0x7A
+	{ "???", Implied },     // 0x7B
+	{ "???", Implied },     // 0x7C
+	{ "ADC", AbsoluteX },   // 0x7D
+	{ "ROR", AbsoluteX },   // 0x7E
+	{ "???", Implied },     // 0x7F
+	{ "???", Implied },     // 0x80
+	{ "STA", IndirectX },   // 0x81
+	{ "???", Implied },     // 0x82
+	{ "???", Implied },     // 0x83
+	{ "STY", ZeroPage },    // 0x84
+	{ "STA", ZeroPage },    // 0x85
+	{ "STX", ZeroPage },    // 0x86
+	{ "???", Implied },     // 0x87
+	{ "DEY", Implied },     // 0x88
+	{ "???", Implied },     // 0x89
+	{ "TXA", Implied },     // 0x8A
+	{ "???", Implied },     // 0x8B
+	{ "STY", Absolute },    // 0x8C
+	{ "STA", Absolute },    // 0x8D
+	{ "STX", Absolute },    // 0x8E
+	{ "???", Implied },     // 0x8F
+	{ "BCC", Relative },    // 0x90
+	{ "STA", IndirectY },   // 0x91
+	{ "???", Implied },     // 0x92
+	{ "???", Implied },     // 0x93
+	{ "STY", ZeroPageX },   // 0x94
+	{ "STA", ZeroPageX },   // 0x95
+	{ "STX", ZeroPageY },   // 0x96
+	{ "???", Implied },     // 0x97
+	{ "TYA", Implied },     // 0x98
+	{ "STA", AbsoluteY },   // 0x99
+	{ "TXS", Implied },     // 0x9A
+	{ "???", Implied },     // 0x9B
+	{ "???", Implied },     // 0x9C
+	{ "STA", AbsoluteX },   // 0x9D
+	{ "???", Implied },     // 0x9E
+	{ "???", Implied },     // 0x9F
+	{ "LDY", Immediate },   // 0xA0
+	{ "LDA", IndirectX },   // 0xA1
+	{ "LDX", Immediate },   // 0xA2
+	{ "???", Implied },     // 0xA3
+	{ "LDY", ZeroPage },    // 0xA4
+	{ "LDA", ZeroPage },    // 0xA5
+	{ "LDX", ZeroPage },    // 0xA6
+	{ "???", Implied },     // 0xA7
+	{ "TAY", Implied },     // 0xA8
+	{ "LDA", Immediate },   // 0xA9
+	{ "TAX", Implied },     // 0xAA
+	{ "???", Implied },     // 0xAB
+	{ "LDY", Absolute },    // 0xAC
+	{ "LDA", Absolute },    // 0xAD
+	{ "LDX", Absolute },    // 0xAE
+	{ "???", Implied },     // 0xAF
+	{ "BCS", Relative },    // 0xB0
+	{ "LDA", IndirectY },   // 0xB1
+	{ "???", Implied },     // 0xB2
+	{ "???", Implied },     // 0xB3
+	{ "LDY", ZeroPageX },   // 0xB4
+	{ "LDA", ZeroPageX },   // 0xB5
+	{ "LDX", ZeroPageY },   // 0xB6
+	{ "???", Implied },     // 0xB7
+	{ "CLV", Implied },     // 0xB8
+	{ "LDA", AbsoluteY },   // 0xB9
+	{ "TSX", Implied },     // 0xBA
+	{ "???", Implied },     // 0xBB
+	{ "LDY", AbsoluteX },   // 0xBC
+	{ "LDA", AbsoluteX },   // 0xBD
+	{ "LDX", AbsoluteY },   // 0xBE
+	{ "???", Implied },     // 0xBF
+	{ "CPY", Immediate },   // 0xC0
+	{ "CMP", IndirectX },   // 0xC1
+	{ "???", Implied },     // 0xC2
+	{ "???", Implied },     // 0xC3
+	{ "CPY", ZeroPage },    // 0xC4
+	{ "CMP", ZeroPage },    // 0xC5
+	{ "DEC", ZeroPage },    // 0xC6
+	{ "???", Implied },     // 0xC7
+	{ "INY", Implied },     // 0xC8
+	{ "CMP", Immediate },   // 0xC9
+	{ "DEX", Implied },     // 0xCA
+	{ "???", Implied },     // 0xCB
+	{ "CPY", Absolute },    // 0xCC
+	{ "CMP", Absolute },    // 0xCD
+	{ "DEC", Absolute },    // 0xCE
+	{ "???", Implied },     // 0xCF
+	{ "BNE", Relative },    // 0xD0
+	{ "CMP", IndirectY },   // 0xD1
+	{ "???", Implied },     // 0xD2
+	{ "???", Implied },     // 0xD3
+	{ "???", Implied },     // 0xD4
+	{ "CMP", ZeroPageX },   // 0xD5
+	{ "DEC", ZeroPageX },   // 0xD6
+	{ "???", Implied },     // 0xD7
+	{ "CLD", Implied },     // 0xD8
+	{ "CMP", AbsoluteY },   // 0xD9
+	{ "???", Implied },     // 0xDA
+	{ "???", Implied },     // 0xDB
+	{ "???", Implied },     // 0xDC
+	{ "CMP", AbsoluteX },   // 0xDD
+	{ "DEC", AbsoluteX },   // 0xDE
+	{ "???", Implied },     // 0xDF
+	{ "CPX", Immediate },   // 0xE0
+	{ "SBC", IndirectX },   // 0xE1
+	{ "???", Implied },     // 0xE2
+	{ "???", Implied },     // 0xE3
+	{ "CPX", ZeroPage },    // 0xE4
+	{ "SBC", ZeroPage },    // 0xE5
+	{ "INC", ZeroPage },    // 0xE6
+	{ "???", Implied },     // 0xE7
+	{ "INX", Implied },     // 0xE8
+	{ "SBC", Immediate },   // 0xE9
+	{ "NOP", Implied },     // 0xEA
+	{ "???", Implied },     // 0xEB
+	{ "CPX", Absolute },    // 0xEC
+	{ "SBC", Absolute },    // 0xED
+	{ "INC", Absolute },    // 0xEE
+	{ "???", Implied },     // 0xEF
+	{ "BEQ", Relative },    // 0xF0
+	{ "SBC", IndirectY },   // 0xF1
+	{ "???", Implied },     // 0xF2
+	{ "???", Implied },     // 0xF3
+	{ "???", Implied },     // 0xF4
+	{ "SBC", ZeroPageX },   // 0xF5
+	{ "INC", ZeroPageX },   // 0xF6
+	{ "???", Implied },     // 0xF7
+	{ "SED", Implied },     // 0xF8
+	{ "SBC", AbsoluteY },   // 0xF9
+	{ "???", Implied },     // 0xFA
+	{ "???", Implied },     // 0xFB
+	{ "???", Implied },     // 0xFC
+	{ "SBC", AbsoluteX },   // 0xFD
+	{ "INC", AbsoluteX },   // 0xFE
+	{ "???", Implied },     // 0xFF
+};
+
+constexpr uint8_t InstructionLength(uint8_t Opcode) {
+	return 1 + OperandLength(OpcodeTable[Opcode].Mode);
+}
+
+/*
+	Operand decoding in this core's dialect, shared by the tools that read its code. The operand
+	starts after the opcode, except JSR's target, which follows the BIT abs opcode its return to
+	opcode + 1 runs.
+*/
+constexpr uint8_t OperandOffset(uint8_t Opcode) {
+	return Opcode == 0x20 ? 2 : 1;
+}
+
+/* Bytes the instruction takes in memory, as the assembler lays it out */
+constexpr uint8_t DialectLength(uint8_t Opcode) {
+	return OperandOffset(Opcode) + OperandLength(OpcodeTable[Opcode].Mode);
+}
+
+/*
+	The operand of the instruction whose opcode and three following bytes are in Bytes, at Address:
+	absolute data operands are high byte first, JMP and JSR targets low byte first, and branch
+	targets relative to the opcode. Byte operands are Bytes[1].
+*/
+constexpr uint16_t OperandValue(const uint8_t* Bytes, uint16_t Address) {
+	uint8_t Opcode = Bytes[0];
+	if (IsBranch(Opcode)) {
+		return static_cast<uint16_t>(Address + static_cast<int8_t>(Bytes[1]));
+	}
+	if (Opcode == 0x4C || Opcode == 0x6C) {
+		return static_cast<uint16_t>(Bytes[1] | Bytes[2] << 8);
+	}
+	if (Opcode == 0x20) {
+		return static_cast<uint16_t>(Bytes[2] | Bytes[3] << 8);
+	}
+	return OperandLength(OpcodeTable[Opcode].Mode) == 2 ? static_cast<uint16_t>(Bytes[1] << 8 | Bytes[2]) : Bytes[1];
+}
+
+/* Coarse instruction groups, for reports that do not want 151 rows */
+enum OpcodeClass : uint8_t {
+	ClassLoad,
+	ClassStore,
+	ClassTransfer,
+	ClassStack,
+	ClassArithmetic,
+	ClassLogic,
+	ClassShift,
+	ClassIncrement,
+	ClassCompare,
+	ClassBranch,
+	ClassJump,
+	ClassFlag,
+	ClassOther,
+	OpcodeClassCount
+};
+
+inline constexpr const char* OpcodeClassNames[] = {
+	"load", "store", "transfer", "stack", "arithmetic", "logic", "shift",
+	"increment", "compare", "branch", "jump", "flag", "other"
+};
+
+constexpr bool MnemonicIn(const char* Mnemonic, const char* List) {
+	for (; *List; List += *List == ' ' ? 1 : 3) {
+		if (*List != ' ' && List[0] == Mnemonic[0] && List[1] == Mnemonic[1] && List[2] == Mnemonic[2]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+constexpr OpcodeClass ClassOf(uint8_t Opcode) {
+	const char* Mnemonic = OpcodeTable[Opcode].Mnemonic;
+	if (IsBranch(Opcode)) return ClassBranch;
+	if (MnemonicIn(Mnemonic, "LDA LDX LDY")) return ClassLoad;
+	if (MnemonicIn(Mnemonic, "STA STX STY")) return ClassStore;
+	if (MnemonicIn(Mnemonic, "TAX TAY TXA TYA TSX TXS")) return ClassTransfer;
+	if (MnemonicIn(Mnemonic, "PHA PHP PLA PLP")) return ClassStack;
+	if (MnemonicIn(Mnemonic, "ADC SBC")) return ClassArithmetic;
+	if (MnemonicIn(Mnemonic, "AND ORA EOR BIT")) return ClassLogic;
+	if (MnemonicIn(Mnemonic, "ASL LSR ROL ROR")) return ClassShift;
+	if (MnemonicIn(Mnemonic, "INC DEC INX INY DEX DEY")) return ClassIncrement;
+	if (MnemonicIn(Mnemonic, "CMP CPX CPY")) return ClassCompare;
+	if (MnemonicIn(Mnemonic, "JMP JSR RTS RTI BRK")) return ClassJump;
+	if (MnemonicIn(Mnemonic, "CLC SEC CLI SEI CLV CLD SED")) return ClassFlag;
+	return ClassOther;
+}
+
+static_assert(ClassOf(0xA9) == ClassLoad && ClassOf(0x6C) == ClassJump && ClassOf(0xD0) == ClassBranch && ClassOf(0xEA) == ClassOther);
+
+/*
+	Documented NMOS 6502 cycle counts. PageCross marks the reads that take one more cycle when the
+	indexed address leaves the base page; for branches it means one more when taken and another
+	when the target is on a different page.
+*/
+struct OpcodeTiming {
+	uint8_t Cycles;
+	bool PageCross;
+};
+
+inline constexpr OpcodeTiming OpcodeTimings[0x100] = {
+	{ 7, false }, // 0x00 BRK Implied
+	{ 6, false }, // 0x01 ORA IndirectX
+	{ 0, false }, // 0x02 ???
+	{ 0, false }, // 0x03 ???
+	{ 0, false }, // 0x04 ???
+	{ 3, false }, // 0x05 ORA ZeroPage
+	{ 5, false }, // 0x06 ASL ZeroPage
+	{ 0, false }, // 0x07 ???
+	{ 3, false }, // 0x08 PHP Implied
+	{ 2, false }, // 0x09 ORA Immediate
+	{ 2, false }, // 0x0A ASL Accumulator
+	{ 0, false }, // 0x0B ???
+	{ 0, false }, // 0x0C ???
+	{ 4, false }, // 0x0D ORA Absolute
+	{ 6, false }, // 0x0E ASL Absolute
+	{ 0, false }, // 0x0F ???
+	{ 2, true  }, // 0x10 BPL Relative
+	{ 5, true  }, // 0x11 ORA IndirectY
+	{ 0, false }, // 0x12 ???
+	{ 0, false }, // 0x13 ???
+	{ 0, false }, // 0x14 ???
+	{ 4, false }, // 0x15 ORA ZeroPageX
+	{ 6, false }, // 0x16 ASL ZeroPageX
+	{ 0, false }, // 0x17 ???
+	{ 2, false }, // 0x18 CLC Implied
+	{ 4, true  }, // 0x19 ORA AbsoluteY
+	{ 0, false }, // 0x1A ???
+	{ 0, false }, // 0x1B ???
+	{ 0, false }, // 0x1C ???
+	{ 4, true  }, // 0x1D ORA AbsoluteX
+	{ 7, false }, // 0x1E ASL AbsoluteX
+	{ 0, false }, // 0x1F ???
+	{ 6, false }, // 0x20 JSR Absolute
+	{ 6, false }, // 0x21 AND IndirectX
+	{ 0, false }, // 0x22 ???
+	{ 0, false }, // 0x23 ???
+	{ 3, false }, // 0x24 BIT ZeroPage
+	{ 3, false }, // 0x25 AND ZeroPage
+	{ 5, false }, // 0x26 ROL ZeroPage
+	{ 0, false }, // 0x27 ???
+	{ 4, false }, // 0x28 PLP Implied
+	{ 2, false }, // 0x29 AND Immediate
+	{ 2, false }, // 0x2A ROL Accumulator
+	{ 0, false }, // 0x2B ???
+	{ 4, false }, // 0x2C BIT Absolute
+	{ 4, false }, // 0x2D AND Absolute
+	{ 6, false }, // 0x2E ROL Absolute
+	{ 0, false }, // 0x2F ???
+	{ 2, true  }, // 0x30 BMI Relative
+	{ 5, true  }, // 0x31 AND IndirectY
+	{ 0, false }, // 0x32 ???
+	{ 0, false }, // 0x33 ???
+	{ 0, false }, // 0x34 ???
+	{ 4, false }, // 0x35 AND ZeroPageX
+	{ 6, false }, // 0x36 ROL ZeroPageX
+	{ 0, false }, // 0x37 ???
+	{ 2, false }, // 0x38 SEC Implied
+	{ 4, true  }, // 0x39 AND AbsoluteY
+	{ 0, false }, // 0x3A ???
+	{ 0, false }, // 0x3B ???
+	{ 0, false }, // 0x3C ???
+	{ 4, true  }, // 0x3D AND AbsoluteX
+	{ 7, false }, // 0x3E ROL AbsoluteX
+	{ 0, false }, // 0x3F ???
+	{ 6, false }, // 0x40 RTI Implied
+	{ 6, false }, // 0x41 EOR IndirectX
+	{ 0, false }, // 0x42 ???
+	{ 0, false }, // 0x43 ???
+	{ 0, false }, // 0x44 ???
+	{ 3, false }, // 0x45 EOR ZeroPage
+	{ 5, false }, // 0x46 LSR ZeroPage
+	{ 0, false }, // 0x47 ???
+	{ 3, false }, // 0x48 PHA Implied
+	{ 2, false }, // 0x49 EOR Immediate
+	{ 2, false }, // 0x4A LSR Accumulator
+	{ 0, false }, // 0x4B ???
+	{ 3, false }, // 0x4C JMP Absolute
+	{ 4, false }, // 0x4D EOR Absolute
+	{ 6, false }, // 0x4E LSR Absolute
+	{ 0, false }, // 0x4F ???
+	{ 2, true  }, // 0x50 BVC Relative
+	{ 5, true  }, // 0x51 EOR IndirectY
+	{ 0, false }, // 0x52 ???
+	{ 0, false }, // 0x53 ???
+	{ 0, false }, // 0x54 ???
+	{ 4, false }, // 0x55 EOR ZeroPageX
+	{ 6, false }, // 0x56 LSR ZeroPageX
+	{ 0, false }, // 0x57 ???
+	{ 2, false }, // 0x58 CLI Implied
+	{ 4, true  }, // 0x59 EOR AbsoluteY
+	{ 0, false }, // 0x5A ???
+	{ 0, false }, // 0x5B ???
+	{ 0, false }, // 0x5C ???
+	{ 4, true  }, // 0x5D EOR AbsoluteX
+	{ 7, false }, // 0x5E LSR AbsoluteX
+	{ 0, false }, // 0x5F ???
+	{ 6, false }, // 0x60 RTS Implied
+	{ 6, false }, // 0x61 ADC IndirectX
+	{ 0, false }, // 0x62 ???
+	{ 0, false }, // 0x63 ???
+	{ 0, false }, // 0x64 ???
+	{ 3, false }, // 0x65 ADC ZeroPage
+	{ 5, false }, // 0x66 ROR ZeroPage
+	{ 0, false }, // 0x67 ???
+	{ 4, false }, // 0x68 PLA Implied
+	{ 2, false }, // 0x69 ADC Immediate
+	{ 2, false }, // 0x6A ROR Accumulator
+	{ 0, false }, // 0x6B ???
+	{ 5, false }, // 0x6C JMP Indirect
+	{ 4, false }, // 0x6D ADC Absolute
+	{ 6, false }, // 0x6E ROR Absolute
+	{ 0, false }, // 0x6F ???
+	{ 2, true  }, // 0x70 BVS Relative
+	{ 5, true  }, // 0x71 ADC IndirectY
+	{ 0, false }, // 0x72 ???
+	{ 0, false }, // 0x73 ???
+	{ 0, false }, // 0x74 ???
+	{ 4, false }, // 0x75 ADC ZeroPageX
+	{ 6, false }, // 0x76 ROR ZeroPageX
+	{ 0, false }, // 0x77 ???
+	{ 2, false }, // 0x78 SEI Implied
+	{ 4, true  }, // 0x79 ADC AbsoluteY
+	{ 0, false }, // 0x7A ???
+	{ 0, false }, // 0x7B ???
+	{ 0, false }, // 0x7C ???
+	{ 4, true  }, // 0x7D ADC AbsoluteX
+	{ 7, false }, // 0x7E ROR AbsoluteX
+	{ 0, false }, // 0x7F ???
+	{ 0, false }, // 0x80 ???
+	{ 6, false }, // 0x81 STA IndirectX
+	{ 0, false }, // 0x82 ???
+	{ 0, false }, // 0x83 ???
+	{ 3, false }, // 0x84 STY ZeroPage
+	{ 3, false }, // 0x85 STA ZeroPage
+	{ 3, false }, // 0x86 STX ZeroPage
+	{ 0, false }, // 0x87 ???
+	{ 2, false }, // 0x88 DEY Implied
+	{ 0, false }, // 0x89 ???
+	{ 2, false }, // 0x8A TXA Implied
+	{ 0, false }, // 0x8B ???
+	{ 4, false }, // 0x8C STY Absolute
+	{ 4, false }, // 0x8D STA Absolute
+	{ 4, false }, // 0x8E STX Absolute
+	{ 0, false }, // 0x8F ???
+	{ 2, true  }, // 0x90 BCC Relative
+	{ 6, false }, // 0x91 STA IndirectY
+	{ 0, false }, // 0x92 ???
+	{ 0, false }, // 0x93 ???
+	{ 4, false }, // 0x94 STY ZeroPageX
+	{ 4, false }, // 0x95 STA ZeroPageX
+	{ 4, false }, // 0x96 STX ZeroPageY
+	{ 0, false }, // 0x97 ???
+	{ 2, false }, // 0x98 TYA Implied
+	{ 5, false }, // 0x99 STA AbsoluteY
+	{ 2, false }, // 0x9A TXS Implied
+	{ 0, false }, // 0x9B ???
+	{ 0, false }, // 0x9C ???
+	{ 5, false }, // 0x9D STA AbsoluteX
+	{ 0, false }, // 0x9E ???
+	{ 0, false }, // 0x9F ???
+	{ 2, false }, // 0xA0 LDY Immediate
+	{ 6, false }, // 0xA1 LDA IndirectX
+	{ 2, false }, // 0xA2 LDX Immediate
+	{ 0, false }, // 0xA3 ???
+	{ 3, false }, // 0xA4 LDY ZeroPage
+	{ 3, false }, // 0xA5 LDA ZeroPage
+	{ 3, false }, // 0xA6 LDX ZeroPage
+	{ 0, false }, // 0xA7 ???
+	{ 2, false }, // 0xA8 TAY Implied
+	{ 2, false }, // 0xA9 LDA Immediate
+	{ 2, false }, // 0xAA TAX Implied
+	{ 0, false }, // 0xAB ???
+	{ 4, false }, // 0xAC LDY Absolute
+	{ 4, false }, // 0xAD LDA Absolute
+	{ 4, false }, // 0xAE LDX Absolute
+	{ 0, false }, // 0xAF ???
+	{ 2, true  }, // 0xB0 BCS Relative
+	{ 5, true  }, // 0xB1 LDA IndirectY
+	{ 0, false }, // 0xB2 ???
+	{ 0, false }, // 0xB3 ???
+	{ 4, false }, // 0xB4 LDY ZeroPageX
+	{ 4, false }, // 0xB5 LDA ZeroPageX
+	{ 4, false }, // 0xB6 LDX ZeroPageY
+	{ 0, false }, // 0xB7 ???
+	{ 2, false }, // 0xB8 CLV Implied
+	{ 4, true  }, // 0xB9 LDA AbsoluteY
+	{ 2, false }, // 0xBA TSX Implied
+	{ 0, false }, // 0xBB ???
+	{ 4, true  }, // 0xBC LDY AbsoluteX
+	{ 4, true  }, // 0xBD LDA AbsoluteX
+	{ 4, true  }, // 0xBE LDX AbsoluteY
+	{ 0, false }, // 0xBF ???
+	{ 2, false }, // 0xC0 CPY Immediate
+	{ 6, false }, // 0xC1 CMP IndirectX
+	{ 0, false }, // 0xC2 ???
+	{ 0, false }, // 0xC3 ???
+	{ 3, false }, // 0xC4 CPY ZeroPage
+	{ 3, false }, // 0xC5 CMP ZeroPage
+	{ 5, false }, // 0xC6 DEC ZeroPage
+	{ 0, false }, // 0xC7 ???
+	{ 2, false }, // 0xC8 INY Implied
+	{ 2, false }, // 0xC9 CMP Immediate
+	{ 2, false }, // 0xCA DEX Implied
+	{ 0, false }, // 0xCB ???
+	{ 4, false }, // 0xCC CPY Absolute
+	{ 4, false }, // 0xCD CMP Absolute
+	{ 6, false }, // 0xCE DEC Absolute
+	{ 0, false }, // 0xCF ???
+	{ 2, true  }, // 0xD0 BNE Relative
+	{ 5, true  }, // 0xD1 CMP IndirectY
+	{ 0, false }, // 0xD2 ???
+	{ 0, false }, // 0xD3 ???
+	{ 0, false }, // 0xD4 ???
+	{ 4, false }, // 0xD5 CMP ZeroPageX
+	{ 6, false }, // 0xD6 DEC ZeroPageX
+	{ 0, false }, // 0xD7 ???
+	{ 2, false }, // 0xD8 CLD Implied
+	{ 4, true  }, // 0xD9 CMP AbsoluteY
+	{ 0, false }, // 0xDA ???
+	{ 0, false }, // 0xDB ???
+	{ 0, false }, // 0xDC ???
+	{ 4, true  }, // 0xDD CMP AbsoluteX
+	{ 7, false }, // 0xDE DEC AbsoluteX
+	{ 0, false }, // 0xDF ???
+	{ 2, false }, // 0xE0 CPX Immediate
+	{ 6, false }, // 0xE1 SBC IndirectX
+	{ 0, false }, // 0xE2 ???
+	{ 0, false }, // 0xE3 ???
+	{ 3, false }, // 0xE4 CPX ZeroPage
+	{ 3, false }, // 0xE5 SBC ZeroPage
+	{ 5, false }, // 0xE6 INC ZeroPage
+	{ 0, false }, // 0xE7 ???
+	{ 2, false }, // 0xE8 INX Implied
+	{ 2, false }, // 0xE9 SBC Immediate
+	{ 2, false }, // 0xEA NOP Implied
+	{ 0, false }, // 0xEB ???
+	{ 4, false }, // 0xEC CPX Absolute
+	{ 4, false }, // 0xED SBC Absolute
+	{ 6, false }, // 0xEE INC Absolute
+	{ 0, false }, // 0xEF ???
+	{ 2, true  }, // 0xF0 BEQ Relative
+	{ 5, true  }, // 0xF1 SBC IndirectY
+	{ 0, false }, // 0xF2 ???
+	{ 0, false }, // 0xF3 ???
+	{ 0, false }, // 0xF4 ???
+	{ 4, false }, // 0xF5 SBC ZeroPageX
+	{ 6, false }, // 0xF6 INC ZeroPageX
+	{ 0, false }, // 0xF7 ???
+	{ 2, false }, // 0xF8 SED Implied
+	{ 4, true  }, // 0xF9 SBC AbsoluteY
+	{ 0, false }, // 0xFA ???
+	{ 0, false }, // 0xFB ???
+	{ 0, false }, // 0xFC ???
+	{ 4, true  }, // 0xFD SBC AbsoluteX
+	{ 7, false }, // 0xFE INC AbsoluteX
+	{ 0, false }, // 0xFF ???
+};
+
+/* Documented cycles for one execution: Crossed is the indexed read or branch target leaving the page */
+constexpr uint8_t ExpectedCycles(uint8_t Opcode, bool Crossed, bool Taken) {
+	const OpcodeTiming& Timing = OpcodeTimings[Opcode];
+	if (IsBranch(Opcode)) {
+		return static_cast<uint8_t>(Timing.Cycles + (Taken ? 1 + Crossed : 0));
+	}
+	return static_cast<uint8_t>(Timing.Cycles + (Timing.PageCross && Crossed));
+}
+
+static_assert(ExpectedCycles(0xBD, true, false) == 5 && ExpectedCycles(0x9D, true, false) == 5 && ExpectedCycles(0xD0, true, true) == 4,
+	"OpcodeTimings out of step with the documented NMOS cycle counts");
+
+/* Branches, jumps, calls, returns and BRK close a basic block */
+struct BlockEndTable {
+	bool Ends[0x100];
+	constexpr BlockEndTable() : Ends() {
+		for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+			OpcodeClass Class = ClassOf(static_cast<uint8_t>(Opcode));
+			Ends[Opcode] = Class == ClassBranch || Class == ClassJump;
+		}
+	}
+};
+
+inline constexpr BlockEndTable BlockEnds;
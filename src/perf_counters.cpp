@@ -0,0 +1,101 @@
+#include "perf_counters.h"
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+static int Open(uint32_t Type, uint64_t Config) {
+	perf_event_attr Attr;
+	std::memset(&Attr, 0, sizeof(Attr));
+	Attr.type = Type;
+	Attr.size = sizeof(Attr);
+	Attr.config = Config;
+	Attr.disabled = 1;
+	Attr.exclude_kernel = 1;
+	Attr.exclude_hv = 1;
+	Attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	return static_cast<int>(syscall(SYS_perf_event_open, &Attr, 0, -1, -1, 0));
+}
+#endif
+
+PerfCounters::PerfCounters() {
+	for (int& Descriptor : Descriptors) {
+		Descriptor = -1;
+	}
+#ifdef __linux__
+	Descriptors[Instructions] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	Descriptors[Cycles] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	Descriptors[BranchMisses] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+	Descriptors[CacheMisses] = Open(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+	Descriptors[TaskClock] = Open(PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK);
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+	for (int Descriptor : Descriptors) {
+		if (Descriptor >= 0) {
+			close(Descriptor);
+		}
+	}
+#endif
+}
+
+bool PerfCounters::AnyAvailable() const {
+	for (int Descriptor : Descriptors) {
+		if (Descriptor >= 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void PerfCounters::Start() {
+#ifdef __linux__
+	for (int Descriptor : Descriptors) {
+		if (Descriptor >= 0) {
+			ioctl(Descriptor, PERF_EVENT_IOC_RESET, 0);
+			ioctl(Descriptor, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+#endif
+}
+
+PerfCounters::Sample PerfCounters::Stop() {
+	Sample Result;
+#ifdef __linux__
+	for (int Which = 0; Which < EventCount; ++Which) {
+		if (Descriptors[Which] >= 0) {
+			ioctl(Descriptors[Which], PERF_EVENT_IOC_DISABLE, 0);
+		}
+	}
+	for (int Which = 0; Which < EventCount; ++Which) {
+		uint64_t Read[3]; // Value, time enabled, time running
+		if (Descriptors[Which] < 0 || read(Descriptors[Which], Read, sizeof(Read)) != sizeof(Read) || Read[2] == 0) {
+			continue;
+		}
+		Result.Values[Which] = Read[2] < Read[1] ? static_cast<uint64_t>(static_cast<double>(Read[0]) * Read[1] / Read[2]) : Read[0];
+		Result.Valid[Which] = true;
+	}
+#endif
+	return Result;
+}
+
+PerfCounters::Sample& PerfCounters::Sample::operator+=(const Sample& Other) {
+	for (int Which = 0; Which < EventCount; ++Which) {
+		Values[Which] += Other.Values[Which];
+		Valid[Which] = Valid[Which] || Other.Valid[Which];
+	}
+	return *this;
+}
+
+double PerfCounters::Sample::InstructionsPerCycle() const {
+	if (!Valid[Instructions] || !Valid[Cycles] || Values[Cycles] == 0) {
+		return -1;
+	}
+	return static_cast<double>(Values[Instructions]) / Values[Cycles];
+}
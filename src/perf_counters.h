@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+
+/*
+	Host hardware counters around a stretch of emulation, through Linux perf_event_open.
+	Every event is opened on its own, so a VM without a PMU still gets the software
+	task clock, and a non-Linux build or a locked-down kernel simply reports nothing.
+	Counts are scaled up when the kernel had to multiplex them.
+*/
+class PerfCounters {
+public:
+	enum Event {
+		Instructions,
+		Cycles,
+		BranchMisses,
+		CacheMisses,
+		TaskClock, // Nanoseconds
+		EventCount
+	};
+	static constexpr const char* EventNames[EventCount] = { "instructions", "cycles", "branch-misses", "cache-misses", "task-clock" };
+
+	struct Sample {
+		uint64_t Values[EventCount] = {};
+		bool Valid[EventCount] = {};
+
+		Sample& operator+=(const Sample& Other);
+		/* Host IPC, or a negative value when either count is missing */
+		double InstructionsPerCycle() const;
+	};
+
+	PerfCounters();
+	~PerfCounters();
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters& operator=(const PerfCounters&) = delete;
+
+	bool Available(Event Which) const {
+		return Descriptors[Which] >= 0;
+	}
+	bool AnyAvailable() const;
+
+	void Start();
+	Sample Stop();
+
+private:
+	int Descriptors[EventCount];
+};
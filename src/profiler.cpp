@@ -0,0 +1,71 @@
+#include "profiler.h"
+#include "disassembler.h"
+#include "opcodes.h"
+#include <algorithm>
+#include <cstdio>
+
+Profiler::Profiler() {
+	Samples = std::vector<Sample>(0x10000, Sample{ 0, 0 });
+}
+
+void Profiler::Clear() {
+	std::fill(Samples.begin(), Samples.end(), Sample{ 0, 0 });
+}
+
+u64 Profiler::TotalCycles() const {
+	u64 Total = 0;
+	for (const Sample& Entry : Samples) {
+		Total += Entry.Cycles;
+	}
+	return Total;
+}
+
+static void WriteLine(std::ostream& Out, const std::vector<u8>& Memory, u32 Address, const Profiler::Sample& Entry, u64 Total) {
+	char Bytes[12] = "";
+	u8 Length = InstructionLength(Memory[Address]);
+	for (u8 i = 0; i < Length; ++i) {
+		std::snprintf(Bytes + i * 3, sizeof(Bytes) - i * 3, "%02X ", Memory[static_cast<u16>(Address + i)]);
+	}
+	char Line[96];
+	std::snprintf(Line, sizeof(Line), "%6.2f%% %14llu %12llu  %04X  %-9s %s\n",
+		Total ? 100.0 * Entry.Cycles / Total : 0.0,
+		static_cast<unsigned long long>(Entry.Cycles),
+		static_cast<unsigned long long>(Entry.Executions),
+		Address, Bytes, Disassemble(Memory, static_cast<u16>(Address)).c_str());
+	Out << Line;
+}
+
+void Profiler::FlatProfile(std::ostream& Out, const std::vector<u8>& Memory, size_t Limit) const {
+	std::vector<u32> Addresses;
+	for (u32 Address = 0; Address < Samples.size(); ++Address) {
+		if (Samples[Address].Executions != 0) {
+			Addresses.push_back(Address);
+		}
+	}
+	std::stable_sort(Addresses.begin(), Addresses.end(), [this](u32 L, u32 R) { return Samples[L].Cycles > Samples[R].Cycles; });
+	if (Limit != 0 && Addresses.size() > Limit) {
+		Addresses.resize(Limit);
+	}
+
+	u64 Total = TotalCycles();
+	Out << "  Cycle%         Cycles   Executions  Addr  Bytes     Instruction\n";
+	for (u32 Address : Addresses) {
+		WriteLine(Out, Memory, Address, Samples[Address], Total);
+	}
+}
+
+void Profiler::AnnotatedListing(std::ostream& Out, const std::vector<u8>& Memory) const {
+	u64 Total = TotalCycles();
+	u32 Expected = 0x10000; // Address following the previously listed instruction
+	Out << "  Cycle%         Cycles   Executions  Addr  Bytes     Instruction\n";
+	for (u32 Address = 0; Address < Samples.size(); ++Address) {
+		if (Samples[Address].Executions == 0) {
+			continue;
+		}
+		if (Expected != 0x10000 && Address != Expected) {
+			Out << '\n'; // Separate discontiguous runs of code
+		}
+		WriteLine(Out, Memory, Address, Samples[Address], Total);
+		Expected = Address + InstructionLength(Memory[Address]);
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <ostream>
+#include <vector>
+#include "6502.h"
+
+/*
+	PC hot-spot profiler. Attach to NMOS6502::PCProfiler in an instrumented build and
+	every executed instruction adds its cycles to the entry for the address it was fetched from.
+*/
+class Profiler {
+public:
+	struct Sample {
+		u64 Cycles;
+		u64 Executions;
+	};
+
+	Profiler();
+	std::vector<Sample> Samples;
+
+	void Record(u16 Address, u32 Cycles) {
+		Sample& Entry = Samples[Address];
+		Entry.Cycles += Cycles;
+		++Entry.Executions;
+	}
+
+	void Clear();
+	u64 TotalCycles() const;
+
+	/* Instruction addresses sorted by cycles spent, Limit of 0 lists every executed address */
+	void FlatProfile(std::ostream& Out, const std::vector<u8>& Memory, size_t Limit = 0) const;
+	/* Every executed instruction in address order with its share of the total cycles */
+	void AnnotatedListing(std::ostream& Out, const std::vector<u8>& Memory) const;
+};
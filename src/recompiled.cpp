@@ -0,0 +1,110 @@
+#include "recompiled.h"
+#include <cstring>
+#include "opcodes.h"
+
+enum WriteKind : u8 { WritesNothing, WritesOperand, WritesStack };
+
+/* What each opcode can write when the interpreter runs it: its operand's address, or the stack */
+struct MemoryWriters {
+	WriteKind Writes[0x100] = {};
+
+	constexpr MemoryWriters() {
+		for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+			OpcodeClass Class = ClassOf(static_cast<u8>(Opcode));
+			AddressingMode Mode = OpcodeTable[Opcode].Mode;
+			bool Memory = Mode != Implied && Mode != Accumulator && Mode != Immediate;
+			if (Class == ClassStack || Opcode == 0x20) {
+				Writes[Opcode] = WritesStack;
+			}
+			else if (Class == ClassStore || ((Class == ClassIncrement || Class == ClassShift) && Memory)) {
+				Writes[Opcode] = WritesOperand;
+			}
+		}
+	}
+};
+
+static constexpr MemoryWriters Writers;
+
+RecompiledRun::RecompiledRun(NMOS6502& M6502, const RecompiledProgram& Program) : M6502(M6502), Program(Program), Index(0x10000, 0) {
+	for (size_t i = 0; i < Program.BlockCount; ++i) {
+		const RecompiledBlock& Block = Program.Blocks[i];
+		Index[Block.Start] = static_cast<u16>(i + 1);
+		for (u32 Page = Block.Start >> 8; Page <= (Block.End - 1) >> 8 && Page < 0x100; ++Page) {
+			CodePages[Page] = true;
+		}
+	}
+}
+
+bool RecompiledRun::Intact(const RecompiledBlock& Block) const {
+	return std::memcmp(&M6502.Memory[Block.Start], Program.Image + (Block.Start - Program.Origin), Block.End - Block.Start) == 0;
+}
+
+/* A page is stale when its image bytes, or the first few of the next page, differ from memory */
+void RecompiledRun::Recheck() {
+	bool Differs[0x101] = {};
+	for (u32 Page = Program.Origin >> 8; Page <= (Program.Origin + Program.Size - 1) >> 8; ++Page) {
+		u32 Start = std::max<u32>(Page << 8, Program.Origin);
+		u32 End = std::min<u32>((Page + 1) << 8, Program.Origin + Program.Size);
+		Differs[Page] = CodePages[Page] && std::memcmp(&M6502.Memory[Start], Program.Image + (Start - Program.Origin), End - Start) != 0;
+	}
+	for (int Page = 0; Page < 0x100; ++Page) {
+		Stale[Page] = Differs[Page] || Differs[Page + 1];
+	}
+}
+
+/* The address the instruction at PC writes, read off its operand as the core's addressing helpers do */
+static u16 OperandAddress(const NMOS6502& M) {
+	u8 Opcode = M.Memory[M.PC];
+	u8 First = M.Memory[static_cast<u16>(M.PC + 1)];
+	u16 Word = static_cast<u16>(First << 8 | M.Memory[static_cast<u16>(M.PC + 2)]); // High byte first
+	bool Store = ClassOf(Opcode) == ClassStore; // The core's zp,X and zp,Y stores do not wrap in page 0
+	switch (OpcodeTable[Opcode].Mode) {
+	case ZeroPage: return First;
+	case ZeroPageX: return Store ? First + M.X : static_cast<u8>(First + M.X);
+	case ZeroPageY: return Store ? First + M.Y : static_cast<u8>(First + M.Y);
+	case AbsoluteX: return static_cast<u16>(Word + M.X);
+	case AbsoluteY: return static_cast<u16>(Word + M.Y);
+	case IndirectX: return RecompiledPointer(M, static_cast<u8>(First + M.X));
+	case IndirectY: return static_cast<u16>(RecompiledPointer(M, First) + M.Y);
+	default: return Word;
+	}
+}
+
+void RecompiledRun::Interpret() {
+	bool Interrupt = M6502.NMIPending || M6502.IRQPending;
+	WriteKind Writes = Writers.Writes[M6502.Memory[M6502.PC]];
+	u16 Address = Writes == WritesOperand ? OperandAddress(M6502) : M6502.SP;
+	Result.Cycles += M6502.Execute(0);
+	++Result.Instructions;
+	++Interpreted;
+	if (Interrupt) { // The handler's pushes and whatever it ran, rare enough to compare the image
+		Recheck();
+	}
+	else if (Writes == WritesOperand) {
+		Wrote(Address);
+	}
+	else if (Writes == WritesStack) { // Pushes go down from SP, at most two of them for JSR
+		Wrote(Address);
+		Wrote(static_cast<u16>(Address - 1));
+	}
+}
+
+RunResult RecompiledRun::Run(u64 Cycles) {
+	Result = {};
+	Budget = Cycles;
+	Recheck();
+	while (Result.Cycles < Budget) {
+		u16 Entry = Index[M6502.PC];
+		if (Entry && !M6502.NMIPending && !M6502.IRQPending) {
+			const RecompiledBlock& Block = Program.Blocks[Entry - 1];
+			if (!Stale[M6502.PC >> 8] || Intact(Block)) {
+				Chained = 0;
+				++Blocks;
+				Block.Run(M6502, *this);
+				continue;
+			}
+		}
+		Interpret();
+	}
+	return Result;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <vector>
+#include "6502.h"
+#include "run_loop.h"
+
+class RecompiledRun;
+
+/* One basic block translated by 6502-recompile, covering the image bytes [Start, End) */
+struct RecompiledBlock {
+	void (*Run)(NMOS6502& M, RecompiledRun& Run);
+	u16 Start;
+	u32 End;
+};
+
+/* What a generated source file exports: its blocks sorted by Start, and the image they came from */
+struct RecompiledProgram {
+	const RecompiledBlock* Blocks;
+	size_t BlockCount;
+	const u8* Image;
+	u16 Origin;
+	u32 Size;
+};
+
+/*
+	Runs a statically recompiled program on an NMOS6502's registers and Memory, falling back to
+	NMOS6502::Execute one instruction at a time wherever there is no translated block: code the
+	recompiler never reached, and blocks whose bytes no longer match the image they were
+	translated from. Interrupts are taken by Execute as well, so they are seen at block
+	boundaries rather than between every instruction.
+
+	Blocks chain into their static successors with direct calls and come back here after
+	ChainLimit of them, when the budget is spent, or at an indirect jump (JMP (ind), RTS, RTI),
+	which is looked up in a table of every block start. Writes to pages that hold code mark them
+	stale, from translated code and from the interpreter alike, as does any difference found after
+	an interrupt or when a run starts (the host may have patched memory between runs); blocks on
+	stale pages are compared with the image before each entry. A block that rewrites its own later bytes still
+	runs as translated to its end.
+
+	Cycles are the core's own counts per opcode, page-cross and branch penalties included.
+*/
+class RecompiledRun {
+public:
+	static constexpr int ChainLimit = 64;
+
+	RecompiledRun(NMOS6502& M6502, const RecompiledProgram& Program);
+	NMOS6502& M6502;
+	const RecompiledProgram& Program;
+	u64 Blocks = 0; // Entered from the dispatch loop or chained, since construction
+	u64 Interpreted = 0; // Instructions run by the interpreter instead, interrupts included
+
+	/* Runs until at least Cycles have been spent, like RunLoop::Run in RunFast mode */
+	RunResult Run(u64 Cycles);
+
+	/* For the generated code: whether a block may chain straight into the block at Target */
+	bool Enter(u16 Target) {
+		M6502.PC = Target;
+		bool Chain = ++Chained < ChainLimit && Result.Cycles < Budget && !Stale[Target >> 8];
+		Blocks += Chain;
+		return Chain;
+	}
+
+	void Retire(u32 Cycles, u32 Instructions) {
+		Result.Cycles += Cycles;
+		Result.Instructions += Instructions;
+	}
+
+	void Store(u16 Address, u8 Value) {
+		M6502.Memory[Address] = Value;
+		Wrote(Address);
+	}
+
+private:
+	std::vector<u16> Index; // Per address, 1 + the block starting there, or 0
+	bool CodePages[0x100] = {};
+	bool Stale[0x100] = {};
+	RunResult Result;
+	u64 Budget = 0;
+	int Chained = 0;
+
+	void Wrote(u16 Address) {
+		if (CodePages[Address >> 8]) {
+			Stale[Address >> 8] = true;
+			Stale[((Address >> 8) + 0xFF) & 0xFF] = true; // A block may run a few bytes into the next page
+		}
+	}
+
+	bool Intact(const RecompiledBlock& Block) const;
+	void Recheck();
+	void Interpret();
+};
+
+/* Zero page pointer as the core reads it for (zp,X) and (zp),Y: low byte first, wrapping in page 0 */
+inline u16 RecompiledPointer(const NMOS6502& M, u8 Address) {
+	return static_cast<u16>(M.Memory[Address] | M.Memory[static_cast<u8>(Address + 1)] << 8);
+}
+
+inline void RecompiledCompare(NMOS6502& M, u8 Register, u8 Operand) {
+	M.ProcessorStatus[NMOS6502::N] = static_cast<u8>(Register - Operand) >> 7;
+	M.ProcessorStatus[NMOS6502::Z] = Register == Operand;
+	M.ProcessorStatus[NMOS6502::C] = Register >= Operand;
+}
+
+/* ASL, LSR, ROL and ROR on memory: carry from the outgoing bit, which a rotate feeds back in */
+inline void RecompiledShift(NMOS6502& M, RecompiledRun& Run, u16 Address, bool Left, bool Rotate) {
+	u8 Value = M.Memory[Address];
+	bool Carry = Left ? Value >> 7 : Value & 1;
+	Value = static_cast<u8>(Left ? Value << 1 : Value >> 1);
+	if (Carry && Rotate) {
+		Value |= Left ? 0x01 : 0x80;
+	}
+	M.ProcessorStatus[NMOS6502::C] = Carry;
+	Run.Store(Address, Value);
+}
@@ -0,0 +1,317 @@
+#include "recompiler.h"
+#include <cstdio>
+#include "opcodes.h"
+
+static constexpr bool IsMnemonic(u8 Opcode, const char* Mnemonic) {
+	return MnemonicIn(OpcodeTable[Opcode].Mnemonic, Mnemonic);
+}
+
+static bool EndsBlock(u8 Opcode) {
+	return IsBranch(Opcode) || Opcode == 0x4C || Opcode == 0x6C || Opcode == 0x20 || Opcode == 0x60 || Opcode == 0x40;
+}
+
+static std::string Hex(u32 Value, int Digits) {
+	char Text[8];
+	std::snprintf(Text, sizeof(Text), "0x%0*X", Digits, Value);
+	return Text;
+}
+
+static std::string BlockName(u16 Address) {
+	char Text[16];
+	std::snprintf(Text, sizeof(Text), "Block_%04X", Address);
+	return Text;
+}
+
+StaticRecompiler::StaticRecompiler(const std::vector<u8>& Image, u16 Origin) : Image(Image), Origin(Origin) {
+	Entries.push_back(Origin);
+	NMOS6502 M6502;
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		M6502.Reset();
+		M6502.SP = 0x01FF;
+		M6502.PC = 0x0200;
+		M6502.Memory[0x0200] = static_cast<u8>(Opcode);
+		M6502.Memory[0x0201] = 0x10;
+		M6502.Memory[0x0202] = 0x20;
+		if (IsBranch(static_cast<u8>(Opcode))) { // Not taken: bits 7-6 pick N, V, C or Z, bit 5 is the value taken on
+			static constexpr NMOS6502::FLAGS Tested[4] = { NMOS6502::N, NMOS6502::V, NMOS6502::C, NMOS6502::Z };
+			M6502.ProcessorStatus[Tested[Opcode >> 6]] = (Opcode & 0x20) == 0;
+		}
+		BaseCycles[Opcode] = static_cast<u8>(M6502.Execute(0));
+	}
+}
+
+void StaticRecompiler::Recover() {
+	Leaders.clear();
+	Decoded.clear();
+	Blocks.clear();
+	std::vector<u16> Work;
+	auto Follow = [&](u32 Target) {
+		if (Inside(Target, 1)) {
+			Leaders.insert(static_cast<u16>(Target));
+			Work.push_back(static_cast<u16>(Target));
+		}
+	};
+	for (u16 Entry : Entries) {
+		Follow(Entry);
+	}
+	while (!Work.empty()) {
+		u16 At = Work.back();
+		Work.pop_back();
+		while (true) {
+			if (Decoded.count(At)) {
+				Leaders.insert(At); // Reached again, so a block must start here
+				break;
+			}
+			u8 Opcode = Byte(At);
+			if (!Inside(At, DialectLength(Opcode))) {
+				break;
+			}
+			Decoded.insert(At);
+			if (IsBranch(Opcode)) {
+				Follow(static_cast<u16>(At + static_cast<int8_t>(Byte(At + 1))));
+				Follow(At + 1u);
+				break;
+			}
+			if (Opcode == 0x4C) {
+				Follow(Byte(At + 1) | Byte(At + 2) << 8);
+				break;
+			}
+			if (Opcode == 0x20) {
+				Follow(Byte(At + 3) << 8 | Byte(At + 2));
+				Follow(At + 1u);
+				break;
+			}
+			if (EndsBlock(Opcode)) {
+				break;
+			}
+			u32 Next = At + InstructionLength(Opcode);
+			if (!Inside(Next, 1)) {
+				break;
+			}
+			if (Next >> 8 != At >> 8u) {
+				Leaders.insert(static_cast<u16>(Next));
+			}
+			At = static_cast<u16>(Next);
+		}
+	}
+
+	for (u16 Leader : Leaders) {
+		if (!Decoded.count(Leader)) {
+			continue;
+		}
+		RecoveredBlock& Block = Blocks[Leader];
+		Block.Start = Leader;
+		for (u16 At = Leader;;) {
+			u8 Opcode = Byte(At);
+			Block.Instructions.push_back(At);
+			Block.End = std::max<u32>(Block.End, At + DialectLength(Opcode));
+			u32 Next = At + InstructionLength(Opcode);
+			if (EndsBlock(Opcode) || Next > 0xFFFF || Leaders.count(static_cast<u16>(Next)) || !Decoded.count(static_cast<u16>(Next))) {
+				break;
+			}
+			At = static_cast<u16>(Next);
+		}
+	}
+}
+
+/* The statement for the instruction at Address, preceded by its page-cross cycle if it has one */
+std::string StaticRecompiler::Instruction(u16 Address, std::string& Comment) const {
+	u8 Opcode = Byte(Address);
+	const OpcodeInfo& Info = OpcodeTable[Opcode];
+	u8 Bytes[4] = { Opcode };
+	for (u32 i = 1; i < 4; ++i) {
+		Bytes[i] = Inside(Address + i, 1) ? Byte(static_cast<u16>(Address + i)) : 0;
+	}
+	u8 First = Bytes[1], Second = Bytes[2];
+	u16 Operand = OperandValue(Bytes, Address);
+	bool Store = ClassOf(Opcode) == ClassStore;
+
+	std::string Effective;
+	char Text[32] = "";
+	switch (Info.Mode) {
+	case ZeroPage:
+		Effective = Hex(First, 2);
+		std::snprintf(Text, sizeof(Text), " $%02X", First);
+		break;
+	case ZeroPageX:
+	case ZeroPageY: {
+		std::string Index = Info.Mode == ZeroPageX ? "M.X" : "M.Y";
+		Effective = Store ? Hex(First, 2) + " + " + Index : "static_cast<u8>(" + Hex(First, 2) + " + " + Index + ")";
+		std::snprintf(Text, sizeof(Text), " $%02X,%c", First, Info.Mode == ZeroPageX ? 'X' : 'Y');
+		break;
+	}
+	case Absolute:
+		Effective = Hex(Operand, 4);
+		std::snprintf(Text, sizeof(Text), " $%04X", Operand);
+		break;
+	case AbsoluteX:
+	case AbsoluteY:
+		Effective = "static_cast<u16>(" + Hex(Operand, 4) + (Info.Mode == AbsoluteX ? " + M.X)" : " + M.Y)");
+		std::snprintf(Text, sizeof(Text), " $%04X,%c", Operand, Info.Mode == AbsoluteX ? 'X' : 'Y');
+		break;
+	case IndirectX:
+		Effective = "RecompiledPointer(M, static_cast<u8>(" + Hex(First, 2) + " + M.X))";
+		std::snprintf(Text, sizeof(Text), " ($%02X,X)", First);
+		break;
+	case IndirectY:
+		Effective = "static_cast<u16>(RecompiledPointer(M, " + Hex(First, 2) + ") + M.Y)";
+		std::snprintf(Text, sizeof(Text), " ($%02X),Y", First);
+		break;
+	case Immediate:
+		std::snprintf(Text, sizeof(Text), " #$%02X", First);
+		break;
+	case Accumulator:
+		std::snprintf(Text, sizeof(Text), " A");
+		break;
+	case Indirect:
+		std::snprintf(Text, sizeof(Text), " ($%04X)", Operand);
+		break;
+	case Relative:
+		std::snprintf(Text, sizeof(Text), " $%04X", Operand);
+		break;
+	default:
+		break;
+	}
+	char Line[64];
+	std::snprintf(Line, sizeof(Line), "%04X  %s%s", Address, Info.Mnemonic, Text);
+	Comment = Line;
+
+	std::string Code;
+	if (OpcodeTimings[Opcode].PageCross && !IsBranch(Opcode)) {
+		if (Info.Mode == AbsoluteX || Info.Mode == AbsoluteY) {
+			Code += "Cycles += (" + Hex(Second, 2) + (Info.Mode == AbsoluteX ? " + M.X) >> 8; " : " + M.Y) >> 8; ");
+		}
+		else if (Info.Mode == IndirectY) {
+			Code += "Cycles += (M.Memory[" + Hex(First, 2) + "] + M.Y) >> 8; ";
+		}
+	}
+	std::string Read = Info.Mode == Immediate ? Hex(First, 2) : "M.Memory[" + Effective + "]";
+	std::string Flag = "M.ProcessorStatus[NMOS6502::";
+	bool Left = Info.Mnemonic[0] == 'A' || Info.Mnemonic[2] == 'L';
+
+	if (IsMnemonic(Opcode, "LDA")) Code += "M.A = " + Read + "; " + Flag + "Z] = M.A == 0; " + Flag + "N] = M.A >> 5 & 1;";
+	else if (IsMnemonic(Opcode, "LDX")) Code += "M.X = " + Read + ";";
+	else if (IsMnemonic(Opcode, "LDY")) Code += "M.Y = " + Read + ";";
+	else if (IsMnemonic(Opcode, "STA")) Code += "Run.Store(" + Effective + ", M.A);";
+	else if (IsMnemonic(Opcode, "STX")) Code += "Run.Store(" + Effective + ", M.X);";
+	else if (IsMnemonic(Opcode, "STY")) Code += "Run.Store(" + Effective + ", M.Y);";
+	else if (IsMnemonic(Opcode, "ADC")) Code += "M.A = static_cast<u8>(M.A + " + Read + " + " + Flag + "C]);";
+	else if (IsMnemonic(Opcode, "SBC")) Code += "M.A = static_cast<u8>(M.A - " + Read + " - " + Flag + "C]);";
+	else if (IsMnemonic(Opcode, "AND")) Code += "M.A &= " + Read + ";";
+	else if (IsMnemonic(Opcode, "ORA")) Code += "M.A |= " + Read + ";";
+	else if (IsMnemonic(Opcode, "EOR")) Code += "M.A ^= " + Read + ";";
+	else if (IsMnemonic(Opcode, "BIT")) Code += Flag + "Z] = (M.A & " + Read + ") == 0; " + Flag + "N] = false; " + Flag + "V] = false;";
+	else if (IsMnemonic(Opcode, "CMP")) Code += "RecompiledCompare(M, M.A, " + Read + ");";
+	else if (IsMnemonic(Opcode, "CPX")) Code += "RecompiledCompare(M, M.X, " + Read + ");";
+	else if (IsMnemonic(Opcode, "CPY")) Code += "RecompiledCompare(M, M.Y, " + Read + ");";
+	else if (Opcode == 0x0A) Code += Flag + "C] = M.A >> 7; M.A = static_cast<u8>(M.A << 1);";
+	else if (Opcode == 0x4A) Code += Flag + "C] = M.A >> 1 & 1; M.A >>= 1;"; // Carry from bit 1, as the core takes it
+	else if (Opcode == 0x2A) Code += Flag + "C] = M.A >> 7; M.A = static_cast<u8>(M.A << 1 | M.A >> 7);";
+	else if (Opcode == 0x6A) Code += Flag + "C] = M.A >> 7; M.A = static_cast<u8>(M.A >> 1 | M.A << 7);";
+	else if (IsMnemonic(Opcode, "ASL LSR ROL ROR")) Code += std::string("RecompiledShift(M, Run, ") + Effective + (Left ? ", true, " : ", false, ") + (Info.Mnemonic[0] == 'R' ? "true);" : "false);");
+	else if (IsMnemonic(Opcode, "INC")) Code += "{ u16 Address = " + Effective + "; Run.Store(Address, static_cast<u8>(M.Memory[Address] + 1)); }";
+	else if (IsMnemonic(Opcode, "DEC")) Code += "{ u16 Address = " + Effective + "; Run.Store(Address, static_cast<u8>(M.Memory[Address] - 1)); }";
+	else if (IsMnemonic(Opcode, "INX")) Code += "++M.X;";
+	else if (IsMnemonic(Opcode, "INY")) Code += "++M.Y;";
+	else if (IsMnemonic(Opcode, "DEX")) Code += "--M.X;";
+	else if (IsMnemonic(Opcode, "DEY")) Code += "--M.Y;";
+	else if (IsMnemonic(Opcode, "TAX")) Code += "M.X = M.A;";
+	else if (IsMnemonic(Opcode, "TAY")) Code += "M.Y = M.A;";
+	else if (IsMnemonic(Opcode, "TXA")) Code += "M.A = M.X;";
+	else if (IsMnemonic(Opcode, "TYA")) Code += "M.A = M.Y;";
+	else if (IsMnemonic(Opcode, "TSX")) Code += "M.X = static_cast<u8>(M.SP);";
+	else if (IsMnemonic(Opcode, "TXS")) Code += "M.SP = M.X;";
+	else if (IsMnemonic(Opcode, "PHA")) Code += "Run.Store(M.SP--, M.A);";
+	else if (IsMnemonic(Opcode, "PHP")) Code += "Run.Store(M.SP--, static_cast<u8>(M.ProcessorStatus.to_ulong()));";
+	else if (IsMnemonic(Opcode, "PLA")) Code += "M.A = M.Memory[M.SP]; Run.Store(M.SP++, 0);"; // Pulls from SP itself and clears the slot
+	else if (IsMnemonic(Opcode, "PLP")) Code += "M.ProcessorStatus = std::bitset<6>(M.Memory[M.SP]); Run.Store(M.SP++, 0);";
+	else if (IsMnemonic(Opcode, "CLC")) Code += Flag + "C] = false;";
+	else if (IsMnemonic(Opcode, "SEC")) Code += Flag + "C] = true;";
+	else if (IsMnemonic(Opcode, "CLI")) Code += Flag + "I] = false;";
+	else if (IsMnemonic(Opcode, "SEI")) Code += Flag + "I] = true;";
+	else if (IsMnemonic(Opcode, "CLV")) Code += Flag + "V] = false;";
+	else if (IsMnemonic(Opcode, "CLD")) Code += Flag + "D] = false;";
+	else if (IsMnemonic(Opcode, "SED")) Code += Flag + "D] = true;";
+	return Code; // BRK, NOP, the undocumented opcodes and the control transfers, left to Exit, do nothing here
+}
+
+std::string StaticRecompiler::Chain(u16 Target, const std::string& Indent) const {
+	if (!Blocks.count(Target)) {
+		return Indent + "M.PC = " + Hex(Target, 4) + ";\n";
+	}
+	return Indent + "if (Run.Enter(" + Hex(Target, 4) + ")) {\n" + Indent + "\treturn " + BlockName(Target) + "(M, Run);\n" + Indent + "}\n";
+}
+
+std::string StaticRecompiler::Exit(const RecoveredBlock& Block, const std::string& Retire) const {
+	u16 At = Block.Instructions.back();
+	u8 Opcode = Byte(At);
+	if (IsBranch(Opcode)) {
+		static constexpr const char* Tested[4] = { "N", "V", "C", "Z" };
+		u16 Target = static_cast<u16>(At + static_cast<int8_t>(Byte(At + 1)));
+		int Taken = 1 + ((At & 0xFF00) != (Target & 0xFF00));
+		return std::string("\tif (") + ((Opcode & 0x20) ? "" : "!") + "M.ProcessorStatus[NMOS6502::" + Tested[Opcode >> 6] + "]) {\n" +
+			"\t\tRun.Retire(Cycles + " + std::to_string(Taken) + Retire + ");\n" + Chain(Target, "\t\t") + "\t\treturn;\n\t}\n" +
+			"\tRun.Retire(Cycles" + Retire + ");\n" + Chain(static_cast<u16>(At + 1), "\t");
+	}
+	switch (Opcode) {
+	case 0x4C:
+		return "\tRun.Retire(Cycles" + Retire + ");\n" + Chain(static_cast<u16>(Byte(At + 1) | Byte(At + 2) << 8), "\t");
+	case 0x6C: {
+		u16 Pointer = static_cast<u16>(Byte(At + 1) | Byte(At + 2) << 8);
+		return "\tRun.Retire(Cycles" + Retire + ");\n\tM.PC = static_cast<u16>(M.Memory[" + Hex(Pointer, 4) + "] << 8 | M.Memory[" + Hex(static_cast<u16>(Pointer + 1), 4) + "]);\n";
+	}
+	case 0x20: // Pushes the opcode address
+		return "\tRun.Store(M.SP--, " + Hex(At >> 8, 2) + ");\n\tRun.Store(M.SP--, " + Hex(At & 0xFF, 2) + ");\n\tRun.Retire(Cycles" + Retire + ");\n" +
+			Chain(static_cast<u16>(Byte(At + 3) << 8 | Byte(At + 2)), "\t");
+	case 0x60:
+		return "\tu8 Low = M.Memory[static_cast<u16>(M.SP + 1)];\n\t++M.SP;\n\tu8 High = M.Memory[static_cast<u16>(M.SP + 1)];\n\t++M.SP;\n"
+			"\tM.PC = static_cast<u16>((High << 8 | Low) + 1);\n\tRun.Retire(Cycles" + Retire + ");\n";
+	case 0x40: // As ReferenceCore: the core shifts the high byte by 8 + the low byte
+		return "\tM.ProcessorStatus = std::bitset<6>(M.Memory[M.SP]);\n\t++M.SP;\n"
+			"\tM.PC = static_cast<u16>(M.Memory[static_cast<u16>(M.SP + 1)] << ((8 + M.Memory[M.SP]) & 31));\n\tM.SP += 2;\n\tRun.Retire(Cycles" + Retire + ");\n";
+	}
+	return "\tRun.Retire(Cycles" + Retire + ");\n" + Chain(static_cast<u16>(At + InstructionLength(Opcode)), "\t");
+}
+
+std::string StaticRecompiler::Emit(const std::string& Program) const {
+	char Header[160];
+	std::snprintf(Header, sizeof(Header), "/* Generated by 6502-recompile from %zu bytes at $%04X, %zu blocks; do not edit */\n", Image.size(), Origin, Blocks.size());
+	std::string Out = Header;
+	Out += "#include \"recompiled.h\"\n\nstatic const u8 Image[] = {";
+	for (size_t i = 0; i < Image.size(); ++i) {
+		Out += (i % 16 ? " " : "\n\t") + Hex(Image[i], 2) + ",";
+	}
+	Out += "\n};\n\n";
+	for (const auto& [Start, Block] : Blocks) {
+		Out += "static void " + BlockName(Start) + "(NMOS6502& M, RecompiledRun& Run);\n";
+	}
+	for (const auto& [Start, Block] : Blocks) {
+		u32 Cycles = 0;
+		std::string Body;
+		for (u16 At : Block.Instructions) {
+			std::string Comment;
+			std::string Code = Instruction(At, Comment);
+			Body += '\t';
+			if (!Code.empty()) {
+				Body += Code;
+				Body += ' ';
+			}
+			Body += "// ";
+			Body += Comment;
+			Body += '\n';
+			Cycles += BaseCycles[Byte(At)];
+		}
+		Out += "\nstatic void " + BlockName(Start) + "(NMOS6502& M, RecompiledRun& Run) {\n\tu32 Cycles = " + std::to_string(Cycles) + ";\n" + Body +
+			Exit(Block, ", " + std::to_string(Block.Instructions.size())) + "}\n";
+	}
+	Out += "\nstatic const RecompiledBlock Blocks[] = {\n";
+	for (const auto& [Start, Block] : Blocks) {
+		Out += "\t{ " + BlockName(Start) + ", " + Hex(Start, 4) + ", " + Hex(Block.End, 4) + " },\n";
+	}
+	if (Blocks.empty()) {
+		Out += "\t{ nullptr, 0, 0 },\n";
+	}
+	Out += "};\n\nextern const RecompiledProgram " + Program + " = { Blocks, " + std::to_string(Blocks.size()) + ", Image, " + Hex(Origin, 4) + ", " +
+		std::to_string(Image.size()) + " };\n";
+	return Out;
+}
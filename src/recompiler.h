@@ -0,0 +1,57 @@
+#pragma once
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "6502.h"
+
+/* A straight run of instructions entered only at Start */
+struct RecoveredBlock {
+	u16 Start = 0;
+	u32 End = 0; // One past the last byte its instructions read
+	std::vector<u16> Instructions;
+};
+
+/*
+	Ahead-of-time translation of a 6502 image into C++ for RecompiledRun (see recompiled.h).
+
+	Recover follows the code by recursive descent from Entries, in this core's dialect: a branch
+	goes to opcode + offset or, not taken, on to the offset byte; JSR goes to the address in its
+	third and fourth bytes and is later returned to at opcode + 1; JMP (ind), RTS and RTI end a
+	path, to be resolved at run time. Undocumented opcodes and BRK are one-byte no-ops here, so
+	they are followed like any other. Paths leaving the image are not followed. Blocks start at
+	every entry, target and return address, and where the code crosses into a new page.
+
+	Emit writes one function per block, with the instruction semantics of ReferenceCore and
+	operands baked in, that chains into static successors with direct calls, and a table of all
+	blocks for the indirect jumps. The result compiles against recompiled.h and the core.
+*/
+class StaticRecompiler {
+public:
+	StaticRecompiler(const std::vector<u8>& Image, u16 Origin);
+	std::vector<u16> Entries;
+	std::map<u16, RecoveredBlock> Blocks;
+
+	void Recover();
+	/* C++ source defining `extern const RecompiledProgram Name` */
+	std::string Emit(const std::string& Name) const;
+
+private:
+	std::vector<u8> Image;
+	u16 Origin;
+	std::set<u16> Leaders;
+	std::set<u16> Decoded;
+	u8 BaseCycles[0x100] = {}; // Measured on the core: indexed reads not crossing a page, branches not taken
+
+	bool Inside(u32 Address, u32 Length) const {
+		return Address >= Origin && Address + Length <= Origin + Image.size();
+	}
+
+	u8 Byte(u16 Address) const {
+		return Image[Address - Origin];
+	}
+
+	std::string Instruction(u16 Address, std::string& Comment) const;
+	std::string Exit(const RecoveredBlock& Block, const std::string& Retire) const;
+	std::string Chain(u16 Target, const std::string& Indent) const;
+};
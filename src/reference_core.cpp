@@ -0,0 +1,187 @@
+#include "reference_core.h"
+#include "opcodes.h"
+
+static constexpr u32 Key(const char* Mnemonic) {
+	return static_cast<u32>(Mnemonic[0]) << 16 | static_cast<u32>(Mnemonic[1]) << 8 | static_cast<u32>(Mnemonic[2]);
+}
+
+ReferenceCore::ReferenceCore() : Memory(0x10000, 0) {}
+
+void ReferenceCore::Interrupt(u16 Vector) {
+	Write(SP--, 0); // The core pushes PC << 8 through a byte, so the high byte is always 0
+	Write(SP--, static_cast<u8>(PC));
+	Write(SP, static_cast<u8>(ProcessorStatus.to_ulong()));
+	PC = Read(Vector);
+	ProcessorStatus[NMOS6502::I] = false;
+}
+
+/* Absolute operands are high byte first; zero page indexing wraps except for the stores */
+u16 ReferenceCore::EffectiveAddress(u8 Opcode) {
+	const OpcodeInfo& Info = OpcodeTable[Opcode];
+	bool Store = ClassOf(Opcode) == ClassStore;
+	switch (Info.Mode) {
+	case Immediate: return PC++;
+	case ZeroPage: return Fetch();
+	case ZeroPageX: return Store ? Fetch() + X : static_cast<u8>(Fetch() + X);
+	case ZeroPageY: return Store ? Fetch() + Y : static_cast<u8>(Fetch() + Y);
+	case Absolute:
+	case AbsoluteX:
+	case AbsoluteY: {
+		u16 High = Fetch();
+		u16 Base = static_cast<u16>(High << 8 | Fetch());
+		return static_cast<u16>(Base + (Info.Mode == AbsoluteX ? X : Info.Mode == AbsoluteY ? Y : 0));
+	}
+	case IndirectX: {
+		u8 Pointer = static_cast<u8>(Fetch() + X);
+		return static_cast<u16>(Read(Pointer) | Read(static_cast<u8>(Pointer + 1)) << 8);
+	}
+	case IndirectY: {
+		u8 Pointer = Fetch();
+		return static_cast<u16>((Read(Pointer) | Read(static_cast<u8>(Pointer + 1)) << 8) + Y);
+	}
+	default: return 0;
+	}
+}
+
+/* Carry comes from the outgoing bit, then a rotate feeds that new carry back in */
+void ReferenceCore::Shift(u8 Opcode, u16 Address) {
+	const char* Mnemonic = OpcodeTable[Opcode].Mnemonic;
+	bool Left = Mnemonic[0] == 'A' || Mnemonic[2] == 'L';
+	if (OpcodeTable[Opcode].Mode == Accumulator) {
+		switch (Opcode) {
+		case 0x0A: ProcessorStatus[NMOS6502::C] = A >> 7; A = static_cast<u8>(A << 1); break;
+		case 0x4A: ProcessorStatus[NMOS6502::C] = A >> 1 & 1; A >>= 1; break; // Carry from bit 1
+		case 0x2A: ProcessorStatus[NMOS6502::C] = A >> 7; A = static_cast<u8>(A << 1 | A >> 7); break;
+		case 0x6A: ProcessorStatus[NMOS6502::C] = A >> 7; A = static_cast<u8>(A >> 1 | A << 7); break; // Carry from bit 7
+		}
+		return;
+	}
+	u8 Value = Read(Address);
+	bool Carry = Left ? Value >> 7 : Value & 1;
+	Value = static_cast<u8>(Left ? Value << 1 : Value >> 1);
+	if (Carry && Mnemonic[0] == 'R') {
+		Value |= Left ? 0x01 : 0x80;
+	}
+	ProcessorStatus[NMOS6502::C] = Carry;
+	Write(Address, Value);
+}
+
+void ReferenceCore::Compare(u8 Register, u8 Operand) {
+	u8 Difference = static_cast<u8>(Register - Operand);
+	ProcessorStatus[NMOS6502::N] = Difference >> 7;
+	ProcessorStatus[NMOS6502::Z] = Register == Operand;
+	ProcessorStatus[NMOS6502::C] = Register >= Operand;
+}
+
+void ReferenceCore::Step() {
+	if (NMIPending) {
+		NMIPending = false;
+		Interrupt(0xFFFE);
+	}
+	if (IRQPending) {
+		IRQPending = false;
+		if (!ProcessorStatus[NMOS6502::I]) {
+			Interrupt(0xFFFA);
+		}
+	}
+
+	u16 Address = PC;
+	u8 Opcode = Fetch();
+	if (IsBranch(Opcode)) { // Relative to the opcode; a branch not taken leaves PC on the offset byte
+		static constexpr NMOS6502::FLAGS Tested[4] = { NMOS6502::N, NMOS6502::V, NMOS6502::C, NMOS6502::Z };
+		if (ProcessorStatus[Tested[Opcode >> 6]] == ((Opcode & 0x20) != 0)) {
+			PC = static_cast<u16>(Address + static_cast<int8_t>(Read(PC)));
+		}
+		return;
+	}
+
+	const char* Mnemonic = OpcodeTable[Opcode].Mnemonic;
+	switch (Key(Mnemonic)) {
+	case Key("JMP"): {
+		u16 Target = static_cast<u16>(Read(PC) | Read(static_cast<u16>(PC + 1)) << 8);
+		PC = Opcode == 0x6C ? static_cast<u16>(Read(Target) << 8 | Read(static_cast<u16>(Target + 1))) : Target;
+		return;
+	}
+	case Key("JSR"): // Pushes the opcode address and takes the target from the two bytes after the next
+		Write(SP--, static_cast<u8>(Address >> 8));
+		Write(SP--, static_cast<u8>(Address));
+		PC = static_cast<u16>(Read(static_cast<u16>(Address + 3)) << 8 | Read(static_cast<u16>(Address + 2)));
+		return;
+	case Key("RTS"): {
+		u8 Low = Read(static_cast<u16>(SP + 1));
+		++SP;
+		u8 High = Read(static_cast<u16>(SP + 1));
+		++SP;
+		PC = static_cast<u16>((High << 8 | Low) + 1);
+		return;
+	}
+	case Key("RTI"): { // The core shifts the high byte by 8 + the low byte, which x86 takes modulo 32
+		ProcessorStatus = std::bitset<6>(Read(SP));
+		++SP;
+		PC = static_cast<u16>(Read(static_cast<u16>(SP + 1)) << ((8 + Read(SP)) & 31));
+		SP += 2;
+		return;
+	}
+	}
+
+	u16 Operand = EffectiveAddress(Opcode);
+	switch (Key(Mnemonic)) {
+	case Key("LDA"):
+		A = Read(Operand);
+		ProcessorStatus[NMOS6502::Z] = A == 0;
+		ProcessorStatus[NMOS6502::N] = A >> 5 & 1; // Bit 5, as the core tests it
+		break;
+	case Key("LDX"): X = Read(Operand); break;
+	case Key("LDY"): Y = Read(Operand); break;
+	case Key("STA"): Write(Operand, A); break;
+	case Key("STX"): Write(Operand, X); break;
+	case Key("STY"): Write(Operand, Y); break;
+	case Key("ADC"): A = static_cast<u8>(A + Read(Operand) + ProcessorStatus[NMOS6502::C]); break; // No flags
+	case Key("SBC"): A = static_cast<u8>(A - Read(Operand) - ProcessorStatus[NMOS6502::C]); break;
+	case Key("AND"): A &= Read(Operand); break;
+	case Key("ORA"): A |= Read(Operand); break;
+	case Key("EOR"): A ^= Read(Operand); break;
+	case Key("BIT"): // N and V are always cleared
+		ProcessorStatus[NMOS6502::Z] = (A & Read(Operand)) == 0;
+		ProcessorStatus[NMOS6502::N] = false;
+		ProcessorStatus[NMOS6502::V] = false;
+		break;
+	case Key("CMP"): Compare(A, Read(Operand)); break;
+	case Key("CPX"): Compare(X, Read(Operand)); break;
+	case Key("CPY"): Compare(Y, Read(Operand)); break;
+	case Key("ASL"):
+	case Key("LSR"):
+	case Key("ROL"):
+	case Key("ROR"): Shift(Opcode, Operand); break;
+	case Key("INC"): Write(Operand, static_cast<u8>(Read(Operand) + 1)); break;
+	case Key("DEC"): Write(Operand, static_cast<u8>(Read(Operand) - 1)); break;
+	case Key("INX"): ++X; break;
+	case Key("INY"): ++Y; break;
+	case Key("DEX"): --X; break;
+	case Key("DEY"): --Y; break;
+	case Key("TAX"): X = A; break;
+	case Key("TAY"): Y = A; break;
+	case Key("TXA"): A = X; break;
+	case Key("TYA"): A = Y; break;
+	case Key("TSX"): X = static_cast<u8>(SP); break;
+	case Key("TXS"): SP = X; break;
+	case Key("PHA"): Write(SP--, A); break;
+	case Key("PHP"): Write(SP--, static_cast<u8>(ProcessorStatus.to_ulong())); break;
+	case Key("PLA"): // Pulls from SP itself and clears the slot
+		A = Read(SP);
+		Write(SP++, 0);
+		break;
+	case Key("PLP"):
+		ProcessorStatus = std::bitset<6>(Read(SP));
+		Write(SP++, 0);
+		break;
+	case Key("CLC"): ProcessorStatus[NMOS6502::C] = false; break;
+	case Key("SEC"): ProcessorStatus[NMOS6502::C] = true; break;
+	case Key("CLI"): ProcessorStatus[NMOS6502::I] = false; break;
+	case Key("SEI"): ProcessorStatus[NMOS6502::I] = true; break;
+	case Key("CLV"): ProcessorStatus[NMOS6502::V] = false; break;
+	case Key("CLD"): ProcessorStatus[NMOS6502::D] = false; break;
+	case Key("SED"): ProcessorStatus[NMOS6502::D] = true; break;
+	default: break; // BRK, NOP and the undocumented opcodes only move past the opcode
+	}
+}
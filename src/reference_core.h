@@ -0,0 +1,45 @@
+#pragma once
+#include <bitset>
+#include <vector>
+#include "6502.h"
+#include "dirty_pages.h"
+
+/*
+	A deliberately plain interpreter of the same instruction set as NMOS6502: one switch over the
+	mnemonic, addressing decoded from OpcodeTable, nothing shared with the core's handlers. It
+	follows this core's dialect rather than silicon (big-endian data operands, JSR and RTS
+	offsets, the flag behaviour the unit tests pin down), since its job is to notice when a
+	faster core changes behaviour, not to judge the behaviour.
+*/
+class ReferenceCore {
+public:
+	ReferenceCore();
+	std::vector<u8> Memory;
+	u8 A = 0, X = 0, Y = 0;
+	u16 SP = 0x0100, PC = 0;
+	std::bitset<6> ProcessorStatus;
+	bool NMIPending = false, IRQPending = false;
+	DirtyPageMap Dirty; // Every page written since the last Clear
+
+	/* One instruction, taking a pending NMI and then IRQ first like NMOS6502::Execute */
+	void Step();
+
+private:
+	u8 Read(u16 Address) const {
+		return Memory[Address];
+	}
+
+	void Write(u16 Address, u8 Value) {
+		Dirty.Mark(Address);
+		Memory[Address] = Value;
+	}
+
+	u8 Fetch() {
+		return Memory[PC++];
+	}
+
+	void Interrupt(u16 Vector);
+	u16 EffectiveAddress(u8 Opcode);
+	void Shift(u8 Opcode, u16 Address);
+	void Compare(u8 Register, u8 Operand);
+};
@@ -0,0 +1,129 @@
+#include "replay.h"
+
+Recorder::Recorder(NMOS6502& M6502, u64 CheckpointEvery) : M6502(M6502), CheckpointEvery(CheckpointEvery) {
+	M6502.Watchpoints = &Inputs;
+}
+
+Recorder::~Recorder() {
+	if (M6502.Watchpoints == &Inputs) {
+		M6502.Watchpoints = nullptr;
+	}
+}
+
+void Recorder::Input(u16 Address, u32 Length) {
+	Inputs.Add(Address, WatchRead, Length);
+}
+
+int Recorder::Step() {
+	if (Cycles >= NextCheckpoint) {
+		Log.Checkpoints.push_back({ Instruction, Cycles, {} });
+		Log.Checkpoints.back().State.Capture(M6502);
+		NextCheckpoint = Cycles + CheckpointEvery;
+	}
+	if (M6502.NMIPending) {
+		Log.Events.push_back({ Instruction, 0, 0, EventNMI });
+	}
+	if (M6502.IRQPending) {
+		Log.Events.push_back({ Instruction, 0, 0, EventIRQ });
+	}
+	int Spent = M6502.Execute(0);
+	if (!Inputs.Hits.empty()) {
+		for (const WatchHit& Hit : Inputs.Hits) {
+			Log.Events.push_back({ Instruction, Hit.Address, Hit.Old, EventRead });
+		}
+		Inputs.ClearHits();
+	}
+	Cycles += Spent;
+	Log.Instructions = ++Instruction;
+	return Spent;
+}
+
+Replayer::Replayer(NMOS6502& M6502, const Recording& Log) : M6502(M6502), Log(Log) {
+	if (!Log.Checkpoints.empty()) {
+		Restore(Log.Checkpoints.front());
+	}
+}
+
+void Replayer::Restore(const Checkpoint& From) {
+	From.State.RestoreAll(M6502);
+	Instruction = From.Instruction;
+	Cycles = From.Cycles;
+	auto Next = std::lower_bound(Log.Events.begin(), Log.Events.end(), Instruction, [](const ReplayEvent& Event, u64 Value) {
+		return Event.Instruction < Value;
+	});
+	NextEvent = Next - Log.Events.begin();
+}
+
+int Replayer::Step() {
+	if (Instruction >= Log.Instructions) {
+		return 0;
+	}
+	for (; NextEvent < Log.Events.size() && Log.Events[NextEvent].Instruction == Instruction; ++NextEvent) {
+		const ReplayEvent& Event = Log.Events[NextEvent];
+		switch (Event.Kind) {
+		case EventIRQ: M6502.IRQPending = true; break;
+		case EventNMI: M6502.NMIPending = true; break;
+		case EventRead: M6502.Memory[Event.Address] = Event.Value; break;
+		}
+	}
+	int Spent = M6502.Execute(0);
+	Cycles += Spent;
+	++Instruction;
+	return Spent;
+}
+
+void Replayer::Seek(u64 Target) {
+	if (Log.Checkpoints.empty()) {
+		return;
+	}
+	Target = std::min(Target, Log.Instructions);
+	auto After = std::upper_bound(Log.Checkpoints.begin(), Log.Checkpoints.end(), Target, [](u64 Value, const Checkpoint& Point) {
+		return Value < Point.Instruction;
+	});
+	const Checkpoint& Nearest = *(After == Log.Checkpoints.begin() ? After : After - 1);
+	if (Target < Instruction || Nearest.Instruction > Instruction) {
+		Restore(Nearest);
+	}
+	while (Instruction < Target) {
+		Step();
+	}
+}
+
+bool Replayer::ReverseStep() {
+	if (Log.Checkpoints.empty() || Instruction <= Log.Checkpoints.front().Instruction) {
+		return false;
+	}
+	Seek(Instruction - 1);
+	return true;
+}
+
+bool Replayer::ReverseContinue(const BreakpointMap& Breakpoints) {
+	if (Log.Checkpoints.empty() || Instruction <= Log.Checkpoints.front().Instruction) {
+		return false;
+	}
+	/* Replay one checkpoint interval at a time, latest first, remembering the last stop in it */
+	u64 Current = Instruction, WindowEnd = Current;
+	auto Window = std::upper_bound(Log.Checkpoints.begin(), Log.Checkpoints.end(), Current - 1, [](u64 Value, const Checkpoint& Point) {
+		return Value < Point.Instruction;
+	}) - 1;
+	for (;;) {
+		Restore(*Window);
+		u64 Found = Current;
+		while (Instruction < WindowEnd) {
+			if (Breakpoints.Test(M6502.PC)) {
+				Found = Instruction;
+			}
+			Step();
+		}
+		if (Found != Current) {
+			Seek(Found);
+			return true;
+		}
+		if (Window == Log.Checkpoints.begin()) {
+			Seek(Current);
+			return false;
+		}
+		WindowEnd = Window->Instruction;
+		--Window;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <vector>
+#include "6502.h"
+#include "run_loop.h"
+#include "snapshot.h"
+#include "watchpoints.h"
+
+enum ReplayEventKind : u8 { EventIRQ, EventNMI, EventRead };
+
+/* An input the guest saw before or during instruction number Instruction */
+struct ReplayEvent {
+	u64 Instruction;
+	u16 Address; // Of an EventRead
+	u8 Value;
+	ReplayEventKind Kind;
+};
+
+struct Checkpoint {
+	u64 Instruction; // Instructions run before the capture
+	u64 Cycles;
+	MachineSnapshot State;
+};
+
+/* Everything needed to run a recorded stretch again: its inputs and where to start from */
+struct Recording {
+	std::vector<ReplayEvent> Events; // In instruction order
+	std::vector<Checkpoint> Checkpoints; // The first is where recording began
+	u64 Instructions = 0; // Recorded in all
+};
+
+/*
+	Records the nondeterministic inputs of a run. The host raises IRQPending or NMIPending and
+	stores device registers into Memory between calls to Step, as it would around Execute;
+	Step logs the interrupt lines it finds pending and, through a WatchpointMap it installs on
+	the core, the value of every read from an address given to Input. A checkpoint is taken
+	every CheckpointEvery cycles. Host writes to addresses that are not inputs are not seen.
+*/
+class Recorder {
+public:
+	Recorder(NMOS6502& M6502, u64 CheckpointEvery = 100000);
+	~Recorder();
+	NMOS6502& M6502;
+	Recording Log;
+	u64 CheckpointEvery;
+	u64 Instruction = 0, Cycles = 0;
+
+	void Input(u16 Address, u32 Length = 1);
+	int Step();
+
+private:
+	WatchpointMap Inputs;
+	u64 NextCheckpoint = 0;
+};
+
+/*
+	Runs a Recording again on a core, forwards or backwards. Moving to an earlier instruction
+	restores the nearest checkpoint at or before it and replays forward with the recorded
+	inputs, so the cost is bounded by the checkpoint interval.
+*/
+class Replayer {
+public:
+	Replayer(NMOS6502& M6502, const Recording& Log);
+	NMOS6502& M6502;
+	const Recording& Log;
+	u64 Instruction = 0, Cycles = 0;
+
+	/* Runs the next recorded instruction; 0 at the end of the recording */
+	int Step();
+	void Seek(u64 Target);
+	/* Steps back one instruction; false at the start of the recording */
+	bool ReverseStep();
+	/* Goes back to the most recent earlier point where PC was on one of Breakpoints */
+	bool ReverseContinue(const BreakpointMap& Breakpoints);
+
+private:
+	size_t NextEvent = 0;
+
+	void Restore(const Checkpoint& From);
+};
@@ -0,0 +1,161 @@
+#include "rewind.h"
+#include <algorithm>
+#include <cstring>
+
+void RewindBuffer::Encode(std::vector<u8>& Out, const u8* Old, const u8* New) {
+	int Offset = 0;
+	while (Offset < 0x100) {
+		int Run = 0;
+		if (Old[Offset] == New[Offset]) {
+			while (Offset + Run < 0x100 && Run < 127 && Old[Offset + Run] == New[Offset + Run]) {
+				++Run;
+			}
+			Out.push_back(static_cast<u8>(0x80 | Run));
+		}
+		else {
+			/* Literals run on over isolated equal bytes, which a zero run would cost as much as */
+			while (Offset + Run < 0x100 && Run < 127 && (Old[Offset + Run] != New[Offset + Run] || (Offset + Run + 1 < 0x100 && Old[Offset + Run + 1] != New[Offset + Run + 1]))) {
+				++Run;
+			}
+			Out.push_back(static_cast<u8>(Run));
+			for (int i = 0; i < Run; ++i) {
+				Out.push_back(Old[Offset + i] ^ New[Offset + i]);
+			}
+		}
+		Offset += Run;
+	}
+}
+
+void RewindBuffer::Apply(const std::vector<u8>& Delta, std::vector<u8>& Memory) {
+	for (size_t Cursor = 0; Cursor < Delta.size();) {
+		u8* Page = &Memory[Delta[Cursor++] << 8];
+		for (int Offset = 0; Offset < 0x100;) {
+			u8 Run = Delta[Cursor++];
+			if (Run & 0x80) {
+				Offset += Run & 0x7F;
+				continue;
+			}
+			for (int i = 0; i < Run; ++i) {
+				Page[Offset++] ^= Delta[Cursor++];
+			}
+		}
+	}
+}
+
+void RewindBuffer::Capture(const NMOS6502& M6502, DirtyPageMap& Dirty, u64 Cycles) {
+	RewindFrame Frame;
+	Frame.Number = Captured++;
+	Frame.Cycles = Cycles;
+	Frame.A = M6502.A;
+	Frame.X = M6502.X;
+	Frame.Y = M6502.Y;
+	Frame.SP = M6502.SP;
+	Frame.PC = M6502.PC;
+	Frame.ProcessorStatus = M6502.ProcessorStatus;
+	Frame.NMIPending = M6502.NMIPending;
+	Frame.IRQPending = M6502.IRQPending;
+	if (History.empty()) {
+		Newest = M6502.Memory;
+	}
+	else {
+		Dirty.ForEach([&](u8 Page) {
+			const u8* Old = &Newest[Page << 8];
+			const u8* New = &M6502.Memory[Page << 8];
+			if (std::memcmp(Old, New, 0x100) != 0) {
+				Frame.Delta.push_back(Page);
+				Encode(Frame.Delta, Old, New);
+				std::memcpy(&Newest[Page << 8], New, 0x100);
+			}
+		});
+		Frame.Delta.shrink_to_fit();
+	}
+	if (KeyframeEvery && Frame.Number % KeyframeEvery == 0) {
+		Frame.Keyframe = Newest;
+	}
+	Dirty.Clear();
+	Held += Size(Frame);
+	History.push_back(std::move(Frame));
+
+	/* The oldest frame's delta only leads to frames already dropped */
+	while (History.size() > 1 && Bytes() > Budget) {
+		Held -= Size(History.front());
+		History.pop_front();
+		Held -= History.front().Delta.capacity();
+		History.front().Delta.clear();
+		History.front().Delta.shrink_to_fit();
+	}
+}
+
+size_t RewindBuffer::Whole(size_t Index) const {
+	if (!KeyframeEvery) {
+		return History.size() - 1;
+	}
+	u64 Number = History[Index].Number;
+	u64 Next = (Number + KeyframeEvery - 1) / KeyframeEvery * KeyframeEvery; // Frames are numbered without gaps
+	size_t Found = static_cast<size_t>(std::min<u64>(Index + (Next - Number), History.size() - 1));
+	return History[Found].Keyframe.empty() ? History.size() - 1 : Found; // KeyframeEvery changed since
+}
+
+void RewindBuffer::Rebuild(size_t Index, std::vector<u8>& Out) const {
+	size_t From = Whole(Index);
+	Out = From == History.size() - 1 ? Newest : History[From].Keyframe;
+	for (size_t i = From; i > Index; --i) {
+		Apply(History[i].Delta, Out);
+	}
+}
+
+bool RewindBuffer::Reconstruct(size_t Back, MachineSnapshot& Out) const {
+	if (Back >= History.size()) {
+		return false;
+	}
+	size_t Index = History.size() - 1 - Back;
+	Rebuild(Index, Out.Memory);
+	const RewindFrame& Frame = History[Index];
+	Out.A = Frame.A;
+	Out.X = Frame.X;
+	Out.Y = Frame.Y;
+	Out.SP = Frame.SP;
+	Out.PC = Frame.PC;
+	Out.ProcessorStatus = Frame.ProcessorStatus;
+	Out.NMIPending = Frame.NMIPending;
+	Out.IRQPending = Frame.IRQPending;
+	return true;
+}
+
+bool RewindBuffer::Rewind(NMOS6502& M6502, DirtyPageMap& Dirty, size_t Back) {
+	if (Back >= History.size()) {
+		return false;
+	}
+	size_t Index = History.size() - 1 - Back;
+	if (Whole(Index) < History.size() - 1) { // A keyframe between here and the target: copy all of memory from it
+		Rebuild(Index, Newest);
+		M6502.Memory = Newest;
+		while (History.size() > Index + 1) {
+			Held -= Size(History.back());
+			History.pop_back();
+		}
+	}
+	else {
+		Dirty.ForEach([&](u8 Page) {
+			std::memcpy(&M6502.Memory[Page << 8], &Newest[Page << 8], 0x100);
+		});
+		for (; Back; --Back) {
+			Apply(History.back().Delta, Newest);
+			Apply(History.back().Delta, M6502.Memory);
+			Held -= Size(History.back());
+			History.pop_back();
+		}
+	}
+	Dirty.Clear();
+	const RewindFrame& Frame = History.back();
+	Captured = Frame.Number + 1;
+	M6502.A = Frame.A;
+	M6502.X = Frame.X;
+	M6502.Y = Frame.Y;
+	M6502.SP = Frame.SP;
+	M6502.PC = Frame.PC;
+	M6502.ProcessorStatus = Frame.ProcessorStatus;
+	M6502.NMIPending = Frame.NMIPending;
+	M6502.IRQPending = Frame.IRQPending;
+	return true;
+}
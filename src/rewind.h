@@ -0,0 +1,85 @@
+#pragma once
+#include <bitset>
+#include <deque>
+#include <vector>
+#include "6502.h"
+#include "dirty_pages.h"
+#include "snapshot.h"
+
+/*
+	Registers of one captured point, and the pages that changed since the point before it as
+	XOR differences, run-length encoded: per page its number, then runs of "n literal bytes"
+	(a byte 1-127 and the bytes) or "n zeros" (a byte 0x80 | n), 256 bytes in all.
+*/
+struct RewindFrame {
+	u64 Number = 0; // Captures before this one
+	u64 Cycles = 0;
+	u8 A = 0, X = 0, Y = 0;
+	u16 SP = 0, PC = 0;
+	std::bitset<6> ProcessorStatus;
+	bool NMIPending = false, IRQPending = false;
+	std::vector<u8> Delta;
+	std::vector<u8> Keyframe; // Whole memory, on every KeyframeEvery-th capture
+};
+
+/*
+	Ring of captured states within a byte Budget. Every frame holds the XOR of the pages it
+	changed, which taken in reverse turns it back into the frame before it. The newest state is
+	kept whole, and so is every KeyframeEvery-th frame, so reaching any retained frame costs one
+	64 KB copy and fewer than KeyframeEvery deltas. Keyframes count against the budget; the
+	oldest frames are dropped when it is exceeded.
+
+	Capture diffs only the pages marked in Dirty, which should cover every page written since the
+	last capture (the core's DirtyPages hook in an instrumented build, or a full MarkRange), and
+	clears it.
+*/
+class RewindBuffer {
+public:
+	explicit RewindBuffer(size_t Budget = 4 << 20) : Budget(Budget) {}
+	size_t Budget;
+	u64 KeyframeEvery = 128;
+
+	void Capture(const NMOS6502& M6502, DirtyPageMap& Dirty, u64 Cycles);
+	size_t Frames() const {
+		return History.size();
+	}
+
+	/* Bytes held, the newest whole state included */
+	size_t Bytes() const {
+		return Held + Newest.size();
+	}
+
+	/* Cycles of the frame Back captures before the newest */
+	u64 CyclesAt(size_t Back) const {
+		return History[History.size() - 1 - Back].Cycles;
+	}
+
+	/* Rebuilds the frame Back captures before the newest into Out, keeping the history */
+	bool Reconstruct(size_t Back, MachineSnapshot& Out) const;
+	/*
+		Puts the core back at the frame Back captures before the newest and drops the frames
+		after it. Dirty must hold the pages written since the last capture; only those and the
+		pages the dropped frames changed are copied, or all of memory when that is cheaper
+		through a keyframe. Dirty is cleared.
+	*/
+	bool Rewind(NMOS6502& M6502, DirtyPageMap& Dirty, size_t Back);
+
+private:
+	std::deque<RewindFrame> History;
+	std::vector<u8> Newest; // Memory of the newest frame
+	size_t Held = 0;
+	u64 Captured = 0;
+
+	static size_t Size(const RewindFrame& Frame) {
+		return sizeof(RewindFrame) + Frame.Delta.capacity() + Frame.Keyframe.capacity();
+	}
+
+	/* Index of the nearest frame at or after Index whose memory is kept whole, or the newest */
+	size_t Whole(size_t Index) const;
+	/* Memory of the frame at Index into Out */
+	void Rebuild(size_t Index, std::vector<u8>& Out) const;
+
+	static void Encode(std::vector<u8>& Out, const u8* Old, const u8* New);
+	/* XORs an encoded delta into Memory, undoing or redoing the frame */
+	static void Apply(const std::vector<u8>& Delta, std::vector<u8>& Memory);
+};
@@ -0,0 +1,75 @@
+#include "run_loop.h"
+#include <bit>
+#include "opcodes.h"
+
+void BreakpointMap::ClearAll() {
+	for (u64& Word : Words) {
+		Word = 0;
+	}
+}
+
+int BreakpointMap::Count() const {
+	int Total = 0;
+	for (u64 Word : Words) {
+		Total += std::popcount(Word);
+	}
+	return Total;
+}
+
+template <RunMode Mode>
+RunResult RunLoop::Loop(u64 Cycles) {
+	RunResult Result;
+	if constexpr (Mode == RunFast) {
+		Stopped = false;
+		while (Result.Cycles < Cycles) {
+			Result.Cycles += M6502.Execute(0);
+			++Result.Instructions;
+		}
+	}
+	else {
+		bool Resume = Stopped && M6502.PC == StoppedAt;
+		bool BlockEntry = true; // Wherever the run starts counts as an entry
+		Stopped = false;
+#ifdef NMOS6502_INSTRUMENTATION
+		u64 Seen = M6502.Watchpoints ? M6502.Watchpoints->Recorded : 0;
+#endif
+		while (Result.Cycles < Cycles) {
+			bool Check = Mode == RunDebugInstruction || BlockEntry;
+			if (Check && !Resume && Breakpoints.Test(M6502.PC) && Holds(Conditions, M6502.PC)) {
+				Stopped = true;
+				StoppedAt = M6502.PC;
+				Result.Stop = RunBreakpoint;
+				break;
+			}
+			Resume = false;
+			if constexpr (Mode == RunDebugBlock) {
+				BlockEntry = BlockEnds.Ends[M6502.Memory[M6502.PC]] || M6502.NMIPending || M6502.IRQPending;
+			}
+			Result.Cycles += M6502.Execute(0);
+			++Result.Instructions;
+#ifdef NMOS6502_INSTRUMENTATION
+			if (M6502.Watchpoints && M6502.Watchpoints->Recorded != Seen) {
+				const auto& New = M6502.Watchpoints->Hits;
+				bool Stop = false;
+				for (size_t i = New.size() - std::min<u64>(M6502.Watchpoints->Recorded - Seen, New.size()); i < New.size(); ++i) {
+					Stop = Stop || Holds(WatchConditions, New[i].Address);
+				}
+				Seen = M6502.Watchpoints->Recorded;
+				if (Stop) {
+					Result.Stop = RunWatchpoint;
+					break;
+				}
+			}
+#endif
+		}
+	}
+	return Result;
+}
+
+RunResult RunLoop::Run(u64 Cycles) {
+	switch (Mode) {
+	case RunDebugInstruction: return Loop<RunDebugInstruction>(Cycles);
+	case RunDebugBlock: return Loop<RunDebugBlock>(Cycles);
+	default: return Loop<RunFast>(Cycles);
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <unordered_map>
+#include "6502.h"
+#include "condition.h"
+
+/* One bit per address, 8 KB for the whole 64K address space */
+class BreakpointMap {
+public:
+	u64 Words[0x10000 / 64] = {};
+
+	void Set(u16 Address) {
+		Words[Address >> 6] |= u64{ 1 } << (Address & 63);
+	}
+
+	void Clear(u16 Address) {
+		Words[Address >> 6] &= ~(u64{ 1 } << (Address & 63));
+	}
+
+	bool Test(u16 Address) const {
+		return Words[Address >> 6] >> (Address & 63) & 1;
+	}
+
+	void ClearAll();
+	int Count() const;
+};
+
+enum RunMode {
+	RunFast, // No breakpoint code at all
+	RunDebugInstruction, // One bitmap lookup before every instruction
+	RunDebugBlock // One lookup where a basic block is entered: after a branch, jump, call, return or interrupt
+};
+
+enum RunStop { RunBudgetSpent, RunBreakpoint, RunWatchpoint };
+
+struct RunResult {
+	u64 Cycles = 0;
+	u64 Instructions = 0;
+	RunStop Stop = RunBudgetSpent;
+};
+
+/*
+	Drives NMOS6502::Execute for a cycle budget. Each RunMode is its own instantiation of the
+	loop, so the fast one carries no breakpoint code, and Mode can be changed between calls
+	without touching the guest. A run stops before the instruction at a breakpoint; the next
+	run resumes over it. Block mode only sees breakpoints on block entry addresses. Execute takes
+	an interrupt together with the first instruction of its handler, so neither debug mode can
+	stop on that one. In an instrumented build the debug modes also stop after any instruction
+	that hit one of the core's Watchpoints.
+
+	A breakpoint or watched address with an entry in Conditions or WatchConditions only stops
+	the run when its condition holds. The bitmap stays the only test on the common path; the
+	condition is looked up and evaluated once the bit is already set. Watch conditions see the
+	state after the instruction that made the access.
+*/
+class RunLoop {
+public:
+	explicit RunLoop(NMOS6502& M6502) : M6502(M6502) {}
+	NMOS6502& M6502;
+	BreakpointMap Breakpoints;
+	std::unordered_map<u16, Condition> Conditions;
+	std::unordered_map<u16, Condition> WatchConditions;
+	RunMode Mode = RunFast;
+
+	/* Runs until at least Cycles have been spent or, in a debug mode, a breakpoint is reached */
+	RunResult Run(u64 Cycles);
+
+private:
+	bool Stopped = false; // The last run ended on a breakpoint at StoppedAt
+	u16 StoppedAt = 0;
+
+	bool Holds(const std::unordered_map<u16, Condition>& Table, u16 Address) const {
+		auto Entry = Table.find(Address);
+		return Entry == Table.end() || Entry->second.Evaluate(M6502);
+	}
+
+	template <RunMode Mode>
+	RunResult Loop(u64 Cycles);
+};
@@ -0,0 +1,208 @@
+#include "save_state.h"
+#include <cstdio>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define M6502_SAVE_STATE_MMAP
+#endif
+
+static constexpr u32 HeaderSize = 64;
+static constexpr u32 ImageOffset = 4096;
+static constexpr u32 ImageSize = 0x10000;
+
+static void Put16(u8* At, u16 Value) {
+	At[0] = static_cast<u8>(Value);
+	At[1] = static_cast<u8>(Value >> 8);
+}
+
+static void Put32(u8* At, u32 Value) {
+	Put16(At, static_cast<u16>(Value));
+	Put16(At + 2, static_cast<u16>(Value >> 16));
+}
+
+static u16 Get16(const u8* At) {
+	return static_cast<u16>(At[0] | At[1] << 8);
+}
+
+static u32 Get32(const u8* At) {
+	return Get16(At) | static_cast<u32>(Get16(At + 2)) << 16;
+}
+
+u8 PackStatus(const std::bitset<6>& ProcessorStatus) {
+	return static_cast<u8>(ProcessorStatus[NMOS6502::N] << 7 | ProcessorStatus[NMOS6502::V] << 6 | 0x20 |
+		ProcessorStatus[NMOS6502::D] << 3 | ProcessorStatus[NMOS6502::I] << 2 | ProcessorStatus[NMOS6502::Z] << 1 | ProcessorStatus[NMOS6502::C]);
+}
+
+std::bitset<6> UnpackStatus(u8 P) {
+	std::bitset<6> ProcessorStatus;
+	ProcessorStatus[NMOS6502::N] = P >> 7 & 1;
+	ProcessorStatus[NMOS6502::V] = P >> 6 & 1;
+	ProcessorStatus[NMOS6502::D] = P >> 3 & 1;
+	ProcessorStatus[NMOS6502::I] = P >> 2 & 1;
+	ProcessorStatus[NMOS6502::Z] = P >> 1 & 1;
+	ProcessorStatus[NMOS6502::C] = P & 1;
+	return ProcessorStatus;
+}
+
+void SaveState(std::vector<u8>& Out, const NMOS6502& M6502, u64 Cycles, const std::vector<DeviceChunk>& Devices) {
+	size_t Size = ImageOffset + ImageSize;
+	for (const DeviceChunk& Chunk : Devices) {
+		Size += 8 + ((Chunk.Data.size() + 3) & ~size_t{ 3 });
+	}
+	Out.assign(Size, 0);
+	u8* Header = Out.data();
+	std::memcpy(Header, "M65S", 4);
+	Put16(Header + 4, SaveStateVersion);
+	Put16(Header + 6, HeaderSize);
+	Header[8] = M6502.A;
+	Header[9] = M6502.X;
+	Header[10] = M6502.Y;
+	Header[11] = PackStatus(M6502.ProcessorStatus);
+	Put16(Header + 12, M6502.SP);
+	Put16(Header + 14, M6502.PC);
+	Header[16] = M6502.NMIPending | M6502.IRQPending << 1;
+	Put32(Header + 24, static_cast<u32>(Cycles));
+	Put32(Header + 28, static_cast<u32>(Cycles >> 32));
+	Put32(Header + 32, ImageOffset);
+	Put32(Header + 36, ImageSize);
+	Put32(Header + 40, ImageOffset + ImageSize);
+	Put32(Header + 44, static_cast<u32>(Devices.size()));
+	std::memcpy(Header + ImageOffset, M6502.Memory.data(), ImageSize);
+	u8* Cursor = Header + ImageOffset + ImageSize;
+	for (const DeviceChunk& Chunk : Devices) {
+		Put32(Cursor, Chunk.Tag);
+		Put32(Cursor + 4, static_cast<u32>(Chunk.Data.size()));
+		if (!Chunk.Data.empty()) {
+			std::memcpy(Cursor + 8, Chunk.Data.data(), Chunk.Data.size());
+		}
+		Cursor += 8 + ((Chunk.Data.size() + 3) & ~size_t{ 3 });
+	}
+}
+
+bool SaveState(const std::string& Path, const NMOS6502& M6502, u64 Cycles, const std::vector<DeviceChunk>& Devices) {
+	std::vector<u8> Contents;
+	SaveState(Contents, M6502, Cycles, Devices);
+	std::FILE* File = std::fopen(Path.c_str(), "wb");
+	if (!File) {
+		return false;
+	}
+	bool Written = std::fwrite(Contents.data(), 1, Contents.size(), File) == Contents.size();
+	return std::fclose(File) == 0 && Written;
+}
+
+SaveStateFile::~SaveStateFile() {
+	Close();
+}
+
+void SaveStateFile::Close() {
+#ifdef M6502_SAVE_STATE_MMAP
+	if (Mapped) {
+		munmap(const_cast<u8*>(Base), Size);
+	}
+#endif
+	Mapped = false;
+	Base = nullptr;
+	Size = 0;
+	Owned.clear();
+	Devices.clear();
+}
+
+bool SaveStateFile::Open(const std::string& Path) {
+	Close();
+#ifdef M6502_SAVE_STATE_MMAP
+	int File = open(Path.c_str(), O_RDONLY);
+	struct stat Status;
+	if (File < 0 || fstat(File, &Status) != 0) {
+		if (File >= 0) {
+			close(File);
+		}
+		Message = "cannot open " + Path;
+		return false;
+	}
+	Size = static_cast<size_t>(Status.st_size);
+	void* Mapping = Size ? mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, File, 0) : MAP_FAILED;
+	close(File);
+	if (Mapping == MAP_FAILED) {
+		Size = 0;
+		Message = "cannot map " + Path;
+		return false;
+	}
+	Base = static_cast<const u8*>(Mapping);
+	Mapped = true;
+	if (!Parse()) {
+		Close();
+		return false;
+	}
+	return true;
+#else
+	std::FILE* File = std::fopen(Path.c_str(), "rb");
+	if (!File) {
+		Message = "cannot open " + Path;
+		return false;
+	}
+	std::vector<u8> Contents;
+	u8 Buffer[65536];
+	for (size_t Read; (Read = std::fread(Buffer, 1, sizeof(Buffer), File)) > 0;) {
+		Contents.insert(Contents.end(), Buffer, Buffer + Read);
+	}
+	std::fclose(File);
+	return Load(std::move(Contents));
+#endif
+}
+
+bool SaveStateFile::Load(std::vector<u8> Contents) {
+	Close();
+	Owned = std::move(Contents);
+	Base = Owned.data();
+	Size = Owned.size();
+	if (!Parse()) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool SaveStateFile::Parse() {
+	if (Size < HeaderSize || std::memcmp(Base, "M65S", 4) != 0) {
+		Message = "not a save-state";
+		return false;
+	}
+	Version = Get16(Base + 4);
+	if (Version > SaveStateVersion) {
+		Message = "save-state version " + std::to_string(Version) + " is newer than " + std::to_string(SaveStateVersion);
+		return false;
+	}
+	MemoryOffset = Get32(Base + 32);
+	u32 DeviceOffset = Get32(Base + 40), Count = Get32(Base + 44);
+	if (Get32(Base + 36) != ImageSize || MemoryOffset > Size || Size - MemoryOffset < ImageSize || DeviceOffset > Size) {
+		Message = "save-state is truncated";
+		return false;
+	}
+	Cycles = Get32(Base + 24) | static_cast<u64>(Get32(Base + 28)) << 32;
+	for (size_t Cursor = DeviceOffset; Count--;) {
+		if (Size - Cursor < 8 || Size - Cursor - 8 < Get32(Base + Cursor + 4)) {
+			Message = "save-state is truncated";
+			return false;
+		}
+		u32 Length = Get32(Base + Cursor + 4);
+		Devices.push_back({ Get32(Base + Cursor), std::vector<u8>(Base + Cursor + 8, Base + Cursor + 8 + Length) });
+		Cursor += 8 + ((Length + size_t{ 3 }) & ~size_t{ 3 });
+		Cursor = std::min(Cursor, Size);
+	}
+	return true;
+}
+
+void SaveStateFile::Restore(NMOS6502& M6502) const {
+	M6502.A = Base[8];
+	M6502.X = Base[9];
+	M6502.Y = Base[10];
+	M6502.ProcessorStatus = UnpackStatus(Base[11]);
+	M6502.SP = Get16(Base + 12);
+	M6502.PC = Get16(Base + 14);
+	M6502.NMIPending = Base[16] & 1;
+	M6502.IRQPending = Base[16] >> 1 & 1;
+	std::memcpy(M6502.Memory.data(), Memory(), ImageSize);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "6502.h"
+
+/*
+	Save-state file, version 1, all fields little-endian:
+
+	  0  "M65S"        magic
+	  4  u16 version   SaveStateVersion
+	  6  u16           header size, 64
+	  8  u8 A, X, Y, P P in the 6502's own layout, NV1BDIZC
+	 12  u16 SP, PC
+	 16  u8 pending    bit 0 NMI, bit 1 IRQ
+	 24  u64 cycles    the caller's cycle clock
+	 32  u32 memory    offset of the 64 KB image, page aligned (4096)
+	 36  u32           memory size, 65536
+	 40  u32 devices   offset of the device chunks, which run to the end of the file
+	 44  u32           device chunk count
+	 48-63             reserved, zero
+
+	Each device chunk is a u32 tag, a u32 length and the data, padded to 4 bytes. Readers skip
+	tags they do not know and reject versions newer than their own. Because the memory image
+	is page aligned, SaveStateFile maps the file copy-on-write instead of reading it.
+*/
+inline constexpr u16 SaveStateVersion = 1;
+
+struct DeviceChunk {
+	u32 Tag; // Four characters, first in the low byte: DeviceTag("VIA1")
+	std::vector<u8> Data;
+};
+
+constexpr u32 DeviceTag(const char (&Name)[5]) {
+	return static_cast<u8>(Name[0]) | static_cast<u8>(Name[1]) << 8 | static_cast<u8>(Name[2]) << 16 | static_cast<u32>(static_cast<u8>(Name[3])) << 24;
+}
+
+/* The core's six flag bits to the 6502's P byte and back */
+u8 PackStatus(const std::bitset<6>& ProcessorStatus);
+std::bitset<6> UnpackStatus(u8 P);
+
+/* Builds a whole file in Out */
+void SaveState(std::vector<u8>& Out, const NMOS6502& M6502, u64 Cycles, const std::vector<DeviceChunk>& Devices = {});
+bool SaveState(const std::string& Path, const NMOS6502& M6502, u64 Cycles, const std::vector<DeviceChunk>& Devices = {});
+
+/*
+	An opened save-state. The file is mapped private and read-only where mmap exists, read into
+	memory elsewhere. Memory() points at the image in the mapping, usable without restoring;
+	Restore copies it and the registers into a core.
+*/
+class SaveStateFile {
+public:
+	SaveStateFile() = default;
+	SaveStateFile(const SaveStateFile&) = delete;
+	SaveStateFile& operator=(const SaveStateFile&) = delete;
+	~SaveStateFile();
+
+	/* False with Error() set when the file is missing, truncated or from a newer version */
+	bool Open(const std::string& Path);
+	/* Checks and adopts an in-memory file */
+	bool Load(std::vector<u8> Contents);
+	void Close();
+
+	u16 Version = 0;
+	u64 Cycles = 0;
+	std::vector<DeviceChunk> Devices;
+	const u8* Memory() const {
+		return Base + MemoryOffset;
+	}
+
+	void Restore(NMOS6502& M6502) const;
+	const std::string& Error() const {
+		return Message;
+	}
+
+private:
+	const u8* Base = nullptr;
+	size_t Size = 0;
+	size_t MemoryOffset = 0;
+	bool Mapped = false;
+	std::vector<u8> Owned;
+	std::string Message;
+
+	bool Parse();
+};
@@ -0,0 +1,377 @@
+#include "single_step.h"
+#include <cctype>
+#include <cstring>
+
+static constexpr size_t ReadSize = 1 << 20;
+
+SingleStepReader::~SingleStepReader() {
+	if (File) {
+		std::fclose(File);
+	}
+}
+
+bool SingleStepReader::Open(const std::string& Path) {
+	if (File) {
+		std::fclose(File);
+	}
+	File = std::fopen(Path.c_str(), "rb");
+	Buffer.resize(ReadSize);
+	Position = Length = 0;
+	Offset = 0;
+	Started = Finished = false;
+	Message.clear();
+	if (!File) {
+		Message = "cannot open " + Path;
+	}
+	return File != nullptr;
+}
+
+void SingleStepReader::OpenText(std::string Text) {
+	if (File) {
+		std::fclose(File);
+		File = nullptr;
+	}
+	Buffer.assign(Text.begin(), Text.end());
+	Position = 0;
+	Length = Buffer.size();
+	Offset = 0;
+	Started = Finished = false;
+	Message.clear();
+}
+
+int SingleStepReader::Peek() {
+	if (Position == Length) {
+		if (!File) {
+			return EOF;
+		}
+		Offset += Length;
+		Length = std::fread(Buffer.data(), 1, Buffer.size(), File);
+		Position = 0;
+		if (Length == 0) {
+			return EOF;
+		}
+	}
+	return static_cast<unsigned char>(Buffer[Position]);
+}
+
+int SingleStepReader::Get() {
+	int Character = Peek();
+	if (Character != EOF) {
+		++Position;
+	}
+	return Character;
+}
+
+void SingleStepReader::Space() {
+	while (std::isspace(Peek())) {
+		++Position;
+	}
+}
+
+bool SingleStepReader::Expect(char Token) {
+	Space();
+	if (Peek() != Token) {
+		return false;
+	}
+	++Position;
+	return true;
+}
+
+bool SingleStepReader::Fail(const char* What) {
+	if (Message.empty()) {
+		Message = std::string(What) + " at offset " + std::to_string(Offset + Position);
+	}
+	Finished = true;
+	return false;
+}
+
+bool SingleStepReader::String(std::string& Value) {
+	if (!Expect('"')) {
+		return false;
+	}
+	Value.clear();
+	for (int Character = Get(); Character != '"'; Character = Get()) {
+		if (Character == EOF) {
+			return false;
+		}
+		if (Character == '\\') {
+			Character = Get();
+			if (Character == EOF) {
+				return false;
+			}
+		}
+		Value += static_cast<char>(Character);
+	}
+	return true;
+}
+
+bool SingleStepReader::Number(u32& Value) {
+	Space();
+	if (!std::isdigit(Peek())) {
+		return false;
+	}
+	Value = 0;
+	while (std::isdigit(Peek())) {
+		Value = Value * 10 + (Get() - '0');
+	}
+	return true;
+}
+
+bool SingleStepReader::Skip() {
+	Space();
+	int Character = Peek();
+	if (Character == '"') {
+		std::string Ignored;
+		return String(Ignored);
+	}
+	if (Character == '[' || Character == '{') {
+		char Close = Character == '[' ? ']' : '}';
+		++Position;
+		if (Expect(Close)) {
+			return true;
+		}
+		do {
+			if (Close == '}') {
+				std::string Key;
+				if (!String(Key) || !Expect(':')) {
+					return false;
+				}
+			}
+			if (!Skip()) {
+				return false;
+			}
+		} while (Expect(','));
+		return Expect(Close);
+	}
+	/* Numbers, true, false and null */
+	bool Any = false;
+	while (std::isalnum(Peek()) || Peek() == '-' || Peek() == '+' || Peek() == '.') {
+		++Position;
+		Any = true;
+	}
+	return Any;
+}
+
+bool SingleStepReader::State(SingleStepState& Out) {
+	Out.RAM.clear();
+	if (!Expect('{')) {
+		return false;
+	}
+	if (Expect('}')) {
+		return true;
+	}
+	do {
+		std::string Key;
+		u32 Value;
+		if (!String(Key) || !Expect(':')) {
+			return false;
+		}
+		if (Key == "ram") {
+			if (!Expect('[')) {
+				return false;
+			}
+			if (!Expect(']')) {
+				do {
+					u32 Address, Byte;
+					if (!Expect('[') || !Number(Address) || !Expect(',') || !Number(Byte) || !Expect(']') || Address > 0xFFFF || Byte > 0xFF) {
+						return false;
+					}
+					Out.RAM.emplace_back(static_cast<u16>(Address), static_cast<u8>(Byte));
+				} while (Expect(','));
+				if (!Expect(']')) {
+					return false;
+				}
+			}
+		}
+		else if (Key == "pc" || Key == "s" || Key == "a" || Key == "x" || Key == "y" || Key == "p") {
+			if (!Number(Value)) {
+				return false;
+			}
+			switch (Key[0]) {
+			case 'p': Key == "pc" ? Out.PC = static_cast<u16>(Value) : Out.P = static_cast<u8>(Value); break;
+			case 's': Out.S = static_cast<u8>(Value); break;
+			case 'a': Out.A = static_cast<u8>(Value); break;
+			case 'x': Out.X = static_cast<u8>(Value); break;
+			case 'y': Out.Y = static_cast<u8>(Value); break;
+			}
+		}
+		else if (!Skip()) {
+			return false;
+		}
+	} while (Expect(','));
+	return Expect('}');
+}
+
+bool SingleStepReader::CycleList(u32& Count) {
+	Count = 0;
+	if (!Expect('[')) {
+		return false;
+	}
+	if (Expect(']')) {
+		return true;
+	}
+	do {
+		if (!Skip()) {
+			return false;
+		}
+		++Count;
+	} while (Expect(','));
+	return Expect(']');
+}
+
+bool SingleStepReader::Next(SingleStepCase& Case) {
+	if (Finished) {
+		return false;
+	}
+	if (!Started) {
+		Started = true;
+		if (!Expect('[')) {
+			return Fail("expected [");
+		}
+		if (Expect(']')) {
+			Finished = true;
+			return false;
+		}
+	}
+	else if (!Expect(',')) {
+		if (Expect(']')) {
+			Finished = true;
+			return false;
+		}
+		return Fail("expected , or ]");
+	}
+
+	Case.Name.clear();
+	Case.Cycles = 0;
+	if (!Expect('{')) {
+		return Fail("expected a test case");
+	}
+	if (!Expect('}')) {
+		do {
+			std::string Key;
+			if (!String(Key) || !Expect(':')) {
+				return Fail("expected a key");
+			}
+			bool Parsed = Key == "name" ? String(Case.Name)
+				: Key == "initial" ? State(Case.Initial)
+				: Key == "final" ? State(Case.Final)
+				: Key == "cycles" ? CycleList(Case.Cycles)
+				: Skip();
+			if (!Parsed) {
+				return Fail(("malformed " + Key).c_str());
+			}
+		} while (Expect(','));
+		if (!Expect('}')) {
+			return Fail("expected }");
+		}
+	}
+	return true;
+}
+
+/* 6502 P layout (NV-BDIZC) to and from the core's six flag bits */
+static std::bitset<6> ToCore(u8 P) {
+	std::bitset<6> Flags;
+	Flags[NMOS6502::N] = (P & 0x80) != 0;
+	Flags[NMOS6502::V] = (P & 0x40) != 0;
+	Flags[NMOS6502::D] = (P & 0x08) != 0;
+	Flags[NMOS6502::I] = (P & 0x04) != 0;
+	Flags[NMOS6502::Z] = (P & 0x02) != 0;
+	Flags[NMOS6502::C] = (P & 0x01) != 0;
+	return Flags;
+}
+
+static u8 FromCore(const std::bitset<6>& Flags) {
+	return (Flags[NMOS6502::N] ? 0x80 : 0) | (Flags[NMOS6502::V] ? 0x40 : 0) | (Flags[NMOS6502::D] ? 0x08 : 0)
+		| (Flags[NMOS6502::I] ? 0x04 : 0) | (Flags[NMOS6502::Z] ? 0x02 : 0) | (Flags[NMOS6502::C] ? 0x01 : 0);
+}
+
+static constexpr u8 KeptFlags = 0xCF;
+
+static int Apply(NMOS6502& M6502, const SingleStepCase& Case) {
+	const SingleStepState& In = Case.Initial;
+	M6502.PC = In.PC;
+	M6502.SP = 0x0100 | In.S;
+	M6502.A = In.A;
+	M6502.X = In.X;
+	M6502.Y = In.Y;
+	M6502.ProcessorStatus = ToCore(In.P);
+	M6502.NMIPending = M6502.IRQPending = false;
+	for (const auto& [Address, Value] : In.RAM) {
+		M6502.Memory[Address] = Value;
+	}
+	return M6502.Execute(0);
+}
+
+static u32 Compare(const NMOS6502& M6502, const SingleStepCase& Case, int Cycles) {
+	const SingleStepState& Out = Case.Final;
+	u32 Mismatch = 0;
+	Mismatch |= (M6502.PC != Out.PC) << StepPC;
+	Mismatch |= (static_cast<u8>(M6502.SP) != Out.S) << StepS;
+	Mismatch |= (M6502.A != Out.A) << StepA;
+	Mismatch |= (M6502.X != Out.X) << StepX;
+	Mismatch |= (M6502.Y != Out.Y) << StepY;
+	Mismatch |= (FromCore(M6502.ProcessorStatus) != (Out.P & KeptFlags)) << StepP;
+	for (const auto& [Address, Value] : Out.RAM) {
+		if (M6502.Memory[Address] != Value) {
+			Mismatch |= 1 << StepRAM;
+			break;
+		}
+	}
+	Mismatch |= (static_cast<u32>(Cycles) != Case.Cycles) << StepCycles;
+	return Mismatch;
+}
+
+static void Clear(NMOS6502& M6502, const SingleStepCase& Case) {
+	for (const auto& Entry : Case.Initial.RAM) {
+		M6502.Memory[Entry.first] = 0;
+	}
+	for (const auto& Entry : Case.Final.RAM) {
+		M6502.Memory[Entry.first] = 0;
+	}
+}
+
+u32 RunSingleStep(NMOS6502& M6502, const SingleStepCase& Case) {
+	int Cycles = Apply(M6502, Case);
+	u32 Mismatch = Compare(M6502, Case, Cycles);
+	if (Mismatch) { // It may have written somewhere the case does not list
+		std::memset(M6502.Memory.data(), 0, M6502.Memory.size());
+	}
+	else {
+		Clear(M6502, Case);
+	}
+	return Mismatch;
+}
+
+std::string DescribeSingleStep(NMOS6502& M6502, const SingleStepCase& Case, u32 Mismatch) {
+	int Cycles = Apply(M6502, Case);
+	const SingleStepState& Out = Case.Final;
+	std::string Text;
+	char Part[64];
+	auto Add = [&](SingleStepField Field, unsigned Expected, unsigned Actual, int Digits) {
+		if (Mismatch & (1 << Field)) {
+			std::snprintf(Part, sizeof(Part), "%s%s %0*X != %0*X", Text.empty() ? "" : ", ", SingleStepFieldNames[Field], Digits, Actual, Digits, Expected);
+			Text += Part;
+		}
+	};
+	Add(StepPC, Out.PC, M6502.PC, 4);
+	Add(StepS, Out.S, static_cast<u8>(M6502.SP), 2);
+	Add(StepA, Out.A, M6502.A, 2);
+	Add(StepX, Out.X, M6502.X, 2);
+	Add(StepY, Out.Y, M6502.Y, 2);
+	Add(StepP, Out.P & KeptFlags, FromCore(M6502.ProcessorStatus), 2);
+	if (Mismatch & (1 << StepRAM)) {
+		for (const auto& [Address, Value] : Out.RAM) {
+			if (M6502.Memory[Address] != Value) {
+				std::snprintf(Part, sizeof(Part), "%sram[%04X] %02X != %02X", Text.empty() ? "" : ", ", Address, M6502.Memory[Address], Value);
+				Text += Part;
+				break;
+			}
+		}
+	}
+	if (Mismatch & (1 << StepCycles)) {
+		std::snprintf(Part, sizeof(Part), "%scycles %d != %u", Text.empty() ? "" : ", ", Cycles, Case.Cycles);
+		Text += Part;
+	}
+	std::memset(M6502.Memory.data(), 0, M6502.Memory.size());
+	return Text;
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include "6502.h"
+
+/*
+	SingleStepTests/ProcessorTests style vectors: one JSON file per opcode holding an array of
+	{ "name", "initial": { pc, s, a, x, y, p, ram: [[address, value], ...] }, "final": { ... },
+	"cycles": [[address, value, "read"|"write"], ...] }. The reader pulls one case at a time
+	from a buffered file, so a corpus of any size is never held in memory.
+*/
+struct SingleStepState {
+	u16 PC = 0;
+	u8 S = 0, A = 0, X = 0, Y = 0, P = 0;
+	std::vector<std::pair<u16, u8>> RAM;
+};
+
+struct SingleStepCase {
+	std::string Name;
+	SingleStepState Initial, Final;
+	u32 Cycles = 0; // Bus cycles listed for the instruction
+};
+
+enum SingleStepField { StepPC, StepS, StepA, StepX, StepY, StepP, StepRAM, StepCycles, SingleStepFieldCount };
+inline constexpr const char* SingleStepFieldNames[SingleStepFieldCount] = { "pc", "s", "a", "x", "y", "p", "ram", "cycles" };
+
+class SingleStepReader {
+public:
+	SingleStepReader() = default;
+	~SingleStepReader();
+	SingleStepReader(const SingleStepReader&) = delete;
+	SingleStepReader& operator=(const SingleStepReader&) = delete;
+
+	bool Open(const std::string& Path);
+	/* Parses text already in memory instead of a file */
+	void OpenText(std::string Text);
+	/* False at the end of the array or on malformed input; Error() tells them apart */
+	bool Next(SingleStepCase& Case);
+	const std::string& Error() const {
+		return Message;
+	}
+
+private:
+	std::FILE* File = nullptr;
+	std::vector<char> Buffer;
+	size_t Position = 0, Length = 0;
+	u64 Offset = 0; // Of Buffer[0] in the input, for error messages
+	bool Started = false, Finished = false;
+	std::string Message;
+
+	int Peek();
+	int Get();
+	void Space();
+	bool Expect(char Token);
+	bool Fail(const char* What);
+	bool String(std::string& Value);
+	bool Number(u32& Value);
+	bool Skip();
+	bool State(SingleStepState& Out);
+	bool CycleList(u32& Count);
+};
+
+/*
+	Loads the initial state into M6502, runs one instruction and returns a bit per
+	SingleStepField that does not match the final state. Memory touched by the case
+	is cleared again afterwards, so one core can run any number of cases.
+	P is compared on N, V, D, I, Z and C only, the bits this core keeps.
+*/
+u32 RunSingleStep(NMOS6502& M6502, const SingleStepCase& Case);
+/* "pc 1234 != 1236, a 00 != 01, ..." for the fields in Mismatch */
+std::string DescribeSingleStep(NMOS6502& M6502, const SingleStepCase& Case, u32 Mismatch);
@@ -0,0 +1,38 @@
+#include "snapshot.h"
+#include <cstring>
+
+void MachineSnapshot::Capture(const NMOS6502& M6502) {
+	Memory = M6502.Memory;
+	A = M6502.A;
+	X = M6502.X;
+	Y = M6502.Y;
+	SP = M6502.SP;
+	PC = M6502.PC;
+	ProcessorStatus = M6502.ProcessorStatus;
+	NMIPending = M6502.NMIPending;
+	IRQPending = M6502.IRQPending;
+}
+
+void MachineSnapshot::RestoreRegisters(NMOS6502& M6502) const {
+	M6502.A = A;
+	M6502.X = X;
+	M6502.Y = Y;
+	M6502.SP = SP;
+	M6502.PC = PC;
+	M6502.ProcessorStatus = ProcessorStatus;
+	M6502.NMIPending = NMIPending;
+	M6502.IRQPending = IRQPending;
+}
+
+void MachineSnapshot::Restore(NMOS6502& M6502, DirtyPageMap& Dirty) const {
+	RestoreRegisters(M6502);
+	Dirty.ForEach([&](u8 Page) {
+		std::memcpy(&M6502.Memory[Page << 8], &Memory[Page << 8], 0x100);
+	});
+	Dirty.Clear();
+}
+
+void MachineSnapshot::RestoreAll(NMOS6502& M6502) const {
+	RestoreRegisters(M6502);
+	std::memcpy(M6502.Memory.data(), Memory.data(), Memory.size());
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <bitset>
+#include <vector>
+#include "6502.h"
+#include "dirty_pages.h"
+
+/*
+	Registers and memory of an NMOS6502 at one point. Restore with the core's DirtyPageMap to
+	copy back only the pages written since the capture (or since the last restore), which makes
+	resetting a machine for the next run cost a few pages instead of 64 KB.
+*/
+class MachineSnapshot {
+public:
+	std::vector<u8> Memory;
+	u8 A = 0, X = 0, Y = 0;
+	u16 SP = 0, PC = 0;
+	std::bitset<6> ProcessorStatus;
+	bool NMIPending = false, IRQPending = false;
+
+	void Capture(const NMOS6502& M6502);
+	/* Restores registers and every page marked in Dirty, then clears Dirty */
+	void Restore(NMOS6502& M6502, DirtyPageMap& Dirty) const;
+	/* Restores all of memory, for when writes were not tracked */
+	void RestoreAll(NMOS6502& M6502) const;
+
+private:
+	void RestoreRegisters(NMOS6502& M6502) const;
+};
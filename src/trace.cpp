@@ -0,0 +1,463 @@
+#include "trace.h"
+#include "compression.h"
+#include <algorithm>
+#include <cstring>
+#include "disassembler.h"
+
+u64 TraceHash(const u8* Bytes, size_t Size) {
+	u64 Hash = 0xCBF29CE484222325ull;
+	for (size_t i = 0; i < Size; ++i) {
+		Hash = (Hash ^ Bytes[i]) * 0x100000001B3ull;
+	}
+	return Hash;
+}
+
+static void Put32(u8* Out, u32 Value) {
+	for (int i = 0; i < 4; ++i) {
+		Out[i] = static_cast<u8>(Value >> (8 * i));
+	}
+}
+
+static u32 Get32(const u8* In) {
+	return In[0] | In[1] << 8 | In[2] << 16 | static_cast<u32>(In[3]) << 24;
+}
+
+TraceWriter::TraceWriter() {}
+
+TraceWriter::~TraceWriter() {
+	Close();
+}
+
+bool TraceWriter::Open(const std::string& Path, u32 RecordsPerBlock, u32 Slots) {
+	Close();
+	if (RecordsPerBlock == 0 || RecordsPerBlock > TraceMaxBlockRecords || Slots < 2) {
+		return false;
+	}
+	File = std::fopen(Path.c_str(), "wb");
+	if (!File) {
+		return false;
+	}
+	u8 Header[TraceFileHeaderSize];
+	std::memcpy(Header, TraceMagic, sizeof(TraceMagic));
+	Put32(Header + 8, TraceVersion);
+	Put32(Header + 12, RecordsPerBlock);
+	std::fwrite(Header, 1, sizeof(Header), File);
+	BytesWritten = sizeof(Header);
+
+	this->RecordsPerBlock = RecordsPerBlock;
+	Ring = std::vector<Slot>(Slots);
+	for (Slot& Entry : Ring) {
+		Entry.Bytes = std::vector<u8>(static_cast<size_t>(RecordsPerBlock) * TraceMaxRecordSize);
+	}
+	Compressed = std::vector<u8>(static_cast<size_t>(RecordsPerBlock) * TraceMaxRecordSize);
+	Head = 0;
+	Tail = 0;
+	Wake = 0;
+	Closing = false;
+	BlockRecords = 0;
+	Cursor = Ring[0].Bytes.data();
+	Clock = 0;
+	Records = 0;
+	Stalls = 0;
+	Writer = std::thread(&TraceWriter::Drain, this);
+	return true;
+}
+
+void TraceWriter::Publish() {
+	u32 Index = Head.load(std::memory_order_relaxed);
+	Slot& Block = Ring[Index % Ring.size()];
+	Block.Records = BlockRecords;
+	Block.Size = static_cast<u32>(Cursor - Block.Bytes.data());
+	Head.store(Index + 1, std::memory_order_release);
+	Wake.fetch_add(1, std::memory_order_release);
+	Wake.notify_one();
+
+	/* Wait for the writer to free the next slot if the ring is full */
+	u32 Drained = Tail.load(std::memory_order_acquire);
+	if (Index + 1 - Drained == Ring.size()) {
+		++Stalls;
+		do {
+			Tail.wait(Drained, std::memory_order_acquire);
+			Drained = Tail.load(std::memory_order_acquire);
+		} while (Index + 1 - Drained == Ring.size());
+	}
+	BlockRecords = 0;
+	Cursor = Ring[(Index + 1) % Ring.size()].Bytes.data();
+}
+
+void TraceWriter::Drain() {
+	for (;;) {
+		u32 Seen = Wake.load(std::memory_order_acquire);
+		u32 Index = Tail.load(std::memory_order_relaxed);
+		if (Index == Head.load(std::memory_order_acquire)) {
+			if (Closing.load(std::memory_order_acquire)) {
+				return;
+			}
+			Wake.wait(Seen, std::memory_order_acquire);
+			continue;
+		}
+		WriteBlock(Ring[Index % Ring.size()]);
+		Tail.store(Index + 1, std::memory_order_release);
+		Tail.notify_one();
+	}
+}
+
+bool TraceWriter::WriteBlock(const Slot& Block) {
+	size_t Stored = CompressBlock(Block.Bytes.data(), Block.Size, Compressed.data(), Block.Size);
+	const u8* Payload = Compressed.data();
+	if (Stored == 0 || Stored >= Block.Size) {
+		Stored = Block.Size;
+		Payload = Block.Bytes.data();
+	}
+	u8 Header[TraceBlockHeaderSize];
+	u64 Hash = TraceHash(Block.Bytes.data(), Block.Size);
+	Put32(Header, Block.Records);
+	Put32(Header + 4, Block.Size);
+	Put32(Header + 8, static_cast<u32>(Stored));
+	Put32(Header + 12, static_cast<u32>(Hash));
+	Put32(Header + 16, static_cast<u32>(Hash >> 32));
+	bool Written = std::fwrite(Header, 1, sizeof(Header), File) == sizeof(Header)
+		&& std::fwrite(Payload, 1, Stored, File) == Stored;
+	BytesWritten += sizeof(Header) + Stored;
+	return Written;
+}
+
+void TraceWriter::Close() {
+	if (!File) {
+		return;
+	}
+	if (BlockRecords != 0) {
+		Publish();
+	}
+	Closing.store(true, std::memory_order_release);
+	Wake.fetch_add(1, std::memory_order_release);
+	Wake.notify_one();
+	Writer.join();
+	std::fclose(File);
+	File = nullptr;
+	Ring.clear();
+	Cursor = nullptr;
+}
+
+TraceReader::~TraceReader() {
+	Close();
+}
+
+bool TraceReader::Open(const std::string& Path) {
+	Close();
+	File = std::fopen(Path.c_str(), "rb");
+	if (!File) {
+		Error = "cannot open " + Path;
+		return false;
+	}
+	u8 Header[TraceFileHeaderSize];
+	if (std::fread(Header, 1, sizeof(Header), File) != sizeof(Header) || std::memcmp(Header, TraceMagic, sizeof(TraceMagic)) != 0) {
+		Error = Path + " is not a trace file";
+		Close();
+		return false;
+	}
+	if (Get32(Header + 8) != TraceVersion) {
+		Error = Path + " has an unsupported trace version";
+		Close();
+		return false;
+	}
+	RecordsPerBlock = Get32(Header + 12);
+	if (RecordsPerBlock == 0 || RecordsPerBlock > TraceMaxBlockRecords) {
+		Error = Path + " has a corrupt file header";
+		Close();
+		return false;
+	}
+	std::fseek(File, 0, SEEK_END);
+	FileSize = std::ftell(File);
+	std::fseek(File, TraceFileHeaderSize, SEEK_SET);
+	Pending.clear();
+	PendingIndex = 0;
+	return true;
+}
+
+void TraceReader::Close() {
+	if (File) {
+		std::fclose(File);
+		File = nullptr;
+	}
+}
+
+bool TraceReader::ReadHeader(Block& Header) {
+	u8 Bytes[TraceBlockHeaderSize];
+	size_t Read = std::fread(Bytes, 1, sizeof(Bytes), File);
+	if (Read != sizeof(Bytes)) {
+		if (Read != 0) {
+			Error = "truncated block header";
+		}
+		return false;
+	}
+	Header.Records = Get32(Bytes);
+	Header.RawSize = Get32(Bytes + 4);
+	Header.StoredSize = Get32(Bytes + 8);
+	Header.Hash = Get32(Bytes + 12) | static_cast<u64>(Get32(Bytes + 16)) << 32;
+	Header.Offset = std::ftell(File);
+	/* Sizes are checked against the file and the block size before anything is allocated for them */
+	if (Header.Records > RecordsPerBlock || Header.StoredSize > FileSize - Header.Offset || Header.StoredSize > Header.RawSize ||
+		Header.RawSize > static_cast<u64>(Header.Records) * TraceMaxRecordSize || Header.RawSize < static_cast<u64>(Header.Records) * TraceMinRecordSize) {
+		Error = "corrupt block header";
+		return false;
+	}
+	return true;
+}
+
+bool TraceReader::NextBlock(Block& Header) {
+	if (!File || !ReadHeader(Header)) {
+		return false;
+	}
+	return std::fseek(File, Header.StoredSize, SEEK_CUR) == 0;
+}
+
+bool TraceReader::ReadBlock(Block& Header, std::vector<TraceRecord>& Out) {
+	return File && ReadHeader(Header) && ReadPayload(Header, Out);
+}
+
+bool TraceReader::Load(const Block& Header, std::vector<TraceRecord>& Out) {
+	if (!File || std::fseek(File, Header.Offset, SEEK_SET) != 0) {
+		return false;
+	}
+	return ReadPayload(Header, Out);
+}
+
+bool TraceReader::ReadPayload(const Block& Header, std::vector<TraceRecord>& Out) {
+	Stored.resize(Header.StoredSize);
+	if (std::fread(Stored.data(), 1, Stored.size(), File) != Stored.size()) {
+		Error = "truncated block";
+		return false;
+	}
+	if (Header.StoredSize == Header.RawSize) {
+		Raw.swap(Stored);
+	}
+	else {
+		Raw.resize(Header.RawSize);
+		if (!DecompressBlock(Stored.data(), Stored.size(), Raw.data(), Raw.size())) {
+			Error = "corrupt compressed block";
+			return false;
+		}
+	}
+	if (TraceHash(Raw.data(), Header.RawSize) != Header.Hash) {
+		Error = "block hash mismatch";
+		return false;
+	}
+	return Decode(Header, Out);
+}
+
+bool TraceReader::Decode(const Block& Header, std::vector<TraceRecord>& Out) {
+	Out.resize(Header.Records);
+	const u8* In = Raw.data();
+	const u8* End = In + Header.RawSize;
+	TraceRecord Previous{};
+	u16 Expected = 0;
+	for (u32 Index = 0; Index < Header.Records; ++Index) {
+		TraceRecord& Record = Out[Index];
+		if (End - In < 3) {
+			Error = "corrupt record";
+			return false;
+		}
+		u8 Flags = *In++;
+		Record.Opcode = *In++;
+		u64 Cycle = 0;
+		int Shift = 0;
+		u8 Byte;
+		do {
+			if (In == End || Shift > 63) {
+				Error = "corrupt record";
+				return false;
+			}
+			Byte = *In++;
+			Cycle |= static_cast<u64>(Byte & 0x7F) << Shift;
+			Shift += 7;
+		} while (Byte & 0x80);
+		if ((Index == 0) != ((Flags & TraceFirst) != 0)) {
+			Error = "corrupt record";
+			return false;
+		}
+		u8 Length = InstructionLength(Record.Opcode);
+		size_t Needed = (Flags & TracePC ? 2 : 0) + (Flags & TraceA ? 1 : 0) + (Flags & TraceX ? 1 : 0) + (Flags & TraceY ? 1 : 0)
+			+ (Flags & TraceSP ? 2 : 0) + (Flags & TraceP ? 1 : 0) + Length - 1;
+		if (static_cast<size_t>(End - In) < Needed) {
+			Error = "corrupt record";
+			return false;
+		}
+		Record.Cycle = Flags & TraceFirst ? Cycle : Previous.Cycle + Cycle;
+		Record.PC = Expected;
+		if (Flags & TracePC) {
+			Record.PC = static_cast<u16>(In[0] | In[1] << 8);
+			In += 2;
+		}
+		Record.A = Flags & TraceA ? *In++ : Previous.A;
+		Record.X = Flags & TraceX ? *In++ : Previous.X;
+		Record.Y = Flags & TraceY ? *In++ : Previous.Y;
+		Record.SP = Previous.SP;
+		if (Flags & TraceSP) {
+			Record.SP = static_cast<u16>(In[0] | In[1] << 8);
+			In += 2;
+		}
+		Record.P = Flags & TraceP ? *In++ : Previous.P;
+		Record.Operands[0] = Length > 1 ? *In++ : 0;
+		Record.Operands[1] = Length > 2 ? *In++ : 0;
+		Expected = static_cast<u16>(Record.PC + Length);
+		Previous = Record;
+	}
+	if (In != End) {
+		Error = "corrupt record";
+		return false;
+	}
+	return true;
+}
+
+bool TraceReader::Next(TraceRecord& Out) {
+	while (PendingIndex == Pending.size()) {
+		Block Header;
+		if (!ReadBlock(Header, Pending)) {
+			return false;
+		}
+		PendingIndex = 0;
+	}
+	Out = Pending[PendingIndex++];
+	return true;
+}
+
+std::string FormatTraceRecord(const TraceRecord& Record) {
+	u8 Recorded[3] = { Record.Opcode, Record.Operands[0], Record.Operands[1] };
+	u8 Length = InstructionLength(Record.Opcode);
+	char Hex[12] = "";
+	for (u8 i = 0; i < Length; ++i) {
+		std::snprintf(Hex + i * 3, sizeof(Hex) - i * 3, "%02X ", Recorded[i]);
+	}
+	u8 Bytes[4] = { Record.Opcode };
+	Bytes[OperandOffset(Record.Opcode)] = Record.Operands[0];
+	Bytes[OperandOffset(Record.Opcode) + 1] = Record.Operands[1];
+	char Text[DisassemblyBufferSize];
+	DisassembleInto(Bytes, Record.PC, Text);
+	char Line[96];
+	std::snprintf(Line, sizeof(Line), "%12llu  %04X  %-9s %-14s A:%02X X:%02X Y:%02X P:%02X SP:%04X",
+		static_cast<unsigned long long>(Record.Cycle), Record.PC, Hex, Text,
+		Record.A, Record.X, Record.Y, Record.P, Record.SP);
+	return Line;
+}
+
+/* Appends up to Count records that follow the current position of Reader */
+static bool ReadAhead(TraceReader& Reader, u32 Count, std::vector<TraceRecord>& Out) {
+	TraceRecord Record;
+	while (Count-- != 0 && Reader.Next(Record)) {
+		Out.push_back(Record);
+	}
+	return Reader.Error.empty();
+}
+
+static bool FindDivergenceByRecord(TraceReader& Left, TraceReader& Right, u32 Context, TraceDivergence& Out) {
+	std::vector<TraceRecord> History; // The last Context matching records, as a ring
+	TraceRecord L, R;
+	for (;;) {
+		bool HasLeft = Left.Next(L), HasRight = Right.Next(R);
+		if (!Left.Error.empty() || !Right.Error.empty()) {
+			return false;
+		}
+		if (!HasLeft && !HasRight) {
+			return true;
+		}
+		if (HasLeft && HasRight && L == R) {
+			if (Context != 0) {
+				if (History.size() < Context) {
+					History.push_back(L);
+				}
+				else {
+					History[Out.Index % Context] = L;
+				}
+			}
+			++Out.Index;
+			continue;
+		}
+		Out.Differs = true;
+		Out.First = Out.Index - History.size();
+		if (History.size() == Context && Context != 0) {
+			std::rotate(History.begin(), History.begin() + Out.Index % Context, History.end());
+		}
+		Out.Left = History;
+		Out.Right = History;
+		if (HasLeft) {
+			Out.Left.push_back(L);
+		}
+		if (HasRight) {
+			Out.Right.push_back(R);
+		}
+		return ReadAhead(Left, Context, Out.Left) && ReadAhead(Right, Context, Out.Right);
+	}
+}
+
+bool FindDivergence(TraceReader& Left, TraceReader& Right, u32 Context, TraceDivergence& Out) {
+	Out = TraceDivergence{};
+	if (Left.RecordsPerBlock != Right.RecordsPerBlock) {
+		return FindDivergenceByRecord(Left, Right, Context, Out);
+	}
+
+	TraceReader::Block LeftHeader, RightHeader, Previous{};
+	bool HasPrevious = false;
+	std::vector<TraceRecord> LeftRecords, RightRecords;
+	for (;;) {
+		bool HasLeft = Left.NextBlock(LeftHeader), HasRight = Right.NextBlock(RightHeader);
+		if (!Left.Error.empty() || !Right.Error.empty()) {
+			return false;
+		}
+		if (!HasLeft && !HasRight) {
+			return true;
+		}
+		if (HasLeft && HasRight && LeftHeader.Records == RightHeader.Records && LeftHeader.RawSize == RightHeader.RawSize
+			&& LeftHeader.Hash == RightHeader.Hash) {
+			Out.Index += LeftHeader.Records;
+			++Out.SkippedBlocks;
+			Previous = LeftHeader;
+			HasPrevious = true;
+			continue;
+		}
+
+		LeftRecords.clear();
+		RightRecords.clear();
+		if ((HasLeft && !Left.Load(LeftHeader, LeftRecords)) || (HasRight && !Right.Load(RightHeader, RightRecords))) {
+			return false;
+		}
+		++Out.DecodedBlocks;
+		size_t Match = 0;
+		while (Match < LeftRecords.size() && Match < RightRecords.size() && LeftRecords[Match] == RightRecords[Match]) {
+			++Match;
+		}
+		if (Match == LeftRecords.size() && Match == RightRecords.size()) {
+			Out.Index += Match;
+			Previous = LeftHeader;
+			HasPrevious = true;
+			continue;
+		}
+
+		/* Context after the divergence, continuing into the following block where needed */
+		Out.Differs = true;
+		Out.Index += Match;
+		size_t Before = std::min<size_t>(Match, Context);
+		Out.First = Out.Index - Before;
+		Out.Left.assign(LeftRecords.begin() + (Match - Before), LeftRecords.begin() + std::min(LeftRecords.size(), Match + Context + 1));
+		Out.Right.assign(RightRecords.begin() + (Match - Before), RightRecords.begin() + std::min(RightRecords.size(), Match + Context + 1));
+		size_t Wanted = Before + Context + 1;
+		if (HasLeft && Out.Left.size() < Wanted && !ReadAhead(Left, static_cast<u32>(Wanted - Out.Left.size()), Out.Left)) {
+			return false;
+		}
+		if (HasRight && Out.Right.size() < Wanted && !ReadAhead(Right, static_cast<u32>(Wanted - Out.Right.size()), Out.Right)) {
+			return false;
+		}
+
+		/* Context before it from the last matching block, which is the same on both sides */
+		if (Before < Context && HasPrevious) {
+			if (!Left.Load(Previous, LeftRecords)) {
+				return false;
+			}
+			size_t Extra = std::min<size_t>(Context - Before, LeftRecords.size());
+			Out.Left.insert(Out.Left.begin(), LeftRecords.end() - Extra, LeftRecords.end());
+			Out.Right.insert(Out.Right.begin(), LeftRecords.end() - Extra, LeftRecords.end());
+			Out.First -= Extra;
+		}
+		return true;
+	}
+}
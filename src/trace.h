@@ -0,0 +1,216 @@
+#pragma once
+#include <atomic>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "6502.h"
+#include "opcodes.h"
+
+/*
+	Binary execution trace. Each record holds the machine state before an instruction executes.
+
+	File layout (all fields little-endian):
+		header: "M6502TRC", u32 version, u32 records per block
+		block:  u32 records, u32 raw size, u32 stored size, u64 FNV-1a hash of the raw bytes, payload
+	A payload is stored raw when stored size == raw size, otherwise it is CompressBlock output.
+
+	Records are delta-encoded against the previous record of the same block, so every block
+	decodes on its own and two runs produce byte-identical blocks until they diverge:
+		u8 flags, u8 opcode, varint cycle (absolute on the first record, else delta),
+		then the fields flagged as changed: u16 PC, u8 A, u8 X, u8 Y, u16 SP, u8 P,
+		then the operand bytes of the opcode, for JSR the target bytes after its BIT opcode
+		(OperandOffset). PC is only stored when it is not the address following the previous
+		instruction.
+*/
+
+struct TraceRecord {
+	u64 Cycle;
+	u16 PC;
+	u16 SP;
+	u8 Opcode;
+	u8 Operands[2];
+	u8 A, X, Y, P;
+
+	bool operator==(const TraceRecord& Other) const = default;
+};
+
+enum TraceFlags : u8 {
+	TracePC = 1 << 0,
+	TraceA = 1 << 1,
+	TraceX = 1 << 2,
+	TraceY = 1 << 3,
+	TraceSP = 1 << 4,
+	TraceP = 1 << 5,
+	TraceFirst = 1 << 7 // First record of a block, cycle is absolute
+};
+
+constexpr char TraceMagic[8] = { 'M', '6', '5', '0', '2', 'T', 'R', 'C' };
+constexpr u32 TraceVersion = 1;
+constexpr size_t TraceFileHeaderSize = 16;
+constexpr size_t TraceBlockHeaderSize = 20;
+constexpr size_t TraceMaxRecordSize = 24;
+constexpr size_t TraceMinRecordSize = 3; // Flags, opcode and a one-byte cycle delta
+constexpr u32 TraceMaxBlockRecords = 1 << 20;
+
+u64 TraceHash(const u8* Bytes, size_t Size);
+
+/*
+	Records a trace from the emulation thread without touching the file system there. Records are
+	encoded into a block of a fixed-size ring; full blocks are handed to a writer thread, which
+	compresses and writes them. The emulation thread only waits when the ring is full (counted in Stalls).
+*/
+class TraceWriter {
+public:
+	TraceWriter();
+	~TraceWriter();
+
+	bool Open(const std::string& Path, u32 RecordsPerBlock = 4096, u32 Slots = 64);
+	void Close();
+	bool IsOpen() const { return File != nullptr; }
+
+	u64 Clock = 0; // Cycle count at the start of the next instruction
+	u64 Records = 0;
+	u64 Stalls = 0;
+	std::atomic<u64> BytesWritten = 0;
+
+	void Record(const NMOS6502& M6502) {
+		if (BlockRecords == RecordsPerBlock) {
+			Publish();
+		}
+		u8* Out = Cursor;
+		u8 Opcode = M6502.Memory[M6502.PC];
+		u8 P = static_cast<u8>(M6502.ProcessorStatus.to_ulong());
+		u8 Flags = 0;
+		u64 Cycle = Clock;
+		if (BlockRecords == 0) {
+			Flags = TraceFirst | TracePC | TraceA | TraceX | TraceY | TraceSP | TraceP;
+		}
+		else {
+			Flags |= M6502.PC != Expected ? TracePC : 0;
+			Flags |= M6502.A != Previous.A ? TraceA : 0;
+			Flags |= M6502.X != Previous.X ? TraceX : 0;
+			Flags |= M6502.Y != Previous.Y ? TraceY : 0;
+			Flags |= M6502.SP != Previous.SP ? TraceSP : 0;
+			Flags |= P != Previous.P ? TraceP : 0;
+			Cycle -= Previous.Cycle;
+		}
+		*Out++ = Flags;
+		*Out++ = Opcode;
+		while (Cycle >= 0x80) {
+			*Out++ = static_cast<u8>(Cycle | 0x80);
+			Cycle >>= 7;
+		}
+		*Out++ = static_cast<u8>(Cycle);
+		if (Flags & TracePC) {
+			*Out++ = static_cast<u8>(M6502.PC);
+			*Out++ = static_cast<u8>(M6502.PC >> 8);
+		}
+		if (Flags & TraceA) *Out++ = M6502.A;
+		if (Flags & TraceX) *Out++ = M6502.X;
+		if (Flags & TraceY) *Out++ = M6502.Y;
+		if (Flags & TraceSP) {
+			*Out++ = static_cast<u8>(M6502.SP);
+			*Out++ = static_cast<u8>(M6502.SP >> 8);
+		}
+		if (Flags & TraceP) *Out++ = P;
+		u8 Length = InstructionLength(Opcode);
+		u8 Offset = OperandOffset(Opcode);
+		for (u8 i = 0; i + 1 < Length; ++i) {
+			*Out++ = M6502.Memory[static_cast<u16>(M6502.PC + Offset + i)];
+		}
+		Cursor = Out;
+		Expected = static_cast<u16>(M6502.PC + Length);
+		Previous = TraceRecord{ Clock, M6502.PC, M6502.SP, Opcode, { 0, 0 }, M6502.A, M6502.X, M6502.Y, P };
+		++BlockRecords;
+		++Records;
+	}
+
+	void Advance(u32 Cycles) {
+		Clock += Cycles;
+	}
+
+private:
+	struct Slot {
+		std::vector<u8> Bytes;
+		u32 Records;
+		u32 Size;
+	};
+
+	void Publish();
+	void Drain();
+	bool WriteBlock(const Slot& Block);
+
+	std::FILE* File = nullptr;
+	std::thread Writer;
+	std::vector<Slot> Ring;
+	std::atomic<u32> Head = 0; // Next slot the emulation thread fills
+	std::atomic<u32> Tail = 0; // Next slot the writer thread drains
+	std::atomic<u32> Wake = 0; // Bumped whenever the writer thread has something to do
+	std::atomic<bool> Closing = false;
+	std::vector<u8> Compressed;
+
+	u32 RecordsPerBlock = 0;
+	u32 BlockRecords = 0;
+	u8* Cursor = nullptr;
+	u16 Expected = 0;
+	TraceRecord Previous{};
+};
+
+/* Sequential reader for trace files, block by block or record by record */
+class TraceReader {
+public:
+	struct Block {
+		u32 Records;
+		u32 RawSize;
+		u32 StoredSize;
+		u64 Hash;
+		long Offset; // File offset of the payload
+	};
+
+	~TraceReader();
+	bool Open(const std::string& Path);
+	void Close();
+
+	/* Reads the next block header and skips its payload */
+	bool NextBlock(Block& Header);
+	/* Reads the next block and decodes its records */
+	bool ReadBlock(Block& Header, std::vector<TraceRecord>& Out);
+	/* Decodes a block returned earlier by NextBlock, reading continues after it */
+	bool Load(const Block& Header, std::vector<TraceRecord>& Out);
+	bool Next(TraceRecord& Out);
+
+	u32 RecordsPerBlock = 0;
+	std::string Error;
+
+private:
+	bool ReadHeader(Block& Header);
+	bool ReadPayload(const Block& Header, std::vector<TraceRecord>& Out);
+	bool Decode(const Block& Header, std::vector<TraceRecord>& Out);
+
+	std::FILE* File = nullptr;
+	long FileSize = 0;
+	std::vector<u8> Stored;
+	std::vector<u8> Raw;
+	std::vector<TraceRecord> Pending;
+	size_t PendingIndex = 0;
+};
+
+/* One line per record: cycle, address, bytes, disassembly and registers */
+std::string FormatTraceRecord(const TraceRecord& Record);
+
+struct TraceDivergence {
+	bool Differs = false;
+	u64 Index = 0; // First differing record, or the number of records when the traces match
+	u64 First = 0; // Record index of Left[0] and Right[0]
+	std::vector<TraceRecord> Left, Right; // Context around Index, cut short where a trace ends
+	u64 SkippedBlocks = 0; // Blocks passed over on equal hashes
+	u64 DecodedBlocks = 0;
+};
+
+/*
+	Streams two traces from their current position and finds the first record where they differ.
+	Blocks with equal headers and hashes are skipped without decompressing them; traces written
+	with different block sizes are compared record by record. Returns false on a read error.
+*/
+bool FindDivergence(TraceReader& Left, TraceReader& Right, u32 Context, TraceDivergence& Out);
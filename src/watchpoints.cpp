@@ -0,0 +1,76 @@
+#include "watchpoints.h"
+#include <algorithm>
+
+WatchpointMap::WatchpointMap() : Kinds(0x10000, 0) {}
+
+void WatchpointMap::Summarise(uint8_t Page) {
+	uint8_t Summary = 0;
+	for (int Offset = 0; Offset < 0x100; ++Offset) {
+		Summary |= Kinds[Page << 8 | Offset];
+	}
+	Pages[Page] = Summary;
+}
+
+void WatchpointMap::Add(uint16_t Address, WatchKind Kind, uint32_t Length) {
+	Length = std::min<uint32_t>(Length, 0x10000 - Address);
+	for (uint32_t i = 0; i < Length; ++i) {
+		Kinds[Address + i] |= Kind;
+		Pages[(Address + i) >> 8] |= Kind;
+	}
+}
+
+void WatchpointMap::Remove(uint16_t Address, WatchKind Kind, uint32_t Length) {
+	Length = std::min<uint32_t>(Length, 0x10000 - Address); // Address + Length - 1 must not wrap
+	for (uint32_t i = 0; i < Length; ++i) {
+		Kinds[Address + i] &= ~Kind;
+	}
+	for (uint32_t Page = Address >> 8; Length && Page <= (Address + Length - 1) >> 8; ++Page) {
+		Summarise(static_cast<uint8_t>(Page));
+	}
+}
+
+void WatchpointMap::ClearAll() {
+	std::fill(Kinds.begin(), Kinds.end(), 0);
+	std::fill(std::begin(Pages), std::end(Pages), 0);
+}
+
+void WatchpointMap::Record(const WatchHit& Hit) {
+	if (Hits.size() == MaxHits) { // Drop the older half at once, so trimming stays cheap per hit
+		size_t Dropped = MaxHits / 2;
+		Hits.erase(Hits.begin(), Hits.begin() + Dropped);
+		Settled -= std::min(Settled, Dropped);
+	}
+	Hits.push_back(Hit);
+	++Recorded;
+}
+
+void WatchpointMap::Read(uint16_t Address, uint8_t Value) {
+	if (Kinds[Address] & WatchRead) {
+		Record({ Address, Instruction, WatchRead, Value, Value });
+	}
+}
+
+void WatchpointMap::Write(uint16_t Address, uint8_t Old, uint8_t Value) {
+	if (Kinds[Address] & WatchWrite) {
+		Record({ Address, Instruction, WatchWrite, Old, Value });
+	}
+}
+
+void WatchpointMap::Modify(uint16_t Address, uint8_t Old) {
+	if (Kinds[Address]) {
+		Record({ Address, Instruction, Kinds[Address], Old, Old });
+		if (!Pending) {
+			Settled = Hits.size() - 1;
+		}
+		Pending = true;
+	}
+}
+
+void WatchpointMap::Settle(const std::vector<uint8_t>& Memory) {
+	for (size_t i = Settled; i < Hits.size(); ++i) {
+		if (Hits[i].Kind & WatchWrite) {
+			Hits[i].Value = Memory[Hits[i].Address];
+		}
+	}
+	Pending = false;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum WatchKind : uint8_t { WatchRead = 1, WatchWrite = 2, WatchAccess = 3 };
+
+struct WatchHit {
+	uint16_t Address;
+	uint16_t Instruction; // Address of the instruction that made the access
+	uint8_t Kind; // WatchRead, WatchWrite, or both for a read-modify-write
+	uint8_t Old; // Value before the access
+	uint8_t Value; // Value read or written
+};
+
+/*
+	Read and write watchpoints for an instrumented core. Pages holds, per 256-byte guest page,
+	the kinds of watch anywhere on it. Only accesses to a watched page reach Read, Write or
+	Modify, which check the exact address. Instruction fetches are not data reads and never hit.
+
+	This is a cheap path for unwatched pages, not a free one: with a map attached, every data
+	access of the instrumented core still tests the pointer and loads the page summary, and the
+	plain core has no watchpoints at all. bench/watchpoint_overhead.cpp measures the cost.
+
+	Hits keeps the most recent hits, at most MaxHits, so a long run with a busy watch does not
+	grow it without end; Recorded counts every hit since the last ClearHits.
+*/
+class WatchpointMap {
+public:
+	static constexpr size_t MaxHits = 4096;
+
+	WatchpointMap();
+	uint8_t Pages[256] = {};
+	std::vector<WatchHit> Hits; // Since the last ClearHits, oldest dropped beyond MaxHits
+	uint64_t Recorded = 0;
+	uint16_t Instruction = 0; // Kept up to date by the core
+
+	void Add(uint16_t Address, WatchKind Kind, uint32_t Length = 1);
+	void Remove(uint16_t Address, WatchKind Kind = WatchAccess, uint32_t Length = 1);
+	void ClearAll();
+	WatchKind At(uint16_t Address) const {
+		return static_cast<WatchKind>(Kinds[Address]);
+	}
+
+	bool Watched(uint16_t Address, WatchKind Kind) const {
+		return Pages[Address >> 8] & Kind;
+	}
+
+	void ClearHits() {
+		Hits.clear();
+		Recorded = 0;
+		Pending = false;
+	}
+
+	/* The slow path, reached only for addresses on watched pages */
+	void Read(uint16_t Address, uint8_t Value);
+	void Write(uint16_t Address, uint8_t Old, uint8_t Value);
+	void Modify(uint16_t Address, uint8_t Old);
+	/* Called by the core after each instruction to fill in what read-modify-writes stored */
+	void Retire(const std::vector<uint8_t>& Memory) {
+		if (Pending) {
+			Settle(Memory);
+		}
+	}
+
+private:
+	std::vector<uint8_t> Kinds;
+	bool Pending = false; // A Modify hit still waits for its value
+	size_t Settled = 0;
+
+	void Summarise(uint8_t Page);
+	void Record(const WatchHit& Hit);
+	void Settle(const std::vector<uint8_t>& Memory);
+};
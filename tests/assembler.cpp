@@ -0,0 +1,175 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include "../src/6502.h"
+#include "../src/assembler.h"
+#include "../bench/workloads.h"
+
+class M6502AssemblerTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.SP = 0x01FF;
+	}
+
+	template <size_t N>
+	void Run(const std::array<u8, N>& Program, u16 Origin, u16 Halt) {
+		std::copy(Program.begin(), Program.end(), M6502.Memory.begin() + Origin);
+		M6502.PC = Origin;
+		for (int i = 0; i < 10000 && M6502.PC != Halt; ++i) {
+			M6502.Execute(1);
+		}
+		ASSERT_EQ(M6502.PC, Halt);
+	}
+};
+
+TEST_F(M6502AssemblerTestSuite, EncodesTheCoreDialect) {
+	constexpr auto Program = R"(
+			.org $C000
+		PTR = $20
+			lda #$42        ; case-insensitive mnemonics
+			STA PTR+1
+			STA $1234
+			LDA $0012,X     ; four digits still fit zero page
+			STA (PTR),Y
+			LDA (PTR,X)
+			LDX PTR,Y
+			ASL
+			ROL A
+			JMP ($3000)
+			JSR sub
+		sub:
+			JMP sub
+			.byte 1, %10, $FF
+	)"_6502;
+	constexpr std::array<u8, 30> Expected = {
+		0xA9, 0x42,             // LDA #$42
+		0x85, 0x21,             // STA $21
+		0x8D, 0x12, 0x34,       // STA $1234, high byte first
+		0xB5, 0x12,             // LDA $12,X
+		0x91, 0x20,             // STA ($20),Y
+		0xA1, 0x20,             // LDA ($20,X)
+		0xB6, 0x20,             // LDX $20,Y
+		0x0A,                   // ASL A
+		0x2A,                   // ROL A
+		0x6C, 0x00, 0x30,       // JMP ($3000), low byte first
+		0x20, 0x2C, 0x18, 0xC0, // JSR sub, with the BIT abs the return lands on
+		0x4C, 0x18, 0xC0,       // JMP sub
+		0x01, 0x02, 0xFF        // .byte
+	};
+	static_assert(Program == Expected);
+	static_assert(Assembled<"\t.org $C000\nsub:\n\tJMP sub">::Label("sub") == 0xC000);
+	ASSERT_EQ(Program, Expected);
+}
+
+TEST_F(M6502AssemblerTestSuite, ReproducesTheWorkloadPrograms) {
+	constexpr auto AssembledMemcpy = R"(
+		SRC = $10
+		DST = $12
+			LDA #$00
+			STA SRC
+			STA DST
+			LDA #$40
+			STA SRC+1
+			LDA #$60
+			STA DST+1
+			LDX #$20
+			LDY #$00
+		copy:
+			LDA (SRC),Y
+			STA (DST),Y
+			INY
+			CPY #$00
+			BNE copy
+			INC SRC+1
+			INC DST+1
+			DEX
+			CPX #$00
+			BNE copy
+		done:
+			JMP done
+	)"_6502;
+	ASSERT_TRUE(std::equal(AssembledMemcpy.begin(), AssembledMemcpy.end(), std::begin(Memcpy), std::end(Memcpy)));
+
+	using AssembledBubbleSort = Assembled<R"(
+		SWAP = $1E
+		sweep:
+			LDA #$00
+			STA SWAP
+			LDX #$00
+		compare:
+			LDA $4000,X
+			CMP $4001,X
+			BCC ordered
+			BEQ ordered
+			LDY $4001,X
+			STA $4001,X
+			TYA
+			STA $4000,X
+			LDA #$01
+			STA SWAP
+		ordered:
+			INX
+			CPX #$BF
+			BNE compare
+			LDA SWAP
+			BNE sweep
+		done:
+			JMP done
+	)">;
+	static_assert(AssembledBubbleSort::Label("done") == BubbleSortHalt);
+	ASSERT_TRUE(std::equal(AssembledBubbleSort::Bytes.begin(), AssembledBubbleSort::Bytes.end(), std::begin(BubbleSort), std::end(BubbleSort)));
+}
+
+TEST_F(M6502AssemblerTestSuite, RunsWithResolvedBranchesAndCalls) {
+	using Program = Assembled<R"(
+		TOTAL = $10
+			LDA #0
+			STA TOTAL
+			LDX #10
+		loop:
+			JSR add
+			DEX
+			CPX #0
+			BNE loop
+			CPX #0
+			BEQ store       ; forward, padded after
+			LDA #$EE
+		store:
+			LDA TOTAL
+			STA $0300
+		done:
+			JMP done
+		add:
+			TXA
+			CLC
+			ADC TOTAL
+			STA TOTAL
+			RTS
+	)">;
+	Run(Program::Bytes, Program::Origin, Program::Label("done"));
+	ASSERT_EQ(M6502.Memory[0x0300], 55);
+	ASSERT_EQ(M6502.X, 0);
+}
+
+TEST_F(M6502AssemblerTestSuite, ReportsErrorsWithTheLine) {
+	Assembly Program = Assemble("\tLDA #$00\n\tFOO $10");
+	ASSERT_STREQ(Program.Error, "unknown instruction");
+	ASSERT_EQ(Program.Line, 2);
+	ASSERT_STREQ(Assemble("\tBNE nowhere").Error, "undefined symbol");
+	ASSERT_STREQ(Assemble("\tLDA #$100").Error, "operand does not fit in a byte");
+	ASSERT_STREQ(Assemble("\tJMP #$10").Error, "addressing mode not available for this instruction");
+	ASSERT_STREQ(Assemble("x:\nx:").Error, "symbol defined twice");
+	ASSERT_STREQ(Assemble("\tNOP\n\t.org $0300").Error, ".org after code");
+	std::string Far = "back:\n";
+	for (int i = 0; i < 70; ++i) {
+		Far += "\tLDA #$00\n";
+	}
+	ASSERT_STREQ(Assemble(Far + "\tBNE back").Error, "branch out of range");
+	Program = Assemble("\t.org $0400\nstart:\n\tBNE start");
+	ASSERT_EQ(Program.Error, nullptr);
+	ASSERT_EQ(Program.Label("start"), 0x0400);
+	ASSERT_EQ(Program.Bytes, (std::vector<u8>{ 0x02, 0xD0, 0xFF })); // BRK is not an empty opcode, so the branch is padded
+}
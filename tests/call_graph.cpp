@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "../src/6502.h"
+#include "../src/call_graph.h"
+
+class M6502CallGraphTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	CallGraphProfiler CallProfiler;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.CallProfiler = &CallProfiler;
+		M6502.SP = 0x01FF;
+		M6502.PC = 0x0200;
+
+		/* JSR operands sit two bytes after the opcode in this core, RTS resumes at opcode + 1 */
+		Load(0x0200, { 0x20, 0xEA, 0x00, 0x03 }); // JSR $0300
+		Load(0x0300, { 0x20, 0xEA, 0x00, 0x04, 0x60 }); // JSR $0400, NOP, BRK, (no-op), RTS
+		Load(0x0400, { 0xA9, 0x01, 0x60 }); // LDA #$01, RTS
+	}
+
+	virtual void TearDown() {
+		M6502.CallProfiler = nullptr;
+	}
+
+	void Load(u16 Address, std::initializer_list<u8> Bytes) {
+		std::copy(Bytes.begin(), Bytes.end(), M6502.Memory.begin() + Address);
+	}
+
+	std::string Folded() {
+		std::ostringstream Out;
+		CallProfiler.WriteFolded(Out);
+		return Out.str();
+	}
+};
+
+TEST_F(M6502CallGraphTestSuite, NestedCalls) {
+	for (int i = 0; i < 8; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_EQ(M6502.PC, 0x0201);
+	ASSERT_TRUE(CallProfiler.Stack.empty());
+	ASSERT_EQ(Folded(), "root 6\nroot;$0300 14\nroot;$0300;$0400 7\n");
+
+	std::ostringstream Out;
+	CallProfiler.Report(Out);
+	std::string Report = Out.str();
+	ASSERT_NE(Report.find("             1              21  77.78%              14  51.85%  $0300\n"), std::string::npos);
+	ASSERT_NE(Report.find("             1               7  25.93%               7  25.93%  $0400\n"), std::string::npos);
+	ASSERT_LT(Report.find("$0300"), Report.find("$0400"));
+}
+
+TEST_F(M6502CallGraphTestSuite, RepeatedCallsShareNode) {
+	for (int Round = 0; Round < 3; ++Round) {
+		M6502.PC = 0x0200;
+		for (int i = 0; i < 8; ++i) {
+			M6502.Execute(0);
+		}
+	}
+	ASSERT_EQ(CallProfiler.Nodes.size(), 3);
+	ASSERT_EQ(CallProfiler.Nodes[1].Calls, 3);
+	ASSERT_EQ(Folded(), "root 18\nroot;$0300 42\nroot;$0300;$0400 21\n");
+}
+
+TEST_F(M6502CallGraphTestSuite, DiscardedReturnAddress) {
+	Load(0x0300, { 0x68, 0x68, 0x4C, 0x00, 0x05 }); // PLA, PLA, JMP $0500
+	Load(0x0500, { 0xE8 }); // INX
+	for (int i = 0; i < 5; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_EQ(M6502.PC, 0x0501);
+	ASSERT_TRUE(CallProfiler.Stack.empty());
+	ASSERT_EQ(Folded(), "root 11\nroot;$0300 8\n");
+}
+
+TEST_F(M6502CallGraphTestSuite, Interrupts) {
+	M6502.PC = 0x0400;
+	M6502.Memory[0xFFFA] = 0x40; // IRQ vector
+	M6502.Memory[0x0040] = 0x40; // RTI
+	M6502.ProcessorStatus.reset(M6502.I);
+	M6502.IRQPending = true;
+	M6502.Execute(0);
+	ASSERT_EQ(CallProfiler.Stack.size(), 0);
+	ASSERT_EQ(Folded(), "root;[int]$0040 1\n");
+}
+
+TEST_F(M6502CallGraphTestSuite, Labels) {
+	std::istringstream Labels("0300 outer\n$0400 inner ; comment\nal C:0040 .irq\n0x0500 far\nnot a label\nFFFFF big\n");
+	ASSERT_EQ(CallProfiler.LoadLabels(Labels), 4);
+	for (int i = 0; i < 8; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_EQ(Folded(), "root 6\nroot;outer 14\nroot;outer;inner 7\n");
+	ASSERT_EQ(CallProfiler.Name(0x0040, true), "[int]irq");
+	ASSERT_EQ(CallProfiler.Name(0x1234), "$1234");
+}
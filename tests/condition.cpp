@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/condition.h"
+#include "../src/run_loop.h"
+#include "../src/watchpoints.h"
+
+class M6502ConditionTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		const u8 Program[] = {
+			0xE8,             // 0200  INX
+			0x86, 0x10,       // 0201  STX $10
+			0x4C, 0x00, 0x02  // 0203  JMP $0200
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+	}
+
+	int32_t Value(const char* Text) {
+		Condition Compiled;
+		EXPECT_TRUE(Compiled.Compile(Text)) << Text << ": " << Compiled.Error();
+		return Compiled.Value(M6502);
+	}
+};
+
+TEST_F(M6502ConditionTestSuite, ReadsRegistersAndMemory) {
+	Condition Compiled;
+	ASSERT_TRUE(Compiled.Compile("A == $42 && mem[$0300] & 0x80"));
+	M6502.A = 0x42;
+	M6502.Memory[0x0300] = 0x81;
+	ASSERT_TRUE(Compiled.Evaluate(M6502));
+	M6502.Memory[0x0300] = 0x01;
+	ASSERT_FALSE(Compiled.Evaluate(M6502));
+	M6502.X = 3;
+	M6502.Memory[0x13] = 0x99;
+	ASSERT_EQ(Value("mem[$10 + x]"), 0x99);
+	ASSERT_EQ(Value("PC"), 0x0200);
+	M6502.ProcessorStatus.set(NMOS6502::C);
+	ASSERT_EQ(Value("C + Z * 0"), 1);
+	ASSERT_EQ(Value("P & 1"), 1);
+}
+
+TEST_F(M6502ConditionTestSuite, FollowsPrecedence) {
+	ASSERT_EQ(Value("1 + 2 << 1"), 6);
+	ASSERT_EQ(Value("2 | 1 == 1"), 3);
+	ASSERT_EQ(Value("6 & 3 ^ 1"), 3);
+	ASSERT_EQ(Value("-1 < 0"), 1);
+	ASSERT_EQ(Value("!0 + ~0"), 0);
+	ASSERT_EQ(Value("%1010 == 10 && (1 != 2)"), 1);
+	ASSERT_EQ(Value("0 || 5"), 1);
+	ASSERT_EQ(Value("3 && 7"), 1);
+	ASSERT_EQ(Value("0 && 7 || 0"), 0);
+	ASSERT_EQ(Value("1 || 0 && 0"), 1);
+}
+
+TEST_F(M6502ConditionTestSuite, RejectsBadText) {
+	Condition Compiled;
+	ASSERT_FALSE(Compiled.Compile("A =="));
+	ASSERT_FALSE(Compiled.Compile("mem[$10"));
+	ASSERT_FALSE(Compiled.Compile("Q == 1"));
+	ASSERT_EQ(Compiled.Error(), "unknown name at column 1");
+	ASSERT_FALSE(Compiled.Compile("A $10"));
+	ASSERT_FALSE(Compiled.Compile("1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+(1+1))))))))))))))))"));
+	ASSERT_TRUE(Compiled.Empty());
+	ASSERT_TRUE(Compiled.Evaluate(M6502)); // An empty condition always holds
+}
+
+TEST_F(M6502ConditionTestSuite, LimitsCodeToJumpRange) {
+	Condition Compiled;
+	std::string Sum = "1";
+	for (int Term = 0; Term < 5000; ++Term) {
+		Sum += "+1";
+	}
+	ASSERT_TRUE(Compiled.Compile("0 || " + Sum + " == 5001")) << Compiled.Error();
+	ASSERT_GT(Compiled.Bytecode().size(), 0x7000u);
+	ASSERT_EQ(Compiled.Value(M6502), 1);
+	ASSERT_FALSE(Compiled.Compile("0 && " + Sum + Sum.substr(1) + Sum.substr(1))); // Over 64 KB, the jump could not reach its end
+	ASSERT_EQ(Compiled.Error().compare(0, 18, "condition too long"), 0) << Compiled.Error();
+	ASSERT_FALSE(Compiled.Compile(Sum + Sum.substr(1) + Sum.substr(1)));
+	ASSERT_TRUE(Compiled.Empty());
+}
+
+TEST_F(M6502ConditionTestSuite, StopsOnlyWhenConditionHolds) {
+	RunLoop Loop(M6502);
+	Loop.Mode = RunDebugInstruction;
+	Loop.Breakpoints.Set(0x0200);
+	ASSERT_TRUE(Loop.Conditions[0x0200].Compile("X == 5"));
+	RunResult Result = Loop.Run(100000);
+	ASSERT_EQ(Result.Stop, RunBreakpoint);
+	ASSERT_EQ(M6502.PC, 0x0200);
+	ASSERT_EQ(M6502.X, 5);
+}
+
+TEST_F(M6502ConditionTestSuite, FiltersWatchpointHits) {
+	WatchpointMap Watchpoints;
+	M6502.Watchpoints = &Watchpoints;
+	Watchpoints.Add(0x10, WatchWrite);
+	RunLoop Loop(M6502);
+	Loop.Mode = RunDebugBlock;
+	ASSERT_TRUE(Loop.WatchConditions[0x10].Compile("mem[$10] == 3"));
+	RunResult Result = Loop.Run(100000);
+	ASSERT_EQ(Result.Stop, RunWatchpoint);
+	ASSERT_EQ(M6502.Memory[0x10], 3);
+	ASSERT_EQ(Watchpoints.Hits.size(), 3);
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/differential.h"
+#include "../bench/workloads.h"
+
+class M6502DifferentialTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		M6502.SP = 0x01FF;
+	}
+
+	void Load(const u8* Program, size_t Size) {
+		std::copy(Program, Program + Size, M6502.Memory.begin() + 0x0200);
+		for (u16 Address = 0x4000; Address < 0x6000; ++Address) {
+			M6502.Memory[Address] = static_cast<u8>(Address * 7 + (Address >> 8));
+		}
+	}
+
+	/* Runs to the program's JMP-to-self, false on divergence */
+	bool RunToHalt(DifferentialRunner& Runner, u16 Halt) {
+		while (M6502.PC != Halt) {
+			if (!Runner.Run(1000)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+TEST_F(M6502DifferentialTestSuite, WorkloadsAgreePerInstruction) {
+	const struct { const u8* Program; size_t Size; u16 Halt; } Programs[] = {
+		{ Memcpy, sizeof(Memcpy), MemcpyHalt },
+		{ Crc16, sizeof(Crc16), Crc16Halt },
+		{ InsertionSort, sizeof(InsertionSort), InsertionSortHalt },
+		{ BcdCounter, sizeof(BcdCounter), BcdCounterHalt },
+	};
+	for (const auto& Program : Programs) {
+		SetUp();
+		Load(Program.Program, Program.Size);
+		DifferentialRunner Runner(M6502);
+		ASSERT_TRUE(RunToHalt(Runner, Program.Halt)) << Runner.Report.Describe();
+		ASSERT_EQ(Runner.CheckedBlocks, Runner.Blocks);
+	}
+}
+
+TEST_F(M6502DifferentialTestSuite, SampledBlocksAgree) {
+	Load(Crc32, sizeof(Crc32));
+	DifferentialRunner Runner(M6502);
+	Runner.Mode = DifferentialRunner::PerBlock;
+	Runner.SampleEvery = 7;
+	ASSERT_TRUE(RunToHalt(Runner, Crc32Halt)) << Runner.Report.Describe();
+	ASSERT_GT(Runner.Blocks, 1000);
+	ASSERT_EQ(Runner.CheckedBlocks, (Runner.Blocks + 6) / 7);
+}
+
+TEST_F(M6502DifferentialTestSuite, ReportsRegisterDivergence) {
+	const u8 Program[] = {
+		0xA2, 0x05,       // 0200  LDX #$05
+		0xAD, 0x30, 0x00, // 0202  LDA $3000
+		0xEA              // 0205  NOP
+	};
+	Load(Program, sizeof(Program));
+	DifferentialRunner Runner(M6502);
+	M6502.Memory[0x3000] = 0x01; // Behind the reference's back
+	ASSERT_FALSE(Runner.Run(3));
+	ASSERT_EQ(Runner.Report.Instruction, 1);
+	ASSERT_EQ(Runner.Report.Address, 0x0202);
+	ASSERT_EQ(Runner.Report.Fields, 1u << DiffA | 1u << DiffP); // Z follows A
+	ASSERT_EQ(Runner.Report.Describe().find("instruction 1 at 0202 (AD LDA Absolute), block 0200: a 01 != 00 p 00 != 02"), 0);
+}
+
+TEST_F(M6502DifferentialTestSuite, ReportsMemoryDivergencePerBlock) {
+	const u8 Program[] = {
+		0xAD, 0x70, 0x00, // 0200  LDA $7000
+		0x8D, 0x30, 0x01, // 0203  STA $3001
+		0x4C, 0x06, 0x02  // 0206  JMP $0206
+	};
+	Load(Program, sizeof(Program));
+	DifferentialRunner Runner(M6502);
+	Runner.Mode = DifferentialRunner::PerBlock;
+	M6502.Memory[0x7000] = 0x07;
+	ASSERT_FALSE(Runner.Run(10));
+	ASSERT_EQ(Runner.Report.Address, 0x0206);
+	ASSERT_EQ(Runner.Report.Fields, 1u << DiffA | 1u << DiffP | 1u << DiffMemory);
+	ASSERT_EQ(Runner.Report.MemoryAddress, 0x3001);
+	ASSERT_EQ(Runner.Report.FastValue, 0x07);
+	ASSERT_EQ(Runner.Report.ReferenceValue, 0x00);
+}
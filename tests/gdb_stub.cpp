@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/gdb_stub.h"
+
+class M6502GdbStubTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		M6502.SP = 0x01FF;
+		const u8 Program[] = {
+			0xE8,             // 0200  INX
+			0x86, 0x10,       // 0201  STX $10
+			0x4C, 0x00, 0x02  // 0203  JMP $0200
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+	}
+};
+
+TEST_F(M6502GdbStubTestSuite, FramesAndAcksPackets) {
+	GdbStub Stub(M6502);
+	ASSERT_EQ(GdbStub::Frame("OK"), "$OK#9a");
+	std::vector<std::string> Packets;
+	std::string Acks;
+	const std::string Input = "+$g#67$m0200,3#00$?#3f";
+	Stub.Receive(Input.data(), 10, Packets, Acks); // Split mid-packet
+	Stub.Receive(Input.data() + 10, Input.size() - 10, Packets, Acks);
+	ASSERT_EQ(Acks, "+-+");
+	ASSERT_EQ(Packets, (std::vector<std::string>{ "g", "?" }));
+	Packets.clear();
+	Acks.clear();
+	const std::string Runaway = "$" + std::string(0x2000, 'a') + "$g#67"; // Never terminated
+	Stub.Receive(Runaway.data(), Runaway.size(), Packets, Acks);
+	ASSERT_EQ(Acks, "-+");
+	ASSERT_EQ(Packets, (std::vector<std::string>{ "g" }));
+}
+
+TEST_F(M6502GdbStubTestSuite, ReadsAndWritesRegisters) {
+	GdbStub Stub(M6502);
+	M6502.A = 0x12;
+	M6502.X = 0x34;
+	M6502.ProcessorStatus.set(NMOS6502::C);
+	ASSERT_EQ(Stub.Handle("g"), "12340001ff010002");
+	ASSERT_EQ(Stub.Handle("p5"), "0002");
+	ASSERT_EQ(Stub.Handle("P5=1003"), "OK");
+	ASSERT_EQ(M6502.PC, 0x0310);
+	ASSERT_EQ(Stub.Handle("G0102030405060708"), "OK");
+	ASSERT_EQ(M6502.Y, 0x03);
+	ASSERT_EQ(M6502.SP, 0x0605);
+	ASSERT_EQ(M6502.PC, 0x0807);
+	ASSERT_EQ(Stub.Handle("G01020304zz060708"), "E01");
+	ASSERT_EQ(Stub.Handle("G0102"), "E01");
+	ASSERT_EQ(M6502.SP, 0x0605); // Nothing set from a malformed G
+	ASSERT_EQ(Stub.Handle("P5=10g3"), "E01");
+	ASSERT_EQ(M6502.PC, 0x0807);
+}
+
+TEST_F(M6502GdbStubTestSuite, TransfersMemoryBlocks) {
+	GdbStub Stub(M6502);
+	ASSERT_EQ(Stub.Handle("m200,6"), "e886104c0002");
+	ASSERT_EQ(Stub.Handle("mfffe,10"), "0000"); // Clipped at the top of memory
+	ASSERT_EQ(Stub.Handle("M300,2:abcd"), "OK");
+	ASSERT_EQ(M6502.Memory[0x0301], 0xCD);
+	ASSERT_EQ(Stub.Handle(std::string("X302,2:\x7d\x03\x41")), "OK"); // 0x7D escapes the next byte
+	ASSERT_EQ(M6502.Memory[0x0302], 0x23);
+	ASSERT_EQ(M6502.Memory[0x0303], 0x41);
+	ASSERT_EQ(Stub.Handle("m10000,1"), "E01");
+	ASSERT_EQ(Stub.Handle("Mffff,ffffffff:00112233"), "E01"); // Would wrap past the top of memory
+	ASSERT_EQ(Stub.Handle("Mfffe,3:001122"), "E01");
+	ASSERT_EQ(Stub.Handle("Xffff,80000000:\x01"), "E01");
+	ASSERT_EQ(Stub.Handle("Mffff,1:5a"), "OK");
+	ASSERT_EQ(M6502.Memory[0xFFFF], 0x5A);
+}
+
+TEST_F(M6502GdbStubTestSuite, StepsAndContinuesToBreakpoints) {
+	GdbStub Stub(M6502);
+	ASSERT_EQ(Stub.Handle("s"), "S05");
+	ASSERT_EQ(M6502.PC, 0x0201);
+	ASSERT_EQ(Stub.Handle("Z0,203,1"), "OK");
+	ASSERT_EQ(Stub.Handle("c"), "S05");
+	ASSERT_EQ(M6502.PC, 0x0203);
+	ASSERT_EQ(Stub.Handle("c"), "S05"); // Resumes over the breakpoint and comes round again
+	ASSERT_EQ(M6502.PC, 0x0203);
+	ASSERT_EQ(M6502.X, 2);
+	ASSERT_EQ(Stub.Handle("z0,203,1"), "OK");
+	int Polls = 0;
+	Stub.Interrupted = [&Polls] { return ++Polls == 3; };
+	ASSERT_EQ(Stub.Handle("c"), "S02");
+}
+
+TEST_F(M6502GdbStubTestSuite, ReportsWatchpoints) {
+	GdbStub Stub(M6502);
+	ASSERT_EQ(Stub.Handle("Z2,10,1"), "OK");
+	ASSERT_EQ(Stub.Handle("c"), "T05watch:0010;");
+	ASSERT_EQ(M6502.Memory[0x10], 1);
+	ASSERT_EQ(Stub.Handle("z2,10,1"), "OK");
+	ASSERT_EQ(Stub.Handle("Z3,10,1"), "OK");
+	ASSERT_EQ(Stub.Handle("s"), "S05"); // A store is not a read
+	ASSERT_EQ(Stub.Handle("D"), "OK");
+	ASSERT_EQ(M6502.Watchpoints, nullptr); // The detached guest runs without the watches
+	Stub.Attach();
+	ASSERT_NE(M6502.Watchpoints, nullptr);
+}
+
+TEST_F(M6502GdbStubTestSuite, ServesTargetDescription) {
+	GdbStub Stub(M6502);
+	ASSERT_NE(Stub.Handle("qSupported:xmlRegisters=i386").find("qXfer:features:read+"), std::string::npos);
+	std::string Document, Chunk;
+	for (size_t Offset = 0; Chunk.empty() || Chunk[0] == 'm'; Offset += Chunk.size() - 1) {
+		char Request[64];
+		std::snprintf(Request, sizeof(Request), "qXfer:features:read:target.xml:%zx,40", Offset);
+		Chunk = Stub.Handle(Request);
+		Document += Chunk.substr(1);
+	}
+	ASSERT_NE(Document.find("<reg name=\"pc\" bitsize=\"16\" type=\"code_ptr\"/>"), std::string::npos);
+	ASSERT_EQ(Document.substr(Document.size() - 9), "</target>");
+	ASSERT_EQ(Stub.Handle("vMustReplyEmpty"), "");
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "../src/6502.h"
+#include "../src/memory_heatmap.h"
+
+class M6502MemoryHeatmapTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	MemoryHeatmap Heatmap;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		const u8 Program[] = {
+			0xA9, 0x42,       // 0200  LDA #$42
+			0x85, 0x10,       // 0202  STA $10
+			0xE6, 0x10,       // 0204  INC $10
+			0x8D, 0x30, 0x00, // 0206  STA $3000
+			0xA5, 0x10,       // 0209  LDA $10
+			0x06, 0x10,       // 020B  ASL $10
+			0x48              // 020D  PHA
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+		M6502.Heatmap = &Heatmap;
+		for (int i = 0; i < 7; ++i) {
+			M6502.Execute(0);
+		}
+		M6502.Heatmap = nullptr;
+	}
+};
+
+TEST_F(M6502MemoryHeatmapTestSuite, CountsAccesses) {
+	ASSERT_EQ(Heatmap.Reads[0x10], 3);
+	ASSERT_EQ(Heatmap.Writes[0x10], 3);
+	ASSERT_EQ(Heatmap.Executes[0x10], 0);
+	ASSERT_EQ(Heatmap.Writes[0x3000], 1);
+	ASSERT_EQ(Heatmap.Reads[0x3000], 0);
+	ASSERT_EQ(Heatmap.Writes[0x0100], 1);
+	for (u16 Address = 0x0200; Address < 0x020E; ++Address) {
+		ASSERT_EQ(Heatmap.Executes[Address], 1);
+		ASSERT_EQ(Heatmap.Reads[Address], 0);
+	}
+	ASSERT_EQ(Heatmap.Executes[0x020E], 0);
+}
+
+TEST_F(M6502MemoryHeatmapTestSuite, WhoWrote) {
+	ASSERT_EQ(Heatmap.WhoWrote(0x10), 0x020B);
+	ASSERT_EQ(Heatmap.WhoWrote(0x3000), 0x0206);
+	ASSERT_EQ(Heatmap.WhoWrote(0x0100), 0x020D);
+	ASSERT_FALSE(Heatmap.WhoWrote(0x3001).has_value());
+	ASSERT_FALSE(Heatmap.WhoWrote(0x0200).has_value());
+}
+
+TEST_F(M6502MemoryHeatmapTestSuite, SaveAndLoad) {
+	std::stringstream Binary;
+	ASSERT_TRUE(Heatmap.Save(Binary));
+	ASSERT_LT(Binary.str().size(), 256);
+
+	MemoryHeatmap Loaded;
+	ASSERT_TRUE(Loaded.Load(Binary));
+	ASSERT_EQ(Loaded.Reads, Heatmap.Reads);
+	ASSERT_EQ(Loaded.Writes, Heatmap.Writes);
+	ASSERT_EQ(Loaded.Executes, Heatmap.Executes);
+	ASSERT_EQ(Loaded.WhoWrote(0x3000), 0x0206);
+
+	std::stringstream Truncated(Binary.str().substr(0, 30));
+	ASSERT_FALSE(Loaded.Load(Truncated));
+	ASSERT_EQ(Loaded.Writes[0x3000], 0);
+}
+
+TEST_F(M6502MemoryHeatmapTestSuite, CSV) {
+	std::ostringstream Out;
+	Heatmap.WriteCSV(Out);
+	std::string CSV = Out.str();
+	ASSERT_EQ(CSV.find("address,reads,writes,executes,last_writer\n"), 0);
+	ASSERT_NE(CSV.find("\n0010,3,3,0,020B\n"), std::string::npos);
+	ASSERT_NE(CSV.find("\n0200,0,0,1,\n"), std::string::npos);
+
+	std::ostringstream Pages;
+	Heatmap.WritePageCSV(Pages);
+	ASSERT_EQ(Pages.str(), "page,reads,writes,executes\n00,3,3,0\n01,0,1,0\n02,0,0,14\n30,0,1,0\n");
+}
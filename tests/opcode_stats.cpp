@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include "../src/6502.h"
+
+class M6502OpcodeStatsTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.Stats.Clear();
+	}
+
+	virtual void TearDown() {
+	}
+};
+
+TEST_F(M6502OpcodeStatsTestSuite, CountsExecutionsAndCycles) {
+	M6502.Memory[0xFFFC] = 0xA9; // LDA #$42
+	M6502.Memory[0xFFFD] = 0x42;
+	M6502.Execute(2);
+	M6502.PC = 0xFFFC;
+	M6502.Execute(2);
+
+	ASSERT_EQ(M6502.Stats.Executions[0xA9], 2);
+	ASSERT_EQ(M6502.Stats.Cycles[0xA9], 4);
+	ASSERT_EQ(M6502.Stats.PageCrosses[0xA9], 0);
+	ASSERT_EQ(M6502.Stats.TotalExecutions(), 2);
+	ASSERT_EQ(M6502.Stats.TotalCycles(), 4);
+}
+
+TEST_F(M6502OpcodeStatsTestSuite, CountsPageCrosses) {
+	M6502.Memory[0xFFFC] = 0xBD; // LDA $FFF2,X
+	M6502.Memory[0xFFFD] = 0xF2;
+	M6502.Memory[0xFFFE] = 0xFF;
+	M6502.X = 0x01;
+	M6502.Execute(5);
+
+	/* Same instruction without crossing a page */
+	M6502.PC = 0xFFFC;
+	M6502.Memory[0xFFFE] = 0x98;
+	M6502.Execute(4);
+
+	ASSERT_EQ(M6502.Stats.Executions[0xBD], 2);
+	ASSERT_EQ(M6502.Stats.Cycles[0xBD], 9);
+	ASSERT_EQ(M6502.Stats.PageCrosses[0xBD], 1);
+}
+
+TEST_F(M6502OpcodeStatsTestSuite, CountsTakenAndUntakenBranches) {
+	M6502.PC = 0xFF00;
+	M6502.Memory[0xFF00] = 0xD0; // BNE
+	M6502.Memory[0xFF01] = 0x10;
+
+	M6502.ProcessorStatus.set(M6502.Z);
+	M6502.Execute(2);
+
+	M6502.ProcessorStatus.reset(M6502.Z);
+	M6502.PC = 0xFF00;
+	M6502.Execute(3);
+
+	/* Taken with a page cross */
+	M6502.PC = 0xEEF0;
+	M6502.Memory[0xEEF0] = 0xD0;
+	M6502.Memory[0xEEF1] = 0x10;
+	M6502.Execute(4);
+
+	ASSERT_EQ(M6502.Stats.Executions[0xD0], 3);
+	ASSERT_EQ(M6502.Stats.BranchesTaken[0xD0], 2);
+	ASSERT_EQ(M6502.Stats.BranchesNotTaken(0xD0), 1);
+	ASSERT_EQ(M6502.Stats.PageCrosses[0xD0], 1);
+	ASSERT_EQ(M6502.Stats.Cycles[0xD0], 2 + 3 + 4);
+}
+
+TEST_F(M6502OpcodeStatsTestSuite, Reports) {
+	M6502.Memory[0xFFFC] = 0xA9;
+	M6502.Memory[0xFFFD] = 0x42;
+	M6502.Execute(2);
+
+	std::ostringstream Text;
+	M6502.Stats.Report(Text);
+	ASSERT_NE(Text.str().find("LDA"), std::string::npos);
+	ASSERT_NE(Text.str().find("Total: 1 instructions, 2 cycles"), std::string::npos);
+
+	std::ostringstream JSON;
+	M6502.Stats.ReportJSON(JSON);
+	ASSERT_NE(JSON.str().find("\"opcode\": 169, \"mnemonic\": \"LDA\", \"mode\": \"Immediate\", \"executions\": 1, \"cycles\": 2"), std::string::npos);
+	ASSERT_EQ(JSON.str().find("BNE"), std::string::npos);
+
+	M6502.Stats.Clear();
+	ASSERT_EQ(M6502.Stats.TotalExecutions(), 0);
+}
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <sstream>
+#include "../src/6502.h"
+#include "../src/assembler.h"
+#include "../src/disassembler.h"
+#include "../src/profiler.h"
+
+class M6502ProfilerTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	Profiler PCProfiler;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PCProfiler = &PCProfiler;
+	}
+
+	virtual void TearDown() {
+		M6502.PCProfiler = nullptr;
+	}
+};
+
+TEST_F(M6502ProfilerTestSuite, RecordsCyclesPerAddress) {
+	M6502.PC = 0x0200;
+	M6502.Memory[0x0200] = 0xA9; // LDA #$42
+	M6502.Memory[0x0201] = 0x42;
+	M6502.Memory[0x0202] = 0xAD; // LDA $BCA1
+	M6502.Memory[0x0203] = 0xBC;
+	M6502.Memory[0x0204] = 0xA1;
+	M6502.Execute(2);
+	M6502.Execute(4);
+	M6502.PC = 0x0200;
+	M6502.Execute(2);
+
+	ASSERT_EQ(PCProfiler.Samples[0x0200].Cycles, 4);
+	ASSERT_EQ(PCProfiler.Samples[0x0200].Executions, 2);
+	ASSERT_EQ(PCProfiler.Samples[0x0202].Cycles, 4);
+	ASSERT_EQ(PCProfiler.Samples[0x0202].Executions, 1);
+	ASSERT_EQ(PCProfiler.Samples[0x0201].Executions, 0);
+	ASSERT_EQ(PCProfiler.TotalCycles(), 8);
+
+	PCProfiler.Clear();
+	ASSERT_EQ(PCProfiler.TotalCycles(), 0);
+}
+
+TEST_F(M6502ProfilerTestSuite, FlatProfileSortedByCycles) {
+	M6502.PC = 0x0200;
+	M6502.Memory[0x0200] = 0xE8; // INX
+	M6502.Memory[0x0201] = 0xEE; // INC $1234
+	M6502.Memory[0x0202] = 0x12;
+	M6502.Memory[0x0203] = 0x34;
+	M6502.Execute(2);
+	M6502.Execute(6);
+
+	std::ostringstream Out;
+	PCProfiler.FlatProfile(Out, M6502.Memory);
+	std::string Profile = Out.str();
+	size_t Increment = Profile.find("INC $1234");
+	size_t IncrementX = Profile.find("INX");
+	ASSERT_NE(Increment, std::string::npos);
+	ASSERT_NE(IncrementX, std::string::npos);
+	ASSERT_LT(Increment, IncrementX);
+	ASSERT_NE(Profile.find(" 75.00% "), std::string::npos);
+
+	std::ostringstream Limited;
+	PCProfiler.FlatProfile(Limited, M6502.Memory, 1);
+	ASSERT_EQ(Limited.str().find("INX"), std::string::npos);
+}
+
+TEST_F(M6502ProfilerTestSuite, AnnotatedListingSeparatesRuns) {
+	M6502.PC = 0x0200;
+	M6502.Memory[0x0200] = 0x4C; // JMP $0300
+	M6502.Memory[0x0201] = 0x00;
+	M6502.Memory[0x0202] = 0x03;
+	M6502.Memory[0x0300] = 0xA2; // LDX #$01
+	M6502.Memory[0x0301] = 0x01;
+	M6502.Memory[0x0302] = 0xB5; // LDA $10,X
+	M6502.Memory[0x0303] = 0x10;
+	M6502.Execute(3);
+	M6502.Execute(2);
+	M6502.Execute(4);
+
+	std::ostringstream Out;
+	PCProfiler.AnnotatedListing(Out, M6502.Memory);
+	std::string Listing = Out.str();
+	ASSERT_NE(Listing.find("0200  4C 00 03  JMP $0300\n\n"), std::string::npos);
+	ASSERT_NE(Listing.find("0300  A2 01     LDX #$01\n"), std::string::npos);
+	ASSERT_NE(Listing.find("0302  B5 10     LDA $10,X\n"), std::string::npos);
+}
+
+TEST(M6502DisassemblerTestSuite, AddressingModes) {
+	std::vector<u8> Memory(0x10000, 0);
+	auto Check = [&Memory](std::initializer_list<u8> Bytes, u16 Address, const char* Expected) {
+		std::copy(Bytes.begin(), Bytes.end(), Memory.begin() + Address);
+		ASSERT_EQ(Disassemble(Memory, Address), Expected);
+	};
+	Check({ 0xEA }, 0x0200, "NOP");
+	Check({ 0x0A }, 0x0200, "ASL A");
+	Check({ 0xA9, 0x42 }, 0x0200, "LDA #$42");
+	Check({ 0xB6, 0x10 }, 0x0200, "LDX $10,Y");
+	Check({ 0xAD, 0x12, 0x34 }, 0x0200, "LDA $1234");
+	Check({ 0x9D, 0x30, 0x00 }, 0x0200, "STA $3000,X");
+	Check({ 0x4C, 0x00, 0x03 }, 0x0200, "JMP $0300");
+	Check({ 0x6C, 0xFC, 0xFF }, 0x0200, "JMP ($FFFC)");
+	Check({ 0x20, 0x2C, 0x34, 0x12 }, 0x0200, "JSR $1234");
+	Check({ 0xA1, 0x20 }, 0x0200, "LDA ($20,X)");
+	Check({ 0x91, 0x20 }, 0x0200, "STA ($20),Y");
+	Check({ 0xD0, 0xFE }, 0x0200, "BNE $01FE");
+	Check({ 0x10, 0x10 }, 0x0200, "BPL $0210");
+	Check({ 0x02 }, 0x0200, "???");
+}
+
+TEST(M6502DisassemblerTestSuite, FormatsIntoCallerBuffers) {
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		u8 Bytes[4] = { static_cast<u8>(Opcode), 0xFF, 0xFF, 0xFF };
+		char Text[DisassemblyBufferSize];
+		size_t Length = DisassembleInto(Bytes, 0xFFFF, Text);
+		ASSERT_EQ(Length, std::strlen(Text));
+		ASSERT_EQ(Text, Disassemble(Bytes, 0xFFFF));
+		ASSERT_LE(Length, 13);
+	}
+}
+
+TEST(M6502DisassemblerTestSuite, ListsRanges) {
+	std::vector<u8> Memory(0x10000, 0);
+	const u8 Program[] = { 0xA9, 0x42, 0x8D, 0x30, 0x00, 0xEA, 0xD0, 0xFC };
+	std::copy(std::begin(Program), std::end(Program), Memory.begin() + 0x0200);
+	char Listing[4 * DisassemblyLineSize];
+	u32 Next = 0;
+	size_t Length = DisassembleRange(Memory.data(), 0x0200, 0x0208, Listing, sizeof(Listing), Next);
+	const std::string Expected =
+		"0200  A9 42     LDA #$42\n"
+		"0202  8D 30 00  STA $3000\n"
+		"0205  EA        NOP\n"
+		"0206  D0 FC     BNE $0202\n";
+	ASSERT_EQ(std::string(Listing, Length), Expected);
+	ASSERT_EQ(Next, 0x0208);
+
+	Length = DisassembleRange(Memory.data(), 0x0200, 0x0208, Listing, 2 * DisassemblyLineSize + 1, Next);
+	ASSERT_EQ(Next, 0x0205); // Stopped for want of room
+	Length += DisassembleRange(Memory.data(), Next, 0x0208, Listing + Length, sizeof(Listing) - Length, Next);
+	ASSERT_EQ(std::string(Listing, Length), Expected);
+}
+
+static constexpr AssemblySource RoundTripSource = R"(
+	.org $0300
+	LDA #$42
+	LDX $10,Y
+	STA $3000
+	STA $1234,X
+	LDA $ABCD,Y
+	LDA ($20,X)
+	STA ($20),Y
+	ASL A
+	INC $40
+	JSR $1234
+	DEX
+	BNE $0300
+	BEQ $0340
+	JMP ($FFFC)
+	JMP $0300
+)";
+
+TEST(M6502DisassemblerTestSuite, ListsAssembledSource) {
+	using Program = Assembled<RoundTripSource>;
+	std::vector<u8> Memory(0x10000, 0);
+	std::copy(Program::Bytes.begin(), Program::Bytes.end(), Memory.begin() + Program::Origin);
+	char Listing[32 * DisassemblyLineSize];
+	u32 Next = 0;
+	std::istringstream Lines(std::string(Listing, DisassembleRange(Memory.data(), Program::Origin, Program::Origin + Program::Size, Listing, sizeof(Listing), Next)));
+	std::istringstream Source{ std::string(RoundTripSource.View()) };
+	std::string Line, Expected;
+	std::getline(Source, Expected);
+	std::getline(Source, Expected); // .org
+	while (std::getline(Lines, Line)) {
+		std::string Text = Line.substr(16);
+		if (Text == "???") {
+			continue; // Padding around the branches
+		}
+		ASSERT_TRUE(std::getline(Source, Expected));
+		ASSERT_EQ(Text, Expected.substr(1));
+	}
+	ASSERT_FALSE(std::getline(Source, Expected) && !Expected.empty());
+	ASSERT_EQ(Next, Program::Origin + Program::Size);
+}
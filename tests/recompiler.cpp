@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "../src/6502.h"
+#include "../src/assembler.h"
+#include "../src/recompiled.h"
+#include "../src/recompiler.h"
+
+/* Built from tests/data/recompiler_image.bin by 6502-recompile, with --entry for tail */
+extern const RecompiledProgram RecompiledImage;
+
+/* The source of tests/data/recompiler_image.bin */
+using RecompilerImage = Assembled<R"(
+	TOTAL = $10
+		LDA #0
+		STA TOTAL
+		LDX #10
+	loop:
+		JSR add
+		DEX
+		CPX #0
+		BNE loop
+		LDA TOTAL
+		STA $0300
+		JMP ($0400)     ; reaches tail only through the vector
+	add:
+		TXA
+		CLC
+		ADC TOTAL
+		STA TOTAL
+		RTS
+	tail:
+		LDY #$FF
+		LDA $0280,Y     ; crosses into page 3
+		ASL A
+		STA $0301
+	done:
+		JMP done
+)">;
+
+class M6502RecompilerTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	NMOS6502 Interpreted;
+
+	virtual void SetUp() {
+		for (NMOS6502* M : { &M6502, &Interpreted }) {
+			M->Reset();
+			M->SP = 0x01FF;
+			M->PC = RecompilerImage::Origin;
+			std::copy(RecompilerImage::Bytes.begin(), RecompilerImage::Bytes.end(), M->Memory.begin() + RecompilerImage::Origin);
+			M->Memory[0x037F] = 0x21;
+		}
+	}
+
+	void Vector(u16 Target) {
+		for (NMOS6502* M : { &M6502, &Interpreted }) {
+			M->Memory[0x0400] = static_cast<u8>(Target >> 8); // JMP (ind) reads its pointer high byte first
+			M->Memory[0x0401] = static_cast<u8>(Target);
+		}
+	}
+
+	void ExpectSameMachines() {
+		ASSERT_EQ(M6502.PC, Interpreted.PC);
+		ASSERT_EQ(M6502.SP, Interpreted.SP);
+		ASSERT_EQ(M6502.A, Interpreted.A);
+		ASSERT_EQ(M6502.X, Interpreted.X);
+		ASSERT_EQ(M6502.Y, Interpreted.Y);
+		ASSERT_EQ(M6502.ProcessorStatus, Interpreted.ProcessorStatus);
+		ASSERT_TRUE(M6502.Memory == Interpreted.Memory);
+	}
+};
+
+TEST_F(M6502RecompilerTestSuite, RecoversBlocksFromEveryEntry) {
+	std::ifstream File(RECOMPILER_IMAGE, std::ios::binary);
+	std::vector<u8> Image((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	ASSERT_TRUE(std::equal(Image.begin(), Image.end(), RecompilerImage::Bytes.begin(), RecompilerImage::Bytes.end()));
+
+	StaticRecompiler Recompiler(Image, RecompilerImage::Origin);
+	Recompiler.Recover();
+	std::vector<u16> Starts;
+	for (const auto& [Start, Block] : Recompiler.Blocks) {
+		Starts.push_back(Start);
+	}
+	// The loop target, the JSR return at opcode + 1, and the branch falling through onto its offset byte
+	ASSERT_EQ(Starts, (std::vector<u16>{ 0x0200, 0x0206, 0x0207, 0x0210, RecompilerImage::Label("add") }));
+	ASSERT_EQ(Recompiler.Blocks[0x0200].Instructions, (std::vector<u16>{ 0x0200, 0x0202, 0x0204 }));
+	ASSERT_EQ(Recompiler.Blocks[0x0206].End, 0x020Au);
+
+	Recompiler.Entries.push_back(RecompilerImage::Label("tail"));
+	Recompiler.Recover();
+	ASSERT_EQ(Recompiler.Blocks.size(), 7u);
+	ASSERT_EQ(Recompiler.Blocks.count(RecompilerImage::Label("done")), 1u);
+	std::string Source = Recompiler.Emit("Program");
+	ASSERT_NE(Source.find("extern const RecompiledProgram Program = { Blocks, 7, Image, 0x0200, 44 };"), std::string::npos);
+	ASSERT_NE(Source.find("return Block_0206(M, Run);"), std::string::npos);
+}
+
+TEST_F(M6502RecompilerTestSuite, MatchesTheInterpreterCycleForCycle) {
+	Vector(RecompilerImage::Label("tail"));
+	RecompiledRun Recompiled(M6502, RecompiledImage);
+	RunLoop Loop(Interpreted);
+	RunResult Fast = Recompiled.Run(2000);
+	RunResult Slow = Loop.Run(2000);
+	ExpectSameMachines();
+	ASSERT_EQ(Fast.Cycles, Slow.Cycles);
+	ASSERT_EQ(Fast.Instructions, Slow.Instructions);
+	ASSERT_EQ(M6502.PC, RecompilerImage::Label("done"));
+	ASSERT_EQ(M6502.Memory[0x0300], 55);
+	ASSERT_EQ(M6502.Memory[0x0301], 0x42);
+	ASSERT_EQ(Recompiled.Interpreted, 0u);
+	ASSERT_GT(Recompiled.Blocks, 0u);
+}
+
+TEST_F(M6502RecompilerTestSuite, InterpretsPatchedAndUndiscoveredCode) {
+	const u8 Elsewhere[] = { 0xA9, 0x66, 0x8D, 0x03, 0x01, 0x4C, 0x29, 0x02 }; // LDA #$66, STA $0301, JMP done
+	for (NMOS6502* M : { &M6502, &Interpreted }) {
+		M->Memory[0x0205] = 5; // LDX #5
+		std::copy(std::begin(Elsewhere), std::end(Elsewhere), M->Memory.begin() + 0x0600);
+	}
+	Vector(0x0600);
+	RecompiledRun Recompiled(M6502, RecompiledImage);
+	RunLoop Loop(Interpreted);
+	RunResult Fast = Recompiled.Run(2000);
+	RunResult Slow = Loop.Run(2000);
+	ExpectSameMachines();
+	ASSERT_EQ(Fast.Cycles, Slow.Cycles);
+	ASSERT_EQ(M6502.Memory[0x0300], 15);
+	ASSERT_EQ(M6502.Memory[0x0301], 0x66);
+	ASSERT_EQ(Recompiled.Interpreted, 6u); // The patched block and the code at $0600
+}
+
+TEST_F(M6502RecompilerTestSuite, SeesInterpretedWritesToTranslatedCode) {
+	const u8 Patch[] = {
+		0xA0, 0x05, 0xA9, 0x05, 0x91, 0x50, // LDY #5, LDA #5, STA ($50),Y
+		0xA9, 0x02, 0x8D, 0x04, 0x00, 0xA9, 0x29, 0x8D, 0x04, 0x01, // Point the vector at done
+		0x4C, 0x00, 0x02 // JMP $0200
+	};
+	for (NMOS6502* M : { &M6502, &Interpreted }) {
+		M->Memory[0x50] = 0x00; // ($50) is $0200, so the store lands on the LDX operand at $0205
+		M->Memory[0x51] = 0x02;
+		std::copy(std::begin(Patch), std::end(Patch), M->Memory.begin() + 0x0600);
+	}
+	Vector(0x0600);
+	RecompiledRun Recompiled(M6502, RecompiledImage);
+	RunLoop Loop(Interpreted);
+	RunResult Fast = Recompiled.Run(2000);
+	RunResult Slow = Loop.Run(2000);
+	ExpectSameMachines();
+	ASSERT_EQ(Fast.Cycles, Slow.Cycles);
+	ASSERT_EQ(M6502.PC, RecompilerImage::Label("done"));
+	ASSERT_EQ(M6502.Memory[0x0205], 5);
+	ASSERT_EQ(M6502.Memory[0x0300], 15); // The first pass totals 55, the second runs the patched LDX #5
+}
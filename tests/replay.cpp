@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/replay.h"
+
+class M6502ReplayTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	Recording Log;
+	std::vector<u16> PCs; // Before each recorded instruction
+	std::vector<u8> Sums;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		M6502.SP = 0x01FF;
+		const u8 Program[] = {
+			0xAD, 0xD0, 0x00, // 0200  LDA $D000 (device register)
+			0x85, 0x10,       // 0203  STA $10
+			0x18,             // 0205  CLC
+			0x65, 0x12,       // 0206  ADC $12
+			0x85, 0x12,       // 0208  STA $12
+			0x4C, 0x00, 0x02  // 020A  JMP $0200
+		};
+		const u8 Handler[] = {
+			0xE6, 0x13,       // 0080  INC $13
+			0x4C, 0x00, 0x02  // 0082  JMP $0200
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+		std::copy(std::begin(Handler), std::end(Handler), M6502.Memory.begin() + 0x0080);
+		M6502.Memory[0xFFFA] = 0x80; // The core takes IRQs through $FFFA, one byte wide
+
+		Recorder Recording(M6502, 200);
+		Recording.Input(0xD000);
+		u32 Noise = 12345;
+		for (int i = 0; i < 5000; ++i) {
+			Noise = Noise * 1103515245 + 12345;
+			M6502.Memory[0xD000] = static_cast<u8>(Noise >> 16);
+			if (i % 97 == 0) {
+				M6502.IRQPending = true;
+			}
+			PCs.push_back(M6502.PC);
+			Sums.push_back(M6502.Memory[0x12]);
+			Recording.Step();
+		}
+		PCs.push_back(M6502.PC);
+		Sums.push_back(M6502.Memory[0x12]);
+		Log = Recording.Log;
+	}
+};
+
+TEST_F(M6502ReplayTestSuite, ReplaysToTheSameState) {
+	ASSERT_EQ(Log.Instructions, 5000);
+	ASSERT_GT(Log.Checkpoints.size(), 10);
+	NMOS6502 Other;
+	Replayer Replay(Other, Log);
+	Replay.Seek(Log.Instructions);
+	Other.Memory[0xD000] = M6502.Memory[0xD000]; // The device register holds whatever the host stored last, read or not
+	ASSERT_EQ(Other.Memory, M6502.Memory);
+	ASSERT_EQ(Other.PC, M6502.PC);
+	ASSERT_EQ(Other.SP, M6502.SP);
+	ASSERT_EQ(Other.A, M6502.A);
+	ASSERT_EQ(Replay.Step(), 0); // Nothing recorded past the end
+	Replay.Seek(2500);
+	ASSERT_EQ(Other.PC, PCs[2500]);
+	ASSERT_EQ(Other.Memory[0x12], Sums[2500]);
+	Replay.Seek(1234);
+	ASSERT_EQ(Other.PC, PCs[1234]);
+	ASSERT_EQ(Other.Memory[0x12], Sums[1234]);
+}
+
+TEST_F(M6502ReplayTestSuite, StepsBackwards) {
+	NMOS6502 Other;
+	Replayer Replay(Other, Log);
+	ASSERT_FALSE(Replay.ReverseStep());
+	Replay.Seek(3001);
+	for (u64 Expected = 3000; Expected > 2990; --Expected) {
+		ASSERT_TRUE(Replay.ReverseStep());
+		ASSERT_EQ(Replay.Instruction, Expected);
+		ASSERT_EQ(Other.PC, PCs[Expected]);
+		ASSERT_EQ(Other.Memory[0x12], Sums[Expected]);
+	}
+}
+
+TEST_F(M6502ReplayTestSuite, ContinuesBackwardsToBreakpoints) {
+	NMOS6502 Other;
+	Replayer Replay(Other, Log);
+	BreakpointMap Breakpoints;
+	Breakpoints.Set(0x0082); // Reached once per interrupt, across several checkpoints
+	Replay.Seek(4000);
+	for (int Hit = 0; Hit < 5; ++Hit) {
+		u64 From = Replay.Instruction;
+		ASSERT_TRUE(Replay.ReverseContinue(Breakpoints));
+		ASSERT_EQ(Other.PC, 0x0082);
+		u64 Expected = From - 1;
+		while (PCs[Expected] != 0x0082) {
+			--Expected;
+		}
+		ASSERT_EQ(Replay.Instruction, Expected);
+	}
+	Breakpoints.ClearAll();
+	Breakpoints.Set(0x0300);
+	u64 Before = Replay.Instruction;
+	ASSERT_FALSE(Replay.ReverseContinue(Breakpoints));
+	ASSERT_EQ(Replay.Instruction, Before);
+}
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/rewind.h"
+
+class M6502RewindTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	DirtyPageMap Dirty;
+	RewindBuffer Buffer;
+	std::vector<std::vector<u8>> Memories; // Of every capture, oldest first
+	std::vector<u16> PCs;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		M6502.SP = 0x01FF;
+		const u8 Program[] = {
+			0xE8,             // 0200  INX
+			0x8A,             // 0201  TXA
+			0x9D, 0x30, 0x00, // 0202  STA $3000,X
+			0xEE, 0x41, 0x00, // 0205  INC $4100
+			0x85, 0x10,       // 0208  STA $10
+			0x4C, 0x00, 0x02  // 020A  JMP $0200
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+		M6502.DirtyPages = &Dirty;
+	}
+
+	void Run(int Captures, int Instructions) {
+		for (int Capture = 0; Capture < Captures; ++Capture) {
+			Buffer.Capture(M6502, Dirty, 0);
+			Memories.push_back(M6502.Memory);
+			PCs.push_back(M6502.PC);
+			for (int i = 0; i < Instructions; ++i) {
+				M6502.Execute(0);
+			}
+		}
+	}
+};
+
+TEST_F(M6502RewindTestSuite, ReconstructsEveryFrame) {
+	Run(40, 37);
+	ASSERT_EQ(Buffer.Frames(), 40);
+	MachineSnapshot State;
+	for (size_t Back = 0; Back < 40; ++Back) {
+		ASSERT_TRUE(Buffer.Reconstruct(Back, State));
+		ASSERT_EQ(State.Memory, Memories[39 - Back]);
+		ASSERT_EQ(State.PC, PCs[39 - Back]);
+	}
+	ASSERT_FALSE(Buffer.Reconstruct(40, State));
+	ASSERT_LT(Buffer.Bytes(), 2 * 0x10000 + 40 * (sizeof(RewindFrame) + 64)); // The first keyframe, then a few dozen bytes of delta per frame
+}
+
+TEST_F(M6502RewindTestSuite, RewindsTheCoreAndDropsNewerFrames) {
+	Run(20, 50);
+	ASSERT_TRUE(Buffer.Rewind(M6502, Dirty, 5)); // Also undoes what ran since the last capture
+	ASSERT_EQ(Buffer.Frames(), 15);
+	ASSERT_EQ(M6502.Memory, Memories[14]);
+	ASSERT_EQ(M6502.PC, PCs[14]);
+	ASSERT_EQ(Dirty.Count(), 0);
+
+	/* Running on from there records a new future */
+	for (int i = 0; i < 50; ++i) {
+		M6502.Execute(0);
+	}
+	Buffer.Capture(M6502, Dirty, 0);
+	MachineSnapshot State;
+	ASSERT_TRUE(Buffer.Reconstruct(0, State));
+	ASSERT_EQ(State.Memory, Memories[15]);
+	ASSERT_TRUE(Buffer.Reconstruct(1, State));
+	ASSERT_EQ(State.Memory, Memories[14]);
+}
+
+TEST_F(M6502RewindTestSuite, StaysWithinBudget) {
+	Buffer.Budget = 0x10000 + 10 * (sizeof(RewindFrame) + 64);
+	Run(100, 37);
+	ASSERT_LE(Buffer.Bytes(), Buffer.Budget);
+	ASSERT_LT(Buffer.Frames(), 100);
+	size_t Oldest = Buffer.Frames() - 1;
+	MachineSnapshot State;
+	ASSERT_TRUE(Buffer.Reconstruct(Oldest, State));
+	ASSERT_EQ(State.Memory, Memories[99 - Oldest]);
+}
+
+TEST_F(M6502RewindTestSuite, ReachesOldFramesThroughKeyframes) {
+	Buffer.KeyframeEvery = 16;
+	Run(100, 37);
+	ASSERT_EQ(Buffer.Frames(), 100);
+	MachineSnapshot State;
+	for (size_t Back = 0; Back < 100; ++Back) {
+		ASSERT_TRUE(Buffer.Reconstruct(Back, State));
+		ASSERT_EQ(State.Memory, Memories[99 - Back]);
+	}
+	ASSERT_GT(Buffer.Bytes(), 7 * 0x10000u); // Frames 0, 16, ... 96 and the newest are whole
+
+	ASSERT_TRUE(Buffer.Rewind(M6502, Dirty, 60)); // Crosses keyframes, so all of memory comes from one
+	ASSERT_EQ(Buffer.Frames(), 40);
+	ASSERT_EQ(M6502.Memory, Memories[39]);
+	ASSERT_EQ(M6502.PC, PCs[39]);
+	ASSERT_TRUE(Buffer.Reconstruct(39, State));
+	ASSERT_EQ(State.Memory, Memories[0]);
+	Memories.resize(40);
+	PCs.resize(40);
+	Run(20, 37); // Numbering continues from the frame rewound to
+	for (size_t Back = 0; Back < 60; ++Back) {
+		ASSERT_TRUE(Buffer.Reconstruct(Back, State));
+		ASSERT_EQ(State.Memory, Memories[Memories.size() - 1 - Back]) << Back;
+	}
+}
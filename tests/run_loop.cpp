@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/run_loop.h"
+
+class M6502RunLoopTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	RunLoop Loop{ M6502 };
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		const u8 Program[] = {
+			0xA2, 0x00,       // 0200  LDX #$00
+			0xE8,             // 0202  INX
+			0xEA,             // 0203  NOP
+			0x4C, 0x02, 0x02  // 0204  JMP $0202
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+	}
+};
+
+TEST_F(M6502RunLoopTestSuite, FastModeIgnoresBreakpoints) {
+	Loop.Breakpoints.Set(0x0203);
+	RunResult Result = Loop.Run(100);
+	ASSERT_EQ(Result.Stop, RunBudgetSpent);
+	ASSERT_GE(Result.Cycles, 100);
+	ASSERT_GT(M6502.X, 10);
+}
+
+TEST_F(M6502RunLoopTestSuite, StopsBeforeBreakpointAndResumes) {
+	Loop.Mode = RunDebugInstruction;
+	Loop.Breakpoints.Set(0x0203);
+	RunResult Result = Loop.Run(1000);
+	ASSERT_EQ(Result.Stop, RunBreakpoint);
+	ASSERT_EQ(Result.Instructions, 2);
+	ASSERT_EQ(M6502.PC, 0x0203);
+	ASSERT_EQ(M6502.X, 1);
+	Result = Loop.Run(1000);
+	ASSERT_EQ(Result.Stop, RunBreakpoint);
+	ASSERT_EQ(Result.Instructions, 3); // NOP, JMP, INX
+	ASSERT_EQ(M6502.PC, 0x0203);
+	ASSERT_EQ(M6502.X, 2);
+}
+
+TEST_F(M6502RunLoopTestSuite, BlockModeChecksEntriesOnly) {
+	Loop.Mode = RunDebugBlock;
+	Loop.Breakpoints.Set(0x0203); // Inside the loop body
+	ASSERT_EQ(Loop.Run(100).Stop, RunBudgetSpent);
+	Loop.Breakpoints.Clear(0x0203); // A run also checks where it starts
+	Loop.Breakpoints.Set(0x0202); // The JMP target
+	RunResult Result = Loop.Run(100);
+	ASSERT_EQ(Result.Stop, RunBreakpoint);
+	ASSERT_EQ(M6502.PC, 0x0202);
+}
+
+TEST_F(M6502RunLoopTestSuite, SwitchesModesMidRun) {
+	Loop.Breakpoints.Set(0x0204);
+	Loop.Run(50);
+	u8 X = M6502.X;
+	Loop.Mode = RunDebugInstruction;
+	RunResult Result = Loop.Run(1000);
+	ASSERT_EQ(Result.Stop, RunBreakpoint);
+	ASSERT_EQ(M6502.PC, 0x0204);
+	ASSERT_GE(M6502.X, X);
+	ASSERT_LE(M6502.X, X + 1);
+	Loop.Mode = RunFast;
+	ASSERT_EQ(Loop.Run(50).Stop, RunBudgetSpent);
+	ASSERT_GT(M6502.X, X + 1);
+}
+
+TEST_F(M6502RunLoopTestSuite, BitmapCoversTheAddressSpace) {
+	Loop.Breakpoints.Set(0x0000);
+	Loop.Breakpoints.Set(0xFFFF);
+	Loop.Breakpoints.Set(0x1234);
+	ASSERT_EQ(Loop.Breakpoints.Count(), 3);
+	ASSERT_TRUE(Loop.Breakpoints.Test(0xFFFF));
+	Loop.Breakpoints.Clear(0x1234);
+	ASSERT_FALSE(Loop.Breakpoints.Test(0x1234));
+	ASSERT_FALSE(Loop.Breakpoints.Test(0x1235));
+	Loop.Breakpoints.ClearAll();
+	ASSERT_EQ(Loop.Breakpoints.Count(), 0);
+}
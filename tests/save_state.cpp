@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "../src/6502.h"
+#include "../src/save_state.h"
+
+class M6502SaveStateTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		for (size_t i = 0; i < M6502.Memory.size(); ++i) {
+			M6502.Memory[i] = static_cast<u8>(i * 7 + (i >> 8));
+		}
+		M6502.A = 0x12;
+		M6502.X = 0x34;
+		M6502.Y = 0x56;
+		M6502.SP = 0x01F0;
+		M6502.PC = 0xC123;
+		M6502.ProcessorStatus.set(NMOS6502::N);
+		M6502.ProcessorStatus.set(NMOS6502::I);
+		M6502.ProcessorStatus.set(NMOS6502::C);
+		M6502.IRQPending = true;
+	}
+};
+
+TEST_F(M6502SaveStateTestSuite, WritesTheDocumentedLayout) {
+	std::vector<u8> File;
+	SaveState(File, M6502, 0x0123456789ull, { { DeviceTag("VIA1"), { 1, 2, 3 } } });
+	ASSERT_EQ(File.size(), 4096 + 0x10000 + 12);
+	ASSERT_EQ(std::string(File.begin(), File.begin() + 4), "M65S");
+	ASSERT_EQ(File[4], SaveStateVersion);
+	ASSERT_EQ(File[11], 0xA5); // N, the unused bit, I and C
+	ASSERT_EQ(File[14], 0x23);
+	ASSERT_EQ(File[15], 0xC1);
+	ASSERT_EQ(File[16], 2);
+	ASSERT_EQ(File[24], 0x89);
+	ASSERT_EQ(File[28], 0x01);
+	ASSERT_EQ(File[4096 + 0x1234], M6502.Memory[0x1234]);
+	ASSERT_EQ(std::string(File.end() - 12, File.end() - 8), "VIA1");
+	ASSERT_EQ(PackStatus(UnpackStatus(0xCF)), 0xEF);
+}
+
+TEST_F(M6502SaveStateTestSuite, RestoresThroughTheMapping) {
+	std::string Path = testing::TempDir() + "m6502_save_state.bin";
+	ASSERT_TRUE(SaveState(Path, M6502, 987654321, { { DeviceTag("TIMR"), { 9, 8, 7, 6, 5 } }, { DeviceTag("NONE"), {} } }));
+	SaveStateFile File;
+	ASSERT_TRUE(File.Open(Path)) << File.Error();
+	ASSERT_EQ(File.Cycles, 987654321);
+	ASSERT_EQ(File.Memory()[0xBEEF], M6502.Memory[0xBEEF]);
+	ASSERT_EQ(File.Devices.size(), 2);
+	ASSERT_EQ(File.Devices[0].Tag, DeviceTag("TIMR"));
+	ASSERT_EQ(File.Devices[0].Data, (std::vector<u8>{ 9, 8, 7, 6, 5 }));
+	ASSERT_TRUE(File.Devices[1].Data.empty());
+
+	NMOS6502 Other;
+	Other.Reset();
+	File.Restore(Other);
+	ASSERT_EQ(Other.Memory, M6502.Memory);
+	ASSERT_EQ(Other.ProcessorStatus, M6502.ProcessorStatus);
+	ASSERT_EQ(Other.PC, 0xC123);
+	ASSERT_EQ(Other.SP, 0x01F0);
+	ASSERT_EQ(Other.Y, 0x56);
+	ASSERT_TRUE(Other.IRQPending);
+	ASSERT_FALSE(Other.NMIPending);
+	File.Close();
+	std::remove(Path.c_str());
+}
+
+TEST_F(M6502SaveStateTestSuite, RejectsBadFiles) {
+	std::vector<u8> Contents;
+	SaveState(Contents, M6502, 0);
+	SaveStateFile File;
+	ASSERT_FALSE(File.Load(std::vector<u8>(Contents.begin(), Contents.end() - 1)));
+	ASSERT_EQ(File.Error(), "save-state is truncated");
+	std::vector<u8> Newer = Contents;
+	Newer[4] = SaveStateVersion + 1;
+	ASSERT_FALSE(File.Load(Newer));
+	std::vector<u8> Garbage = Contents;
+	Garbage[0] = 'X';
+	ASSERT_FALSE(File.Load(Garbage));
+	ASSERT_FALSE(File.Open(testing::TempDir() + "m6502_missing_save_state.bin"));
+	ASSERT_TRUE(File.Load(Contents));
+}
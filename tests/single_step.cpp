@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/single_step.h"
+
+/* LDA #$42 then TAX, in the vector format; the second case expects the wrong X */
+static const char* Vectors = R"([
+	{ "name": "a9 42 00", "initial": { "pc": 512, "s": 253, "a": 0, "x": 0, "y": 0, "p": 36, "ram": [ [512, 169], [513, 66] ] },
+	  "final": { "pc": 514, "s": 253, "a": 66, "x": 0, "y": 0, "p": 36, "ram": [ [512, 169], [513, 66] ] },
+	  "cycles": [ [512, 169, "read"], [513, 66, "read"] ] },
+	{ "name": "aa bad x", "initial": { "pc": 768, "s": 253, "a": 7, "x": 0, "y": 0, "p": 0, "ram": [ [768, 170] ] },
+	  "final": { "pc": 769, "s": 253, "a": 7, "x": 8, "y": 0, "p": 0, "ram": [ [768, 170] ] },
+	  "cycles": [ [768, 170, "read"], [769, 0, "read"] ], "extra": { "ignored": [1, 2.5, null, true] } }
+])";
+
+class M6502SingleStepTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	SingleStepReader Reader;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		Reader.OpenText(Vectors);
+	}
+};
+
+TEST_F(M6502SingleStepTestSuite, StreamsCases) {
+	SingleStepCase Case;
+	ASSERT_TRUE(Reader.Next(Case));
+	ASSERT_EQ(Case.Name, "a9 42 00");
+	ASSERT_EQ(Case.Initial.PC, 512);
+	ASSERT_EQ(Case.Initial.S, 253);
+	ASSERT_EQ(Case.Initial.P, 36);
+	ASSERT_EQ(Case.Initial.RAM.size(), 2);
+	ASSERT_EQ(Case.Initial.RAM[1].first, 513);
+	ASSERT_EQ(Case.Initial.RAM[1].second, 66);
+	ASSERT_EQ(Case.Final.A, 66);
+	ASSERT_EQ(Case.Cycles, 2);
+	ASSERT_TRUE(Reader.Next(Case));
+	ASSERT_EQ(Case.Name, "aa bad x");
+	ASSERT_EQ(Case.Initial.RAM.size(), 1);
+	ASSERT_FALSE(Reader.Next(Case));
+	ASSERT_TRUE(Reader.Error().empty());
+}
+
+TEST_F(M6502SingleStepTestSuite, ReportsMismatchedFields) {
+	SingleStepCase Case;
+	ASSERT_TRUE(Reader.Next(Case));
+	ASSERT_EQ(RunSingleStep(M6502, Case), 0);
+	ASSERT_EQ(M6502.Memory[512], 0); // Cleared for the next case
+	ASSERT_TRUE(Reader.Next(Case));
+	u32 Mismatch = RunSingleStep(M6502, Case);
+	ASSERT_EQ(Mismatch, 1u << StepX);
+	ASSERT_EQ(DescribeSingleStep(M6502, Case, Mismatch), "x 07 != 08");
+}
+
+TEST_F(M6502SingleStepTestSuite, RejectsMalformedInput) {
+	SingleStepCase Case;
+	Reader.OpenText(R"([ { "name": "broken", "initial": { "pc": 1, "ram": [ [1] ] } } ])");
+	ASSERT_FALSE(Reader.Next(Case));
+	ASSERT_FALSE(Reader.Error().empty());
+	Reader.OpenText("{}");
+	ASSERT_FALSE(Reader.Next(Case));
+	ASSERT_FALSE(Reader.Error().empty());
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/snapshot.h"
+
+class M6502SnapshotTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	MachineSnapshot Snapshot;
+	DirtyPageMap Dirty;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		M6502.SP = 0x01FF;
+		const u8 Program[] = {
+			0xA9, 0x42,       // 0200  LDA #$42
+			0x85, 0x10,       // 0202  STA $10
+			0x8D, 0x30, 0x00, // 0204  STA $3000
+			0x48              // 0207  PHA
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+		Snapshot.Capture(M6502);
+		M6502.DirtyPages = &Dirty;
+		for (int i = 0; i < 4; ++i) {
+			M6502.Execute(0);
+		}
+	}
+};
+
+TEST_F(M6502SnapshotTestSuite, MarksWrittenPages) {
+	ASSERT_EQ(Dirty.Count(), 3);
+	ASSERT_TRUE(Dirty.Test(0x00));
+	ASSERT_TRUE(Dirty.Test(0x01));
+	ASSERT_TRUE(Dirty.Test(0x30));
+	ASSERT_FALSE(Dirty.Test(0x02));
+}
+
+TEST_F(M6502SnapshotTestSuite, RestoresDirtyPages) {
+	Snapshot.Restore(M6502, Dirty);
+	ASSERT_EQ(Dirty.Count(), 0);
+	ASSERT_EQ(M6502.Memory[0x10], 0);
+	ASSERT_EQ(M6502.Memory[0x3000], 0);
+	ASSERT_EQ(M6502.Memory[0x01FF], 0);
+	ASSERT_EQ(M6502.A, 0);
+	ASSERT_EQ(M6502.PC, 0x0200);
+	ASSERT_EQ(M6502.SP, 0x01FF);
+	M6502.Execute(0);
+	M6502.Execute(0);
+	ASSERT_EQ(M6502.Memory[0x10], 0x42);
+}
+
+TEST_F(M6502SnapshotTestSuite, MarksRanges) {
+	Dirty.Clear();
+	Dirty.MarkRange(0x12F0, 0x20);
+	ASSERT_EQ(Dirty.Count(), 2);
+	ASSERT_TRUE(Dirty.Test(0x12));
+	ASSERT_TRUE(Dirty.Test(0x13));
+	Dirty.MarkRange(0xFFFF, 1);
+	ASSERT_TRUE(Dirty.Test(0xFF));
+	Dirty.MarkRange(0x4000, 0);
+	ASSERT_EQ(Dirty.Count(), 3);
+}
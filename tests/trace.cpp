@@ -0,0 +1,254 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include "../src/6502.h"
+#include "../src/compression.h"
+#include "../src/trace.h"
+
+class M6502TraceTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	TraceWriter Tracer;
+	std::string Path;
+
+	virtual void SetUp() {
+		Path = testing::TempDir() + "m6502_trace_" + testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin"; // Tests run in parallel under ctest
+		M6502.Reset();
+		M6502.ProcessorStatus.reset(); // Reset leaves the flags alone
+		M6502.PC = 0x0200;
+		const u8 Program[] = {
+			0xA2, 0x00,       // 0200  LDX #$00
+			0xB5, 0x10,       // 0202  LDA $10,X
+			0x95, 0x20,       // 0204  STA $20,X
+			0xE8,             // 0206  INX
+			0xEA,             // 0207  NOP
+			0xEA,             // 0208  NOP
+			0xE0, 0x10,       // 0209  CPX #$10
+			0xD0, 0xF7,       // 020B  BNE back to $0202
+			0x4C, 0x00, 0x02  // 020D  JMP $0200
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+		for (u8 i = 0; i < 0x10; ++i) {
+			M6502.Memory[0x10 + i] = i * 7;
+		}
+	}
+
+	virtual void TearDown() {
+		M6502.Tracer = nullptr;
+		std::remove(Path.c_str());
+	}
+
+	/* Runs the program with the tracer attached and returns the expected records, optionally changing its input at Diverge */
+	std::vector<TraceRecord> Record(u32 Instructions, u32 Diverge = 0xFFFFFFFF) {
+		std::vector<TraceRecord> Expected;
+		u64 Clock = 0;
+		M6502.Tracer = &Tracer;
+		for (u32 i = 0; i < Instructions; ++i) {
+			if (i == Diverge) {
+				M6502.Memory[0x1F] = 0xFF;
+			}
+			u16 Operand = static_cast<u16>(M6502.PC + OperandOffset(M6502.Memory[M6502.PC]));
+			Expected.push_back(TraceRecord{ Clock, M6502.PC, M6502.SP, M6502.Memory[M6502.PC],
+				{ M6502.Memory[Operand], M6502.Memory[static_cast<u16>(Operand + 1)] },
+				M6502.A, M6502.X, M6502.Y, static_cast<u8>(M6502.ProcessorStatus.to_ulong()) });
+			u8 Length = InstructionLength(Expected.back().Opcode);
+			if (Length < 3) Expected.back().Operands[1] = 0;
+			if (Length < 2) Expected.back().Operands[0] = 0;
+			Clock += M6502.Execute(0);
+		}
+		M6502.Tracer = nullptr;
+		Tracer.Close();
+		return Expected;
+	}
+};
+
+TEST_F(M6502TraceTestSuite, RoundTrip) {
+	ASSERT_TRUE(Tracer.Open(Path, 64, 2));
+	std::vector<TraceRecord> Expected = Record(10000);
+	ASSERT_EQ(Tracer.Records, 10000);
+
+	TraceReader Reader;
+	ASSERT_TRUE(Reader.Open(Path));
+	ASSERT_EQ(Reader.RecordsPerBlock, 64);
+	TraceRecord Actual;
+	for (const TraceRecord& Record : Expected) {
+		ASSERT_TRUE(Reader.Next(Actual));
+		ASSERT_EQ(Actual, Record);
+	}
+	ASSERT_FALSE(Reader.Next(Actual));
+	ASSERT_TRUE(Reader.Error.empty());
+}
+
+TEST_F(M6502TraceTestSuite, CompactBlocks) {
+	ASSERT_TRUE(Tracer.Open(Path, 4096, 4));
+	Record(100000);
+
+	TraceReader Reader;
+	ASSERT_TRUE(Reader.Open(Path));
+	TraceReader::Block Header;
+	u64 Records = 0, Raw = 0, Stored = 0, Blocks = 0;
+	while (Reader.NextBlock(Header)) {
+		Records += Header.Records;
+		Raw += Header.RawSize;
+		Stored += Header.StoredSize;
+		++Blocks;
+	}
+	ASSERT_EQ(Records, 100000);
+	ASSERT_EQ(Blocks, 25);
+	ASSERT_LT(Raw, Records * 6); // Delta encoding
+	ASSERT_LT(Stored, Raw / 4); // The loop compresses well
+}
+
+TEST_F(M6502TraceTestSuite, IdenticalRunsHaveIdenticalBlocks) {
+	std::string SecondPath = Path + ".2";
+	ASSERT_TRUE(Tracer.Open(Path, 256, 4));
+	Record(5000);
+	SetUp();
+	ASSERT_TRUE(Tracer.Open(SecondPath, 256, 4));
+	Record(5000, 300);
+
+	TraceReader First, Second;
+	ASSERT_TRUE(First.Open(Path));
+	ASSERT_TRUE(Second.Open(SecondPath));
+	TraceReader::Block L, R;
+	ASSERT_TRUE(First.NextBlock(L));
+	ASSERT_TRUE(Second.NextBlock(R));
+	ASSERT_EQ(L.Hash, R.Hash);
+	ASSERT_TRUE(First.NextBlock(L));
+	ASSERT_TRUE(Second.NextBlock(R));
+	ASSERT_NE(L.Hash, R.Hash);
+	Second.Close();
+	std::remove(SecondPath.c_str());
+}
+
+TEST_F(M6502TraceTestSuite, FindDivergence) {
+	std::string SecondPath = Path + ".2";
+	ASSERT_TRUE(Tracer.Open(Path, 256, 4));
+	std::vector<TraceRecord> First = Record(20000);
+	SetUp();
+	ASSERT_TRUE(Tracer.Open(SecondPath, 256, 4));
+	std::vector<TraceRecord> Second = Record(20000, 15000);
+	u64 Expected = std::mismatch(First.begin(), First.end(), Second.begin()).first - First.begin();
+	ASSERT_GT(Expected, 15000);
+
+	TraceReader Left, Right;
+	ASSERT_TRUE(Left.Open(Path));
+	ASSERT_TRUE(Right.Open(SecondPath));
+	TraceDivergence Result;
+	ASSERT_TRUE(FindDivergence(Left, Right, 4, Result));
+	ASSERT_TRUE(Result.Differs);
+	ASSERT_EQ(Result.Index, Expected);
+	ASSERT_EQ(Result.SkippedBlocks, Expected / 256);
+	ASSERT_EQ(Result.DecodedBlocks, 1);
+	ASSERT_EQ(Result.First, Expected - 4);
+	ASSERT_EQ(Result.Left, std::vector<TraceRecord>(First.begin() + Expected - 4, First.begin() + Expected + 5));
+	ASSERT_EQ(Result.Right, std::vector<TraceRecord>(Second.begin() + Expected - 4, Second.begin() + Expected + 5));
+
+	/* Traces with different block sizes are compared record by record */
+	ASSERT_TRUE(Tracer.Open(Path, 100, 4));
+	SetUp();
+	Record(20000);
+	ASSERT_TRUE(Left.Open(Path));
+	ASSERT_TRUE(Right.Open(SecondPath));
+	ASSERT_TRUE(FindDivergence(Left, Right, 4, Result));
+	ASSERT_TRUE(Result.Differs);
+	ASSERT_EQ(Result.Index, Expected);
+	ASSERT_EQ(Result.SkippedBlocks, 0);
+	ASSERT_EQ(Result.Left, std::vector<TraceRecord>(First.begin() + Expected - 4, First.begin() + Expected + 5));
+	ASSERT_EQ(Result.Right, std::vector<TraceRecord>(Second.begin() + Expected - 4, Second.begin() + Expected + 5));
+	Right.Close();
+	std::remove(SecondPath.c_str());
+}
+
+TEST_F(M6502TraceTestSuite, FindDivergenceAtEnd) {
+	std::string SecondPath = Path + ".2";
+	ASSERT_TRUE(Tracer.Open(Path, 256, 4));
+	Record(1000);
+	SetUp();
+	ASSERT_TRUE(Tracer.Open(SecondPath, 256, 4));
+	Record(1000);
+
+	TraceReader Left, Right;
+	TraceDivergence Result;
+	ASSERT_TRUE(Left.Open(Path));
+	ASSERT_TRUE(Right.Open(SecondPath));
+	ASSERT_TRUE(FindDivergence(Left, Right, 4, Result));
+	ASSERT_FALSE(Result.Differs);
+	ASSERT_EQ(Result.Index, 1000);
+	ASSERT_EQ(Result.SkippedBlocks, 4);
+
+	/* A longer run matches up to where the shorter one ends */
+	SetUp();
+	ASSERT_TRUE(Tracer.Open(SecondPath, 256, 4));
+	Record(1010);
+	ASSERT_TRUE(Left.Open(Path));
+	ASSERT_TRUE(Right.Open(SecondPath));
+	ASSERT_TRUE(FindDivergence(Left, Right, 4, Result));
+	ASSERT_TRUE(Result.Differs);
+	ASSERT_EQ(Result.Index, 1000);
+	ASSERT_EQ(Result.Left.size(), 4);
+	ASSERT_EQ(Result.Right.size(), 9);
+	Right.Close();
+	std::remove(SecondPath.c_str());
+}
+
+TEST_F(M6502TraceTestSuite, RejectsCorruptFiles) {
+	ASSERT_TRUE(Tracer.Open(Path, 64, 2));
+	Record(1000);
+	std::FILE* File = std::fopen(Path.c_str(), "r+b");
+	ASSERT_NE(File, nullptr);
+	std::fseek(File, TraceFileHeaderSize + TraceBlockHeaderSize + 3, SEEK_SET);
+	std::fputc(0x5A, File);
+	std::fclose(File);
+
+	TraceReader Reader;
+	ASSERT_TRUE(Reader.Open(Path));
+	TraceRecord Actual;
+	while (Reader.Next(Actual)) {
+	}
+	ASSERT_FALSE(Reader.Error.empty());
+
+	ASSERT_TRUE(Tracer.Open(Path, 64, 2));
+	Record(100);
+	File = std::fopen(Path.c_str(), "r+b");
+	ASSERT_NE(File, nullptr);
+	std::fseek(File, TraceFileHeaderSize, SEEK_SET);
+	const u8 Records[4] = { 0xFF, 0xFF, 0xFF, 0x7F }; // Would ask for gigabytes of records
+	std::fwrite(Records, 1, sizeof(Records), File);
+	std::fclose(File);
+	TraceReader Oversized;
+	ASSERT_TRUE(Oversized.Open(Path));
+	ASSERT_FALSE(Oversized.Next(Actual));
+	ASSERT_EQ(Oversized.Error, "corrupt block header");
+
+	TraceReader Missing;
+	ASSERT_FALSE(Missing.Open(Path + ".missing"));
+}
+
+TEST(M6502CompressionTestSuite, RoundTrip) {
+	std::mt19937 Random(6502);
+	std::vector<u8> Patterns[3];
+	for (int i = 0; i < 50000; ++i) {
+		Patterns[0].push_back(static_cast<u8>(Random()));
+		Patterns[1].push_back(static_cast<u8>(i % 37 == 0 ? Random() : i & 0x0F));
+	}
+	Patterns[2].assign(70000, 0xAA);
+
+	for (const std::vector<u8>& Input : Patterns) {
+		std::vector<u8> Compressed(Input.size() + Input.size() / 2 + 16);
+		size_t Size = CompressBlock(Input.data(), Input.size(), Compressed.data(), Compressed.size());
+		ASSERT_NE(Size, 0);
+		std::vector<u8> Output(Input.size());
+		ASSERT_TRUE(DecompressBlock(Compressed.data(), Size, Output.data(), Output.size()));
+		ASSERT_EQ(Output, Input);
+		if (&Input != &Patterns[0]) {
+			ASSERT_LT(Size, Input.size() / 4);
+		}
+		/* Truncated input must be rejected rather than read past */
+		ASSERT_FALSE(DecompressBlock(Compressed.data(), Size / 2, Output.data(), Output.size()));
+	}
+
+	/* Does not fit */
+	u8 Small[4];
+	ASSERT_EQ(CompressBlock(Patterns[0].data(), Patterns[0].size(), Small, sizeof(Small)), 0);
+}
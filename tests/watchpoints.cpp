@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+#include "../src/6502.h"
+#include "../src/run_loop.h"
+#include "../src/watchpoints.h"
+
+class M6502WatchpointTestSuite : public testing::Test {
+public:
+	NMOS6502 M6502;
+	WatchpointMap Watchpoints;
+
+	virtual void SetUp() {
+		M6502.Reset();
+		M6502.PC = 0x0200;
+		M6502.SP = 0x01FF;
+		const u8 Program[] = {
+			0xA9, 0x42,       // 0200  LDA #$42
+			0x85, 0x10,       // 0202  STA $10
+			0xE6, 0x10,       // 0204  INC $10
+			0xAD, 0xD0, 0x12, // 0206  LDA $D012
+			0x85, 0x11,       // 0209  STA $11
+			0x48,             // 020B  PHA
+			0x4C, 0x0C, 0x02  // 020C  JMP $020C
+		};
+		std::copy(std::begin(Program), std::end(Program), M6502.Memory.begin() + 0x0200);
+		M6502.Memory[0xD012] = 0x7F;
+		M6502.Watchpoints = &Watchpoints;
+	}
+};
+
+TEST_F(M6502WatchpointTestSuite, RecordsZeroPageWrites) {
+	Watchpoints.Add(0x10, WatchWrite);
+	for (int i = 0; i < 6; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_EQ(Watchpoints.Hits.size(), 2);
+	ASSERT_EQ(Watchpoints.Hits[0].Instruction, 0x0202);
+	ASSERT_EQ(Watchpoints.Hits[0].Kind, WatchWrite);
+	ASSERT_EQ(Watchpoints.Hits[0].Old, 0x00);
+	ASSERT_EQ(Watchpoints.Hits[0].Value, 0x42);
+	ASSERT_EQ(Watchpoints.Hits[1].Instruction, 0x0204); // INC is settled after the instruction
+	ASSERT_EQ(Watchpoints.Hits[1].Old, 0x42);
+	ASSERT_EQ(Watchpoints.Hits[1].Value, 0x43);
+}
+
+TEST_F(M6502WatchpointTestSuite, RecordsDeviceReads) {
+	Watchpoints.Add(0xD012, WatchRead);
+	for (int i = 0; i < 6; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_EQ(Watchpoints.Hits.size(), 1);
+	ASSERT_EQ(Watchpoints.Hits[0].Address, 0xD012);
+	ASSERT_EQ(Watchpoints.Hits[0].Instruction, 0x0206);
+	ASSERT_EQ(Watchpoints.Hits[0].Value, 0x7F);
+}
+
+TEST_F(M6502WatchpointTestSuite, IgnoresNeighboursOnWatchedPages) {
+	Watchpoints.Add(0x12, WatchAccess);
+	Watchpoints.Add(0x0200, WatchRead, 0x10); // Fetches are not data reads
+	for (int i = 0; i < 6; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_TRUE(Watchpoints.Hits.empty());
+	ASSERT_EQ(Watchpoints.Pages[0x00], WatchAccess);
+	Watchpoints.Remove(0x12);
+	ASSERT_EQ(Watchpoints.Pages[0x00], 0);
+	ASSERT_EQ(Watchpoints.Pages[0x02], WatchRead);
+}
+
+TEST_F(M6502WatchpointTestSuite, StopsTheDebugLoop) {
+	Watchpoints.Add(0x01FF, WatchWrite); // The PHA push
+	RunLoop Loop(M6502);
+	ASSERT_EQ(Loop.Run(1000).Stop, RunBudgetSpent); // The fast loop never looks
+	ASSERT_EQ(Watchpoints.Hits.size(), 1);
+	M6502.PC = 0x0200;
+	M6502.SP = 0x01FF;
+	Watchpoints.ClearHits();
+	Loop.Mode = RunDebugBlock;
+	RunResult Result = Loop.Run(1000);
+	ASSERT_EQ(Result.Stop, RunWatchpoint);
+	ASSERT_EQ(Result.Instructions, 6);
+	ASSERT_EQ(M6502.PC, 0x020C);
+}
+
+TEST_F(M6502WatchpointTestSuite, BoundsRangesAndHits) {
+	Watchpoints.Add(0xFF00, WatchWrite, 0xFFFFFFFF);
+	ASSERT_EQ(Watchpoints.Pages[0xFF], WatchWrite);
+	Watchpoints.Remove(0xFF00, WatchWrite, 0xFFFFFFFF); // Would wrap to an empty page range
+	ASSERT_EQ(Watchpoints.Pages[0xFF], 0);
+
+	Watchpoints.Add(0x10, WatchWrite);
+	M6502.Memory[0x0206] = 0x4C; // JMP $0204 after the INC, so it runs forever
+	M6502.Memory[0x0207] = 0x04;
+	M6502.Memory[0x0208] = 0x02;
+	for (int i = 0; i < 20000; ++i) {
+		M6502.Execute(0);
+	}
+	ASSERT_LE(Watchpoints.Hits.size(), WatchpointMap::MaxHits);
+	ASSERT_EQ(Watchpoints.Recorded, 10000u);
+	ASSERT_EQ(Watchpoints.Hits.back().Old, static_cast<u8>(0x42 + 9998)); // The latest INC is kept
+	ASSERT_EQ(Watchpoints.Hits.back().Value, static_cast<u8>(0x42 + 9999));
+}
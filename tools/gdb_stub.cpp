@@ -0,0 +1,174 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../src/gdb_stub.h"
+
+/*
+	Serves a raw 6502 image to GDB over a Unix socket or stdin/stdout. The image is loaded and
+	started at the origin, and the guest waits stopped for the first connection. After a detach
+	it runs the fast loop, with no breakpoint checks, until the next connection on a socket, or
+	for the --cycles budget on stdio and then exits. The tool is built on the plain core so the
+	detached guest pays nothing for debugging; Z2-Z4 get an empty reply and GDB falls back to
+	single-stepping for watchpoints. From GDB: target remote /path/to/socket, or
+	target remote | gdb-stub --stdio image.
+	Usage: gdb-stub (--socket path | --stdio) [--origin hex] [--cycles N] image
+*/
+
+static bool WriteAll(int Out, const std::string& Data) {
+	for (size_t Done = 0; Done < Data.size();) {
+		ssize_t Written = write(Out, Data.data() + Done, Data.size() - Done);
+		if (Written < 0 && errno != EINTR) {
+			return false;
+		}
+		Done += Written > 0 ? Written : 0;
+	}
+	return true;
+}
+
+/* One GDB session; returns when it detaches, kills the target or hangs up */
+static void Serve(GdbStub& Stub, int In, int Out) {
+	Stub.Attach();
+	std::string Early; // Read while polling for ^C during a continue, still to be received
+	Stub.Interrupted = [In, &Early] {
+		pollfd Poll = { In, POLLIN, 0 };
+		char Byte = 0;
+		while (poll(&Poll, 1, 0) > 0 && read(In, &Byte, 1) == 1) {
+			if (Byte == '\x03') {
+				return true;
+			}
+			Early += Byte;
+		}
+		return false;
+	};
+	char Buffer[4096];
+	std::vector<std::string> Packets;
+	std::string Acks;
+	while (Stub.Attached && !Stub.Killed) {
+		ssize_t Length;
+		if (!Early.empty()) {
+			Length = static_cast<ssize_t>(std::min(Early.size(), sizeof(Buffer)));
+			std::memcpy(Buffer, Early.data(), Length);
+			Early.erase(0, Length);
+		}
+		else {
+			Length = read(In, Buffer, sizeof(Buffer));
+		}
+		if (Length <= 0) {
+			if (Length < 0 && errno == EINTR) {
+				continue;
+			}
+			Stub.Detach();
+			break;
+		}
+		Packets.clear();
+		Acks.clear();
+		Stub.Receive(Buffer, static_cast<size_t>(Length), Packets, Acks);
+		bool Connected = WriteAll(Out, Acks); // Packets from a client that has hung up still count
+		for (const std::string& Packet : Packets) {
+			std::string Reply = Stub.Handle(Packet);
+			if (Stub.Killed) {
+				break;
+			}
+			Connected = Connected && WriteAll(Out, GdbStub::Frame(Reply));
+		}
+		if (!Connected) {
+			Stub.Detach();
+			break;
+		}
+	}
+	Stub.Interrupted = nullptr;
+}
+
+int main(int argc, char** argv) {
+	const char* SocketPath = nullptr;
+	const char* Path = nullptr;
+	bool Stdio = false;
+	u16 Origin = 0x0200;
+	u64 Cycles = 0; // Budget after a detach; zero is unlimited on a socket
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+			SocketPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--stdio") == 0) {
+			Stdio = true;
+		}
+		else if (std::strcmp(argv[i], "--origin") == 0 && i + 1 < argc) {
+			Origin = static_cast<u16>(std::strtoul(argv[++i], nullptr, 16));
+		}
+		else if (std::strcmp(argv[i], "--cycles") == 0 && i + 1 < argc) {
+			Cycles = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (argv[i][0] != '-' && !Path) {
+			Path = argv[i];
+		}
+		else {
+			Path = nullptr;
+			break;
+		}
+	}
+	if (!Path || Stdio == (SocketPath != nullptr)) {
+		std::fprintf(stderr, "usage: %s (--socket path | --stdio) [--origin hex] [--cycles N] image\n", argv[0]);
+		return 2;
+	}
+	std::ifstream File(Path, std::ios::binary);
+	std::vector<char> Image((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	if ((!File.good() && !File.eof()) || Image.empty()) {
+		std::fprintf(stderr, "cannot read %s\n", Path);
+		return 2;
+	}
+
+	std::signal(SIGPIPE, SIG_IGN); // A client hanging up ends its session, not the stub
+	NMOS6502 M6502;
+	M6502.Reset();
+	std::memcpy(&M6502.Memory[Origin], Image.data(), std::min<size_t>(Image.size(), 0x10000 - Origin));
+	M6502.PC = Origin;
+	M6502.SP = 0x01FF;
+	GdbStub Stub(M6502);
+	RunLoop Fast(M6502);
+
+	if (Stdio) {
+		Serve(Stub, STDIN_FILENO, STDOUT_FILENO);
+		for (u64 Spent = 0; !Stub.Killed && Spent < Cycles;) {
+			Spent += Fast.Run(Cycles - Spent).Cycles;
+		}
+		return 0;
+	}
+
+	int Listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un Address = {};
+	Address.sun_family = AF_UNIX;
+	std::strncpy(Address.sun_path, SocketPath, sizeof(Address.sun_path) - 1);
+	unlink(SocketPath);
+	if (Listener < 0 || bind(Listener, reinterpret_cast<sockaddr*>(&Address), sizeof(Address)) != 0 || listen(Listener, 1) != 0) {
+		std::fprintf(stderr, "cannot listen on %s: %s\n", SocketPath, std::strerror(errno));
+		return 2;
+	}
+	bool Running = false; // Stopped until the first session, then free-running between sessions
+	u64 Spent = 0;
+	while (!Stub.Killed) {
+		pollfd Poll = { Listener, POLLIN, 0 };
+		if (poll(&Poll, 1, Running ? 0 : -1) > 0) {
+			int Client = accept(Listener, nullptr, nullptr);
+			if (Client >= 0) {
+				Serve(Stub, Client, Client);
+				close(Client);
+				Running = true;
+			}
+		}
+		else if (Running) {
+			Spent += Fast.Run(Stub.Slice).Cycles;
+			Running = !Cycles || Spent < Cycles;
+		}
+	}
+	close(Listener);
+	unlink(SocketPath);
+	return 0;
+}
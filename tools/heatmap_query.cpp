@@ -0,0 +1,44 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "../src/memory_heatmap.h"
+
+/*
+	Inspects a heatmap saved with MemoryHeatmap::Save.
+	Usage: heatmap-query <heatmap> [--csv | --pages | address...]
+	Addresses are hexadecimal and print their counters and the instruction that last wrote them.
+*/
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		std::fprintf(stderr, "usage: %s <heatmap> [--csv | --pages | address...]\n", argv[0]);
+		return 2;
+	}
+	std::ifstream File(argv[1], std::ios::binary);
+	MemoryHeatmap Heatmap;
+	if (!File || !Heatmap.Load(File)) {
+		std::fprintf(stderr, "%s is not a heatmap file\n", argv[1]);
+		return 1;
+	}
+	if (argc == 2 || std::strcmp(argv[2], "--pages") == 0) {
+		Heatmap.WritePageCSV(std::cout);
+		return 0;
+	}
+	if (std::strcmp(argv[2], "--csv") == 0) {
+		Heatmap.WriteCSV(std::cout);
+		return 0;
+	}
+	for (int i = 2; i < argc; ++i) {
+		const char* Text = argv[i][0] == '$' ? argv[i] + 1 : argv[i];
+		uint16_t Address = static_cast<uint16_t>(std::strtoul(Text, nullptr, 16));
+		std::printf("$%04X  reads %llu  writes %llu  executes %llu", Address, static_cast<unsigned long long>(Heatmap.Reads[Address]),
+			static_cast<unsigned long long>(Heatmap.Writes[Address]), static_cast<unsigned long long>(Heatmap.Executes[Address]));
+		if (std::optional<uint16_t> Writer = Heatmap.WhoWrote(Address)) {
+			std::printf("  last written by $%04X", *Writer);
+		}
+		std::printf("\n");
+	}
+	return 0;
+}
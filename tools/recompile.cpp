@@ -0,0 +1,73 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include "../src/recompiler.h"
+
+/*
+	Translates a raw 6502 image into a C++ source file defining a RecompiledProgram, to be
+	compiled into the host and run with RecompiledRun. Code is discovered from the origin and
+	every --entry; reach code only jumped to indirectly (vectors, JMP (ind) tables) by naming it
+	with --entry, or leave it to the interpreter. Writes to stdout without --output.
+	Usage: 6502-recompile [--origin hex] [--entry hex]... [--name Name] [--output file.cpp] image
+*/
+
+int main(int argc, char** argv) {
+	u16 Origin = 0x0200;
+	std::vector<u16> Entries;
+	const char* Name = "Recompiled";
+	const char* Output = nullptr;
+	const char* Path = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--origin") == 0 && i + 1 < argc) {
+			Origin = static_cast<u16>(std::strtoul(argv[++i], nullptr, 16));
+		}
+		else if (std::strcmp(argv[i], "--entry") == 0 && i + 1 < argc) {
+			Entries.push_back(static_cast<u16>(std::strtoul(argv[++i], nullptr, 16)));
+		}
+		else if (std::strcmp(argv[i], "--name") == 0 && i + 1 < argc) {
+			Name = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			Output = argv[++i];
+		}
+		else if (argv[i][0] != '-' && !Path) {
+			Path = argv[i];
+		}
+		else {
+			Path = nullptr;
+			break;
+		}
+	}
+	if (!Path) {
+		std::fprintf(stderr, "usage: %s [--origin hex] [--entry hex]... [--name Name] [--output file.cpp] image\n", argv[0]);
+		return 2;
+	}
+	std::ifstream File(Path, std::ios::binary);
+	std::vector<u8> Image((std::istreambuf_iterator<char>(File)), std::istreambuf_iterator<char>());
+	if ((!File.good() && !File.eof()) || Image.empty()) {
+		std::fprintf(stderr, "cannot read %s\n", Path);
+		return 2;
+	}
+	Image.resize(std::min<size_t>(Image.size(), 0x10000 - Origin));
+
+	StaticRecompiler Recompiler(Image, Origin);
+	Recompiler.Entries.insert(Recompiler.Entries.end(), Entries.begin(), Entries.end());
+	Recompiler.Recover();
+	std::string Source = Recompiler.Emit(Name);
+
+	if (!Output) {
+		std::fwrite(Source.data(), 1, Source.size(), stdout);
+		return 0;
+	}
+	std::ofstream Out(Output, std::ios::binary);
+	Out << Source;
+	if (!Out.good()) {
+		std::fprintf(stderr, "cannot write %s\n", Output);
+		return 2;
+	}
+	std::fprintf(stderr, "%zu blocks from %zu bytes at $%04X\n", Recompiler.Blocks.size(), Image.size(), Origin);
+	return 0;
+}
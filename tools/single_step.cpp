@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/opcodes.h"
+#include "../src/single_step.h"
+
+/*
+	Runs SingleStepTests/ProcessorTests JSON vectors against the core and reports mismatches
+	per opcode. Arguments are vector files or directories of them (one "xx.json" per opcode);
+	files are shared out to worker threads, each streaming its file case by case into its own core.
+	Usage: single-step [--threads N] [--limit cases-per-file] [--verbose] path...
+	Exit code 0 when every case passed, 1 on mismatches, 2 on unreadable or malformed input.
+*/
+
+struct FileReport {
+	std::string Path;
+	int Opcode = -1; // From the file name, or the first case when the name is not hex
+	u64 Cases = 0;
+	u64 Failed = 0;
+	u64 Fields[SingleStepFieldCount] = {};
+	std::string FirstName, FirstDetail, Error;
+};
+
+static int OpcodeFromName(const std::filesystem::path& Path) {
+	std::string Stem = Path.stem().string();
+	char* End;
+	long Value = std::strtol(Stem.c_str(), &End, 16);
+	return Stem.size() == 2 && *End == '\0' ? static_cast<int>(Value) : -1;
+}
+
+static void RunFile(FileReport& Report, u64 Limit) {
+	SingleStepReader Reader;
+	if (!Reader.Open(Report.Path)) {
+		Report.Error = Reader.Error();
+		return;
+	}
+	NMOS6502 M6502;
+	M6502.Reset();
+	std::memset(M6502.Memory.data(), 0, M6502.Memory.size());
+	SingleStepCase Case;
+	while ((!Limit || Report.Cases < Limit) && Reader.Next(Case)) {
+		if (Report.Opcode < 0) {
+			for (const auto& [Address, Value] : Case.Initial.RAM) {
+				if (Address == Case.Initial.PC) {
+					Report.Opcode = Value;
+				}
+			}
+		}
+		++Report.Cases;
+		u32 Mismatch = RunSingleStep(M6502, Case);
+		if (!Mismatch) {
+			continue;
+		}
+		if (!Report.Failed) {
+			Report.FirstName = Case.Name;
+			Report.FirstDetail = DescribeSingleStep(M6502, Case, Mismatch);
+		}
+		++Report.Failed;
+		for (int Field = 0; Field < SingleStepFieldCount; ++Field) {
+			Report.Fields[Field] += (Mismatch >> Field) & 1;
+		}
+	}
+	Report.Error = Reader.Error();
+}
+
+int main(int argc, char** argv) {
+	unsigned Threads = std::max(1u, std::thread::hardware_concurrency());
+	u64 Limit = 0;
+	bool Verbose = false;
+	std::vector<FileReport> Reports;
+	auto Add = [&Reports](const std::filesystem::path& Path) {
+		FileReport& Report = Reports.emplace_back();
+		Report.Path = Path.string();
+		Report.Opcode = OpcodeFromName(Path);
+	};
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			Threads = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+			Limit = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--verbose") == 0) {
+			Verbose = true;
+		}
+		else if (std::filesystem::is_directory(argv[i])) {
+			for (const auto& Entry : std::filesystem::directory_iterator(argv[i])) {
+				if (Entry.path().extension() == ".json") {
+					Add(Entry.path());
+				}
+			}
+		}
+		else if (argv[i][0] != '-') {
+			Add(argv[i]);
+		}
+		else {
+			Reports.clear();
+			break;
+		}
+	}
+	if (Reports.empty()) {
+		std::fprintf(stderr, "usage: %s [--threads N] [--limit cases-per-file] [--verbose] path...\n", argv[0]);
+		return 2;
+	}
+
+	/* Biggest files first so one large opcode does not finish last on its own */
+	std::sort(Reports.begin(), Reports.end(), [](const FileReport& Left, const FileReport& Right) {
+		std::error_code Ignored;
+		return std::filesystem::file_size(Left.Path, Ignored) > std::filesystem::file_size(Right.Path, Ignored);
+	});
+	auto Start = std::chrono::steady_clock::now();
+	std::atomic<size_t> Next{ 0 };
+	std::vector<std::thread> Workers;
+	for (unsigned Thread = 0; Thread < std::min<size_t>(Threads, Reports.size()); ++Thread) {
+		Workers.emplace_back([&] {
+			for (size_t Index; (Index = Next.fetch_add(1)) < Reports.size();) {
+				RunFile(Reports[Index], Limit);
+			}
+		});
+	}
+	for (std::thread& Worker : Workers) {
+		Worker.join();
+	}
+	double Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+
+	std::sort(Reports.begin(), Reports.end(), [](const FileReport& Left, const FileReport& Right) {
+		return Left.Opcode != Right.Opcode ? Left.Opcode < Right.Opcode : Left.Path < Right.Path;
+	});
+	u64 Cases = 0, Failed = 0;
+	int FailedOpcodes = 0;
+	bool Malformed = false;
+	for (const FileReport& Report : Reports) {
+		Cases += Report.Cases;
+		Failed += Report.Failed;
+		FailedOpcodes += Report.Failed != 0;
+		Malformed |= !Report.Error.empty();
+		if (!Report.Failed && Report.Error.empty() && !Verbose) {
+			continue;
+		}
+		if (Report.Opcode >= 0) {
+			const OpcodeInfo& Info = OpcodeTable[Report.Opcode];
+			std::printf("%02X %s %-11s", Report.Opcode, Info.Mnemonic, AddressingModeNames[Info.Mode]);
+		}
+		else {
+			std::printf("%-18s", "??");
+		}
+		std::printf(" %7llu/%-7llu failed", static_cast<unsigned long long>(Report.Failed), static_cast<unsigned long long>(Report.Cases));
+		for (int Field = 0; Field < SingleStepFieldCount; ++Field) {
+			if (Report.Fields[Field]) {
+				std::printf(" %s:%llu", SingleStepFieldNames[Field], static_cast<unsigned long long>(Report.Fields[Field]));
+			}
+		}
+		std::printf("\n");
+		if (Report.Failed) {
+			std::printf("   first \"%s\": %s\n", Report.FirstName.c_str(), Report.FirstDetail.c_str());
+		}
+		if (!Report.Error.empty()) {
+			std::printf("   %s: %s\n", Report.Path.c_str(), Report.Error.c_str());
+		}
+	}
+	std::printf("%zu files, %llu cases, %llu failed across %d opcodes, %.2f s (%.0f cases/s)\n", Reports.size(),
+		static_cast<unsigned long long>(Cases), static_cast<unsigned long long>(Failed), FailedOpcodes, Seconds, Seconds > 0 ? Cases / Seconds : 0.0);
+	return Malformed ? 2 : Failed ? 1 : 0;
+}
@@ -0,0 +1,63 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../src/trace.h"
+
+/*
+	Turns a binary execution trace back into a readable listing.
+	Usage: trace-decode [--blocks] <trace> [first record [count]]
+*/
+
+int main(int argc, char** argv) {
+	bool Blocks = argc > 1 && std::strcmp(argv[1], "--blocks") == 0;
+	int Argument = Blocks ? 2 : 1;
+	if (argc <= Argument) {
+		std::fprintf(stderr, "usage: %s [--blocks] <trace> [first record [count]]\n", argv[0]);
+		return 2;
+	}
+	TraceReader Reader;
+	if (!Reader.Open(argv[Argument])) {
+		std::fprintf(stderr, "%s\n", Reader.Error.c_str());
+		return 1;
+	}
+
+	if (Blocks) {
+		TraceReader::Block Header;
+		u64 Records = 0, Raw = 0, Stored = 0;
+		std::printf("   Block      Records   Raw bytes  Stored bytes  Hash\n");
+		for (u64 Index = 0; Reader.NextBlock(Header); ++Index) {
+			std::printf("%8llu %12u %11u %13u  %016llX\n", static_cast<unsigned long long>(Index), Header.Records, Header.RawSize,
+				Header.StoredSize, static_cast<unsigned long long>(Header.Hash));
+			Records += Header.Records;
+			Raw += Header.RawSize;
+			Stored += Header.StoredSize;
+		}
+		std::printf("%llu records, %.2f raw bytes/record, %.2f stored bytes/record\n", static_cast<unsigned long long>(Records),
+			Records ? static_cast<double>(Raw) / Records : 0.0, Records ? static_cast<double>(Stored) / Records : 0.0);
+		return Reader.Error.empty() ? 0 : 1;
+	}
+
+	u64 First = argc > Argument + 1 ? std::strtoull(argv[Argument + 1], nullptr, 0) : 0;
+	u64 Count = argc > Argument + 2 ? std::strtoull(argv[Argument + 2], nullptr, 0) : ~0ull;
+
+	/* Skip whole blocks without decoding them */
+	TraceReader::Block Header;
+	u64 Index = 0;
+	while (Reader.RecordsPerBlock != 0 && First - Index >= Reader.RecordsPerBlock && Reader.NextBlock(Header)) {
+		Index += Header.Records;
+	}
+
+	TraceRecord Record;
+	while (Count != 0 && Reader.Next(Record)) {
+		if (Index++ < First) {
+			continue;
+		}
+		std::printf("%s\n", FormatTraceRecord(Record).c_str());
+		--Count;
+	}
+	if (!Reader.Error.empty()) {
+		std::fprintf(stderr, "%s\n", Reader.Error.c_str());
+		return 1;
+	}
+	return 0;
+}
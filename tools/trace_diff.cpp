@@ -0,0 +1,81 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "../src/trace.h"
+
+/*
+	Finds the first record where two binary execution traces differ and prints the records around it.
+	Usage: trace-diff [--context N] <left trace> <right trace>
+	Exits with 0 when the traces match, 1 when they differ and 2 on errors.
+*/
+
+static std::string Differences(const TraceRecord& L, const TraceRecord& R) {
+	std::string Fields;
+	auto Check = [&Fields](bool Differs, const char* Name) {
+		if (Differs) {
+			Fields += Fields.empty() ? Name : std::string(" ") + Name;
+		}
+	};
+	Check(L.Cycle != R.Cycle, "cycle");
+	Check(L.PC != R.PC, "PC");
+	Check(L.Opcode != R.Opcode || L.Operands[0] != R.Operands[0] || L.Operands[1] != R.Operands[1], "instruction");
+	Check(L.A != R.A, "A");
+	Check(L.X != R.X, "X");
+	Check(L.Y != R.Y, "Y");
+	Check(L.SP != R.SP, "SP");
+	Check(L.P != R.P, "P");
+	return Fields;
+}
+
+int main(int argc, char** argv) {
+	u32 Context = 8;
+	int Argument = 1;
+	if (argc > 2 && std::strcmp(argv[1], "--context") == 0) {
+		Context = static_cast<u32>(std::strtoul(argv[2], nullptr, 0));
+		Argument = 3;
+	}
+	if (argc != Argument + 2) {
+		std::fprintf(stderr, "usage: %s [--context N] <left trace> <right trace>\n", argv[0]);
+		return 2;
+	}
+	TraceReader Left, Right;
+	if (!Left.Open(argv[Argument]) || !Right.Open(argv[Argument + 1])) {
+		std::fprintf(stderr, "%s\n", (Left.Error.empty() ? Right.Error : Left.Error).c_str());
+		return 2;
+	}
+
+	TraceDivergence Result;
+	if (!FindDivergence(Left, Right, Context, Result)) {
+		std::fprintf(stderr, "%s\n", (Left.Error.empty() ? Right.Error : Left.Error).c_str());
+		return 2;
+	}
+	std::printf("%llu identical blocks skipped, %llu decoded\n", static_cast<unsigned long long>(Result.SkippedBlocks),
+		static_cast<unsigned long long>(Result.DecodedBlocks));
+	if (!Result.Differs) {
+		std::printf("Traces match (%llu records)\n", static_cast<unsigned long long>(Result.Index));
+		return 0;
+	}
+
+	size_t At = static_cast<size_t>(Result.Index - Result.First);
+	if (At >= Result.Left.size() || At >= Result.Right.size()) {
+		std::printf("First difference at record %llu: %s trace ends\n", static_cast<unsigned long long>(Result.Index),
+			At >= Result.Left.size() ? "left" : "right");
+	}
+	else {
+		std::printf("First difference at record %llu: %s\n", static_cast<unsigned long long>(Result.Index),
+			Differences(Result.Left[At], Result.Right[At]).c_str());
+	}
+	for (size_t i = 0; i < At; ++i) {
+		std::printf("  %12llu %s\n", static_cast<unsigned long long>(Result.First + i), FormatTraceRecord(Result.Left[i]).c_str());
+	}
+	for (size_t i = At; i < Result.Left.size() || i < Result.Right.size(); ++i) {
+		if (i < Result.Left.size()) {
+			std::printf("< %12llu %s\n", static_cast<unsigned long long>(Result.First + i), FormatTraceRecord(Result.Left[i]).c_str());
+		}
+		if (i < Result.Right.size()) {
+			std::printf("> %12llu %s\n", static_cast<unsigned long long>(Result.First + i), FormatTraceRecord(Result.Right[i]).c_str());
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,382 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../src/6502.h"
+#include "../src/opcodes.h"
+
+/*
+	Exhaustive check of every ALU opcode, in every addressing mode, against an independent
+	model of the NMOS 6502: ADC/SBC over A x operand x carry x decimal, the logic ops, BIT and
+	compares over register x operand, shifts and rotates over value x carry.
+
+	The core runs one instruction per case, so the work is sharded across threads by the
+	register value. Within a shard the model and the comparison run over all 256 operands at
+	once in structure-of-arrays form, plain loops the compiler vectorises.
+
+	The core knowingly differs from silicon in places the unit tests pin down (ADC and SBC leave
+	the flags alone, no decimal mode, LDA-only Z/N). Those are listed in KnownDeviations and are
+	reported but do not fail the run. Results are tallied apart in decimal mode ("decimal") so
+	the binary ADC/SBC result is still checked. Anything else does, and so does a known deviation that went
+	away, so the list stays honest.
+	Usage: verify-alu [--threads N] [--verbose]
+*/
+
+enum Field { FieldResult, FieldDecimal, FieldN, FieldV, FieldZ, FieldC, FieldCount };
+static constexpr const char* FieldNames[FieldCount] = { "result", "decimal", "N", "V", "Z", "C" };
+static constexpr u8 FieldBits[FieldCount] = { 0, 0, 1 << NMOS6502::N, 1 << NMOS6502::V, 1 << NMOS6502::Z, 1 << NMOS6502::C };
+
+/* Not a field: the result is checked against the model with the incoming carry inverted */
+static constexpr unsigned KnownBorrow = 1u << FieldCount;
+
+/* Fields this core is known to get wrong, as "MNE:fields" for every mode or "XX:fields" for one opcode */
+static constexpr const char* KnownDeviations[] = {
+	"ADC:decimal,N,V,Z,C", // No decimal mode, flags untouched
+	"SBC:borrow,decimal,N,V,Z,C", // Subtracts the carry where silicon subtracts the borrow
+	"AND:N,Z", // Only LDA updates N and Z
+	"ORA:N,Z",
+	"EOR:N,Z",
+	"BIT:N,V", // Tests bits 6 and 7 against 1, so never set
+	"ASL:N,Z",
+	"LSR:N,Z",
+	"4A:C", // LSR A takes C from bit 1
+	"ROL:result,N,Z", // Rotates through the carry after it has been replaced
+	"ROR:result,N,Z",
+	"6A:C", // ROR A takes C from bit 7
+};
+
+/* Which register the opcode compares or combines with, and where its operand comes from */
+enum Register { RegisterA, RegisterX, RegisterY };
+
+static constexpr u16 Origin = 0x0200;
+static constexpr u8 Index = 0x04;
+
+/* Operand location for each mode; symmetric address bytes so the core's operand byte order does not matter */
+static u16 Encode(NMOS6502& M6502, u8 Opcode) {
+	AddressingMode Mode = OpcodeTable[Opcode].Mode;
+	M6502.Memory[Origin] = Opcode;
+	M6502.Memory[Origin + 1] = 0x30;
+	M6502.Memory[Origin + 2] = 0x30;
+	M6502.Memory[0x44] = 0x30;
+	M6502.Memory[0x45] = 0x30;
+	switch (Mode) {
+	case Immediate: return Origin + 1;
+	case ZeroPage: M6502.Memory[Origin + 1] = 0x40; return 0x40;
+	case ZeroPageX: M6502.Memory[Origin + 1] = 0x40; return 0x40 + Index;
+	case Absolute: return 0x3030;
+	case AbsoluteX: case AbsoluteY: return 0x3030 + Index;
+	case IndirectX: M6502.Memory[Origin + 1] = 0x40; return 0x3030; // ($40,X) -> pointer at $44
+	case IndirectY: M6502.Memory[Origin + 1] = 0x44; return 0x3030 + Index;
+	default: return 0; // Accumulator
+	}
+}
+
+/* The reference model, 256 operands per call for one register value and incoming C/D */
+struct Lanes {
+	u8 Result[256];
+	u8 Flags[256];
+};
+
+static u8 NZ(u8 Value) {
+	return (Value & 0x80 ? FieldBits[FieldN] : 0) | (Value == 0 ? FieldBits[FieldZ] : 0);
+}
+
+static void Reference(const char* Mnemonic, u8 Register, bool Carry, bool Decimal, u8 FlagsIn, Lanes& Out) {
+	const u8 C = FieldBits[FieldC], V = FieldBits[FieldV], Z = FieldBits[FieldZ], N = FieldBits[FieldN];
+	const u8 Kept = FlagsIn & ~(N | V | Z | C);
+	const unsigned CarryIn = Carry ? 1 : 0;
+	if (std::strcmp(Mnemonic, "ADC") == 0 && !Decimal) {
+		for (unsigned M = 0; M < 256; ++M) {
+			unsigned Sum = Register + M + CarryIn;
+			u8 Result = static_cast<u8>(Sum);
+			Out.Result[M] = Result;
+			Out.Flags[M] = Kept | NZ(Result) | (Sum > 0xFF ? C : 0) | ((~(Register ^ M) & (Register ^ Result) & 0x80) ? V : 0);
+		}
+	}
+	else if (std::strcmp(Mnemonic, "ADC") == 0) {
+		for (unsigned M = 0; M < 256; ++M) {
+			unsigned Low = (Register & 0x0F) + (M & 0x0F) + CarryIn;
+			if (Low > 9) {
+				Low += 6;
+			}
+			unsigned High = (Register >> 4) + (M >> 4) + (Low > 0x0F);
+			u8 Binary = static_cast<u8>(Register + M + CarryIn);
+			u8 Intermediate = static_cast<u8>(High << 4 | (Low & 0x0F));
+			u8 Flags = Kept | (Binary == 0 ? Z : 0) | (Intermediate & 0x80 ? N : 0) | ((~(Register ^ M) & (Register ^ Intermediate) & 0x80) ? V : 0);
+			if (High > 9) {
+				High += 6;
+			}
+			Out.Result[M] = static_cast<u8>(High << 4 | (Low & 0x0F));
+			Out.Flags[M] = Flags | (High > 0x0F ? C : 0);
+		}
+	}
+	else if (std::strcmp(Mnemonic, "SBC") == 0) {
+		for (unsigned M = 0; M < 256; ++M) {
+			int Difference = static_cast<int>(Register) - static_cast<int>(M) - static_cast<int>(1 - CarryIn);
+			u8 Binary = static_cast<u8>(Difference);
+			u8 Result = Binary;
+			if (Decimal) {
+				int Low = (Register & 0x0F) - (M & 0x0F) - static_cast<int>(1 - CarryIn);
+				int High = (Register >> 4) - (M >> 4);
+				if (Low & 0x10) {
+					Low -= 6;
+					--High;
+				}
+				if (High & 0x10) {
+					High -= 6;
+				}
+				Result = static_cast<u8>(High << 4 | (Low & 0x0F));
+			}
+			Out.Result[M] = Result;
+			Out.Flags[M] = Kept | NZ(Binary) | (Difference >= 0 ? C : 0) | (((Register ^ M) & (Register ^ Binary) & 0x80) ? V : 0);
+		}
+	}
+	else if (std::strcmp(Mnemonic, "AND") == 0 || std::strcmp(Mnemonic, "ORA") == 0 || std::strcmp(Mnemonic, "EOR") == 0) {
+		char Op = Mnemonic[0];
+		for (unsigned M = 0; M < 256; ++M) {
+			u8 Result = static_cast<u8>(Op == 'A' ? Register & M : Op == 'O' ? Register | M : Register ^ M);
+			Out.Result[M] = Result;
+			Out.Flags[M] = (FlagsIn & ~(N | Z)) | NZ(Result);
+		}
+	}
+	else if (std::strcmp(Mnemonic, "BIT") == 0) {
+		for (unsigned M = 0; M < 256; ++M) {
+			Out.Result[M] = Register;
+			Out.Flags[M] = (FlagsIn & ~(N | V | Z)) | ((Register & M) == 0 ? Z : 0) | (M & 0x80 ? N : 0) | (M & 0x40 ? V : 0);
+		}
+	}
+	else if (Mnemonic[0] == 'C') { // CMP, CPX, CPY
+		for (unsigned M = 0; M < 256; ++M) {
+			Out.Result[M] = Register;
+			Out.Flags[M] = (FlagsIn & ~(N | Z | C)) | NZ(static_cast<u8>(Register - M)) | (Register >= M ? C : 0);
+		}
+	}
+	else { // ASL, LSR, ROL, ROR on the operand itself
+		bool Left = Mnemonic[0] == 'A' || (Mnemonic[1] == 'O' && Mnemonic[2] == 'L');
+		bool Rotate = Mnemonic[0] == 'R';
+		for (unsigned M = 0; M < 256; ++M) {
+			u8 Result = static_cast<u8>(Left ? M << 1 | (Rotate ? CarryIn : 0) : M >> 1 | (Rotate ? CarryIn << 7 : 0));
+			bool Shifted = Left ? (M & 0x80) != 0 : (M & 0x01) != 0;
+			Out.Result[M] = Result;
+			Out.Flags[M] = (FlagsIn & ~(N | Z | C)) | NZ(Result) | (Shifted ? C : 0);
+		}
+	}
+}
+
+static bool IsShift(const char* Mnemonic) {
+	return MnemonicIn(Mnemonic, "ASL LSR ROL ROR");
+}
+
+static bool IsAlu(u8 Opcode) {
+	return MnemonicIn(OpcodeTable[Opcode].Mnemonic, "ADC SBC AND ORA EOR BIT CMP CPX CPY ASL LSR ROL ROR");
+}
+
+struct Mismatches {
+	u64 Cases = 0;
+	u64 Count[FieldCount] = {};
+	bool Example = false;
+	char Description[160] = "";
+};
+
+static u8 PackFlags(const NMOS6502& M6502) {
+	return static_cast<u8>(M6502.ProcessorStatus.to_ulong());
+}
+
+/* One register value (or shift operand), every operand, carry and decimal combination */
+static void Sweep(u8 Opcode, unsigned Value, bool Borrow, Mismatches& Found) {
+	const char* Mnemonic = OpcodeTable[Opcode].Mnemonic;
+	bool Shift = IsShift(Mnemonic);
+	bool Sums = MnemonicIn(Mnemonic, "ADC SBC");
+	Register Source = Mnemonic[2] == 'X' && Mnemonic[0] == 'C' ? RegisterX : Mnemonic[2] == 'Y' && Mnemonic[0] == 'C' ? RegisterY : RegisterA;
+	bool AccumulatorMode = OpcodeTable[Opcode].Mode == Accumulator;
+
+	NMOS6502 M6502;
+	M6502.Reset();
+	u16 Operand = Encode(M6502, Opcode);
+	Lanes Expected, Actual;
+	for (int Incoming = 0; Incoming < (Sums ? 4 : 2); ++Incoming) {
+		bool Carry = Incoming & 1, Decimal = Incoming & 2;
+		/* Flags that should pass through untouched alternate with the operand */
+		u8 FlagsIn = (Carry ? FieldBits[FieldC] : 0) | (Decimal ? 1 << NMOS6502::D : 0) | (Value & 1 ? FieldBits[FieldV] | FieldBits[FieldN] | FieldBits[FieldZ] : 0);
+		if (!Shift) {
+			Reference(Mnemonic, static_cast<u8>(Value), Carry, Decimal, FlagsIn, Expected);
+		}
+		if (Borrow) {
+			Lanes Borrowed;
+			Reference(Mnemonic, static_cast<u8>(Value), !Carry, Decimal, FlagsIn, Borrowed);
+			std::memcpy(Expected.Result, Borrowed.Result, sizeof(Expected.Result));
+		}
+
+		unsigned Count = Shift ? 1 : 256;
+		for (unsigned M = 0; M < Count; ++M) {
+			M6502.PC = Origin;
+			M6502.SP = 0x01FF;
+			M6502.ProcessorStatus = std::bitset<6>(FlagsIn);
+			M6502.A = M6502.X = M6502.Y = Index;
+			u8 Input = static_cast<u8>(Shift ? Value : M);
+			switch (Source) {
+			case RegisterA: M6502.A = static_cast<u8>(Value); break;
+			case RegisterX: M6502.X = static_cast<u8>(Value); break;
+			case RegisterY: M6502.Y = static_cast<u8>(Value); break;
+			}
+			if (AccumulatorMode) {
+				M6502.A = Input;
+			}
+			else {
+				M6502.Memory[Operand] = Input;
+			}
+			M6502.Execute(0);
+			u8 Result = Source == RegisterX ? M6502.X : Source == RegisterY ? M6502.Y : M6502.A;
+			if (Shift && !AccumulatorMode) {
+				Result = M6502.Memory[Operand];
+			}
+			Actual.Result[M] = Result;
+			Actual.Flags[M] = PackFlags(M6502);
+		}
+		if (Shift) { // The value is the operand, a single lane picked out of the model
+			Lanes Model;
+			Reference(Mnemonic, 0, Carry, false, FlagsIn, Model);
+			Expected.Result[0] = Model.Result[Value];
+			Expected.Flags[0] = Model.Flags[Value];
+		}
+
+		/* Branch-free per-field tallies over the lanes */
+		u8 Differs[FieldCount][256];
+		for (unsigned M = 0; M < Count; ++M) {
+			Differs[FieldResult][M] = Expected.Result[M] != Actual.Result[M];
+			u8 Flags = Expected.Flags[M] ^ Actual.Flags[M];
+			for (int Which = FieldN; Which < FieldCount; ++Which) {
+				Differs[Which][M] = (Flags & FieldBits[Which]) != 0;
+			}
+		}
+		for (int Which = 0; Which < FieldCount; ++Which) {
+			if (Which == FieldDecimal) {
+				continue;
+			}
+			unsigned Sum = 0;
+			for (unsigned M = 0; M < Count; ++M) {
+				Sum += Differs[Which][M];
+			}
+			Found.Count[Which == FieldResult && Decimal ? FieldDecimal : Which] += Sum;
+		}
+		Found.Cases += Count;
+		if (!Found.Example) {
+			for (unsigned M = 0; M < Count; ++M) {
+				if (Expected.Result[M] != Actual.Result[M] || Expected.Flags[M] != Actual.Flags[M]) {
+					std::snprintf(Found.Description, sizeof(Found.Description), "%s=%02X operand=%02X C=%d D=%d: expected %02X flags %02X, got %02X flags %02X",
+						Source == RegisterX ? "X" : Source == RegisterY ? "Y" : "A", Shift ? 0 : Value, Shift ? Value : M, Carry, Decimal,
+						Expected.Result[M], Expected.Flags[M], Actual.Result[M], Actual.Flags[M]);
+					Found.Example = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
+/* Known deviations for an opcode as a field mask, plus KnownBorrow */
+static unsigned KnownMask(u8 Opcode) {
+	char Hex[3];
+	std::snprintf(Hex, sizeof(Hex), "%02X", Opcode);
+	unsigned Mask = 0;
+	for (const char* Entry : KnownDeviations) {
+		const char* Colon = std::strchr(Entry, ':');
+		std::string Key(Entry, Colon), Fields = Colon + 1;
+		if (Key != OpcodeTable[Opcode].Mnemonic && Key != Hex) {
+			continue;
+		}
+		for (int Which = 0; Which <= FieldCount; ++Which) {
+			std::string Name = Which == FieldCount ? "borrow" : FieldNames[Which];
+			size_t At = Fields.find(Name);
+			if (At != std::string::npos && (At + Name.size() == Fields.size() || Fields[At + Name.size()] == ',')) {
+				Mask |= 1u << Which;
+			}
+		}
+	}
+	return Mask;
+}
+
+int main(int argc, char** argv) {
+	unsigned Threads = std::max(1u, std::thread::hardware_concurrency());
+	bool Verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			Threads = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--verbose") == 0) {
+			Verbose = true;
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--threads N] [--verbose]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::vector<u8> Opcodes;
+	std::vector<unsigned> Known;
+	for (int Opcode = 0; Opcode < 0x100; ++Opcode) {
+		if (IsAlu(static_cast<u8>(Opcode))) {
+			Opcodes.push_back(static_cast<u8>(Opcode));
+			Known.push_back(KnownMask(static_cast<u8>(Opcode)));
+		}
+	}
+
+	/* Work items are (opcode, register value); each thread keeps its own tallies */
+	std::vector<std::vector<Mismatches>> PerThread(Threads, std::vector<Mismatches>(Opcodes.size()));
+	std::atomic<size_t> Next{ 0 };
+	size_t Items = Opcodes.size() * 256;
+	std::vector<std::thread> Workers;
+	for (unsigned Thread = 0; Thread < Threads; ++Thread) {
+		Workers.emplace_back([&, Thread] {
+			for (size_t Item; (Item = Next.fetch_add(1)) < Items;) {
+				Sweep(Opcodes[Item / 256], static_cast<unsigned>(Item % 256), (Known[Item / 256] & KnownBorrow) != 0, PerThread[Thread][Item / 256]);
+			}
+		});
+	}
+	for (std::thread& Worker : Workers) {
+		Worker.join();
+	}
+
+	bool Passed = true;
+	u64 Cases = 0;
+	for (size_t i = 0; i < Opcodes.size(); ++i) {
+		Mismatches Total;
+		for (unsigned Thread = 0; Thread < Threads; ++Thread) {
+			const Mismatches& Part = PerThread[Thread][i];
+			Total.Cases += Part.Cases;
+			for (int Which = 0; Which < FieldCount; ++Which) {
+				Total.Count[Which] += Part.Count[Which];
+			}
+			if (!Total.Example && Part.Example) {
+				Total.Example = true;
+				std::memcpy(Total.Description, Part.Description, sizeof(Total.Description));
+			}
+		}
+		Cases += Total.Cases;
+		const OpcodeInfo& Info = OpcodeTable[Opcodes[i]];
+		unsigned Expected = Known[i] & ~KnownBorrow, Seen = 0;
+		for (int Which = 0; Which < FieldCount; ++Which) {
+			Seen |= Total.Count[Which] ? 1u << Which : 0;
+		}
+		bool Unexpected = (Seen & ~Expected) != 0, Fixed = (Expected & ~Seen) != 0;
+		Passed &= !Unexpected && !Fixed;
+		if (!Seen && !Expected && !Verbose) {
+			continue;
+		}
+		std::printf("%02X %s %-11s", Opcodes[i], Info.Mnemonic, AddressingModeNames[Info.Mode]);
+		for (int Which = 0; Which < FieldCount; ++Which) {
+			if (Total.Count[Which]) {
+				std::printf(" %s:%llu", FieldNames[Which], static_cast<unsigned long long>(Total.Count[Which]));
+			}
+		}
+		std::printf("%s\n", Unexpected ? "  UNEXPECTED" : Fixed ? "  FIXED, update KnownDeviations" : Seen ? "  known" : "");
+		if (Unexpected || Verbose) {
+			std::printf("   first: %s\n", Total.Description);
+		}
+	}
+	std::printf("%zu opcodes, %llu cases, %s\n", Opcodes.size(), static_cast<unsigned long long>(Cases), Passed ? "no unexpected differences" : "FAILED");
+	return Passed ? 0 : 1;
+}
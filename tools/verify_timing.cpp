@@ -0,0 +1,150 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "../src/6502.h"
+#include "../src/opcodes.h"
+
+/*
+	Runs every documented opcode once per timing variant and compares CyclesPerformed with
+	OpcodeTimings: indexed modes with and without the page cross, branches not taken, taken
+	and taken across a page. Operand address bytes are symmetric so the core's operand byte
+	order does not move the effective address.
+
+	Known deviations are reported but do not fail the run; anything else does, and so does a
+	known deviation that went away.
+	Usage: verify-timing [--verbose]
+*/
+
+enum Variant { VariantPlain, VariantNoCross, VariantCross, VariantNotTaken, VariantTaken, VariantTakenCross, VariantCount };
+static constexpr const char* VariantNames[VariantCount] = { "plain", "no-cross", "cross", "not-taken", "taken", "taken-cross" };
+
+/* Variants this core is known to time wrongly, as "MNE:variants" for every mode or "XX:variants" for one opcode */
+static constexpr const char* KnownDeviations[] = {
+	"BRK:plain", // Empty handler, only the opcode fetch
+	"RTI:plain", // Not implemented
+	"BIT:plain", // One cycle short in both modes
+	"35:plain", // AND zp,X misses the data read cycle
+	"RTS:plain", // One cycle short
+	"NOP:plain", // No idle cycle after the fetch
+};
+
+static constexpr u16 Origin = 0x0200;
+static constexpr u16 BranchOrigin = 0x04F0; // Offset $7F lands on the next page, $02 does not
+static constexpr u8 Index = 0x10;
+
+static bool Indexed(AddressingMode Mode) {
+	return Mode == AbsoluteX || Mode == AbsoluteY || Mode == IndirectY;
+}
+
+/* Flag the branch tests: opcode bits 7-6 pick N, V, C or Z, bit 5 is the value it branches on */
+static void SetBranchCondition(NMOS6502& M6502, u8 Opcode, bool Taken) {
+	static constexpr NMOS6502::FLAGS Flags[4] = { NMOS6502::N, NMOS6502::V, NMOS6502::C, NMOS6502::Z };
+	bool Wanted = (Opcode & 0x20) != 0;
+	M6502.ProcessorStatus[Flags[Opcode >> 6]] = Taken ? Wanted : !Wanted;
+}
+
+static int Run(NMOS6502& M6502, u8 Opcode, Variant Which) {
+	std::memset(M6502.Memory.data(), 0, M6502.Memory.size());
+	M6502.NMIPending = M6502.IRQPending = false;
+	M6502.ProcessorStatus.reset();
+	M6502.SP = 0x01FD;
+	M6502.A = 0;
+	M6502.X = M6502.Y = Index;
+	u16 Address = IsBranch(Opcode) ? BranchOrigin : Origin;
+	M6502.PC = Address;
+	M6502.Memory[Address] = Opcode;
+	if (IsBranch(Opcode)) {
+		SetBranchCondition(M6502, Opcode, Which != VariantNotTaken);
+		M6502.Memory[Address + 1] = Which == VariantTakenCross ? 0x7F : 0x02;
+	}
+	else {
+		u8 Operand = Which == VariantCross ? 0xF8 : 0x30;
+		M6502.Memory[Address + 1] = OpcodeTable[Opcode].Mode == IndirectY ? 0x44 : Operand;
+		M6502.Memory[Address + 2] = Operand;
+		M6502.Memory[0x44] = M6502.Memory[0x45] = Operand; // ($44),Y
+	}
+	return M6502.Execute(0);
+}
+
+static unsigned KnownMask(u8 Opcode) {
+	char Hex[3];
+	std::snprintf(Hex, sizeof(Hex), "%02X", Opcode);
+	unsigned Mask = 0;
+	for (const char* Entry : KnownDeviations) {
+		const char* Colon = std::strchr(Entry, ':');
+		if (!Colon) {
+			continue;
+		}
+		std::string Key(Entry, Colon), Variants = Colon + 1;
+		if (Key != OpcodeTable[Opcode].Mnemonic && Key != Hex) {
+			continue;
+		}
+		for (int Which = 0; Which < VariantCount; ++Which) {
+			std::string Name = VariantNames[Which];
+			size_t At = Variants.find(Name);
+			while (At != std::string::npos && ((At > 0 && Variants[At - 1] != ',') || (At + Name.size() != Variants.size() && Variants[At + Name.size()] != ','))) {
+				At = Variants.find(Name, At + 1);
+			}
+			if (At != std::string::npos) {
+				Mask |= 1u << Which;
+			}
+		}
+	}
+	return Mask;
+}
+
+int main(int argc, char** argv) {
+	bool Verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		if (std::strcmp(argv[i], "--verbose") == 0) {
+			Verbose = true;
+		}
+		else {
+			std::fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	NMOS6502 M6502;
+	M6502.Reset();
+	bool Passed = true;
+	int Opcodes = 0, Cases = 0;
+	for (int Value = 0; Value < 0x100; ++Value) {
+		u8 Opcode = static_cast<u8>(Value);
+		const OpcodeInfo& Info = OpcodeTable[Opcode];
+		if (std::strcmp(Info.Mnemonic, "???") == 0) {
+			continue;
+		}
+		++Opcodes;
+		unsigned Variants = IsBranch(Opcode) ? 1u << VariantNotTaken | 1u << VariantTaken | 1u << VariantTakenCross
+			: Indexed(Info.Mode) ? 1u << VariantNoCross | 1u << VariantCross
+			: 1u << VariantPlain;
+		unsigned Known = KnownMask(Opcode), Seen = 0;
+		std::string Detail;
+		for (int Which = 0; Which < VariantCount; ++Which) {
+			if (!(Variants & 1u << Which)) {
+				continue;
+			}
+			++Cases;
+			int Expected = ExpectedCycles(Opcode, Which == VariantCross || Which == VariantTakenCross, Which == VariantTaken || Which == VariantTakenCross);
+			int Actual = Run(M6502, Opcode, static_cast<Variant>(Which));
+			if (Actual != Expected) {
+				Seen |= 1u << Which;
+			}
+			if (Actual != Expected || Verbose) {
+				char Part[48];
+				std::snprintf(Part, sizeof(Part), " %s:%d/%d", VariantNames[Which], Actual, Expected);
+				Detail += Part;
+			}
+		}
+		bool Unexpected = (Seen & ~Known) != 0, Fixed = (Known & Variants & ~Seen) != 0;
+		Passed &= !Unexpected && !Fixed;
+		if (!Seen && !Known && !Verbose) {
+			continue;
+		}
+		std::printf("%02X %s %-11s%s%s\n", Opcode, Info.Mnemonic, AddressingModeNames[Info.Mode], Detail.c_str(),
+			Unexpected ? "  UNEXPECTED" : Fixed ? "  FIXED, update KnownDeviations" : Seen ? "  known" : "");
+	}
+	std::printf("%d opcodes, %d cases (actual/expected cycles), %s\n", Opcodes, Cases, Passed ? "no unexpected differences" : "FAILED");
+	return Passed ? 0 : 1;
+}